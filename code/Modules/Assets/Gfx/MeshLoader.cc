@@ -22,6 +22,13 @@ MeshLoaderBase(setup_, loadedFunc_) {
     // empty
 }
 
+//------------------------------------------------------------------------------
+MeshLoader::MeshLoader(const MeshSetup& setup_, int ioPriority_, LoadedFunc loadedFunc_) :
+MeshLoaderBase(setup_, loadedFunc_),
+ioPriority(ioPriority_) {
+    // empty
+}
+
 //------------------------------------------------------------------------------
 MeshLoader::~MeshLoader() {
     o_assert_dbg(!this->ioRequest);
@@ -31,7 +38,12 @@ MeshLoader::~MeshLoader() {
 void
 MeshLoader::Cancel() {
     if (this->ioRequest) {
-        this->ioRequest->Cancelled = true;
+        if (IO::IsValid()) {
+            IO::Cancel(this->ioRequest);
+        }
+        else {
+            this->ioRequest->Cancelled = true;
+        }
         this->ioRequest = nullptr;
     }
 }
@@ -40,7 +52,7 @@ MeshLoader::Cancel() {
 Id
 MeshLoader::Start() {
     this->resId = Gfx::resource()->prepareAsync(this->setup);
-    this->ioRequest = IO::LoadFile(setup.Locator.Location());
+    this->ioRequest = IO::LoadFile(setup.Locator.Location(), this->ioPriority);
     return this->resId;
 }
 
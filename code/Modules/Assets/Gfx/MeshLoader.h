@@ -20,6 +20,8 @@ public:
     MeshLoader(const MeshSetup& setup);
     /// constructor with success callback
     MeshLoader(const MeshSetup& setup, LoadedFunc onLoaded);
+    /// constructor with IO priority and optional success callback
+    MeshLoader(const MeshSetup& setup, int ioPriority, LoadedFunc onLoaded=LoadedFunc());
     /// destructor
     ~MeshLoader();
     /// start loading, return a resource id
@@ -30,6 +32,7 @@ public:
     virtual void Cancel() override;
 private:
     Id resId;
+    int ioPriority = IORequest::DefaultPriority;
     Ptr<IORead> ioRequest;
 };
 
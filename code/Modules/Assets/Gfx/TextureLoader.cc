@@ -23,6 +23,13 @@ TextureLoaderBase(setup_, loadedFunc_) {
   // empty
 }
 
+//------------------------------------------------------------------------------
+TextureLoader::TextureLoader(const TextureSetup& setup_, int ioPriority_, LoadedFunc loadedFunc_) :
+TextureLoaderBase(setup_, loadedFunc_),
+ioPriority(ioPriority_) {
+    // empty
+}
+
 //------------------------------------------------------------------------------
 TextureLoader::~TextureLoader() {
     o_assert_dbg(!this->ioRequest);
@@ -32,7 +39,12 @@ TextureLoader::~TextureLoader() {
 void
 TextureLoader::Cancel() {
     if (this->ioRequest) {
-        this->ioRequest->Cancelled = true;
+        if (IO::IsValid()) {
+            IO::Cancel(this->ioRequest);
+        }
+        else {
+            this->ioRequest->Cancelled = true;
+        }
         this->ioRequest = nullptr;
     }
 }
@@ -41,7 +53,7 @@ TextureLoader::Cancel() {
 Id
 TextureLoader::Start() {
     this->resId = Gfx::resource()->prepareAsync(this->setup);
-    this->ioRequest = IO::LoadFile(setup.Locator.Location());
+    this->ioRequest = IO::LoadFile(setup.Locator.Location(), this->ioPriority);
     return this->resId;
 }
 
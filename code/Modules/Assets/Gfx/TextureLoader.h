@@ -21,6 +21,8 @@ public:
     TextureLoader(const TextureSetup& setup);
     /// constructor with success callback
     TextureLoader(const TextureSetup& setup, LoadedFunc onLoaded);
+    /// constructor with IO priority and optional success callback
+    TextureLoader(const TextureSetup& setup, int ioPriority, LoadedFunc onLoaded=LoadedFunc());
     /// destructor
     ~TextureLoader();
     /// start loading, return a resource id
@@ -35,6 +37,7 @@ private:
     TextureSetup buildSetup(const TextureSetup& blueprint, const gliml::context* ctx, const uint8_t* data);
     
     Id resId;
+    int ioPriority = IORequest::DefaultPriority;
     Ptr<IORead> ioRequest;
 };
 
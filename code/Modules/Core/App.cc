@@ -7,6 +7,7 @@
 #include "Core/Core.h"
 #include "Core/RunLoop.h"
 #include "Core/Trace.h"
+#include "Core/Time/Clock.h"
 #if ORYOL_EMSCRIPTEN
 #include <emscripten/emscripten.h>
 #elif ORYOL_IOS
@@ -28,7 +29,9 @@ App::App() :
 curState(AppState::Init),
 nextState(AppState::InvalidAppState),
 quitRequested(false),
-suspendRequested(false)
+suspendRequested(false),
+frameLimit(0),
+numRunningFrames(0)
 {
     self = this;
     #if ORYOL_ANDROID
@@ -89,6 +92,19 @@ App::StartMainLoop() {
     Core::Discard();
 }
 
+//------------------------------------------------------------------------------
+void
+App::SetFrameLimit(int numFrames) {
+    o_assert(numFrames >= 0);
+    this->frameLimit = numFrames;
+}
+
+//------------------------------------------------------------------------------
+int
+App::FrameLimit() const {
+    return this->frameLimit;
+}
+
 //------------------------------------------------------------------------------
 void
 App::staticOnFrame() {
@@ -155,7 +171,17 @@ App::onFrame() {
                 this->nextState = this->OnInit();
                 break;
             case AppState::Running:
+                if (0 == this->numRunningFrames) {
+                    this->runningStartTime = Clock::Now();
+                }
                 this->nextState = this->OnRunning();
+                this->numRunningFrames++;
+                if ((this->frameLimit > 0) && (this->numRunningFrames == this->frameLimit)) {
+                    const double ms = Clock::Since(this->runningStartTime).AsMilliSeconds();
+                    Log::Info("App::onFrame(): frame limit reached, %d frames in %.3f ms (%.3f ms/frame)\n",
+                        this->numRunningFrames, ms, ms / this->numRunningFrames);
+                    this->requestQuit();
+                }
                 break;
             case AppState::Cleanup:
                 this->nextState = this->OnCleanup();
@@ -31,11 +31,20 @@
     };
     OryolMain(MyAppClass);    
     ```
+
+    For automated testing and benchmarking, the number of frames an app
+    runs can be limited with SetFrameLimit(), or by passing '-frames N'
+    on the command line (a negative N is ignored with a warning). After
+    N frames in the Running state the app quits and logs the measured
+    frame time, this is most useful together with the headless Gfx
+    backend (ORYOL_USE_HEADLESS cmake option) which doesn't need a
+    window or GPU.
 */
 #include "Core/Types.h"
 #include "Core/Args.h"
 #include "Core/AppState.h"
 #include "Core/Containers/Set.h"
+#include "Core/Time/TimePoint.h"
 
 namespace Oryol {
 namespace _priv {
@@ -57,6 +66,10 @@ public:
     
     /// start the main loop, returns when QuitRequested is set
     void StartMainLoop();
+    /// quit after a number of frames in the Running state (0 means no limit)
+    void SetFrameLimit(int numFrames);
+    /// get the frame limit
+    int FrameLimit() const;
 
     /// on init frame method
     virtual AppState::Code OnInit();
@@ -90,6 +103,9 @@ protected:
     Set<AppState::Code> blockers;
     bool quitRequested;
     bool suspendRequested;
+    int frameLimit;
+    int numRunningFrames;
+    TimePoint runningStartTime;
     #if ORYOL_IOS
     _priv::iosBridge* iosBridge;
     #elif ORYOL_MACOS && ORYOL_METAL
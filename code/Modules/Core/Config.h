@@ -51,6 +51,26 @@
 /// maximum grow size for dynamic container classes (num elements)
 #define ORYOL_CONTAINER_DEFAULT_MAX_GROW (1<<16)
 
+/// initial size of the per-thread frame allocator arena (bytes)
+#ifndef ORYOL_FRAMEALLOCATOR_DEFAULT_SIZE
+#define ORYOL_FRAMEALLOCATOR_DEFAULT_SIZE (64 * 1024)
+#endif
+
+/// cache line size (used for padding of data shared between threads)
+#ifndef ORYOL_CACHELINE_SIZE
+#define ORYOL_CACHELINE_SIZE (64)
+#endif
+
+/// use a thread-local lookup cache in front of the global StringAtom table
+#ifndef ORYOL_STRINGATOM_CACHE
+#define ORYOL_STRINGATOM_CACHE (0)
+#endif
+
+/// use the size-class small-object allocator as backend for Memory::Alloc
+#ifndef ORYOL_SMALL_OBJECT_ALLOCATOR
+#define ORYOL_SMALL_OBJECT_ALLOCATOR (0)
+#endif
+
 #ifndef __GNUC__
 #define __attribute__(x)
 #endif
@@ -25,6 +25,14 @@
     
     NOTE: An array growth operation will truncate any spare room
     at the front.
+
+    Call UseFrameAllocator() on an empty array to allocate its
+    storage from the thread's FrameAllocator, such an array must not
+    be used beyond the current frame!
+
+    The array storage is aligned to alignof(TYPE), call SetAlignment()
+    on an empty array to request a bigger alignment (e.g. 32 or 64 bytes
+    for SIMD processing).
     
     For sorting, iterating and sorted insertion, use the standard 
     algorithm stuff!
@@ -61,6 +69,12 @@ public:
     int GetMinGrow() const;
     /// get max grow value
     int GetMaxGrow() const;
+    /// set buffer alignment in bytes (power of 2, array must not have storage yet)
+    void SetAlignment(int alignment);
+    /// get buffer alignment in bytes (default is alignof(TYPE))
+    int GetAlignment() const;
+    /// allocate storage from the thread's FrameAllocator (array must not have storage yet)
+    void UseFrameAllocator();
     /// get number of elements in array
     int Size() const;
     /// return true if empty
@@ -219,6 +233,28 @@ Array<TYPE>::GetMaxGrow() const {
     return this->maxGrow;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Array<TYPE>::SetAlignment(int alignment) {
+    o_assert_dbg(nullptr == this->buffer.buf);
+    o_assert_dbg(0 == (alignment & (alignment - 1)));
+    o_assert_dbg(alignment >= int(alignof(TYPE)));
+    this->buffer.alignment = alignment;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+Array<TYPE>::GetAlignment() const {
+    return this->buffer.alignment;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Array<TYPE>::UseFrameAllocator() {
+    o_assert_dbg(nullptr == this->buffer.buf);
+    this->buffer.useFrameAllocator = true;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> int
 Array<TYPE>::Size() const {
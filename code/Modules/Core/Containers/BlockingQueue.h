@@ -0,0 +1,210 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::BlockingQueue
+    @ingroup Core
+    @brief waitable wrapper around a lock-free SPSCQueue or MPMCQueue
+
+    Adds blocking WaitDequeue() methods to a lock-free queue. Enqueue()
+    and Dequeue() stay lock-free, the mutex and condition variable are
+    only touched when a consumer actually needs to go to sleep, or
+    when a producer sees that a consumer is sleeping.
+
+    Close() wakes up all waiting consumers, after that WaitDequeue()
+    returns false once the queue is empty.
+
+    Without ORYOL_HAS_THREADS, WaitDequeue() doesn't block.
+
+    @see SPSCQueue, MPMCQueue
+*/
+#include <atomic>
+#include "Core/Config.h"
+#include "Core/Time/Duration.h"
+#include "Core/Containers/MPMCQueue.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#endif
+
+namespace Oryol {
+
+template<class TYPE, class QUEUE=MPMCQueue<TYPE>> class BlockingQueue {
+public:
+    /// constructor with capacity
+    BlockingQueue(int capacity);
+
+    /// get capacity of queue
+    int Capacity() const;
+    /// get number of elements in queue (approximate)
+    int Size() const;
+    /// return true if queue is empty (approximate)
+    bool Empty() const;
+
+    /// copy-enqueue an element and wake up a waiting consumer, return false if full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element and wake up a waiting consumer, return false if full
+    bool Enqueue(TYPE&& elm);
+    /// dequeue an element without waiting, return false if empty
+    bool Dequeue(TYPE& outElm);
+    /// wait until an element can be dequeued, return false if closed and empty
+    bool WaitDequeue(TYPE& outElm);
+    /// wait with timeout until an element can be dequeued, return false on timeout
+    bool WaitDequeue(TYPE& outElm, Duration timeout);
+
+    /// wake up all waiting consumers, WaitDequeue() won't block anymore
+    void Close();
+    /// return true if the queue has been closed
+    bool IsClosed() const;
+
+private:
+    /// wake up a waiting consumer if there is one
+    void notify();
+
+    QUEUE queue;
+    std::atomic<bool> closed;
+    #if ORYOL_HAS_THREADS
+    std::atomic<int> numWaiters;
+    std::mutex mutex;
+    std::condition_variable condVar;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE>
+BlockingQueue<TYPE, QUEUE>::BlockingQueue(int capacity) :
+queue(capacity),
+closed(false)
+#if ORYOL_HAS_THREADS
+, numWaiters(0)
+#endif
+{
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> int
+BlockingQueue<TYPE, QUEUE>::Capacity() const {
+    return this->queue.Capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> int
+BlockingQueue<TYPE, QUEUE>::Size() const {
+    return this->queue.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::Empty() const {
+    return this->queue.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> void
+BlockingQueue<TYPE, QUEUE>::notify() {
+    #if ORYOL_HAS_THREADS
+    // NOTE: the fence pairs with the fence in WaitDequeue(), either
+    // the consumer sees the new element, or we see the consumer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->numWaiters.load(std::memory_order_relaxed) > 0) {
+        // taking the lock guarantees that the consumer is inside wait()
+        { std::lock_guard<std::mutex> lock(this->mutex); }
+        this->condVar.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::Enqueue(const TYPE& elm) {
+    if (this->queue.Enqueue(elm)) {
+        this->notify();
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::Enqueue(TYPE&& elm) {
+    if (this->queue.Enqueue(std::move(elm))) {
+        this->notify();
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::Dequeue(TYPE& outElm) {
+    return this->queue.Dequeue(outElm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::WaitDequeue(TYPE& outElm) {
+    if (this->queue.Dequeue(outElm)) {
+        return true;
+    }
+    #if ORYOL_HAS_THREADS
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->numWaiters++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool result;
+    while (!(result = this->queue.Dequeue(outElm)) && !this->closed) {
+        this->condVar.wait(lock);
+    }
+    this->numWaiters--;
+    return result;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::WaitDequeue(TYPE& outElm, Duration timeout) {
+    if (this->queue.Dequeue(outElm)) {
+        return true;
+    }
+    #if ORYOL_HAS_THREADS
+    const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(int64_t(timeout.AsMicroSeconds()));
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->numWaiters++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool result;
+    while (!(result = this->queue.Dequeue(outElm)) && !this->closed) {
+        if (std::cv_status::timeout == this->condVar.wait_until(lock, until)) {
+            result = this->queue.Dequeue(outElm);
+            break;
+        }
+    }
+    this->numWaiters--;
+    return result;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> void
+BlockingQueue<TYPE, QUEUE>::Close() {
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->closed = true;
+    }
+    this->condVar.notify_all();
+    #else
+    this->closed = true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class QUEUE> bool
+BlockingQueue<TYPE, QUEUE>::IsClosed() const {
+    return this->closed;
+}
+
+} // namespace Oryol
@@ -4,15 +4,35 @@
     @class Oryol::Buffer
     @ingroup Core
     @brief growable memory buffer for raw data
+
+    Call UseFrameAllocator() on an empty buffer to allocate its
+    memory from the thread's FrameAllocator, such a buffer must not
+    be used beyond the current frame!
+
+    Call SetAlignment() on an empty buffer to align its memory to
+    more than ORYOL_MAX_PLATFORM_ALIGN bytes.
+
+    Call Wrap() to let the buffer point to memory it doesn't own
+    (for instance a memory-mapped file) without copying. The optional
+    release function is called when the buffer no longer references
+    the memory (when it is destroyed, cleared, or assigned new content).
+    A wrapped buffer must be treated as read-only: all operations
+    which modify the content first copy it into memory owned by
+    the buffer.
 */
 #include "Core/Types.h"
 #include "Core/Assertion.h"
+#include "Core/Delegate.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/FrameAllocator.h"
 
 namespace Oryol {
 
 class Buffer {
 public:
+    /// release function for wrapped memory, called with pointer and size passed to Wrap()
+    typedef Delegate<void(const uint8_t* ptr, int numBytes)> ReleaseFunc;
+
     /// default constructor
     Buffer();
     /// move constructor
@@ -36,6 +56,16 @@ public:
     int Capacity() const;
     /// get number of free bytes at back
     int Spare() const;
+    /// allocate memory from the thread's FrameAllocator (buffer must be empty)
+    void UseFrameAllocator();
+    /// set alignment of buffer memory (power of 2, buffer must be empty)
+    void SetAlignment(int alignment);
+    /// get alignment of buffer memory
+    int GetAlignment() const;
+    /// point buffer to external read-only memory without copying (replaces content)
+    void Wrap(const uint8_t* ptr, int numBytes, ReleaseFunc releaseFunc=ReleaseFunc());
+    /// return true if the buffer currently wraps external memory
+    bool IsWrapped() const;
 
     /// make room for N more bytes
     void Reserve(int numBytes);
@@ -59,10 +89,16 @@ private:
     void destroy();
     /// append-copy content into currently allocated buffer, bump size
     void copy(const uint8_t* ptr, int numBytes);
+    /// free buffer memory (or release wrapped memory)
+    void freeData(uint8_t* ptr);
 
     int size;
     int capacity;
     uint8_t* data;
+    bool useFrameAllocator;
+    bool wrapped;
+    int alignment;
+    ReleaseFunc releaseFunc;
 };
 
 //------------------------------------------------------------------------------
@@ -70,7 +106,10 @@ inline
 Buffer::Buffer() :
 size(0),
 capacity(0),
-data(nullptr) {
+data(nullptr),
+useFrameAllocator(false),
+wrapped(false),
+alignment(ORYOL_MAX_PLATFORM_ALIGN) {
     // empty
 }
 
@@ -79,10 +118,16 @@ inline
 Buffer::Buffer(Buffer&& rhs) :
 size(rhs.size),
 capacity(rhs.capacity),
-data(rhs.data) {
+data(rhs.data),
+useFrameAllocator(rhs.useFrameAllocator),
+wrapped(rhs.wrapped),
+alignment(rhs.alignment),
+releaseFunc(std::move(rhs.releaseFunc)) {
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
+    rhs.wrapped = false;
+    rhs.useFrameAllocator = false;
 }
 
 //------------------------------------------------------------------------------
@@ -94,26 +139,70 @@ Buffer::~Buffer() {
 //------------------------------------------------------------------------------
 inline void
 Buffer::alloc(int newCapacity) {
-    o_assert_dbg(newCapacity > this->capacity);
-    o_assert_dbg(newCapacity > this->size);
+    // NOTE: a wrapped buffer may be re-allocated to the same capacity
+    o_assert_dbg((newCapacity > this->capacity) || this->wrapped);
+    o_assert_dbg(newCapacity >= this->size);
+
+    // frame memory can grow in place if it is the most recent frame allocation
+    if (this->useFrameAllocator && this->data && !this->wrapped &&
+        (this->alignment <= ORYOL_MAX_PLATFORM_ALIGN) &&
+        FrameAllocator::Grow(this->data, newCapacity)) {
+        this->capacity = newCapacity;
+        return;
+    }
 
-    uint8_t* newBuf = (uint8_t*) Memory::Alloc(newCapacity);
+    uint8_t* newBuf;
+    if (this->useFrameAllocator) {
+        if (this->alignment > ORYOL_MAX_PLATFORM_ALIGN) {
+            newBuf = (uint8_t*) Memory::AlignTo(FrameAllocator::Alloc(newCapacity + this->alignment), this->alignment);
+        }
+        else {
+            newBuf = (uint8_t*) FrameAllocator::Alloc(newCapacity);
+        }
+    }
+    else if (this->alignment > ORYOL_MAX_PLATFORM_ALIGN) {
+        newBuf = (uint8_t*) Memory::AllocAligned(newCapacity, this->alignment);
+    }
+    else {
+        newBuf = (uint8_t*) Memory::Alloc(newCapacity);
+    }
     if (this->size > 0) {
         o_assert_dbg(this->data);
         Memory::Copy(this->data, newBuf, this->size);
     }
     if (this->data) {
-        Memory::Free(this->data);
+        this->freeData(this->data);
     }
     this->data = newBuf;
     this->capacity = newCapacity;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Buffer::freeData(uint8_t* ptr) {
+    if (this->wrapped) {
+        if (this->releaseFunc) {
+            this->releaseFunc(ptr, this->capacity);
+            this->releaseFunc = nullptr;
+        }
+        this->wrapped = false;
+    }
+    else if (this->useFrameAllocator) {
+        FrameAllocator::Free(ptr);
+    }
+    else if (this->alignment > ORYOL_MAX_PLATFORM_ALIGN) {
+        Memory::FreeAligned(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 inline void
 Buffer::destroy() {
     if (this->data) {
-        Memory::Free(this->data);
+        this->freeData(this->data);
     }
     this->data = nullptr;
     this->size = 0;
@@ -137,9 +226,15 @@ Buffer::operator=(Buffer&& rhs) {
     this->size = rhs.size;
     this->capacity = rhs.capacity;
     this->data = rhs.data;
+    this->useFrameAllocator = rhs.useFrameAllocator;
+    this->wrapped = rhs.wrapped;
+    this->alignment = rhs.alignment;
+    this->releaseFunc = std::move(rhs.releaseFunc);
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
+    rhs.wrapped = false;
+    rhs.useFrameAllocator = false;
 }
 
 //------------------------------------------------------------------------------
@@ -166,11 +261,50 @@ Buffer::Spare() const {
     return this->capacity - this->size;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Buffer::UseFrameAllocator() {
+    o_assert_dbg(nullptr == this->data);
+    this->useFrameAllocator = true;
+}
+
+//------------------------------------------------------------------------------
+inline void
+Buffer::SetAlignment(int alignment_) {
+    o_assert_dbg(nullptr == this->data);
+    o_assert_dbg((alignment_ > 0) && (0 == (alignment_ & (alignment_ - 1))));
+    this->alignment = alignment_;
+}
+
+//------------------------------------------------------------------------------
+inline int
+Buffer::GetAlignment() const {
+    return this->alignment;
+}
+
+//------------------------------------------------------------------------------
+inline void
+Buffer::Wrap(const uint8_t* ptr, int numBytes, ReleaseFunc releaseFunc_) {
+    o_assert_dbg(ptr && (numBytes > 0));
+    this->destroy();
+    this->data = const_cast<uint8_t*>(ptr);
+    this->size = numBytes;
+    this->capacity = numBytes;
+    this->wrapped = true;
+    this->releaseFunc = std::move(releaseFunc_);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+Buffer::IsWrapped() const {
+    return this->wrapped;
+}
+
 //------------------------------------------------------------------------------
 inline void
 Buffer::Reserve(int numBytes) {
-    // need to grow?
-    if ((this->size + numBytes) > this->capacity) {
+    // need to grow? (a wrapped buffer is always copied into owned memory)
+    if (((this->size + numBytes) > this->capacity) || this->wrapped) {
         const int newCapacity = this->size + numBytes;
         this->alloc(newCapacity);
     }
@@ -195,6 +329,9 @@ Buffer::Add(int numBytes) {
 //------------------------------------------------------------------------------
 inline void
 Buffer::Clear() {
+    if (this->wrapped) {
+        this->destroy();
+    }
     this->size = 0;
 }
 
@@ -212,6 +349,9 @@ Buffer::Remove(int offset, int numBytes) {
     o_assert_dbg((offset + numBytes) <= this->size);
     o_assert_dbg(numBytes >= 0);
     if (numBytes > 0) {
+        if (this->wrapped) {
+            this->alloc(this->size);
+        }
         int bytesToMove = this->size - (offset + numBytes);
         if (bytesToMove > 0) {
             Memory::Move(this->data + offset + numBytes, this->data + offset, this->size - numBytes);
@@ -0,0 +1,186 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::HashMap
+    @ingroup Core
+    @brief open-addressing hash map for fast key lookup
+
+    A key-value-pair container with O(1) lookup, insertion and
+    erase, using open addressing with Robin Hood probing and
+    backward-shift erase (no tombstones). The key-value-pairs live
+    in a single, contiguous array, the table grows (and rehashes)
+    when it would be more than 7/8 full. See _priv::hashTable for
+    details.
+
+    Unlike Map, a key can only be contained once, and the iteration
+    order is undefined. Pointers to elements are invalidated by any
+    Add() or Erase() operation.
+
+    HASHER must be a function object which returns a hash value
+    for a key, the default is std::hash<KEY>. The hash value is
+    scrambled internally, so a simple identity hash is fine.
+
+    @see Map, ArrayMap, HashSet
+*/
+#include <functional>
+#include "Core/Config.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/hashTable.h"
+
+namespace Oryol {
+
+template<class KEY, class VALUE, class HASHER=std::hash<KEY>> class HashMap {
+public:
+    /// get number of elements in map
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots
+    int Capacity() const;
+
+    /// read/write access single element (element must exist)
+    VALUE& operator[](const KEY& key);
+    /// read-only access single element (element must exist)
+    const VALUE& operator[](const KEY& key) const;
+
+    /// make room for at least numElements more elements without rehashing
+    void Reserve(int numElements);
+    /// clear the map (deletes elements, keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// find value by key, return nullptr if not found
+    VALUE* Find(const KEY& key);
+    /// find value by key, return nullptr if not found
+    const VALUE* Find(const KEY& key) const;
+    /// add new element (key must not exist)
+    void Add(const KEY& key, const VALUE& value);
+    /// add new element with move-semantics (key must not exist)
+    void Add(KEY&& key, VALUE&& value);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KEY& key, const VALUE& value);
+    /// erase element by key, does nothing if key not contained
+    void Erase(const KEY& key);
+
+private:
+    struct keyOf {
+        const KEY& operator()(const KeyValuePair<KEY, VALUE>& kvp) const {
+            return kvp.key;
+        };
+    };
+    typedef _priv::hashTable<KeyValuePair<KEY, VALUE>, KEY, keyOf, HASHER> tableType;
+    tableType table;
+
+public:
+    typedef _priv::hashTableIterator<KeyValuePair<KEY, VALUE>, tableType> Iterator;
+    typedef _priv::hashTableIterator<const KeyValuePair<KEY, VALUE>, const tableType> ConstIterator;
+
+    /// C++ conform begin
+    Iterator begin() { return Iterator(&this->table, 0); };
+    /// C++ conform begin
+    ConstIterator begin() const { return ConstIterator(&this->table, 0); };
+    /// C++ conform end
+    Iterator end() { return Iterator(&this->table, this->table.capacity); };
+    /// C++ conform end
+    ConstIterator end() const { return ConstIterator(&this->table, this->table.capacity); };
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->table.size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return 0 == this->table.size;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->table.capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) {
+    const int slotIndex = this->table.findSlot(key);
+    o_assert(InvalidIndex != slotIndex);
+    return this->table.slots[slotIndex].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) const {
+    const int slotIndex = this->table.findSlot(key);
+    o_assert(InvalidIndex != slotIndex);
+    return this->table.slots[slotIndex].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int numElements) {
+    this->table.reserve(numElements);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    this->table.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const KEY& key) const {
+    return InvalidIndex != this->table.findSlot(key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) {
+    const int slotIndex = this->table.findSlot(key);
+    return (InvalidIndex != slotIndex) ? &this->table.slots[slotIndex].value : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) const {
+    const int slotIndex = this->table.findSlot(key);
+    return (InvalidIndex != slotIndex) ? &this->table.slots[slotIndex].value : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KEY& key, const VALUE& value) {
+    this->table.add(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(KEY&& key, VALUE&& value) {
+    this->table.add(KeyValuePair<KEY, VALUE>(std::move(key), std::move(value)));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KEY& key, const VALUE& value) {
+    if (this->Contains(key)) {
+        return false;
+    }
+    this->table.add(KeyValuePair<KEY, VALUE>(key, value));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Erase(const KEY& key) {
+    const int slotIndex = this->table.findSlot(key);
+    if (InvalidIndex != slotIndex) {
+        this->table.eraseSlot(slotIndex);
+    }
+}
+
+} // namespace Oryol
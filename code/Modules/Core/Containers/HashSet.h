@@ -5,181 +5,140 @@
     @ingroup Core
     @brief a Set using hashing for fast access
     
-    Implements a hash set with a fixed number of buckets, each
-    bucket is a binary-sorted set.
+    Implements a hash set with open addressing (Robin Hood probing
+    and backward-shift erase) in a single, contiguous array which
+    grows and rehashes when it would be more than 7/8 full, see
+    _priv::hashTable for details. Lookup, insertion and erase are
+    O(1), the iteration order is undefined.
+
+    HASHER must be a function object which returns a hash value
+    for an element, the default is std::hash<VALUETYPE>.
     
-    @see Array, ArrayMap, Map, Set
+    @see Array, ArrayMap, Map, Set, HashMap
 */
+#include <functional>
 #include "Core/Config.h"
-#include "Core/Containers/Set.h"
+#include "Core/Containers/hashTable.h"
 
 namespace Oryol {
 
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> class HashSet {
+template<class VALUETYPE, class HASHER=std::hash<VALUETYPE>> class HashSet {
 public:
-    /// default constructor
-    HashSet();
-    /// copy constructor
-    HashSet(const HashSet& rhs);
-    /// move constructor
-    HashSet(HashSet&& rhs);
-    /// copy-assignment operator
-    void operator=(const HashSet& rhs);
-    /// move-assignment operator (same capacity and size)
-    void operator=(HashSet&& rhs);
-    
-    /// set allocation strategy
-    void SetAllocStrategy(int minGrow, int maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
-    /// get min grow value
-    int GetMinGrow() const;
-    /// get max grow value
-    int GetMaxGrow() const;
-    /// get number of elements in array
+    /// get number of elements in set
     int Size() const;
     /// return true if empty
     bool Empty() const;
+    /// get number of slots
+    int Capacity() const;
+
+    /// make room for at least numElements more elements without rehashing
+    void Reserve(int numElements);
+    /// clear the set (deletes elements, keeps capacity)
+    void Clear();
     
     /// test if an element exists
     bool Contains(const VALUETYPE& val) const;
-    /// find element
+    /// find element, return nullptr if not found
     const VALUETYPE* Find(const VALUETYPE& val) const;
-    /// add element
+    /// add element (must not exist)
     void Add(const VALUETYPE& val);
-    /// erase element
+    /// add element with move-semantics (must not exist)
+    void Add(VALUETYPE&& val);
+    /// add element, return false if already exists
+    bool AddUnique(const VALUETYPE& val);
+    /// erase element, does nothing if element doesn't exist
     void Erase(const VALUETYPE& val);
     
 private:
-    /// get the bucket for a value
-    const Set<VALUETYPE>& findBucket(const VALUETYPE& val) const;
-    /// get the bucket for a value
-    Set<VALUETYPE>& findBucket(const VALUETYPE& val);
-
-    int size;
-    Set<VALUETYPE> buckets[NUMBUCKETS];
-};
-
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet() :
-size(0) {
-    // empty
-};
-
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(const HashSet& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = rhs.buckets[i];
+    struct keyOf {
+        const VALUETYPE& operator()(const VALUETYPE& val) const {
+            return val;
+        };
     };
-}
+    typedef _priv::hashTable<VALUETYPE, VALUETYPE, keyOf, HASHER> tableType;
+    tableType table;
 
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(HashSet&& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = std::move(rhs.buckets[i]);
-    }
-    rhs.size = 0;
-}
+public:
+    typedef _priv::hashTableIterator<const VALUETYPE, const tableType> ConstIterator;
 
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(const HashSet& rhs) {
-    if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = rhs.buckets[i];
-        }
-    }
-}
+    /// C++ conform begin
+    ConstIterator begin() const { return ConstIterator(&this->table, 0); };
+    /// C++ conform end
+    ConstIterator end() const { return ConstIterator(&this->table, this->table.capacity); };
+};
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(HashSet&& rhs) {
-    if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = std::move(rhs.buckets[i]);
-        }
-        rhs.size = 0;
-    }
-}
-    
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int minGrow, int maxGrow) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i].SetAllocStrategy(minGrow, maxGrow);
-    }
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::Size() const {
+    return this->table.size;
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMinGrow() const {
-    return this->buckets[0].GetMinGrow();
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER>::Empty() const {
+    return (0 == this->table.size);
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMaxGrow() const {
-    return this->buckets[0].GetMaxGrow();
+template<class VALUETYPE, class HASHER> int
+HashSet<VALUETYPE, HASHER>::Capacity() const {
+    return this->table.capacity;
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Size() const {
-    return this->size;
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Reserve(int numElements) {
+    this->table.reserve(numElements);
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Empty() const {
-    return (0 == this->size);
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Clear() {
+    this->table.clear();
 }
     
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Contains(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Contains(val);
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER>::Contains(const VALUETYPE& val) const {
+    return InvalidIndex != this->table.findSlot(val);
 }
     
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> const VALUETYPE*
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Find(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Find(val);
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+HashSet<VALUETYPE, HASHER>::Find(const VALUETYPE& val) const {
+    const int slotIndex = this->table.findSlot(val);
+    return (InvalidIndex != slotIndex) ? &this->table.slots[slotIndex] : nullptr;
 }
     
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Add(const VALUETYPE& val) {
-    this->size++;
-    auto& bucket = this->findBucket(val);
-    bucket.Add(val);
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Add(const VALUETYPE& val) {
+    this->table.add(VALUETYPE(val));
 }
-    
-//------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Erase(const VALUETYPE& val) {
-    o_assert_dbg(this->size > 0);
-    this->size--;
-    auto& bucket = this->findBucket(val);
-    bucket.Erase(val);
-};
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> const Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) const {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Add(VALUETYPE&& val) {
+    this->table.add(std::move(val));
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER> bool
+HashSet<VALUETYPE, HASHER>::AddUnique(const VALUETYPE& val) {
+    if (this->Contains(val)) {
+        return false;
+    }
+    this->table.add(VALUETYPE(val));
+    return true;
+}
+    
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+HashSet<VALUETYPE, HASHER>::Erase(const VALUETYPE& val) {
+    const int slotIndex = this->table.findSlot(val);
+    if (InvalidIndex != slotIndex) {
+        this->table.eraseSlot(slotIndex);
+    }
 }
 
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
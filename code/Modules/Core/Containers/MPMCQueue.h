@@ -0,0 +1,205 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MPMCQueue
+    @ingroup Core
+    @brief lock-free bounded multi-producer/multi-consumer queue
+
+    A fixed-capacity ring buffer which can be used from any number of
+    producer and consumer threads without locking (Dmitry Vyukov's
+    bounded MPMC queue). Each slot has a sequence number which tells
+    producers and consumers whether the slot is ready for them, so
+    that Enqueue() and Dequeue() only need a single CAS on the
+    shared enqueue or dequeue position. The capacity is rounded up
+    to the next power of 2.
+
+    Enqueue() returns false if the queue is full, Dequeue() returns
+    false if the queue is empty. The enqueue and dequeue positions
+    live in separate cache lines.
+
+    Wrap the queue in a BlockingQueue if consumers need to wait
+    for new elements.
+
+    @see SPSCQueue, BlockingQueue, Queue
+*/
+#include <atomic>
+#include <new>
+#include <utility>
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+
+template<class TYPE> class MPMCQueue {
+public:
+    /// constructor with capacity (rounded up to power of 2)
+    MPMCQueue(int capacity);
+    /// destructor
+    ~MPMCQueue();
+
+    /// no copying
+    MPMCQueue(const MPMCQueue& rhs) = delete;
+    /// no copy-assignment
+    void operator=(const MPMCQueue& rhs) = delete;
+
+    /// get capacity of queue
+    int Capacity() const;
+    /// get number of elements in queue (approximate)
+    int Size() const;
+    /// return true if queue is empty (approximate)
+    bool Empty() const;
+
+    /// copy-enqueue an element, return false if full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element, return false if full
+    bool Enqueue(TYPE&& elm);
+    /// dequeue an element, return false if empty
+    bool Dequeue(TYPE& outElm);
+
+private:
+    /// construct-enqueue an element
+    template<class T> bool enqueue(T&& elm);
+
+    struct cell {
+        std::atomic<uint32_t> sequence;
+        TYPE* elm() { return (TYPE*) &this->storage; };
+        typename std::aligned_storage<sizeof(TYPE), alignof(TYPE)>::type storage;
+    };
+    static const int padSize = ORYOL_CACHELINE_SIZE;
+
+    // read-only after construction
+    cell* cells;
+    uint32_t mask;
+    char pad0[padSize];
+    std::atomic<uint32_t> enqueuePos;
+    char pad1[padSize];
+    std::atomic<uint32_t> dequeuePos;
+    char pad2[padSize];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::MPMCQueue(int capacity) :
+enqueuePos(0),
+dequeuePos(0) {
+    o_assert_dbg(capacity > 0);
+    uint32_t cap = 2;
+    while (cap < uint32_t(capacity)) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    const int align = alignof(cell) > ORYOL_CACHELINE_SIZE ? int(alignof(cell)) : ORYOL_CACHELINE_SIZE;
+    this->cells = (cell*) Memory::AllocAligned(cap * sizeof(cell), align);
+    for (uint32_t i = 0; i < cap; i++) {
+        new(&this->cells[i].sequence) std::atomic<uint32_t>(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::~MPMCQueue() {
+    // destroy remaining elements
+    const uint32_t end = this->enqueuePos.load(std::memory_order_relaxed);
+    for (uint32_t pos = this->dequeuePos.load(std::memory_order_relaxed); pos != end; pos++) {
+        this->cells[pos & this->mask].elm()->~TYPE();
+    }
+    Memory::FreeAligned(this->cells);
+    this->cells = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Size() const {
+    const uint32_t d = this->dequeuePos.load(std::memory_order_acquire);
+    const uint32_t e = this->enqueuePos.load(std::memory_order_acquire);
+    const int size = int(e - d);
+    return size < 0 ? 0 : size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+template<class T> bool
+MPMCQueue<TYPE>::enqueue(T&& elm) {
+    cell* c;
+    uint32_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        c = &this->cells[pos & this->mask];
+        const uint32_t seq = c->sequence.load(std::memory_order_acquire);
+        const int32_t diff = int32_t(seq - pos);
+        if (0 == diff) {
+            // slot is free, try to claim it
+            if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // queue is full
+            return false;
+        }
+        else {
+            // another producer was faster
+            pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    new(c->elm()) TYPE(std::forward<T>(elm));
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    return this->enqueue(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    return this->enqueue(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    cell* c;
+    uint32_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        c = &this->cells[pos & this->mask];
+        const uint32_t seq = c->sequence.load(std::memory_order_acquire);
+        const int32_t diff = int32_t(seq - (pos + 1));
+        if (0 == diff) {
+            // slot is filled, try to claim it
+            if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // queue is empty
+            return false;
+        }
+        else {
+            // another consumer was faster
+            pos = this->dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    TYPE* elm = c->elm();
+    outElm = std::move(*elm);
+    elm->~TYPE();
+    c->sequence.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Oryol
@@ -412,7 +412,7 @@ Map<KEY, VALUE>::AddBulk(KeyValuePair<KEY, VALUE>&& kvp) {
 //------------------------------------------------------------------------------
 template<class KEY, class VALUE> void
 Map<KEY, VALUE>::AddBulk(const KEY& key, const VALUE& value) {
-    this->Insert(KeyValuePair<KEY, VALUE>(key, value));
+    this->AddBulk(KeyValuePair<KEY, VALUE>(key, value));
 }
 
 //------------------------------------------------------------------------------
@@ -4,6 +4,9 @@
     @class Oryol::Queue
     @ingroup Core
     @brief a FIFO queue
+
+    The queue storage is aligned to alignof(TYPE), or to the
+    alignment set with SetAlignment().
 */
 #include "Core/Config.h"
 #include "Core/Containers/elementBuffer.h"
@@ -33,6 +36,10 @@ public:
     int GetMinGrow() const;
     /// get max-grow value
     int GetMaxGrow() const;
+    /// set buffer alignment in bytes (power of 2, queue must not have storage yet)
+    void SetAlignment(int alignment);
+    /// get buffer alignment in bytes (default is alignof(TYPE))
+    int GetAlignment() const;
     /// get number of elements in array
     int Size() const;
     /// return true if empty
@@ -144,7 +151,7 @@ Queue<TYPE>::moveToFront() {
     const int num = this->buffer.size();
     if (num > 0) {
         o_assert_dbg(this->buffer.buf);
-        const TYPE* from = this->buffer._begin();
+        TYPE* from = this->buffer._begin();
         TYPE* to = this->buffer.buf;
         for (int i = 0; i < num; i++) {
             new(to) TYPE(std::move(*from));
@@ -222,6 +229,21 @@ Queue<TYPE>::GetMaxGrow() const {
     return this->maxGrow;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Queue<TYPE>::SetAlignment(int alignment) {
+    o_assert_dbg(nullptr == this->buffer.buf);
+    o_assert_dbg(0 == (alignment & (alignment - 1)));
+    o_assert_dbg(alignment >= int(alignof(TYPE)));
+    this->buffer.alignment = alignment;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+Queue<TYPE>::GetAlignment() const {
+    return this->buffer.alignment;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> int
 Queue<TYPE>::Size() const {
@@ -0,0 +1,174 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SPSCQueue
+    @ingroup Core
+    @brief lock-free bounded single-producer/single-consumer queue
+
+    A fixed-capacity ring buffer for handing elements from exactly one
+    producer thread to exactly one consumer thread without locking.
+    The capacity is rounded up to the next power of 2.
+
+    Enqueue() returns false if the queue is full, Dequeue() returns
+    false if the queue is empty. The producer and consumer indices
+    live in separate cache lines, and each side keeps a cached copy
+    of the other side's index, so that the shared indices are only
+    read when the queue looks full or empty.
+
+    Wrap the queue in a BlockingQueue if the consumer needs to wait
+    for new elements.
+
+    @see MPMCQueue, BlockingQueue, Queue
+*/
+#include <atomic>
+#include <new>
+#include <utility>
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+
+template<class TYPE> class SPSCQueue {
+public:
+    /// constructor with capacity (rounded up to power of 2)
+    SPSCQueue(int capacity);
+    /// destructor
+    ~SPSCQueue();
+
+    /// no copying
+    SPSCQueue(const SPSCQueue& rhs) = delete;
+    /// no copy-assignment
+    void operator=(const SPSCQueue& rhs) = delete;
+
+    /// get capacity of queue
+    int Capacity() const;
+    /// get number of elements in queue (approximate if called from other threads)
+    int Size() const;
+    /// return true if queue is empty (approximate if called from other threads)
+    bool Empty() const;
+
+    /// copy-enqueue an element (producer thread only), return false if full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element (producer thread only), return false if full
+    bool Enqueue(TYPE&& elm);
+    /// dequeue an element (consumer thread only), return false if empty
+    bool Dequeue(TYPE& outElm);
+
+private:
+    /// construct-enqueue an element
+    template<class T> bool enqueue(T&& elm);
+
+    static const int padSize = ORYOL_CACHELINE_SIZE;
+
+    // read-only after construction
+    TYPE* slots;
+    uint32_t mask;
+    char pad0[padSize];
+    // written by producer
+    std::atomic<uint32_t> tail;
+    uint32_t cachedHead;
+    char pad1[padSize];
+    // written by consumer
+    std::atomic<uint32_t> head;
+    uint32_t cachedTail;
+    char pad2[padSize];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::SPSCQueue(int capacity) :
+tail(0),
+cachedHead(0),
+head(0),
+cachedTail(0) {
+    o_assert_dbg(capacity > 0);
+    uint32_t cap = 1;
+    while (cap < uint32_t(capacity)) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    const int align = alignof(TYPE) > ORYOL_CACHELINE_SIZE ? int(alignof(TYPE)) : ORYOL_CACHELINE_SIZE;
+    this->slots = (TYPE*) Memory::AllocAligned(cap * sizeof(TYPE), align);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::~SPSCQueue() {
+    // destroy remaining elements
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    for (uint32_t h = this->head.load(std::memory_order_relaxed); h != t; h++) {
+        this->slots[h & this->mask].~TYPE();
+    }
+    Memory::FreeAligned(this->slots);
+    this->slots = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Size() const {
+    const uint32_t h = this->head.load(std::memory_order_acquire);
+    const uint32_t t = this->tail.load(std::memory_order_acquire);
+    return int(t - h);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+template<class T> bool
+SPSCQueue<TYPE>::enqueue(T&& elm) {
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    if ((t - this->cachedHead) > this->mask) {
+        // looks full, refresh the consumer's index
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        if ((t - this->cachedHead) > this->mask) {
+            return false;
+        }
+    }
+    new(&this->slots[t & this->mask]) TYPE(std::forward<T>(elm));
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    return this->enqueue(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    return this->enqueue(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    const uint32_t h = this->head.load(std::memory_order_relaxed);
+    if (h == this->cachedTail) {
+        // looks empty, refresh the producer's index
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        if (h == this->cachedTail) {
+            return false;
+        }
+    }
+    TYPE* slot = &this->slots[h & this->mask];
+    outElm = std::move(*slot);
+    slot->~TYPE();
+    this->head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Oryol
@@ -18,12 +18,25 @@
     
     '----' - empty memory slot (guaranteed to be destructed)
     'XXXX' - valid element (guaranteed to be constructed)
+
+    If useFrameAllocator is set, the buffer memory comes from the
+    thread's FrameAllocator instead of Memory::Alloc(). The flag
+    is transferred on move (the moved-from buffer falls back to the
+    heap), but not on copy. If the buffer is the most recent frame
+    allocation, it grows in place instead of being copied.
+
+    The buffer start is aligned to 'alignment' bytes, which is 
+    alignof(TYPE) by default and can be raised for SIMD data, 
+    alignments above ORYOL_MAX_PLATFORM_ALIGN are allocated with
+    Memory::AllocAligned(). The alignment is transferred on copy
+    and move.
 */
 #include <new>
 #include <utility>
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/FrameAllocator.h"
 
 //------------------------------------------------------------------------------
 namespace Oryol {
@@ -71,6 +84,10 @@ public:
     
     /// allocate, grow or shrink the elementBuffer
     void alloc(int capacity, int frontSpare);
+    /// allocate raw buffer memory
+    TYPE* allocBuffer(int capacity);
+    /// free raw buffer memory
+    void freeBuffer(TYPE* ptr);
     /// destroy all
     void destroy();
     /// destroy element at pointer
@@ -141,6 +158,8 @@ public:
     int cap;            // buffer capacity (num elements)
     int start;          // index of first valid element in buffer
     int end;            // index of one-past-last valid element in buffer
+    bool useFrameAllocator; // allocate from thread's FrameAllocator
+    int alignment;      // alignment of buffer start in bytes
 };
 
 //------------------------------------------------------------------------------
@@ -149,7 +168,9 @@ elementBuffer<TYPE>::elementBuffer() :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+useFrameAllocator(false),
+alignment(alignof(TYPE))
 {
     // empty
 }
@@ -160,7 +181,9 @@ elementBuffer<TYPE>::elementBuffer(const elementBuffer& rhs) :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+useFrameAllocator(false),
+alignment(rhs.alignment)
 {
     if (rhs.buf) {
         this->alloc(rhs.size(), 0);
@@ -175,12 +198,15 @@ elementBuffer<TYPE>::elementBuffer(elementBuffer&& rhs) :
 buf(rhs.buf),
 cap(rhs.cap),
 start(rhs.start),
-end(rhs.end)
+end(rhs.end),
+useFrameAllocator(rhs.useFrameAllocator),
+alignment(rhs.alignment)
 {
     rhs.buf = nullptr;
     rhs.cap = 0;
     rhs.start = InvalidIndex;
     rhs.end = InvalidIndex;
+    rhs.useFrameAllocator = false;
 }
 
 //------------------------------------------------------------------------------
@@ -194,6 +220,7 @@ template<class TYPE> void
 elementBuffer<TYPE>::operator=(const elementBuffer<TYPE>& rhs) {
     if (&rhs != this) {
         this->destroy();
+        this->alignment = rhs.alignment;
         const int newSize = rhs.size();
         if (newSize > 0)
         {
@@ -213,10 +240,13 @@ elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
         this->cap   = rhs.cap;
         this->start = rhs.start;
         this->end   = rhs.end;
+        this->useFrameAllocator = rhs.useFrameAllocator;
+        this->alignment = rhs.alignment;
         rhs.buf   = nullptr;
         rhs.cap   = 0;
         rhs.start = 0;
         rhs.end   = 0;
+        rhs.useFrameAllocator = false;
     }
 }
 
@@ -304,9 +334,16 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     const int curSize = this->size();
     o_assert_dbg((newStart + curSize) <= newCapacity);
 
+    // frame memory can grow in place if it is the most recent frame allocation
+    if (this->useFrameAllocator && this->buf && (newCapacity > this->cap) &&
+        (newStart == this->start) && (this->alignment <= ORYOL_MAX_PLATFORM_ALIGN) &&
+        FrameAllocator::Grow(this->buf, newCapacity * sizeof(TYPE))) {
+        this->cap = newCapacity;
+        return;
+    }
+
     // allocate new buffer
-    const int newBufSize = newCapacity * sizeof(TYPE);
-    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize);
+    TYPE* newBuffer = this->allocBuffer(newCapacity);
     TYPE* newElmStart = newBuffer + newStart;
     
     // need to move any elements?
@@ -324,7 +361,7 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     
     // need to free old buffer?
     if (nullptr != this->buf) {
-        Memory::Free(this->buf);
+        this->freeBuffer(this->buf);
     }
     
     // replace pointers
@@ -334,6 +371,39 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
     this->end   = newStart + curSize;
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+elementBuffer<TYPE>::allocBuffer(int capacity) {
+    const int bufSize = capacity * sizeof(TYPE);
+    if (this->useFrameAllocator) {
+        if (this->alignment > ORYOL_MAX_PLATFORM_ALIGN) {
+            // frame memory is never freed individually, just over-allocate
+            return (TYPE*) Memory::AlignTo(FrameAllocator::Alloc(bufSize + this->alignment), this->alignment);
+        }
+        return (TYPE*) FrameAllocator::Alloc(bufSize);
+    }
+    else if (this->alignment > ORYOL_MAX_PLATFORM_ALIGN) {
+        return (TYPE*) Memory::AllocAligned(bufSize, this->alignment);
+    }
+    else {
+        return (TYPE*) Memory::Alloc(bufSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::freeBuffer(TYPE* ptr) {
+    if (this->useFrameAllocator) {
+        FrameAllocator::Free(ptr);
+    }
+    else if (this->alignment > ORYOL_MAX_PLATFORM_ALIGN) {
+        Memory::FreeAligned(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 elementBuffer<TYPE>::destroy() {
@@ -342,7 +412,7 @@ elementBuffer<TYPE>::destroy() {
         for (int i = this->start; i < this->end; i++) {
             this->buf[i].~TYPE();
         }
-        Memory::Free(this->buf);
+        this->freeBuffer(this->buf);
     }
     this->buf = nullptr;
     this->cap = 0;
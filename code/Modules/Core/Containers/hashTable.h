@@ -0,0 +1,399 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    @class Oryol::_priv::hashTable
+    @ingroup _priv
+
+    Open-addressing hash table with Robin Hood probing, used as base
+    for HashMap and HashSet. The elements live in a single, contiguous
+    array of slots (the capacity is always a power of 2), next to a
+    separate array of 32-bit hashes which is scanned during lookup, so
+    that most probes don't need to touch the elements:
+
+    - on insertion, an element which is closer to its home slot
+      is displaced by an element which is further away, this keeps
+      probe sequences short even at high load factors
+    - erase uses backward-shift deletion, so there are no 'tombstones'
+      and lookup performance doesn't degrade after many erases
+    - the table grows (and rehashes) when it would be more than 7/8 full
+
+    KEYOF is a function object which returns the key of an element,
+    HASHER returns a hash value for a key, the hash value is scrambled
+    internally, so a simple identity hash is fine.
+*/
+#include <new>
+#include <utility>
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE, class KEY, class KEYOF, class HASHER> class hashTable {
+public:
+    /// default constructor
+    hashTable();
+    /// copy constructor
+    hashTable(const hashTable& rhs);
+    /// move constructor
+    hashTable(hashTable&& rhs);
+    /// destructor
+    ~hashTable();
+
+    /// copy-assignment operator
+    void operator=(const hashTable& rhs);
+    /// move-assignment operator
+    void operator=(hashTable&& rhs);
+
+    /// compute scrambled, non-zero hash value of a key
+    static uint32_t hashOf(const KEY& key);
+    /// find slot index of key, or InvalidIndex
+    int findSlot(const KEY& key) const;
+    /// insert a new element (key must not exist, grows table), return slot index
+    int add(TYPE&& elm);
+    /// erase element at slot index
+    void eraseSlot(int slotIndex);
+    /// make room for at least numElements more elements without rehashing
+    void reserve(int numElements);
+    /// destroy elements, keep capacity
+    void clear();
+    /// destroy elements and free memory
+    void destroy();
+    /// get next used slot index starting at slotIndex, or capacity
+    int nextUsed(int slotIndex) const;
+
+    uint32_t* hashes;   // 0 means 'empty slot'
+    TYPE* slots;        // elements, only valid where hash != 0
+    int capacity;
+    int size;
+
+private:
+    /// get probe distance of a hash value at a slot index
+    int probeDistance(uint32_t hash, int slotIndex) const;
+    /// insert a new element (key must not exist, capacity must be ok), return slot index
+    int insert(uint32_t hash, TYPE&& elm);
+    /// allocate new slots and rehash existing elements
+    void rehash(int newCapacity);
+    /// allocate slot memory
+    void alloc(int newCapacity);
+    /// copy from other table
+    void copy(const hashTable& rhs);
+    /// move from other table
+    void move(hashTable&& rhs);
+
+    static const int MinCapacity = 16;
+    static const bool overAligned = alignof(TYPE) > ORYOL_MAX_PLATFORM_ALIGN;
+};
+
+//------------------------------------------------------------------------------
+/// forward iterator over the used slots of a hashTable (undefined order)
+template<class TYPE, class TABLE> class hashTableIterator {
+public:
+    /// constructor
+    hashTableIterator(TABLE* table_, int slotIndex_) : table(table_), slotIndex(table_->nextUsed(slotIndex_)) { };
+    /// dereference
+    TYPE& operator*() const { return this->table->slots[this->slotIndex]; };
+    /// member access
+    TYPE* operator->() const { return &this->table->slots[this->slotIndex]; };
+    /// advance to next element
+    hashTableIterator& operator++() { this->slotIndex = this->table->nextUsed(this->slotIndex + 1); return *this; };
+    /// test equality
+    bool operator==(const hashTableIterator& rhs) const { return this->slotIndex == rhs.slotIndex; };
+    /// test inequality
+    bool operator!=(const hashTableIterator& rhs) const { return this->slotIndex != rhs.slotIndex; };
+private:
+    TABLE* table;
+    int slotIndex;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashTable() :
+hashes(nullptr),
+slots(nullptr),
+capacity(0),
+size(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashTable(const hashTable& rhs) :
+hashes(nullptr),
+slots(nullptr),
+capacity(0),
+size(0) {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashTable(hashTable&& rhs) :
+hashes(nullptr),
+slots(nullptr),
+capacity(0),
+size(0) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::~hashTable() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::operator=(const hashTable& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::operator=(hashTable&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> uint32_t
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashOf(const KEY& key) {
+    // Fibonacci hashing, so that weak hashes (e.g. identity) still
+    // spread over the whole table, 0 is reserved for 'empty'
+    const uint64_t h = uint64_t(uint32_t(HASHER()(key))) * 0x9E3779B97F4A7C15ULL;
+    const uint32_t hash = uint32_t(h >> 32);
+    return hash ? hash : 1;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int
+hashTable<TYPE, KEY, KEYOF, HASHER>::probeDistance(uint32_t hash, int slotIndex) const {
+    return (slotIndex - int(hash & (this->capacity - 1))) & (this->capacity - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int
+hashTable<TYPE, KEY, KEYOF, HASHER>::findSlot(const KEY& key) const {
+    if (0 == this->size) {
+        return InvalidIndex;
+    }
+    const uint32_t hash = hashOf(key);
+    const int mask = this->capacity - 1;
+    int slotIndex = hash & mask;
+    for (int dist = 0; ; dist++) {
+        const uint32_t slotHash = this->hashes[slotIndex];
+        if ((0 == slotHash) || (this->probeDistance(slotHash, slotIndex) < dist)) {
+            // an element with our key would have displaced this one
+            return InvalidIndex;
+        }
+        if ((slotHash == hash) && (KEYOF()(this->slots[slotIndex]) == key)) {
+            return slotIndex;
+        }
+        slotIndex = (slotIndex + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int
+hashTable<TYPE, KEY, KEYOF, HASHER>::add(TYPE&& elm) {
+    o_assert_dbg(InvalidIndex == this->findSlot(KEYOF()(elm)));
+    // keep load factor below 7/8
+    if ((this->size + 1) > (this->capacity - (this->capacity >> 3))) {
+        this->rehash(this->capacity > 0 ? this->capacity << 1 : MinCapacity);
+    }
+    const uint32_t hash = hashOf(KEYOF()(elm));
+    return this->insert(hash, std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int
+hashTable<TYPE, KEY, KEYOF, HASHER>::insert(uint32_t hash, TYPE&& elm) {
+    o_assert_dbg(this->size < this->capacity);
+    const int mask = this->capacity - 1;
+    int slotIndex = hash & mask;
+    int dist = 0;
+    int result = InvalidIndex;
+    for (;;) {
+        const uint32_t slotHash = this->hashes[slotIndex];
+        if (0 == slotHash) {
+            new(&this->slots[slotIndex]) TYPE(std::move(elm));
+            this->hashes[slotIndex] = hash;
+            this->size++;
+            return (InvalidIndex == result) ? slotIndex : result;
+        }
+        const int slotDist = this->probeDistance(slotHash, slotIndex);
+        if (slotDist < dist) {
+            // Robin Hood: take the slot from the 'richer' element and
+            // continue inserting the displaced element
+            std::swap(this->slots[slotIndex], elm);
+            this->hashes[slotIndex] = hash;
+            hash = slotHash;
+            dist = slotDist;
+            if (InvalidIndex == result) {
+                result = slotIndex;
+            }
+        }
+        slotIndex = (slotIndex + 1) & mask;
+        dist++;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::eraseSlot(int slotIndex) {
+    o_assert_range_dbg(slotIndex, this->capacity);
+    o_assert_dbg(0 != this->hashes[slotIndex]);
+    this->slots[slotIndex].~TYPE();
+
+    // backward-shift following elements which are not in their home slot
+    const int mask = this->capacity - 1;
+    int nextIndex = (slotIndex + 1) & mask;
+    while ((0 != this->hashes[nextIndex]) && (this->probeDistance(this->hashes[nextIndex], nextIndex) > 0)) {
+        new(&this->slots[slotIndex]) TYPE(std::move(this->slots[nextIndex]));
+        this->slots[nextIndex].~TYPE();
+        this->hashes[slotIndex] = this->hashes[nextIndex];
+        slotIndex = nextIndex;
+        nextIndex = (nextIndex + 1) & mask;
+    }
+    this->hashes[slotIndex] = 0;
+    this->size--;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::reserve(int numElements) {
+    o_assert_dbg(numElements >= 0);
+    // keep load factor below 7/8
+    const int minCapacity = this->size + numElements + ((this->size + numElements) >> 3) + 1;
+    int newCapacity = this->capacity > 0 ? this->capacity : MinCapacity;
+    while (newCapacity < minCapacity) {
+        newCapacity <<= 1;
+    }
+    if (newCapacity != this->capacity) {
+        this->rehash(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::clear() {
+    for (int i = 0; i < this->capacity; i++) {
+        if (0 != this->hashes[i]) {
+            this->slots[i].~TYPE();
+            this->hashes[i] = 0;
+        }
+    }
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int
+hashTable<TYPE, KEY, KEYOF, HASHER>::nextUsed(int slotIndex) const {
+    while ((slotIndex < this->capacity) && (0 == this->hashes[slotIndex])) {
+        slotIndex++;
+    }
+    return slotIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::rehash(int newCapacity) {
+    o_assert_dbg((newCapacity & (newCapacity - 1)) == 0);
+    o_assert_dbg(newCapacity > this->size);
+    uint32_t* oldHashes = this->hashes;
+    TYPE* oldSlots = this->slots;
+    const int oldCapacity = this->capacity;
+
+    this->alloc(newCapacity);
+    this->size = 0;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (0 != oldHashes[i]) {
+            this->insert(oldHashes[i], std::move(oldSlots[i]));
+            oldSlots[i].~TYPE();
+        }
+    }
+    if (oldHashes) {
+        if (overAligned) {
+            Memory::FreeAligned(oldHashes);
+        }
+        else {
+            Memory::Free(oldHashes);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::alloc(int newCapacity) {
+    // hashes and slots live in the same memory block
+    const int align = overAligned ? int(alignof(TYPE)) : ORYOL_MAX_PLATFORM_ALIGN;
+    const int hashesSize = Memory::RoundUp(newCapacity * int(sizeof(uint32_t)), align);
+    const int slotsSize = newCapacity * int(sizeof(TYPE));
+    uint8_t* ptr;
+    if (overAligned) {
+        ptr = (uint8_t*) Memory::AllocAligned(hashesSize + slotsSize, align);
+    }
+    else {
+        ptr = (uint8_t*) Memory::Alloc(hashesSize + slotsSize);
+    }
+    this->hashes = (uint32_t*) ptr;
+    this->slots = (TYPE*) (ptr + hashesSize);
+    this->capacity = newCapacity;
+    Memory::Clear(this->hashes, newCapacity * int(sizeof(uint32_t)));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::destroy() {
+    if (this->hashes) {
+        this->clear();
+        if (overAligned) {
+            Memory::FreeAligned(this->hashes);
+        }
+        else {
+            Memory::Free(this->hashes);
+        }
+    }
+    this->hashes = nullptr;
+    this->slots = nullptr;
+    this->capacity = 0;
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::copy(const hashTable& rhs) {
+    o_assert_dbg(nullptr == this->hashes);
+    if (rhs.capacity > 0) {
+        this->alloc(rhs.capacity);
+        for (int i = 0; i < rhs.capacity; i++) {
+            if (0 != rhs.hashes[i]) {
+                new(&this->slots[i]) TYPE(rhs.slots[i]);
+                this->hashes[i] = rhs.hashes[i];
+            }
+        }
+        this->size = rhs.size;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::move(hashTable&& rhs) {
+    this->hashes = rhs.hashes;
+    this->slots = rhs.slots;
+    this->capacity = rhs.capacity;
+    this->size = rhs.size;
+    rhs.hashes = nullptr;
+    rhs.slots = nullptr;
+    rhs.capacity = 0;
+    rhs.size = 0;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -5,6 +5,14 @@
 #include "Core.h"
 #include "Core/RunLoop.h"
 #include "Core/Ptr.h"
+#include "Core/Log.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Memory/poolAllocator.h"
+#include "Core/String/stringAtomTable.h"
+#if ORYOL_SMALL_OBJECT_ALLOCATOR
+#include "Core/Memory/smallObjectAllocator.h"
+#endif
 
 namespace Oryol {
     
@@ -22,6 +30,10 @@ Core::Setup() {
     state->mainThreadId = std::this_thread::get_id();
     threadPreRunLoop = Memory::New<RunLoop>();
     threadPostRunLoop = Memory::New<RunLoop>();
+    setupFrameAllocator();
+    #if ORYOL_MEMORY_TRACKING
+    threadPostRunLoop->Add(&MemoryTracker::NewFrame, RunLoop::Late);
+    #endif
 }
 
 //------------------------------------------------------------------------------
@@ -32,13 +44,11 @@ Core::Discard() {
     o_assert(threadPostRunLoop);
     Memory::Delete<RunLoop>(threadPreRunLoop);
     Memory::Delete<RunLoop>(threadPostRunLoop);
+    FrameAllocator::Discard();
     Memory::Delete(state);
     threadPreRunLoop = nullptr;
     threadPostRunLoop = nullptr;
     state = nullptr;
-
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data!!!    
 }
 
 //------------------------------------------------------------------------------
@@ -80,6 +90,7 @@ Core::EnterThread() {
     o_assert(nullptr == threadPostRunLoop);
     threadPreRunLoop = Memory::New<RunLoop>();
     threadPostRunLoop = Memory::New<RunLoop>();
+    setupFrameAllocator();
     #endif
 }
 
@@ -91,12 +102,29 @@ Core::LeaveThread() {
     o_assert(threadPostRunLoop);
     Memory::Delete<RunLoop>(threadPreRunLoop);
     Memory::Delete<RunLoop>(threadPostRunLoop);
+    FrameAllocator::Discard();
+    _priv::poolThreadSlot::Release();
+    #if ORYOL_SMALL_OBJECT_ALLOCATOR
+    _priv::smallObjectAllocator::FlushThreadCache();
+    #endif
     threadPreRunLoop = nullptr;
     threadPostRunLoop = nullptr;
 
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data
+    Log::LeaveThread();
+
+    // the thread's StringAtom lookup cache can go away, the
+    // string data itself lives in the global table
+    stringAtomCache::discardThreadLocal();
     #endif
 }
 
+//------------------------------------------------------------------------------
+void
+Core::setupFrameAllocator() {
+    // setup the thread's frame allocator, and reset it once per frame
+    // from the post-frame runloop
+    FrameAllocator::Setup();
+    threadPostRunLoop->Add(&FrameAllocator::Reset);
+}
+
 } // namespace Oryol
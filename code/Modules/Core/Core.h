@@ -33,12 +33,15 @@ public:
 
     /// called when a thread is entered
     static void EnterThread();
-    /// called before a thread is left
+    /// called before a thread is left (must be called by threads which used pool-allocated objects)
     static void LeaveThread();
     /// test if we are on the main thread
     static bool IsMainThread();
 
 private:
+    /// setup the calling thread's frame allocator
+    static void setupFrameAllocator();
+
     static ORYOL_THREADLOCAL_PTR(RunLoop) threadPreRunLoop;
     static ORYOL_THREADLOCAL_PTR(RunLoop) threadPostRunLoop;
     struct _state {
@@ -0,0 +1,166 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Delegate
+    @ingroup Core
+    @brief non-allocating function wrapper with inline storage
+
+    A Delegate works like std::function, but stores the callable object
+    in a fixed-size inline buffer and never allocates memory. Function
+    pointers and lambdas with small captures (for instance [this]) fit
+    into the default buffer, a callable which is too big is rejected
+    at compile time:
+
+    ```cpp
+    Delegate<void()> d0 = &myFunc;
+    Delegate<void()> d1 = [this]() { this->update(); };
+    Delegate<int(int)> d2 = [](int x) { return x * 2; };
+    ```
+
+    @see RunLoop
+*/
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+
+template<class SIGNATURE, int SIZE = 4 * sizeof(void*)> class Delegate;
+
+template<class RET, class... ARGS, int SIZE> class Delegate<RET(ARGS...), SIZE> {
+public:
+    /// size of the inline storage in bytes
+    static const int BufferSize = SIZE;
+
+    /// default constructor (empty delegate)
+    Delegate() { };
+    /// construct empty delegate from nullptr
+    Delegate(std::nullptr_t) { };
+    /// construct from callable object
+    template<class FUNC, class = typename std::enable_if<!std::is_same<typename std::decay<FUNC>::type, Delegate>::value>::type>
+    Delegate(FUNC&& func) {
+        this->set(std::forward<FUNC>(func));
+    };
+    /// copy constructor
+    Delegate(const Delegate& rhs) {
+        this->copy(rhs);
+    };
+    /// move constructor
+    Delegate(Delegate&& rhs) {
+        this->move(std::move(rhs));
+    };
+    /// destructor
+    ~Delegate() {
+        this->reset();
+    };
+
+    /// copy-assignment
+    void operator=(const Delegate& rhs) {
+        if (&rhs != this) {
+            this->reset();
+            this->copy(rhs);
+        }
+    };
+    /// move-assignment
+    void operator=(Delegate&& rhs) {
+        if (&rhs != this) {
+            this->reset();
+            this->move(std::move(rhs));
+        }
+    };
+    /// assign nullptr (clears the delegate)
+    void operator=(std::nullptr_t) {
+        this->reset();
+    };
+
+    /// test if delegate contains a callable
+    explicit operator bool() const {
+        return nullptr != this->invokeFunc;
+    };
+    /// call the delegate (must not be empty)
+    RET operator()(ARGS... args) const {
+        o_assert_dbg(this->invokeFunc);
+        return this->invokeFunc(const_cast<void*>((const void*)this->buf), std::forward<ARGS>(args)...);
+    };
+
+private:
+    enum op {
+        opCopy,
+        opMove,
+        opDestroy,
+    };
+    typedef RET (*invokeFuncType)(void* obj, ARGS... args);
+    typedef void (*manageFuncType)(op o, void* dst, void* src);
+
+    /// invoke the stored callable
+    template<class FUNC> static RET invoke(void* obj, ARGS... args) {
+        return (*(FUNC*)obj)(std::forward<ARGS>(args)...);
+    };
+    /// copy, move or destroy the stored callable
+    template<class FUNC> static void manage(op o, void* dst, void* src) {
+        switch (o) {
+            case opCopy:    new(dst) FUNC(*(const FUNC*)src); break;
+            case opMove:    new(dst) FUNC(std::move(*(FUNC*)src)); ((FUNC*)src)->~FUNC(); break;
+            case opDestroy: ((FUNC*)dst)->~FUNC(); break;
+        }
+    };
+    /// store a callable
+    template<class FUNC> void set(FUNC&& func) {
+        typedef typename std::decay<FUNC>::type funcType;
+        static_assert(sizeof(funcType) <= SIZE, "Delegate: callable object too big for inline storage!");
+        static_assert(alignof(funcType) <= alignof(std::max_align_t), "Delegate: callable object alignment too big!");
+        new(this->buf) funcType(std::forward<FUNC>(func));
+        this->invokeFunc = &invoke<funcType>;
+        // NOTE: trivially copyable callables (function pointers, lambdas
+        // capturing pointers or values) are copied with memcpy
+        this->manageFunc = std::is_trivially_copyable<funcType>::value ? nullptr : &manage<funcType>;
+    };
+    /// copy from other delegate (this must be empty)
+    void copy(const Delegate& rhs) {
+        if (rhs.invokeFunc) {
+            if (rhs.manageFunc) {
+                rhs.manageFunc(opCopy, this->buf, const_cast<void*>((const void*)rhs.buf));
+            }
+            else {
+                std::memcpy(this->buf, rhs.buf, SIZE);
+            }
+            this->invokeFunc = rhs.invokeFunc;
+            this->manageFunc = rhs.manageFunc;
+        }
+    };
+    /// move from other delegate (this must be empty)
+    void move(Delegate&& rhs) {
+        if (rhs.invokeFunc) {
+            if (rhs.manageFunc) {
+                rhs.manageFunc(opMove, this->buf, rhs.buf);
+            }
+            else {
+                std::memcpy(this->buf, rhs.buf, SIZE);
+            }
+            this->invokeFunc = rhs.invokeFunc;
+            this->manageFunc = rhs.manageFunc;
+            rhs.invokeFunc = nullptr;
+            rhs.manageFunc = nullptr;
+        }
+    };
+    /// destroy the stored callable
+    void reset() {
+        if (this->invokeFunc) {
+            if (this->manageFunc) {
+                this->manageFunc(opDestroy, this->buf, nullptr);
+            }
+            this->invokeFunc = nullptr;
+            this->manageFunc = nullptr;
+        }
+    };
+
+    invokeFuncType invokeFunc = nullptr;
+    manageFuncType manageFunc = nullptr;
+    alignas(std::max_align_t) uint8_t buf[SIZE];
+};
+
+} // namespace Oryol
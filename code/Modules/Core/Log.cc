@@ -8,7 +8,18 @@
 #include "Core/Logger.h"
 #include "Core/StackTrace.h"
 #include "Core/Threading/RWLock.h"
+#include "Core/Threading/ThreadLocalPtr.h"
 #include "Core/Containers/Array.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Time/Clock.h"
+#include "Core/Trace.h"
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
 #if ORYOL_WINDOWS
 #include <Windows.h>
 #endif
@@ -29,6 +40,109 @@ Log::Level curLogLevel = Log::Level::Dbg;
 RWLock lock;
 Array<Ptr<Logger>> loggers;
 
+namespace {
+
+// a preformatted message in a per-thread ring buffer
+struct asyncEntry {
+    Log::Level level;
+    TimePoint time;
+    char msg[Log::MaxAsyncMessageSize];
+};
+
+// the per-thread ring buffer, buffers are linked into a global list,
+// only the producer thread enqueues, only the drain thread dequeues
+struct asyncBuffer {
+    asyncBuffer() : queue(Log::AsyncQueueSize) { };
+    SPSCQueue<asyncEntry> queue;
+    int threadId = 0;
+    std::atomic<bool> orphaned{false};
+    asyncBuffer* next = nullptr;
+};
+
+std::atomic<bool> asyncActive{false};
+std::atomic<asyncBuffer*> asyncBuffers{nullptr};
+std::atomic<int> asyncNumDropped{0};
+std::atomic<int> asyncNextThreadId{1};
+ORYOL_THREADLOCAL_PTR(asyncBuffer) threadAsyncBuffer = nullptr;
+#if ORYOL_HAS_THREADS
+const int asyncWakeupMs = 5;
+std::mutex drainMutex;
+std::mutex asyncMutex;
+std::condition_variable asyncCondVar;
+bool asyncStopRequested = false;
+std::thread asyncThread;
+#endif
+
+//------------------------------------------------------------------------------
+asyncBuffer*
+getAsyncBuffer() {
+    asyncBuffer* buf = threadAsyncBuffer;
+    if (nullptr == buf) {
+        // create a new buffer and push it to the front of the global list
+        buf = Memory::New<asyncBuffer>();
+        buf->threadId = asyncNextThreadId++;
+        buf->next = asyncBuffers.load(std::memory_order_relaxed);
+        while (!asyncBuffers.compare_exchange_weak(buf->next, buf, std::memory_order_release, std::memory_order_relaxed)) {
+            // retry
+        }
+        threadAsyncBuffer = buf;
+    }
+    return buf;
+}
+
+} // anonymous namespace
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+/**
+    Write all pending messages of all threads and free the buffers of
+    threads which have been left. Must be called with drainMutex locked.
+*/
+void
+Log::drainAsync() {
+    asyncEntry entry;
+    Log::Record rec;
+    asyncBuffer* prev = nullptr;
+    asyncBuffer* buf = asyncBuffers.load(std::memory_order_acquire);
+    while (buf) {
+        // NOTE: check orphaned before draining, so that no message
+        // enqueued before the thread was left gets lost
+        const bool orphaned = buf->orphaned.load(std::memory_order_acquire);
+        while (buf->queue.Dequeue(entry)) {
+            rec.LogLevel = entry.level;
+            rec.Time = entry.time;
+            rec.ThreadId = buf->threadId;
+            rec.Message = entry.msg;
+            write(rec);
+        }
+        asyncBuffer* next = buf->next;
+        if (orphaned) {
+            // unlink and free the buffer, new buffers are only ever
+            // pushed to the front of the list
+            if (prev) {
+                prev->next = next;
+            }
+            else {
+                asyncBuffer* expected = buf;
+                if (!asyncBuffers.compare_exchange_strong(expected, next)) {
+                    // new buffers have been pushed in the meantime, find our predecessor
+                    prev = asyncBuffers.load(std::memory_order_acquire);
+                    while (prev->next != buf) {
+                        prev = prev->next;
+                    }
+                    prev->next = next;
+                }
+            }
+            Memory::Delete(buf);
+        }
+        else {
+            prev = buf;
+        }
+        buf = next;
+    }
+}
+#endif
+
 //------------------------------------------------------------------------------
 void
 Log::AddLogger(const Ptr<Logger>& l) {
@@ -39,6 +153,17 @@ Log::AddLogger(const Ptr<Logger>& l) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::RemoveLogger(const Ptr<Logger>& l) {
+    lock.LockWrite();
+    const int index = loggers.FindIndexLinear(l);
+    if (InvalidIndex != index) {
+        loggers.Erase(index);
+    }
+    lock.UnlockWrite();
+}
+
 //------------------------------------------------------------------------------
 int
 Log::GetNumLoggers() {
@@ -142,6 +267,32 @@ Log::VError(const char* msg, va_list args) {
 //------------------------------------------------------------------------------
 void
 Log::vprint(Level lvl, const char* msg, va_list args) {
+    if (asyncActive.load(std::memory_order_relaxed)) {
+        if (Level::Error != lvl) {
+            // async mode: format into the thread's ring buffer, drop if full
+            asyncBuffer* buf = getAsyncBuffer();
+            asyncEntry entry;
+            entry.level = lvl;
+            entry.time = Clock::Now();
+            std::vsnprintf(entry.msg, sizeof(entry.msg), msg, args);
+            if (!buf->queue.Enqueue(entry)) {
+                asyncNumDropped++;
+            }
+            // if async mode was stopped while enqueueing, StopAsync()'s final
+            // flush may have missed the message, so write it out ourselves
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!asyncActive.load(std::memory_order_relaxed)) {
+                Flush();
+            }
+            return;
+        }
+        else {
+            // errors are usually followed by a program abort, write
+            // all pending messages, and the error itself synchronously
+            Flush();
+        }
+    }
+
     lock.LockRead();
     if (loggers.Empty()) {
         #if ORYOL_ANDROID
@@ -182,9 +333,43 @@ Log::vprint(Level lvl, const char* msg, va_list args) {
     lock.UnlockRead();
 }
 
+//------------------------------------------------------------------------------
+void
+Log::write(const Record& rec) {
+    lock.LockRead();
+    if (loggers.Empty()) {
+        #if ORYOL_ANDROID
+            android_LogPriority pri = ANDROID_LOG_DEFAULT;
+            switch (rec.LogLevel) {
+                case Level::Error: pri = ANDROID_LOG_ERROR; break;
+                case Level::Warn:  pri = ANDROID_LOG_WARN; break;
+                case Level::Info:  pri = ANDROID_LOG_INFO; break;
+                case Level::Dbg:   pri = ANDROID_LOG_DEBUG; break;
+                default:           pri = ANDROID_LOG_DEFAULT; break;
+            }
+            __android_log_write(pri, "oryol", rec.Message);
+        #else
+            std::fputs(rec.Message, stdout);
+            #if ORYOL_WINDOWS
+                OutputDebugStringA(rec.Message);
+            #endif
+        #endif
+    }
+    else {
+        for (const auto& l : loggers) {
+            l->PrintRecord(rec);
+        }
+    }
+    lock.UnlockRead();
+}
+
 //------------------------------------------------------------------------------
 void
 Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func) {
+    // make sure that all pending async messages are written before the assert
+    if (asyncActive.load(std::memory_order_relaxed)) {
+        Flush();
+    }
     lock.LockRead();
     if (loggers.Empty()) {
         char callstack[4096];
@@ -213,4 +398,89 @@ Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, co
     lock.UnlockRead();
 } 
 
+//------------------------------------------------------------------------------
+void
+Log::StartAsync() {
+    #if ORYOL_HAS_THREADS
+    o_assert(!IsAsync());
+    asyncStopRequested = false;
+    asyncThread = std::thread(asyncThreadFunc);
+    asyncActive = true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::StopAsync() {
+    #if ORYOL_HAS_THREADS
+    o_assert(IsAsync());
+    asyncActive = false;
+    // pairs with the fence in vprint(): a producer which still saw async
+    // mode active has enqueued its message before the final Flush() below,
+    // otherwise it sees async mode stopped and flushes by itself
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lk(asyncMutex);
+        asyncStopRequested = true;
+    }
+    asyncCondVar.notify_one();
+    asyncThread.join();
+    // write messages which arrived while the thread was stopping
+    Flush();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsAsync() {
+    return asyncActive;
+}
+
+//------------------------------------------------------------------------------
+void
+Log::Flush() {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lk(drainMutex);
+    drainAsync();
+    std::fflush(stdout);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+Log::NumDropped() {
+    return asyncNumDropped;
+}
+
+//------------------------------------------------------------------------------
+void
+Log::LeaveThread() {
+    // the drain thread frees the buffer after writing its pending messages
+    asyncBuffer* buf = threadAsyncBuffer;
+    if (buf) {
+        threadAsyncBuffer = nullptr;
+        buf->orphaned.store(true, std::memory_order_release);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Log::asyncThreadFunc() {
+    #if ORYOL_HAS_THREADS
+    // wake up periodically and drain the ring buffers, producers
+    // never need to signal the logger thread
+    o_trace_thread_name("Logger");
+    std::unique_lock<std::mutex> lk(asyncMutex);
+    while (!asyncStopRequested) {
+        asyncCondVar.wait_for(lk, std::chrono::milliseconds(asyncWakeupMs));
+        lk.unlock();
+        {
+            std::lock_guard<std::mutex> drainLock(drainMutex);
+            drainAsync();
+        }
+        lk.lock();
+    }
+    #endif
+}
+
 } // namespace Oryol
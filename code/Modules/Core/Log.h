@@ -9,11 +9,21 @@
     output is logged to stdout and stderr, but custom Logger objects
     can be attached to handle log output differently.
 
+    By default, log output is written synchronously by the calling
+    thread. After Log::StartAsync(), log calls only format the message
+    into a per-thread lock-free ring buffer and return, a dedicated
+    logger thread drains the ring buffers into the Logger objects.
+    If a ring buffer is full, the message is dropped and counted
+    (see Log::NumDropped()). Errors and assert messages flush all
+    pending messages and are then written synchronously, so they
+    are never lost when the program is aborted.
+
     @see Logger
 */
 #include <cstdarg>
 #include "Core/Types.h"
 #include "Core/Config.h"
+#include "Core/Time/TimePoint.h"
 
 namespace Oryol {
 
@@ -33,9 +43,22 @@ public:
         NumLevels,
         InvalidLevel
     };
+    /// a log message with meta data
+    struct Record {
+        Level LogLevel = Level::InvalidLevel;
+        TimePoint Time;
+        int ThreadId = 0;
+        const char* Message = nullptr;
+    };
+    /// max length of a message in async mode (longer messages are truncated)
+    static const int MaxAsyncMessageSize = 480;
+    /// number of messages in a per-thread ring buffer in async mode
+    static const int AsyncQueueSize = 256;
 
     /// add a logger object
     static void AddLogger(const Ptr<Logger>& p);
+    /// remove a logger object
+    static void RemoveLogger(const Ptr<Logger>& p);
     /// get number of loggers
     static int GetNumLoggers();
     /// get logger at index
@@ -64,7 +87,26 @@ public:
     /// print an assert message
     static void AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func);
 
+    /// start asynchronous logging through a logger thread
+    static void StartAsync();
+    /// stop asynchronous logging (flushes pending messages)
+    static void StopAsync();
+    /// return true if asynchronous logging is active
+    static bool IsAsync();
+    /// write all pending asynchronous messages (blocking)
+    static void Flush();
+    /// get number of messages dropped because a ring buffer was full
+    static int NumDropped();
+    /// release the calling thread's ring buffer (called from Core::LeaveThread)
+    static void LeaveThread();
+
 private:
+    /// write a message to all loggers, or stdout if no loggers attached
+    static void write(const Record& rec);
+    /// the logger thread function
+    static void asyncThreadFunc();
+    /// write pending async messages (must be called with drain lock held)
+    static void drainAsync();
     /// generic vprint-style method
     static void vprint(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
 };
@@ -23,6 +23,21 @@ Logger::VPrint(Log::Level /*l*/, const char* /*msg*/, va_list /*args*/) {
     // we can't do an o_error() here since it would recurse
 }
 
+//------------------------------------------------------------------------------
+static void
+printToLogger(Logger* logger, Log::Level l, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    logger->VPrint(l, msg, args);
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+void
+Logger::PrintRecord(const Log::Record& rec) {
+    printToLogger(this, rec.LogLevel, "%s", rec.Message);
+}
+
 //------------------------------------------------------------------------------
 /**
  */
@@ -20,8 +20,24 @@
 #include "Core/android/android_native_app_glue.h"
 #endif
 #include "Core/App.h"
+#include "Core/Log.h"
 #include "Core/String/WideString.h"
 
+namespace Oryol {
+namespace _priv {
+/// get the frame limit from the '-frames' command line arg, ignore negative values
+inline int
+frameLimitArg(const Args& args) {
+    const int numFrames = args.GetInt("-frames", 0);
+    if (numFrames < 0) {
+        o_warn("Ignoring negative '-frames %d' command line arg, running without frame limit!\n", numFrames);
+        return 0;
+    }
+    return numFrames;
+}
+} // namespace _priv
+} // namespace Oryol
+
 #if ORYOL_WINDOWS
 #define OryolMain(clazz) \
 Oryol::Args OryolArgs; \
@@ -29,6 +45,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance, LPSTR lpCmdLine,
     Oryol::WideString cmdLine = ::GetCommandLineW(); \
     OryolArgs = Oryol::Args(cmdLine); \
     clazz* app = Memory::New<clazz>(); \
+    app->SetFrameLimit(Oryol::_priv::frameLimitArg(OryolArgs)); \
     app->StartMainLoop(); \
     Oryol::Memory::Delete<clazz>(app); \
     return 0; \
@@ -50,6 +67,7 @@ Oryol::Args OryolArgs; \
 int main(int argc, const char** argv) { \
     OryolArgs = Oryol::Args(argc, argv); \
     clazz* app = Oryol::Memory::New<clazz>(); \
+    app->SetFrameLimit(Oryol::_priv::frameLimitArg(OryolArgs)); \
     app->StartMainLoop(); \
     Oryol::Memory::Delete(app); \
     return 0; \
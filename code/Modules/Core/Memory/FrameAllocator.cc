@@ -0,0 +1,230 @@
+//------------------------------------------------------------------------------
+//  FrameAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FrameAllocator.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+
+ORYOL_THREADLOCAL_PTR(FrameAllocator::arena) FrameAllocator::threadArena = nullptr;
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::Setup(int initialSize) {
+    o_assert(nullptr == threadArena);
+    o_assert(initialSize > 0);
+    arena* a = Memory::New<arena>();
+    allocChunk(a, initialSize);
+    a->numHeapAllocs = 0;
+    threadArena = a;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::Discard() {
+    o_assert(nullptr != threadArena);
+    arena* a = threadArena;
+    freeChunks(a);
+    Memory::Delete(a);
+    threadArena = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameAllocator::IsValid() {
+    return nullptr != threadArena;
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+FrameAllocator::chunkData(chunk* c) {
+    return ((uint8_t*)c) + Memory::RoundUp(sizeof(chunk), ORYOL_MAX_PLATFORM_ALIGN);
+}
+
+//------------------------------------------------------------------------------
+FrameAllocator::chunk*
+FrameAllocator::allocChunk(arena* a, int size) {
+    size = Memory::RoundUp(size, ORYOL_MAX_PLATFORM_ALIGN);
+    const int headerSize = Memory::RoundUp(sizeof(chunk), ORYOL_MAX_PLATFORM_ALIGN);
+    chunk* c = (chunk*) Memory::Alloc(headerSize + size);
+    c->next = a->chunks;
+    c->size = size;
+    c->pos = 0;
+    a->chunks = c;
+    a->numHeapAllocs++;
+    return c;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::freeChunks(arena* a) {
+    chunk* c = a->chunks;
+    while (c) {
+        chunk* next = c->next;
+        Memory::Free(c);
+        c = next;
+    }
+    a->chunks = nullptr;
+    a->lastAlloc = nullptr;
+    a->lastAllocSize = 0;
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameAllocator::Alloc(int numBytes) {
+    o_assert_dbg(nullptr != threadArena);
+    o_assert_dbg(numBytes >= 0);
+    arena* a = threadArena;
+    const int size = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    chunk* c = a->chunks;
+    if ((c->pos + size) > c->size) {
+        // current chunk is exhausted, need to grab a new one from the heap,
+        // the chunks will be merged in the next Reset()
+        allocChunk(a, size > c->size ? size : c->size);
+        c = a->chunks;
+    }
+    void* ptr = chunkData(c) + c->pos;
+    c->pos += size;
+    a->used += size;
+    if (a->used > a->frameHighWater) {
+        a->frameHighWater = a->used;
+    }
+    a->lastAlloc = ptr;
+    a->lastAllocSize = size;
+    #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
+    #endif
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::Free(void* ptr) {
+    o_assert_dbg(nullptr != threadArena);
+    #if ORYOL_ALLOCATOR_DEBUG
+    o_assert(IsOwned(ptr));
+    #endif
+    arena* a = threadArena;
+    if (ptr && (ptr == a->lastAlloc)) {
+        // roll back the most recent allocation
+        a->chunks->pos -= a->lastAllocSize;
+        a->used -= a->lastAllocSize;
+        a->lastAlloc = nullptr;
+        a->lastAllocSize = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameAllocator::Grow(void* ptr, int numBytes) {
+    o_assert_dbg(nullptr != threadArena);
+    o_assert_dbg(numBytes >= 0);
+    arena* a = threadArena;
+    if (!ptr || (ptr != a->lastAlloc)) {
+        return false;
+    }
+    const int size = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    chunk* c = a->chunks;
+    const int newPos = c->pos - a->lastAllocSize + size;
+    if (newPos > c->size) {
+        return false;
+    }
+    a->used += size - a->lastAllocSize;
+    if (a->used > a->frameHighWater) {
+        a->frameHighWater = a->used;
+    }
+    c->pos = newPos;
+    a->lastAllocSize = size;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::Reset() {
+    o_assert_dbg(nullptr != threadArena);
+    arena* a = threadArena;
+    if (a->frameHighWater > a->highWater) {
+        a->highWater = a->frameHighWater;
+    }
+    a->lastFrameHighWater = a->frameHighWater;
+    a->frameHighWater = 0;
+    a->frameNumHeapAllocs = a->numHeapAllocs;
+    if (a->chunks->next) {
+        // the last frame needed more than one chunk, merge
+        // all chunks into one which can hold the whole frame
+        int size = 0;
+        for (chunk* c = a->chunks; c; c = c->next) {
+            size += c->size;
+        }
+        freeChunks(a);
+        allocChunk(a, size);
+    }
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill(chunkData(a->chunks), a->chunks->size, ORYOL_MEMORY_DEBUG_BYTE);
+    #endif
+    a->chunks->pos = 0;
+    a->lastAlloc = nullptr;
+    a->lastAllocSize = 0;
+    a->numHeapAllocs = 0;
+    a->used = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameAllocator::IsOwned(const void* ptr) {
+    if (nullptr == threadArena) {
+        return false;
+    }
+    const uint8_t* p = (const uint8_t*) ptr;
+    for (chunk* c = threadArena->chunks; c; c = c->next) {
+        const uint8_t* start = chunkData(c);
+        if ((p >= start) && (p < (start + c->size))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameAllocator::NumBytesUsed() {
+    o_assert_dbg(nullptr != threadArena);
+    return threadArena->used;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameAllocator::Capacity() {
+    o_assert_dbg(nullptr != threadArena);
+    int size = 0;
+    for (chunk* c = threadArena->chunks; c; c = c->next) {
+        size += c->size;
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameAllocator::FrameHighWaterMark() {
+    o_assert_dbg(nullptr != threadArena);
+    return threadArena->lastFrameHighWater;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameAllocator::HighWaterMark() {
+    o_assert_dbg(nullptr != threadArena);
+    const arena* a = threadArena;
+    return a->frameHighWater > a->highWater ? a->frameHighWater : a->highWater;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameAllocator::FrameNumHeapAllocs() {
+    o_assert_dbg(nullptr != threadArena);
+    return threadArena->frameNumHeapAllocs;
+}
+
+} // namespace Oryol
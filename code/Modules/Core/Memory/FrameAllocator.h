@@ -0,0 +1,92 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrameAllocator
+    @ingroup Core
+    @brief per-thread linear allocator for short-lived per-frame data
+
+    The FrameAllocator hands out scratch memory from a thread-local
+    linear arena by bumping a pointer, freeing memory is a no-op (except
+    for the most recent allocation, which is rolled back). The most
+    recent allocation can also be grown in place, so that a growing
+    container doesn't leave its old storage behind. The whole arena is
+    reset once per frame from the thread's post-frame runloop, so frame
+    memory is only valid until the next Core::PostRunLoop() run!
+
+    The arena starts with ORYOL_FRAMEALLOCATOR_DEFAULT_SIZE bytes. If a
+    frame needs more, additional chunks are allocated from the heap,
+    and on the next reset all chunks are merged into a single chunk
+    big enough for the frame's high-water mark, so that steady-state
+    frames don't do any general heap allocations.
+
+    Core::Setup() and Core::EnterThread() create the frame arena of the
+    calling thread, Core::Discard() and Core::LeaveThread() destroy it.
+
+    Containers can use the frame allocator for their storage
+    through Array::UseFrameAllocator() and Buffer::UseFrameAllocator().
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+
+namespace Oryol {
+
+class FrameAllocator {
+public:
+    /// setup the frame allocator for the calling thread
+    static void Setup(int initialSize=ORYOL_FRAMEALLOCATOR_DEFAULT_SIZE);
+    /// discard the frame allocator of the calling thread
+    static void Discard();
+    /// return true if the calling thread has a frame allocator
+    static bool IsValid();
+
+    /// allocate frame memory (valid until next Reset)
+    static void* Alloc(int numBytes);
+    /// free frame memory (only rolls back the most recent allocation)
+    static void Free(void* ptr);
+    /// try to grow the most recent allocation in place, return false if not possible
+    static bool Grow(void* ptr, int numBytes);
+    /// reset the allocator, invalidates all frame memory (called from PostRunLoop)
+    static void Reset();
+    /// test if a pointer is owned by the calling thread's frame allocator
+    static bool IsOwned(const void* ptr);
+
+    /// number of bytes currently allocated in the current frame
+    static int NumBytesUsed();
+    /// size of the current arena in bytes
+    static int Capacity();
+    /// max number of bytes allocated during the previous frame
+    static int FrameHighWaterMark();
+    /// max number of bytes allocated in any frame so far
+    static int HighWaterMark();
+    /// number of heap allocations the arena had to do in the previous frame
+    static int FrameNumHeapAllocs();
+
+private:
+    struct chunk {
+        chunk* next;
+        int size;
+        int pos;
+    };
+    struct arena {
+        chunk* chunks = nullptr;    // current chunk is at front
+        void* lastAlloc = nullptr;  // most recent allocation
+        int lastAllocSize = 0;
+        int used = 0;
+        int frameHighWater = 0;
+        int lastFrameHighWater = 0;
+        int highWater = 0;
+        int numHeapAllocs = 0;
+        int frameNumHeapAllocs = 0;
+    };
+    /// allocate a new chunk and push it as current chunk
+    static chunk* allocChunk(arena* a, int size);
+    /// free all chunks of an arena
+    static void freeChunks(arena* a);
+    /// get pointer to start of chunk data
+    static uint8_t* chunkData(chunk* c);
+
+    static ORYOL_THREADLOCAL_PTR(arena) threadArena;
+};
+
+} // namespace Oryol
@@ -5,16 +5,38 @@
 #include <cstdlib>
 #include <cstring>
 #include "Memory.h"
+#include "MemoryTracker.h"
+#if ORYOL_SMALL_OBJECT_ALLOCATOR
+#include "smallObjectAllocator.h"
+#endif
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
 namespace Oryol {
+
+#if ORYOL_SMALL_OBJECT_ALLOCATOR
+#define _oryol_sys_malloc(s) _priv::smallObjectAllocator::Alloc(s)
+#define _oryol_sys_realloc(p, s) _priv::smallObjectAllocator::ReAlloc(p, s)
+#define _oryol_sys_free(p) _priv::smallObjectAllocator::Free(p)
+#else
+#define _oryol_sys_malloc(s) std::malloc(s)
+#define _oryol_sys_realloc(p, s) std::realloc(p, s)
+#define _oryol_sys_free(p) std::free(p)
+#endif
     
 //------------------------------------------------------------------------------
 void*
 Memory::Alloc(int numBytes) {
-    void* ptr = std::malloc(numBytes);
+#if ORYOL_MEMORY_TRACKING
+    void* raw = _oryol_sys_malloc(numBytes + MemoryTracker::HeaderSize);
+    if (nullptr == raw) {
+        return nullptr;
+    }
+    void* ptr = MemoryTracker::track(raw, numBytes, MemoryTracker::CurrentTag());
+#else
+    void* ptr = _oryol_sys_malloc(numBytes);
+#endif
 #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
     Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
 #endif
@@ -31,13 +53,51 @@ Memory::Fill(void* ptr, int numBytes, uint8_t value) {
 void*
 Memory::ReAlloc(void* ptr, int s) {
     /// @todo: HMM need to fix fill with debug pattern...
-    return std::realloc(ptr, s);
+#if ORYOL_MEMORY_TRACKING
+    if (nullptr == ptr) {
+        return Memory::Alloc(s);
+    }
+    // re-allocated memory stays with the tag of the original allocation,
+    // if realloc fails the old block is untouched and stays tracked
+    void* raw = _oryol_sys_realloc(((uint8_t*)ptr) - MemoryTracker::HeaderSize, s + MemoryTracker::HeaderSize);
+    if (nullptr == raw) {
+        return nullptr;
+    }
+    // the header has been moved along with the data
+    return MemoryTracker::retrack(raw, s);
+#else
+    return _oryol_sys_realloc(ptr, s);
+#endif
 }
 
 //------------------------------------------------------------------------------
 void
 Memory::Free(void* p) {
-    std::free(p);
+#if ORYOL_MEMORY_TRACKING
+    if (p) {
+        p = MemoryTracker::untrack(p);
+    }
+#endif
+    _oryol_sys_free(p);
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::AllocAligned(int numBytes, int alignment) {
+    o_assert_dbg((alignment > 0) && (0 == (alignment & (alignment - 1))));
+    // over-allocate, and store the original pointer right before the aligned pointer
+    uint8_t* raw = (uint8_t*) Memory::Alloc(numBytes + alignment - 1 + int(sizeof(void*)));
+    void** ptr = (void**) Memory::AlignTo(raw + sizeof(void*), alignment);
+    ptr[-1] = raw;
+    return (void*) ptr;
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::FreeAligned(void* ptr) {
+    if (ptr) {
+        Memory::Free(((void**)ptr)[-1]);
+    }
 }
 
 //------------------------------------------------------------------------------
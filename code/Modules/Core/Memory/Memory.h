@@ -9,11 +9,13 @@
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
     
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+    By default this simply calls malloc()/free(), with
+    ORYOL_SMALL_OBJECT_ALLOCATOR=1 small allocations go through the
+    size-class allocator in smallObjectAllocator.h.
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
+#include "Core/Assertion.h"
 #include <new>
 #include <utility>
 
@@ -27,6 +29,10 @@ public:
     static void* ReAlloc(void* ptr, int numBytes);
     /// free a raw chunk of memory
     static void Free(void* ptr);
+    /// allocate a raw chunk of memory with alignment (power of 2, may be > ORYOL_MAX_PLATFORM_ALIGN)
+    static void* AllocAligned(int numBytes, int alignment);
+    /// free memory allocated with AllocAligned
+    static void FreeAligned(void* ptr);
     /// fill range of memory with a byte value
     static void Fill(void* ptr, int numBytes, uint8_t value);
     /// copy a raw chunk of non-overlapping memory
@@ -37,6 +43,8 @@ public:
     static void Clear(void* ptr, int numBytes);
     /// align a pointer to size up to ORYOL_MAX_PLATFORM_ALIGN
     static void* Align(void* ptr, int byteSize);
+    /// align a pointer up to any power-of-2 alignment
+    static void* AlignTo(void* ptr, int alignment);
     /// round-up a value to the next multiple of byteSize
     static int RoundUp(int val, int byteSize);
     /// replacement for new() going through Memory::Alloc without overriding new
@@ -60,6 +68,15 @@ Memory::Align(void* ptr, int byteSize) {
     return (void*) ptri;
 };
 
+//------------------------------------------------------------------------------
+inline void*
+Memory::AlignTo(void* ptr, int alignment) {
+    o_assert_dbg((alignment > 0) && (0 == (alignment & (alignment - 1))));
+    intptr_t ptri = (intptr_t)ptr;
+    ptri = (ptri + (alignment - 1)) & ~intptr_t(alignment - 1);
+    return (void*) ptri;
+}
+
 //------------------------------------------------------------------------------
 inline int
 Memory::RoundUp(int val, int roundTo) {
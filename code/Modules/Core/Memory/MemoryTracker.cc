@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+//  MemoryTracker.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "MemoryTracker.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#if ORYOL_MEMORY_TRACKING
+#include "Core/Threading/RWLock.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <cstring>
+#endif
+
+namespace Oryol {
+
+#if ORYOL_MEMORY_TRACKING
+namespace {
+
+struct tagRecord {
+    const char* name;
+    std::atomic<int64_t> liveBytes;
+    std::atomic<int64_t> highWaterBytes;
+    std::atomic<int64_t> numLiveAllocs;
+    std::atomic<int64_t> numAllocs;
+};
+
+struct header {
+    int32_t size;
+    int32_t tag;
+    uint32_t magic;
+    uint32_t padding;
+};
+static_assert(sizeof(header) == MemoryTracker::HeaderSize, "MemoryTracker: header size mismatch!");
+const uint32_t headerMagic = 0x4D454D54;    // 'MEMT'
+
+tagRecord tags[MemoryTracker::MaxNumTags];
+std::atomic<int> numTags{1};
+RWLock tagLock;
+
+std::atomic<int> frameNumAllocs{0};
+std::atomic<int> frameNumFrees{0};
+std::atomic<int64_t> frameNumBytes{0};
+MemoryTracker::FrameStats prevFrameStats;
+
+// NOTE: the thread's current tag is stored as (tagIndex + 1) in a
+// thread-local pointer, so that a nullptr means 'default tag'
+ORYOL_THREADLOCAL_PTR(void) curTag = nullptr;
+
+} // anonymous namespace
+#endif
+
+//------------------------------------------------------------------------------
+bool
+MemoryTracker::IsEnabled() {
+    #if ORYOL_MEMORY_TRACKING
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+MemoryTracker::RegisterTag(const char* name) {
+    #if ORYOL_MEMORY_TRACKING
+    o_assert_dbg(name);
+    ScopedWriteLock lock(tagLock);
+    const int num = numTags;
+    for (int i = 1; i < num; i++) {
+        if (0 == std::strcmp(tags[i].name, name)) {
+            return i;
+        }
+    }
+    o_assert2(num < MaxNumTags, "MemoryTracker: too many memory tags!\n");
+    tags[num].name = name;
+    numTags = num + 1;
+    return num;
+    #else
+    return DefaultTag;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+MemoryTracker::NumTags() {
+    #if ORYOL_MEMORY_TRACKING
+    return numTags;
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+MemoryTracker::TagStats
+MemoryTracker::GetTagStats(int tagIndex) {
+    TagStats stats;
+    #if ORYOL_MEMORY_TRACKING
+    o_assert_range(tagIndex, numTags);
+    const tagRecord& rec = tags[tagIndex];
+    stats.Name = (DefaultTag == tagIndex) ? "default" : rec.name;
+    stats.LiveBytes = rec.liveBytes;
+    stats.HighWaterBytes = rec.highWaterBytes;
+    stats.NumLiveAllocs = rec.numLiveAllocs;
+    stats.NumAllocs = rec.numAllocs;
+    #endif
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+MemoryTracker::FrameStats
+MemoryTracker::GetFrameStats() {
+    #if ORYOL_MEMORY_TRACKING
+    return prevFrameStats;
+    #else
+    return FrameStats();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+MemoryTracker::FrameStats
+MemoryTracker::GetCurrentFrameStats() {
+    FrameStats stats;
+    #if ORYOL_MEMORY_TRACKING
+    stats.NumAllocs = frameNumAllocs;
+    stats.NumFrees = frameNumFrees;
+    stats.NumBytes = frameNumBytes;
+    #endif
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryTracker::NewFrame() {
+    #if ORYOL_MEMORY_TRACKING
+    prevFrameStats.NumAllocs = frameNumAllocs.exchange(0);
+    prevFrameStats.NumFrees = frameNumFrees.exchange(0);
+    prevFrameStats.NumBytes = frameNumBytes.exchange(0);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryTracker::Dump() {
+    #if ORYOL_MEMORY_TRACKING
+    Log::Info("MemoryTracker: %d allocs, %d frees, %d bytes in previous frame\n",
+        prevFrameStats.NumAllocs, prevFrameStats.NumFrees, int(prevFrameStats.NumBytes));
+    const int num = NumTags();
+    for (int i = 0; i < num; i++) {
+        const TagStats stats = GetTagStats(i);
+        Log::Info("  %-16s live: %10lld bytes (%lld allocs), high-water: %10lld bytes, total allocs: %lld\n",
+            stats.Name,
+            (long long) stats.LiveBytes,
+            (long long) stats.NumLiveAllocs,
+            (long long) stats.HighWaterBytes,
+            (long long) stats.NumAllocs);
+    }
+    #else
+    Log::Info("MemoryTracker: not enabled (compile with ORYOL_MEMORY_TRACKING=1)\n");
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+MemoryTracker::SetCurrentTag(int tagIndex) {
+    #if ORYOL_MEMORY_TRACKING
+    const int prevTag = CurrentTag();
+    curTag = (void*) intptr_t(tagIndex + 1);
+    return prevTag;
+    #else
+    return DefaultTag;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+MemoryTracker::CurrentTag() {
+    #if ORYOL_MEMORY_TRACKING
+    void* p = curTag;
+    return p ? int(intptr_t(p) - 1) : DefaultTag;
+    #else
+    return DefaultTag;
+    #endif
+}
+
+#if ORYOL_MEMORY_TRACKING
+//------------------------------------------------------------------------------
+void*
+MemoryTracker::track(void* raw, int numBytes, int tagIndex) {
+    o_assert_dbg(raw);
+    header* hdr = (header*) raw;
+    hdr->size = numBytes;
+    hdr->tag = tagIndex;
+    hdr->magic = headerMagic;
+    hdr->padding = 0;
+
+    tagRecord& rec = tags[tagIndex];
+    const int64_t live = (rec.liveBytes += numBytes);
+    int64_t highWater = rec.highWaterBytes;
+    while ((live > highWater) && !rec.highWaterBytes.compare_exchange_weak(highWater, live)) {
+        // retry
+    }
+    rec.numLiveAllocs++;
+    rec.numAllocs++;
+    frameNumAllocs++;
+    frameNumBytes += numBytes;
+    return (void*) (hdr + 1);
+}
+
+//------------------------------------------------------------------------------
+void*
+MemoryTracker::untrack(void* ptr) {
+    o_assert_dbg(ptr);
+    header* hdr = ((header*)ptr) - 1;
+    o_assert2(headerMagic == hdr->magic, "MemoryTracker: freeing untracked or corrupted memory!\n");
+    tagRecord& rec = tags[hdr->tag];
+    rec.liveBytes -= hdr->size;
+    rec.numLiveAllocs--;
+    frameNumFrees++;
+    hdr->magic = 0;
+    return (void*) hdr;
+}
+
+//------------------------------------------------------------------------------
+void*
+MemoryTracker::retrack(void* raw, int numBytes) {
+    o_assert_dbg(raw);
+    header* hdr = (header*) raw;
+    o_assert2(headerMagic == hdr->magic, "MemoryTracker: reallocating untracked or corrupted memory!\n");
+
+    // the allocation keeps its record, only the size changes, this
+    // doesn't count as an allocation or free in the frame stats
+    const int delta = numBytes - hdr->size;
+    hdr->size = numBytes;
+    tagRecord& rec = tags[hdr->tag];
+    const int64_t live = (rec.liveBytes += delta);
+    int64_t highWater = rec.highWaterBytes;
+    while ((live > highWater) && !rec.highWaterBytes.compare_exchange_weak(highWater, live)) {
+        // retry
+    }
+    if (delta > 0) {
+        frameNumBytes += delta;
+    }
+    return (void*) (hdr + 1);
+}
+
+#endif
+
+} // namespace Oryol
@@ -0,0 +1,111 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemoryTracker
+    @ingroup Core
+    @brief optional allocation statistics for Memory::Alloc/ReAlloc/Free
+
+    When compiled with ORYOL_MEMORY_TRACKING=1 (cmake option
+    ORYOL_MEMORY_TRACKING), each Memory::Alloc() gets a small header
+    which records the size and the 'memory tag' of the allocation.
+    Tags group allocations by subsystem, the current tag of a thread
+    is set with the o_memory_scope() macro:
+
+    ```cpp
+    {
+        o_memory_scope("IO");
+        // all allocations in this scope are accounted to the tag "IO"
+        ...
+    }
+    ```
+
+    Allocations outside of any scope go to the "default" tag. For each
+    tag, the number of live bytes, live allocations and the high-water
+    mark are recorded. Additionally, the number of allocations per frame
+    is counted, the counters are reset once per frame from the main
+    thread's post-frame runloop.
+
+    Without ORYOL_MEMORY_TRACKING, the o_memory_scope() macro is a no-op
+    and all query functions return zero.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+
+namespace Oryol {
+
+class MemoryTracker {
+public:
+    /// max number of memory tags
+    static const int MaxNumTags = 64;
+    /// the default tag index
+    static const int DefaultTag = 0;
+
+    /// per-tag statistics
+    struct TagStats {
+        const char* Name = nullptr;
+        int64_t LiveBytes = 0;
+        int64_t HighWaterBytes = 0;
+        int64_t NumLiveAllocs = 0;
+        int64_t NumAllocs = 0;
+    };
+    /// per-frame statistics
+    struct FrameStats {
+        int NumAllocs = 0;
+        int NumFrees = 0;
+        int64_t NumBytes = 0;
+    };
+
+    /// return true if memory tracking has been compiled in
+    static bool IsEnabled();
+    /// register a new tag (or lookup existing tag by name), returns tag index
+    static int RegisterTag(const char* name);
+    /// get number of registered tags
+    static int NumTags();
+    /// get statistics of a tag
+    static TagStats GetTagStats(int tagIndex);
+    /// get statistics of the previous frame
+    static FrameStats GetFrameStats();
+    /// get statistics of the current (unfinished) frame
+    static FrameStats GetCurrentFrameStats();
+    /// start a new frame (called from main thread's PostRunLoop)
+    static void NewFrame();
+    /// dump statistics to the log
+    static void Dump();
+
+    /// set the calling thread's current tag, return previous tag
+    static int SetCurrentTag(int tagIndex);
+    /// get the calling thread's current tag
+    static int CurrentTag();
+
+    /// scoped tag helper, use via o_memory_scope()
+    class Scope {
+    public:
+        Scope(int tagIndex) : prevTag(SetCurrentTag(tagIndex)) { };
+        ~Scope() { SetCurrentTag(this->prevTag); };
+    private:
+        int prevTag;
+    };
+
+    #if ORYOL_MEMORY_TRACKING
+    /// size of the per-allocation header
+    static const int HeaderSize = 16;
+    /// record an allocation, raw points to the header, returns user pointer
+    static void* track(void* raw, int numBytes, int tagIndex);
+    /// record a free, ptr is user pointer, returns raw pointer
+    static void* untrack(void* ptr);
+    /// record a resize of a reallocated block, raw points to the moved header, returns user pointer
+    static void* retrack(void* raw, int numBytes);
+    #endif
+};
+
+#if ORYOL_MEMORY_TRACKING
+#define __o_memory_scope_name(line) _oryol_memory_scope_##line
+#define __o_memory_scope(name, line) static const int __o_memory_scope_name(line) = Oryol::MemoryTracker::RegisterTag(name); Oryol::MemoryTracker::Scope __o_memory_scope_name(line##_scope)(__o_memory_scope_name(line))
+#define __o_memory_scope_expand(name, line) __o_memory_scope(name, line)
+/// account all allocations in the current scope to a named memory tag
+#define o_memory_scope(name) __o_memory_scope_expand(name, __LINE__)
+#else
+#define o_memory_scope(name) ((void)0)
+#endif
+
+} // namespace Oryol
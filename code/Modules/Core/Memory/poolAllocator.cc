@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------
+//  poolAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "poolAllocator.h"
+
+namespace Oryol {
+namespace _priv {
+
+std::atomic<uint64_t> poolThreadSlot::usedSlots{0};
+ORYOL_THREADLOCAL_PTR(void) poolThreadSlot::threadSlot = nullptr;
+
+//------------------------------------------------------------------------------
+int
+poolThreadSlot::acquire() {
+    o_assert_dbg(nullptr == threadSlot);
+    uint64_t used = usedSlots.load(std::memory_order_relaxed);
+    for (;;) {
+        if (~used == 0) {
+            // all slots taken, use the shared overflow slot
+            threadSlot = (void*) intptr_t(OverflowSlot + 1);
+            return OverflowSlot;
+        }
+        int slot = 0;
+        while (used & (uint64_t(1) << slot)) {
+            slot++;
+        }
+        const uint64_t newUsed = used | (uint64_t(1) << slot);
+        if (usedSlots.compare_exchange_weak(used, newUsed, std::memory_order_acquire, std::memory_order_relaxed)) {
+            threadSlot = (void*) intptr_t(slot + 1);
+            return slot;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+poolThreadSlot::Release() {
+    #if ORYOL_HAS_THREADS
+    void* p = threadSlot;
+    if (p) {
+        const int slot = int(intptr_t(p) - 1);
+        if (slot != OverflowSlot) {
+            usedSlots.fetch_and(~(uint64_t(1) << slot), std::memory_order_release);
+        }
+        threadSlot = nullptr;
+    }
+    #endif
+}
+
+} // namespace _priv
+} // namespace Oryol
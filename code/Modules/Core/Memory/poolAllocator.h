@@ -3,237 +3,412 @@
 /*
     @class Oryol::_priv::poolAllocator
     @ingroup _priv
- 
-    Thread-safe pool allocator with placement-new/delete. Uses 32-bit
-    tags with a unique-count masked-in for its forward-linked list 
-    instead of pointers because of the ABA problem (which I was actually 
-    running into with many threads and high object reuse). The pool
-    is split into up to 256 "puddles", where each puddle can hold
-    up to 256 elements. When no elements are in the free list, 
-    a new puddle is allocated. Thus one pool can hold up to
-    65536 elements.
+
+    Thread-safe pool allocator with placement-new/delete.
+
+    Each thread has its own 'magazine' (a small stack of free elements)
+    per pool allocator, so that Create() and Destroy() usually don't
+    touch any shared state. When a magazine runs empty, a whole batch of
+    free elements is popped from a shared lock-free 'depot', and when a
+    magazine overflows, a batch is pushed back to the depot. This means
+    that only one CAS operation happens per BatchSize
+    Create()/Destroy() calls.
+
+    Elements are addressed by 32-bit indices instead of pointers, the
+    depot head is a 64-bit tag with a unique-count masked-in because
+    of the ABA problem (which I was actually running into with many
+    threads and high object reuse).
+
+    The pool is split into up to 24 "puddles", where the first puddle
+    holds 256 elements, and each new puddle is twice as big as the
+    previous one. When the depot is empty, a new puddle is allocated,
+    threads which ran into an empty depot at the same time only grow
+    the pool once.
+
+    Threads get a magazine slot on first use, the slot is given up in
+    Core::LeaveThread() (a new thread will then inherit the magazine
+    content of the slot). If more than MaxThreadSlots threads are
+    active, the remaining threads share a spin-locked magazine.
+    Threads which use pool-allocated objects MUST call Core::LeaveThread()
+    before they exit: otherwise their slot is never given up, and the
+    free elements in its magazine can't be reused until the pool is
+    destroyed (the destructor frees all magazines and puddles, so no
+    memory is leaked beyond the pool's lifetime).
 */
 #include <atomic>
 #include <utility>
 #include "Core/Types.h"
+#include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#if ORYOL_WINDOWS
+#include <intrin.h>
+#endif
 
 namespace Oryol {
 namespace _priv {
-    
+
+//------------------------------------------------------------------------------
+class poolThreadSlot {
+public:
+    /// max number of threads with their own magazine
+    static const int MaxThreadSlots = 64;
+    /// the shared 'overflow' slot index
+    static const int OverflowSlot = MaxThreadSlots;
+
+    /// get the calling thread's slot index (acquires a slot on first call)
+    static int Get();
+    /// release the calling thread's slot (called from Core::LeaveThread)
+    static void Release();
+
+private:
+    /// acquire a new slot
+    static int acquire();
+
+    static std::atomic<uint64_t> usedSlots;
+    // NOTE: stored as (slotIndex + 1) so that nullptr means 'no slot yet'
+    static ORYOL_THREADLOCAL_PTR(void) threadSlot;
+};
+
+//------------------------------------------------------------------------------
+inline int
+poolThreadSlot::Get() {
+    #if ORYOL_HAS_THREADS
+    void* p = threadSlot;
+    if (p) {
+        return int(intptr_t(p) - 1);
+    }
+    return acquire();
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
 template<class TYPE> class poolAllocator {
 public:
     /// constructor
     poolAllocator();
     /// destructor
     ~poolAllocator();
-    
+
     /// allocate and construct an object of type T
     template<typename... ARGS> TYPE* Create(ARGS&&... args);
     /// delete and free an object
     void Destroy(TYPE* obj);
-    
+
+    /// get overall number of elements in the pool (used and free)
+    uint32_t Capacity() const;
+
 private:
     enum class nodeState : uint8_t {
         init, free, used,
     };
-    
-    typedef uint32_t nodeTag;    // [16bit counter] | [8bit puddle index ] | [8bit elm_index])
-    static const uint32_t invalidTag = 0xFFFFFFFF;
+
+    static const uint32_t invalidIndex = 0xFFFFFFFF;
 
     struct node {
-        nodeTag next;          // tag of next node
-        nodeTag myTag;        // my own tag
-        nodeState state;       // current state
-        uint8_t padding[16 - (2*sizeof(nodeTag) + sizeof(nodeState))];      // pad to 16 bytes
+        uint32_t next;                      // index of next node in batch
+        uint32_t myIndex;                   // my own index
+        std::atomic<uint32_t> nextBatch;    // index of first node of next batch in depot
+        uint16_t batchSize;                 // number of nodes in batch (first node only)
+        nodeState state;                    // current state
+        uint8_t padding;
     };
 
-    /// pop a new node from the free-list, return 0 if empty
-    node* pop();
-    /// push a node onto the free-list
-    void push(node*);
-    /// allocate a new puddle and add entries to free-list
-    void allocPuddle();
-    /// get node address from a tag
-    node* addressFromTag(nodeTag tag) const;
-    /// get tag from a node address
-    nodeTag tagFromAddress(node* n) const;
+    static const uint32_t MaxNumPuddles = 24;
+    static const uint32_t FirstPuddleShift = 8;
+    static const uint32_t BatchSize = 32;
+    static const uint32_t MagazineSize = 2 * BatchSize;
+
+    struct magazine {
+        uint32_t count;
+        uint32_t items[MagazineSize];
+    };
+
+    /// get magazine of calling thread (lock if overflow magazine)
+    magazine* lockMagazine();
+    /// unlock magazine (only does something for overflow magazine)
+    void unlockMagazine(magazine* mag);
+    /// load a batch from the depot into an empty magazine
+    void refill(magazine* mag);
+    /// push a batch from a full magazine to the depot
+    void flush(magazine* mag);
+    /// pop a batch from the depot, return invalidIndex if empty
+    uint32_t popBatch();
+    /// push a batch to the depot
+    void pushBatch(node* batch);
+    /// allocate a new puddle and add batches to the depot, unless the number of puddles has changed
+    void allocPuddle(uint32_t seenNumPuddles);
+    /// get puddle index from node index
+    static uint32_t puddleIndex(uint32_t index);
+    /// get first node index of puddle
+    static uint32_t puddleStart(uint32_t puddleIndex);
+    /// get number of elements in puddle
+    static uint32_t puddleNumElements(uint32_t puddleIndex);
+    /// get node address from index
+    node* addressFromIndex(uint32_t index) const;
     /// test if a pointer is owned by this allocator (SLOW)
     bool isOwned(TYPE* obj) const;
-    
-    static const uint32_t MaxNumPuddles = 256;
-    static const uint32_t NumPuddleElements = 256;
-    
+
     int32_t elmSize;                      // offset to next element in bytes
 
-    #if ORYOL_HAS_ATOMIC
-        std::atomic<uint32_t> uniqueCount;
-        std::atomic<nodeTag> head;          // free-list head
-        std::atomic<uint32_t> numPuddles;     // current number of puddles
-    #else
-        uint32_t uniqueCount;
-        nodeTag head;
-        uint32_t numPuddles;
-    #endif
-    uint8_t* puddles[MaxNumPuddles];
+    std::atomic<uint64_t> head;           // depot head [32 bit unique count | 32 bit node index]
+    std::atomic<uint32_t> numPuddles;     // current number of puddles
+    std::atomic<uint8_t*> puddles[MaxNumPuddles];
+    std::atomic_flag growLock;
+    std::atomic_flag overflowLock;
+    std::atomic<magazine*> magazines[poolThreadSlot::MaxThreadSlots + 1];
 };
 
 //------------------------------------------------------------------------------
 template<class TYPE>
-poolAllocator<TYPE>::poolAllocator()
+poolAllocator<TYPE>::poolAllocator() :
+head(invalidIndex),
+numPuddles(0)
 {
     static_assert(sizeof(node) == 16, "pool_allocator::node should be 16 bytes!");
 
-    Memory::Clear(this->puddles, sizeof(this->puddles));
-    this->numPuddles = 0;
+    for (uint32_t i = 0; i < MaxNumPuddles; i++) {
+        this->puddles[i] = nullptr;
+    }
+    for (int i = 0; i <= poolThreadSlot::MaxThreadSlots; i++) {
+        this->magazines[i] = nullptr;
+    }
+    this->growLock.clear();
+    this->overflowLock.clear();
     this->elmSize = Memory::RoundUp(sizeof(node) + sizeof(TYPE), sizeof(node));
     o_assert((this->elmSize & (sizeof(node) - 1)) == 0);
     o_assert(this->elmSize >= (int32_t)(2*sizeof(node)));
-    this->uniqueCount = 0;
-    this->head = invalidTag;
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 poolAllocator<TYPE>::~poolAllocator() {
-
+    for (int i = 0; i <= poolThreadSlot::MaxThreadSlots; i++) {
+        if (this->magazines[i]) {
+            Memory::Free(this->magazines[i]);
+            this->magazines[i] = nullptr;
+        }
+    }
     const uint32_t num = this->numPuddles;
     for (uint32_t i = 0; i < num; i++) {
         Memory::Free(this->puddles[i]);
-        this->puddles[i] = 0;
+        this->puddles[i] = nullptr;
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+poolAllocator<TYPE>::puddleIndex(uint32_t index) {
+    // puddle k starts at node index 256 * (2^k - 1)
+    uint32_t v = (index >> FirstPuddleShift) + 1;
+    #if ORYOL_WINDOWS
+    unsigned long bit;
+    _BitScanReverse(&bit, v);
+    return bit;
+    #else
+    return 31 - __builtin_clz(v);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+poolAllocator<TYPE>::puddleStart(uint32_t puddleIndex) {
+    return ((1u << puddleIndex) - 1u) << FirstPuddleShift;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint32_t
+poolAllocator<TYPE>::puddleNumElements(uint32_t puddleIndex) {
+    return (1u << FirstPuddleShift) << puddleIndex;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::addressFromTag(nodeTag tag) const {
-    uint32_t elmIndex = tag & 0xFF;
-    uint32_t puddleIndex = (tag & 0xFF00) >> 8;
-    uint8_t* ptr = this->puddles[puddleIndex] + elmIndex * elmSize;
+poolAllocator<TYPE>::addressFromIndex(uint32_t index) const {
+    o_assert_dbg(invalidIndex != index);
+    const uint32_t pi = puddleIndex(index);
+    uint8_t* ptr = this->puddles[pi].load(std::memory_order_relaxed) + size_t(index - puddleStart(pi)) * this->elmSize;
     return (node*) ptr;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-typename poolAllocator<TYPE>::nodeTag
-poolAllocator<TYPE>::tagFromAddress(node* n) const {
-    o_assert(nullptr != n);
-    nodeTag tag = n->myTag;
-    #if ORYOL_ALLOCATOR_DEBUG
-    o_assert(n == addressFromTag(tag));
-    #endif
-    return tag;
+template<class TYPE> uint32_t
+poolAllocator<TYPE>::Capacity() const {
+    return puddleStart(this->numPuddles);
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE> void
-poolAllocator<TYPE>::allocPuddle() {
-
-    // increment the puddle-counter (this must happen first because the
-    // method can be called from different threads
-    #if ORYOL_HAS_ATOMIC
-        uint32_t newPuddleIndex = this->numPuddles.fetch_add(1, std::memory_order_relaxed);
-    #else 
-        uint32_t newPuddleIndex = this->numPuddles++;
-    #endif
-    o_assert(newPuddleIndex < MaxNumPuddles);
-    
+poolAllocator<TYPE>::allocPuddle(uint32_t seenNumPuddles) {
+
+    // only one thread at a time may grow the pool
+    while (this->growLock.test_and_set(std::memory_order_acquire)) {
+        // spinning...
+    }
+    const uint32_t newPuddleIndex = this->numPuddles.load(std::memory_order_relaxed);
+    if (newPuddleIndex != seenNumPuddles) {
+        // another thread has grown the pool while we were waiting,
+        // its batches are already in the depot
+        this->growLock.clear(std::memory_order_release);
+        return;
+    }
+    o_assert2(newPuddleIndex < MaxNumPuddles, "poolAllocator: pool exhausted!\n");
+
     // allocate new puddle
-    const uint32_t puddleByteSize = NumPuddleElements * this->elmSize;
-    this->puddles[newPuddleIndex] = (uint8_t*) Memory::Alloc(puddleByteSize);
-    Memory::Clear(this->puddles[newPuddleIndex], puddleByteSize);
-    
-    // populate the free stack
-    for (int elmIndex = (NumPuddleElements - 1); elmIndex >= 0; elmIndex--) {
-        uint8_t* ptr = this->puddles[newPuddleIndex] + elmIndex * this->elmSize;
-        node* nodePtr = (node*) ptr;
-        nodePtr->next  = invalidTag;
-        nodePtr->myTag = (newPuddleIndex << 8) | elmIndex;
+    const uint32_t numElements = puddleNumElements(newPuddleIndex);
+    const uint32_t startIndex = puddleStart(newPuddleIndex);
+    const size_t puddleByteSize = size_t(numElements) * this->elmSize;
+    o_assert2(puddleByteSize <= size_t(0x7FFFFFFF), "poolAllocator: puddle too big!\n");
+    uint8_t* puddle = (uint8_t*) Memory::Alloc(int(puddleByteSize));
+    Memory::Clear(puddle, int(puddleByteSize));
+    for (uint32_t elmIndex = 0; elmIndex < numElements; elmIndex++) {
+        node* nodePtr = (node*) (puddle + size_t(elmIndex) * this->elmSize);
+        nodePtr->next = (((elmIndex + 1) % BatchSize) == 0) ? invalidIndex : startIndex + elmIndex + 1;
+        nodePtr->myIndex = startIndex + elmIndex;
+        new(&nodePtr->nextBatch) std::atomic<uint32_t>(invalidIndex);
+        nodePtr->batchSize = 0;
         nodePtr->state = nodeState::init;
-        this->push(nodePtr);
     }
+    this->puddles[newPuddleIndex].store(puddle, std::memory_order_release);
+
+    // push the new elements to the depot in batches (puddle sizes are multiples
+    // of BatchSize), before the new puddle count becomes visible to waiting threads
+    static_assert(((1 << FirstPuddleShift) % BatchSize) == 0, "poolAllocator: invalid BatchSize");
+    for (uint32_t elmIndex = 0; elmIndex < numElements; elmIndex += BatchSize) {
+        node* batch = (node*) (puddle + size_t(elmIndex) * this->elmSize);
+        batch->batchSize = BatchSize;
+        this->pushBatch(batch);
+    }
+    this->numPuddles.store(newPuddleIndex + 1, std::memory_order_release);
+    this->growLock.clear(std::memory_order_release);
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE> void
-poolAllocator<TYPE>::push(node* newHead) {
-    
+poolAllocator<TYPE>::pushBatch(node* batch) {
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
-    o_assert((nodeState::init == newHead->state) || (nodeState::used == newHead->state));
-    
-    o_assert(invalidTag == newHead->next);
-    #if ORYOL_ALLOCATOR_DEBUG
-    Memory::Fill((void*) (newHead + 1), sizeof(TYPE), 0xAA);
-    #endif
-    
-    newHead->state = nodeState::free;
-    newHead->myTag = (newHead->myTag & 0x0000FFFF) | (++this->uniqueCount & 0xFFFF) << 16;
-    #if ORYOL_HAS_ATOMIC
-        nodeTag oldHeadTag = this->head.load(std::memory_order_relaxed);
-        for (;;) {
-            newHead->next = oldHeadTag;
-            if (this->head.compare_exchange_weak(oldHeadTag, newHead->myTag)) {
-                break;
-            }
+    o_assert_dbg(batch->batchSize > 0);
+    uint64_t oldHead = this->head.load(std::memory_order_relaxed);
+    for (;;) {
+        batch->nextBatch.store(uint32_t(oldHead & 0xFFFFFFFF), std::memory_order_relaxed);
+        const uint64_t newHead = (((oldHead >> 32) + 1) << 32) | batch->myIndex;
+        if (this->head.compare_exchange_weak(oldHead, newHead, std::memory_order_release, std::memory_order_relaxed)) {
+            break;
         }
-    #else
-        nodeTag oldHeadTag = this->head;
-        newHead->next = oldHeadTag;
-        this->head = newHead->myTag;
-    #endif
+    }
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::pop()
-{
+template<class TYPE> uint32_t
+poolAllocator<TYPE>::popBatch() {
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
+    uint64_t oldHead = this->head.load(std::memory_order_acquire);
     for (;;) {
-        #if ORYOL_HAS_ATOMIC
-            nodeTag oldHeadTag = this->head.load(std::memory_order_consume);
-        #else 
-            nodeTag oldHeadTag = this->head;
-        #endif
-        if (invalidTag == oldHeadTag) {
-            return nullptr;
+        const uint32_t index = uint32_t(oldHead & 0xFFFFFFFF);
+        if (invalidIndex == index) {
+            return invalidIndex;
         }
-        nodeTag newHeadTag = this->addressFromTag(oldHeadTag)->next;
-        #if ORYOL_HAS_ATOMIC
-        if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
-        #else
-        this->head = newHeadTag;
-        #endif
-            o_assert(invalidTag != oldHeadTag);
-            node* nodePtr = this->addressFromTag(oldHeadTag);
-            o_assert(nodeState::free == nodePtr->state);
-            #if ORYOL_ALLOCATOR_DEBUG
-            Memory::Fill((void*) (nodePtr+ 1), sizeof(TYPE), 0xBB);
-            #endif
-            nodePtr->next = invalidTag;
-            nodePtr->state = nodeState::used;
-            return nodePtr;
-        #if ORYOL_HAS_ATOMIC
+        // NOTE: puddles are never freed, so it is safe to look at the
+        // node even if another thread has popped it in the meantime
+        const uint32_t nextIndex = this->addressFromIndex(index)->nextBatch.load(std::memory_order_relaxed);
+        const uint64_t newHead = (((oldHead >> 32) + 1) << 32) | nextIndex;
+        if (this->head.compare_exchange_weak(oldHead, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+            return index;
         }
-        #endif
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename poolAllocator<TYPE>::magazine*
+poolAllocator<TYPE>::lockMagazine() {
+    const int slot = poolThreadSlot::Get();
+    if (poolThreadSlot::OverflowSlot == slot) {
+        while (this->overflowLock.test_and_set(std::memory_order_acquire)) {
+            // spinning...
+        }
+    }
+    magazine* mag = this->magazines[slot].load(std::memory_order_relaxed);
+    if (nullptr == mag) {
+        // only the owning thread of a slot creates its magazine
+        mag = (magazine*) Memory::Alloc(sizeof(magazine));
+        mag->count = 0;
+        this->magazines[slot].store(mag, std::memory_order_relaxed);
+    }
+    return mag;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::unlockMagazine(magazine* mag) {
+    if (mag == this->magazines[poolThreadSlot::OverflowSlot].load(std::memory_order_relaxed)) {
+        this->overflowLock.clear(std::memory_order_release);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::refill(magazine* mag) {
+    o_assert_dbg(0 == mag->count);
+    uint32_t index;
+    for (;;) {
+        // NOTE: the number of puddles must be read before looking at the
+        // depot, so that an empty depot means that nobody has grown the
+        // pool in the meantime, other threads may grab the new batches
+        // before we get one, so try again until we succeed
+        const uint32_t seenNumPuddles = this->numPuddles.load(std::memory_order_acquire);
+        if (invalidIndex != (index = this->popBatch())) {
+            break;
+        }
+        this->allocPuddle(seenNumPuddles);
+    }
+    while (invalidIndex != index) {
+        o_assert_dbg(mag->count < MagazineSize);
+        node* n = this->addressFromIndex(index);
+        mag->items[mag->count++] = index;
+        index = n->next;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::flush(magazine* mag) {
+    o_assert_dbg(MagazineSize == mag->count);
+    // link the oldest BatchSize items into a batch and push it to the depot
+    node* first = this->addressFromIndex(mag->items[0]);
+    for (uint32_t i = 0; i < BatchSize; i++) {
+        node* n = this->addressFromIndex(mag->items[i]);
+        n->next = (i < (BatchSize - 1)) ? mag->items[i + 1] : invalidIndex;
+    }
+    first->batchSize = BatchSize;
+    for (uint32_t i = BatchSize; i < MagazineSize; i++) {
+        mag->items[i - BatchSize] = mag->items[i];
+    }
+    mag->count -= BatchSize;
+    this->pushBatch(first);
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE>
 template<typename... ARGS> TYPE*
 poolAllocator<TYPE>::Create(ARGS&&... args) {
-    
-    // pop a new node from the free-stack
-    node* n = this->pop();
-    if (nullptr == n) {
-        // need to allocate a new puddle
-        this->allocPuddle();
-        n = this->pop();
+
+    // pop a new node from the thread's magazine
+    magazine* mag = this->lockMagazine();
+    if (0 == mag->count) {
+        this->refill(mag);
     }
-    o_assert(nullptr != n);
-    
+    node* n = this->addressFromIndex(mag->items[--mag->count]);
+    this->unlockMagazine(mag);
+    o_assert((nodeState::init == n->state) || (nodeState::free == n->state));
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xBB);
+    #endif
+    n->state = nodeState::used;
+
     // construct with placement new
     void* objPtr = (void*) (n + 1);
     TYPE* obj = new(objPtr) TYPE(std::forward<ARGS>(args)...);
@@ -247,7 +422,7 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
     const uint32_t num = this->numPuddles;
     for (uint32_t i = 0; i < num; i++) {
         const uint8_t* start = this->puddles[i];
-        const uint8_t* end = this->puddles[i] + NumPuddleElements * this->elmSize;
+        const uint8_t* end = start + size_t(puddleNumElements(i)) * this->elmSize;
         const uint8_t* ptr = (uint8_t*) obj;
         if ((ptr >= start) && (ptr < end)) {
             return true;
@@ -259,18 +434,28 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
 //------------------------------------------------------------------------------
 template<class TYPE> void
 poolAllocator<TYPE>::Destroy(TYPE* obj) {
-    
+
     #if ORYOL_ALLOCATOR_DEBUG
     // make sure this object has been allocated by us
     o_assert(this->isOwned(obj));
     #endif
-    
+
     // call destructor on obj
     obj->~TYPE();
-    
-    // push the pool element back on the free-stack
+
+    // push the pool element back into the thread's magazine
     node* n = ((node*)obj) - 1;
-    push(n);
+    o_assert(nodeState::used == n->state);
+    n->state = nodeState::free;
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xAA);
+    #endif
+    magazine* mag = this->lockMagazine();
+    if (MagazineSize == mag->count) {
+        this->flush(mag);
+    }
+    mag->items[mag->count++] = n->myIndex;
+    this->unlockMagazine(mag);
 }
 
 } // namespace _priv
@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------------
+//  smallObjectAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "smallObjectAllocator.h"
+#include "Core/Assertion.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+
+const uint32_t largeClass = 0xFFFF;
+const uint32_t headerMagic = 0x534F4131;    // 'SOA1'
+
+struct header {
+    uint32_t sizeClass;
+    uint32_t magic;
+    uint64_t padding;
+};
+static_assert(sizeof(header) == smallObjectAllocator::HeaderSize, "smallObjectAllocator: header size mismatch!");
+
+// a free block, the link overlaps the header
+struct freeBlock {
+    freeBlock* next;
+};
+
+// block sizes including the header
+const int blockSizes[smallObjectAllocator::NumSizeClasses] = {
+    32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024
+};
+
+struct centralList {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    freeBlock* head = nullptr;
+};
+centralList central[smallObjectAllocator::NumSizeClasses];
+
+struct threadCache {
+    freeBlock* lists[smallObjectAllocator::NumSizeClasses];
+    int counts[smallObjectAllocator::NumSizeClasses];
+};
+ORYOL_THREADLOCAL_PTR(threadCache) curCache = nullptr;
+
+std::atomic<int> numSpans{0};
+// read by every allocating thread, may be toggled at any time
+std::atomic<bool> enabled{true};
+
+//------------------------------------------------------------------------------
+void
+lockCentral(centralList& c) {
+    while (c.lock.test_and_set(std::memory_order_acquire)) {
+        // spinning...
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+unlockCentral(centralList& c) {
+    c.lock.clear(std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+threadCache*
+getCache() {
+    threadCache* cache = curCache;
+    if (nullptr == cache) {
+        // NOTE: can't use Memory::Alloc() here
+        cache = (threadCache*) std::calloc(1, sizeof(threadCache));
+        o_assert(cache);
+        curCache = cache;
+    }
+    return cache;
+}
+
+//------------------------------------------------------------------------------
+void
+refill(threadCache* cache, int cls) {
+    o_assert_dbg(nullptr == cache->lists[cls]);
+    centralList& c = central[cls];
+
+    // take a batch from the central free-list
+    lockCentral(c);
+    freeBlock* first = c.head;
+    freeBlock* last = nullptr;
+    freeBlock* cur = first;
+    int num = 0;
+    while (cur && (num < smallObjectAllocator::BatchSize)) {
+        last = cur;
+        cur = cur->next;
+        num++;
+    }
+    c.head = cur;
+    unlockCentral(c);
+
+    if (num > 0) {
+        last->next = nullptr;
+    }
+    else {
+        // central free-list is empty, carve a new span
+        const int blockSize = blockSizes[cls];
+        const int numBlocks = smallObjectAllocator::SpanSize / blockSize;
+        uint8_t* span = (uint8_t*) std::malloc(smallObjectAllocator::SpanSize);
+        o_assert(span);
+        numSpans++;
+        num = numBlocks < smallObjectAllocator::BatchSize ? numBlocks : smallObjectAllocator::BatchSize;
+
+        // the first batch goes into the thread cache, the rest into the central free-list
+        first = nullptr;
+        for (int i = num - 1; i >= 0; i--) {
+            freeBlock* block = (freeBlock*) (span + i * blockSize);
+            block->next = first;
+            first = block;
+        }
+        if (numBlocks > num) {
+            freeBlock* restFirst = nullptr;
+            freeBlock* restLast = (freeBlock*) (span + (numBlocks - 1) * blockSize);
+            for (int i = numBlocks - 1; i >= num; i--) {
+                freeBlock* block = (freeBlock*) (span + i * blockSize);
+                block->next = restFirst;
+                restFirst = block;
+            }
+            lockCentral(c);
+            restLast->next = c.head;
+            c.head = restFirst;
+            unlockCentral(c);
+        }
+    }
+    cache->lists[cls] = first;
+    cache->counts[cls] = num;
+}
+
+//------------------------------------------------------------------------------
+void
+flush(threadCache* cache, int cls, int maxNum) {
+    freeBlock* first = cache->lists[cls];
+    if (nullptr == first) {
+        return;
+    }
+    freeBlock* last = first;
+    int num = 1;
+    while (last->next && (num < maxNum)) {
+        last = last->next;
+        num++;
+    }
+    cache->lists[cls] = last->next;
+    cache->counts[cls] -= num;
+
+    centralList& c = central[cls];
+    lockCentral(c);
+    last->next = c.head;
+    c.head = first;
+    unlockCentral(c);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int
+smallObjectAllocator::SizeClass(int numBytes) {
+    const int blockSize = numBytes + HeaderSize;
+    if (blockSize <= 128) {
+        return (blockSize <= 32) ? 0 : ((blockSize + 15) >> 4) - 2;
+    }
+    else if (blockSize <= 256) {
+        return 7 + ((blockSize - 128 + 31) >> 5) - 1;
+    }
+    else if (blockSize <= 512) {
+        return 11 + ((blockSize - 256 + 63) >> 6) - 1;
+    }
+    else if (blockSize <= MaxBlockSize) {
+        return 15 + ((blockSize - 512 + 127) >> 7) - 1;
+    }
+    else {
+        return -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+smallObjectAllocator::BlockSize(int sizeClass) {
+    o_assert_range_dbg(sizeClass, NumSizeClasses);
+    return blockSizes[sizeClass];
+}
+
+//------------------------------------------------------------------------------
+void
+smallObjectAllocator::SetEnabled(bool b) {
+    enabled.store(b, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+bool
+smallObjectAllocator::IsEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int
+smallObjectAllocator::NumSpans() {
+    return numSpans;
+}
+
+//------------------------------------------------------------------------------
+void*
+smallObjectAllocator::Alloc(int numBytes) {
+    o_assert_dbg(numBytes >= 0);
+    const int cls = enabled.load(std::memory_order_relaxed) ? SizeClass(numBytes) : -1;
+    header* hdr;
+    if (cls < 0) {
+        hdr = (header*) std::malloc(numBytes + HeaderSize);
+        o_assert(hdr);
+        hdr->sizeClass = largeClass;
+    }
+    else {
+        threadCache* cache = getCache();
+        if (nullptr == cache->lists[cls]) {
+            refill(cache, cls);
+        }
+        freeBlock* block = cache->lists[cls];
+        cache->lists[cls] = block->next;
+        cache->counts[cls]--;
+        hdr = (header*) block;
+        hdr->sizeClass = cls;
+    }
+    hdr->magic = headerMagic;
+    return (void*) (hdr + 1);
+}
+
+//------------------------------------------------------------------------------
+void
+smallObjectAllocator::Free(void* ptr) {
+    if (nullptr == ptr) {
+        return;
+    }
+    header* hdr = ((header*)ptr) - 1;
+    o_assert2(headerMagic == hdr->magic, "smallObjectAllocator: freeing invalid or corrupted memory!\n");
+    hdr->magic = 0;
+    const uint32_t cls = hdr->sizeClass;
+    if (largeClass == cls) {
+        std::free(hdr);
+    }
+    else {
+        threadCache* cache = getCache();
+        if (cache->counts[cls] >= 2 * BatchSize) {
+            flush(cache, cls, BatchSize);
+        }
+        freeBlock* block = (freeBlock*) hdr;
+        block->next = cache->lists[cls];
+        cache->lists[cls] = block;
+        cache->counts[cls]++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+smallObjectAllocator::ReAlloc(void* ptr, int numBytes) {
+    if (nullptr == ptr) {
+        return Alloc(numBytes);
+    }
+    header* hdr = ((header*)ptr) - 1;
+    o_assert2(headerMagic == hdr->magic, "smallObjectAllocator: re-allocating invalid or corrupted memory!\n");
+    const uint32_t cls = hdr->sizeClass;
+    if (largeClass == cls) {
+        // large allocations stay with malloc
+        hdr = (header*) std::realloc(hdr, numBytes + HeaderSize);
+        o_assert(hdr);
+        return (void*) (hdr + 1);
+    }
+    else {
+        const int oldSize = blockSizes[cls] - HeaderSize;
+        if (numBytes <= oldSize) {
+            // still fits into the block
+            return ptr;
+        }
+        void* newPtr = Alloc(numBytes);
+        std::memcpy(newPtr, ptr, oldSize);
+        Free(ptr);
+        return newPtr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+smallObjectAllocator::FlushThreadCache() {
+    threadCache* cache = curCache;
+    if (cache) {
+        for (int cls = 0; cls < NumSizeClasses; cls++) {
+            flush(cache, cls, cache->counts[cls]);
+        }
+        curCache = nullptr;
+        std::free(cache);
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
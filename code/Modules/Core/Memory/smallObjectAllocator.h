@@ -0,0 +1,72 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::smallObjectAllocator
+    @ingroup _priv
+    @brief size-class slab allocator backend for Memory::Alloc
+
+    Only used when compiled with ORYOL_SMALL_OBJECT_ALLOCATOR=1 (cmake
+    option ORYOL_SMALL_OBJECT_ALLOCATOR). Allocations up to
+    MaxSmallSize bytes are rounded up to one of NumSizeClasses size
+    classes and carved from 64 KByte spans, bigger allocations go
+    to malloc(). Each allocation has a 16-byte header which records
+    the size class, so that Free() knows where the memory came from.
+
+    Each thread has a cache with a free-list per size class, so that
+    most Alloc() and Free() calls don't need any synchronization. When
+    a thread's free-list runs empty or grows too big, a batch of blocks
+    is moved from or to the central free-list of the size class, which
+    is protected by a spinlock. Spans are never returned to the system.
+
+    A thread's cache is returned to the central free-lists in
+    Core::LeaveThread().
+
+    The allocator is selected at compile time instead of in Core::Setup(),
+    since Memory::Alloc() is already called before Core::Setup() (e.g. by
+    static initializers). SetEnabled() switches size classes on or off at
+    any time, each block's header records where it came from.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+
+namespace Oryol {
+namespace _priv {
+
+class smallObjectAllocator {
+public:
+    /// size of the per-allocation header
+    static const int HeaderSize = 16;
+    /// number of size classes
+    static const int NumSizeClasses = 19;
+    /// max block size (including header) served from size classes
+    static const int MaxBlockSize = 1024;
+    /// max user-size served from size classes
+    static const int MaxSmallSize = MaxBlockSize - HeaderSize;
+    /// byte size of a span
+    static const int SpanSize = 64 * 1024;
+    /// number of blocks moved between thread-cache and central free-list
+    static const int BatchSize = 32;
+
+    /// allocate memory
+    static void* Alloc(int numBytes);
+    /// re-allocate memory
+    static void* ReAlloc(void* ptr, int numBytes);
+    /// free memory
+    static void Free(void* ptr);
+    /// return the calling thread's cached blocks to the central free-lists
+    static void FlushThreadCache();
+
+    /// enable/disable size classes at runtime (disabled: everything goes to malloc)
+    static void SetEnabled(bool b);
+    /// test if size classes are enabled
+    static bool IsEnabled();
+    /// get number of spans allocated so far
+    static int NumSpans();
+    /// get the size-class index for a user size (-1 if too big)
+    static int SizeClass(int numBytes);
+    /// get the block size (including header) of a size class
+    static int BlockSize(int sizeClass);
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,439 @@
+//------------------------------------------------------------------------------
+//  Profiler.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Profiler.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace Oryol {
+
+namespace {
+
+struct profEvent {
+    const char* name;
+    int64_t time;
+    Profiler::EventType type;
+};
+
+struct profThread {
+    char name[32];
+    int index = 0;
+    uint64_t mask = 0;
+    profEvent* events = nullptr;
+    std::atomic<uint64_t> count{0};
+};
+
+// NOTE: the thread's buffer is only valid if the thread's generation
+// matches the global generation, the generation is bumped by Setup()
+ORYOL_THREADLOCAL_PTR(profThread) curThread = nullptr;
+ORYOL_THREADLOCAL_PTR(void) curGeneration = nullptr;
+std::atomic<intptr_t> generation{0};
+
+const char* frameName = "Frame";
+
+// NOTE: Clock::Now() only has microsecond resolution, which is
+// too coarse for short zones
+int64_t
+nowNanoSecs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct profState {
+    int eventsPerThread = 0;
+    int64_t startTime = 0;
+    Array<profThread*> threads;
+    std::atomic<int> numFrames{0};
+    std::mutex mutex;
+};
+profState* state = nullptr;
+std::atomic<bool> enabled{false};
+std::atomic<bool> valid{false};
+
+// number of threads which are currently writing into the profiler
+// state, Discard() waits until this has dropped to zero before
+// freeing the per-thread buffers
+std::atomic<int> numWriters{0};
+
+// enter the profiler for writing if flag is set, return false otherwise
+bool
+beginWrite(const std::atomic<bool>& flag) {
+    if (!flag.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    // NOTE: check the flag again after announcing the write,
+    // Discard() clears the flag before waiting for writers
+    numWriters++;
+    if (!flag) {
+        numWriters--;
+        return false;
+    }
+    return true;
+}
+
+// leave the profiler after writing
+void
+endWrite() {
+    numWriters.fetch_sub(1, std::memory_order_release);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+Profiler::Setup(int eventsPerThread) {
+    o_assert(!IsValid());
+    o_assert(eventsPerThread > 0);
+    state = Memory::New<profState>();
+    int num = 1;
+    while (num < eventsPerThread) {
+        num <<= 1;
+    }
+    state->eventsPerThread = num;
+    state->startTime = nowNanoSecs();
+    generation++;
+    valid = true;
+    enabled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::Discard() {
+    o_assert(IsValid());
+    // stop recording, and wait for threads which are still
+    // in the middle of writing an event
+    valid = false;
+    enabled = false;
+    while (numWriters > 0) {
+        std::this_thread::yield();
+    }
+    for (profThread* t : state->threads) {
+        Memory::Free(t->events);
+        Memory::Delete(t);
+    }
+    state->threads.Clear();
+    Memory::Delete(state);
+    state = nullptr;
+    curThread = nullptr;
+    curGeneration = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+Profiler::IsValid() {
+    return nullptr != state;
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::SetEnabled(bool b) {
+    o_assert_dbg(IsValid());
+    enabled = b;
+}
+
+//------------------------------------------------------------------------------
+bool
+Profiler::IsEnabled() {
+    return enabled;
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::Clear() {
+    o_assert_dbg(IsValid());
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (profThread* t : state->threads) {
+        t->count = 0;
+    }
+    state->numFrames = 0;
+}
+
+//------------------------------------------------------------------------------
+static profThread*
+registerThread() {
+    // NOTE: called on the first event of a thread
+    profThread* t = Memory::New<profThread>();
+    t->mask = state->eventsPerThread - 1;
+    t->events = (profEvent*) Memory::Alloc(state->eventsPerThread * sizeof(profEvent));
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        t->index = state->threads.Size();
+        state->threads.Add(t);
+    }
+    std::snprintf(t->name, sizeof(t->name), "Thread %d", t->index);
+    curThread = t;
+    curGeneration = (void*) generation.load();
+    return t;
+}
+
+//------------------------------------------------------------------------------
+static void
+record(Profiler::EventType type, const char* name) {
+    if (!beginWrite(enabled)) {
+        return;
+    }
+    profThread* t = curThread;
+    if ((nullptr == t) || ((void*)generation.load(std::memory_order_relaxed) != curGeneration)) {
+        t = registerThread();
+    }
+    const uint64_t n = t->count.load(std::memory_order_relaxed);
+    profEvent& e = t->events[n & t->mask];
+    e.name = name;
+    e.time = nowNanoSecs();
+    e.type = type;
+    t->count.store(n + 1, std::memory_order_release);
+    if (Profiler::FrameEnd == type) {
+        state->numFrames++;
+    }
+    endWrite();
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::Begin(const char* name) {
+    record(ZoneBegin, name);
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::End() {
+    record(ZoneEnd, nullptr);
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::BeginFrame() {
+    record(FrameBegin, frameName);
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::EndFrame() {
+    record(FrameEnd, nullptr);
+}
+
+//------------------------------------------------------------------------------
+void
+Profiler::SetThreadName(const char* name) {
+    o_assert_dbg(name);
+    if (!beginWrite(valid)) {
+        return;
+    }
+    profThread* t = curThread;
+    if ((nullptr == t) || ((void*)generation.load() != curGeneration)) {
+        t = registerThread();
+    }
+    std::strncpy(t->name, name, sizeof(t->name) - 1);
+    t->name[sizeof(t->name) - 1] = 0;
+    endWrite();
+}
+
+//------------------------------------------------------------------------------
+int
+Profiler::NumEvents() {
+    o_assert_dbg(IsValid());
+    std::lock_guard<std::mutex> lock(state->mutex);
+    uint64_t num = 0;
+    for (const profThread* t : state->threads) {
+        const uint64_t n = t->count.load(std::memory_order_acquire);
+        num += (n > t->mask) ? (t->mask + 1) : n;
+    }
+    return int(num);
+}
+
+//------------------------------------------------------------------------------
+int
+Profiler::NumFrames() {
+    o_assert_dbg(IsValid());
+    return state->numFrames;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Iterate over the valid events of a thread's ring buffer, skips zone-ends
+    without matching begin (because the begin has been overwritten), and
+    closes zones which are still open at the end.
+*/
+template<class FUNC> static void
+forEachEvent(const profThread* t, FUNC func) {
+    const uint64_t n = t->count.load(std::memory_order_acquire);
+    const uint64_t first = (n > t->mask) ? (n - t->mask - 1) : 0;
+    int depth = 0;
+    int64_t lastTime = 0;
+    for (uint64_t i = first; i < n; i++) {
+        const profEvent& e = t->events[i & t->mask];
+        lastTime = e.time;
+        if ((Profiler::ZoneBegin == e.type) || (Profiler::FrameBegin == e.type)) {
+            depth++;
+        }
+        else {
+            if (0 == depth) {
+                continue;
+            }
+            depth--;
+        }
+        func(e.type, e.name, e.time);
+    }
+    while (depth-- > 0) {
+        func(Profiler::ZoneEnd, nullptr, lastTime);
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+writeJSONString(FILE* fp, const char* str) {
+    std::fputc('"', fp);
+    for (const char* p = str; *p; p++) {
+        const char c = *p;
+        if (('"' == c) || ('\\' == c)) {
+            std::fputc('\\', fp);
+            std::fputc(c, fp);
+        }
+        else if (uint8_t(c) < 0x20) {
+            std::fprintf(fp, "\\u%04x", c);
+        }
+        else {
+            std::fputc(c, fp);
+        }
+    }
+    std::fputc('"', fp);
+}
+
+//------------------------------------------------------------------------------
+bool
+Profiler::WriteChromeTrace(const char* path) {
+    o_assert(IsValid());
+    o_assert_dbg(path);
+    FILE* fp = std::fopen(path, "wb");
+    if (nullptr == fp) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    const int64_t startTime = state->startTime;
+    bool first = true;
+    std::fputs("{\"traceEvents\":[\n", fp);
+    for (const profThread* t : state->threads) {
+        std::fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+            first ? "" : ",\n", t->index);
+        writeJSONString(fp, t->name);
+        std::fputs("}}", fp);
+        first = false;
+        int frameIndex = 0;
+        forEachEvent(t, [fp, t, startTime, &frameIndex](EventType type, const char* name, int64_t time) {
+            const double ts = double(time - startTime) / 1000.0;
+            if (ZoneBegin == type) {
+                std::fputs(",\n{\"name\":", fp);
+                writeJSONString(fp, name ? name : "?");
+                std::fprintf(fp, ",\"cat\":\"oryol\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", ts, t->index);
+            }
+            else if (FrameBegin == type) {
+                std::fprintf(fp, ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"frame\":%d}}",
+                    ts, t->index, frameIndex++);
+            }
+            else {
+                std::fprintf(fp, ",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", ts, t->index);
+            }
+        });
+    }
+    std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", fp);
+    const bool success = (0 == std::ferror(fp));
+    std::fclose(fp);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+static void
+writeVarInt(FILE* fp, uint64_t val) {
+    do {
+        uint8_t b = val & 0x7F;
+        val >>= 7;
+        if (val) {
+            b |= 0x80;
+        }
+        std::fputc(b, fp);
+    }
+    while (val);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeU32(FILE* fp, uint32_t val) {
+    uint8_t bytes[4] = { uint8_t(val), uint8_t(val >> 8), uint8_t(val >> 16), uint8_t(val >> 24) };
+    std::fwrite(bytes, 1, sizeof(bytes), fp);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeString(FILE* fp, const char* str) {
+    const int len = int(std::strlen(str));
+    o_assert_dbg(len < (1<<16));
+    uint8_t bytes[2] = { uint8_t(len), uint8_t(len >> 8) };
+    std::fwrite(bytes, 1, sizeof(bytes), fp);
+    std::fwrite(str, 1, len, fp);
+}
+
+//------------------------------------------------------------------------------
+bool
+Profiler::WriteBinary(const char* path) {
+    o_assert(IsValid());
+    o_assert_dbg(path);
+    FILE* fp = std::fopen(path, "wb");
+    if (nullptr == fp) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    // build the name table (zone names are identified by their pointer)
+    HashMap<const char*, int> nameIndices;
+    Array<const char*> names;
+    names.Add("");
+    nameIndices.Add(nullptr, 0);
+    for (const profThread* t : state->threads) {
+        forEachEvent(t, [&nameIndices, &names](EventType, const char* name, int64_t) {
+            if (name && !nameIndices.Contains(name)) {
+                nameIndices.Add(name, names.Size());
+                names.Add(name);
+            }
+        });
+    }
+
+    std::fwrite("ORYP", 1, 4, fp);
+    writeU32(fp, 1);
+    writeU32(fp, names.Size());
+    for (const char* name : names) {
+        writeString(fp, name);
+    }
+    writeU32(fp, state->threads.Size());
+    const int64_t startTime = state->startTime;
+    for (const profThread* t : state->threads) {
+        writeString(fp, t->name);
+        uint32_t numEvents = 0;
+        forEachEvent(t, [&numEvents](EventType, const char*, int64_t) {
+            numEvents++;
+        });
+        writeU32(fp, numEvents);
+        int64_t prevTime = startTime;
+        forEachEvent(t, [fp, &nameIndices, &prevTime](EventType type, const char* name, int64_t time) {
+            std::fputc(type, fp);
+            writeVarInt(fp, nameIndices[name]);
+            const int64_t delta = time - prevTime;
+            writeVarInt(fp, delta > 0 ? uint64_t(delta) : 0);
+            prevTime = time;
+        });
+    }
+    const bool success = (0 == std::ferror(fp));
+    std::fclose(fp);
+    return success;
+}
+
+} // namespace Oryol
@@ -0,0 +1,99 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Profiler
+    @ingroup Core
+    @brief built-in hierarchical CPU profiler
+
+    The Profiler records nested, named zones and frame markers with
+    nanosecond timestamps into per-thread ring buffers. Recording is
+    lock-free, each thread only writes into its own buffer (the buffer
+    is registered on the first recorded event). When a ring buffer is
+    full, the oldest events are overwritten.
+
+    The recorded events can be exported as Chrome trace-event JSON
+    (open in chrome://tracing or https://ui.perfetto.dev), or in a
+    compact binary format:
+
+        magic 'ORYP', u32 version
+        u32 numNames, numNames * (u16 len, chars)
+        u32 numThreads, per thread:
+            u16 nameLen, chars, u32 numEvents,
+            numEvents * (u8 type, varint nameIndex, varint deltaNanoSecs)
+
+    Timestamps in the binary format are deltas to the previous event of
+    the same thread (the first event is relative to Profiler::Setup()).
+
+    Normally the Profiler is not used directly, but through the o_trace
+    macros in Trace.h, which forward to the Profiler if Oryol is compiled
+    with ORYOL_PROFILING and ORYOL_NATIVE_PROFILER (cmake option).
+    The profile is then automatically written as Chrome trace JSON
+    on shutdown if the environment variable ORYOL_PROFILER_OUTPUT
+    contains a file path.
+
+    NOTE: export the profile only when no other threads are recording
+    (e.g. after SetEnabled(false)), otherwise the exported events
+    might be inconsistent. Discard() can be called while other threads
+    are still recording, it waits until they are done with their
+    current event before freeing the buffers.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+
+namespace Oryol {
+
+class Profiler {
+public:
+    /// default number of events per thread ring buffer
+    static const int DefaultEventsPerThread = 64 * 1024;
+    /// event types
+    enum EventType : uint8_t {
+        ZoneBegin = 0,
+        ZoneEnd,
+        FrameBegin,
+        FrameEnd,
+    };
+
+    /// setup the profiler with number of events per thread (rounded up to power of 2)
+    static void Setup(int eventsPerThread = DefaultEventsPerThread);
+    /// discard the profiler
+    static void Discard();
+    /// return true if the profiler has been setup
+    static bool IsValid();
+    /// enable or disable recording (default is enabled)
+    static void SetEnabled(bool b);
+    /// return true if recording is enabled
+    static bool IsEnabled();
+    /// clear all recorded events
+    static void Clear();
+
+    /// begin a named zone (name must have static lifetime)
+    static void Begin(const char* name);
+    /// end the current zone
+    static void End();
+    /// begin a frame
+    static void BeginFrame();
+    /// end a frame
+    static void EndFrame();
+    /// set the calling thread's name (shown in the trace viewer)
+    static void SetThreadName(const char* name);
+
+    /// get number of recorded events (in ring buffers) over all threads
+    static int NumEvents();
+    /// get number of recorded frames
+    static int NumFrames();
+
+    /// write Chrome trace-event JSON file
+    static bool WriteChromeTrace(const char* path);
+    /// write compact binary file
+    static bool WriteBinary(const char* path);
+
+    /// scoped zone helper
+    class Scope {
+    public:
+        Scope(const char* name) { Profiler::Begin(name); };
+        ~Scope() { Profiler::End(); };
+    };
+};
+
+} // namespace Oryol
@@ -3,39 +3,40 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Assertion.h"
+#include "Core/Trace.h"
+#include "Core/Threading/JobSystem.h"
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
-RunLoop::RunLoop() :
-curId(InvalidId)
-{
+RunLoop::RunLoop() {
     // empty
 }
 
 //------------------------------------------------------------------------------
 RunLoop::~RunLoop() {
-    // empty
+    o_assert_dbg(!this->running);
 }
 
 //------------------------------------------------------------------------------
 void
 RunLoop::Run() {
-    this->remCallbacks();
-    this->addCallbacks();
-    for (const auto& entry : this->callbacks) {
-        if (entry.Value().valid) {
-            entry.Value().func();
-        }
+    o_trace_scoped(RunLoop_Run);
+    o_assert_dbg(!this->running);
+    this->update();
+    this->running = true;
+    // call the serial callbacks between the parallel groups
+    int begin = 0;
+    for (const group& g : this->parallelGroups) {
+        this->runSerial(begin, g.begin);
+        this->runParallel(g.begin, g.end);
+        begin = g.end;
     }
-    this->remCallbacks();
-    this->addCallbacks();
-}
-
-//------------------------------------------------------------------------------
-bool
-RunLoop::HasCallback(Id id) const {
-    return this->callbacks.Contains(id) || this->toAdd.Contains(id);
+    this->runSerial(begin, this->funcs.Size());
+    this->running = false;
+    this->curIndex = InvalidIndex;
+    this->update();
 }
 
 //------------------------------------------------------------------------------
@@ -44,47 +45,267 @@ RunLoop::HasCallback(Id id) const {
  start or end of the Run function.
 */
 RunLoop::Id
-RunLoop::Add(Func func) {
-    Id newId = ++this->curId;
-    this->toAdd.Add(newId, item{func, false});
-    return newId;
+RunLoop::Add(Func func, Phase phase, int priority) {
+    return this->add(std::move(func), phase, priority, false);
+}
+
+//------------------------------------------------------------------------------
+RunLoop::Id
+RunLoop::AddParallel(Func func, Phase phase, int priority) {
+    return this->add(std::move(func), phase, priority, true);
+}
+
+//------------------------------------------------------------------------------
+RunLoop::Id
+RunLoop::add(Func func, Phase phase, int priority, bool parallel) {
+    o_assert_dbg(func);
+    o_assert2_dbg(!this->inParallelGroup, "RunLoop: parallel callbacks must not add callbacks!\n");
+    o_assert_range_dbg(phase, NumPhases);
+    const int handleIndex = this->allocHandle();
+    item newItem;
+    newItem.phase = phase;
+    newItem.priority = priority;
+    newItem.order = this->addCounter++;
+    newItem.handleIndex = handleIndex;
+    newItem.parallel = parallel;
+    this->handles[handleIndex].key = newItem;
+    this->pending.Add(newItem);
+    this->pendingFuncs.Add(std::move(func));
+    return Id((uint32_t(this->handles[handleIndex].generation) << 16) | uint32_t(handleIndex + 1));
+}
+
+//------------------------------------------------------------------------------
+static void
+noop() {
+    // empty
 }
 
 //------------------------------------------------------------------------------
 /**
- NOTE: the callback function not be removed immediately, but at the 
- start or end of the Run function.
+ NOTE: the callback function will not be called anymore, but it is only
+ destroyed at the start or end of the Run function.
 */
 void
 RunLoop::Remove(Id id) {
-    o_assert_dbg(!this->toRemove.Contains(id));
-    o_assert_dbg(this->callbacks.Contains(id) || this->toAdd.Contains(id));
-    this->toRemove.Add(id);
+    o_assert2_dbg(!this->inParallelGroup, "RunLoop: parallel callbacks must not remove callbacks!\n");
+    const int handleIndex = this->lookup(id);
+    o_assert_dbg(InvalidIndex != handleIndex);
+    if (InvalidIndex != handleIndex) {
+        handle& h = this->handles[handleIndex];
+        h.removed = true;
+        this->removedHandles.Add(handleIndex);
+        if (this->running && h.inserted) {
+            // a callback which hasn't been called yet in this frame is
+            // replaced with a no-op, so that the per-frame loop doesn't
+            // need to check for removed callbacks, the callable object
+            // is kept alive until the end of Run()
+            const int index = this->upperBound(h.key) - 1;
+            if (index > this->curIndex) {
+                this->removedFuncs.Add(std::move(this->funcs[index]));
+                this->funcs[index] = &noop;
+            }
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
-void
-RunLoop::addCallbacks() {
-    for (auto& entry : this->toAdd) {
-        item& item = entry.Value();
-        item.valid = true;
-        this->callbacks.Add(entry.Key(), item);
+bool
+RunLoop::HasCallback(Id id) const {
+    return InvalidIndex != this->lookup(id);
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::NumCallbacks() const {
+    return this->items.Size() + this->pending.Size() - this->removedHandles.Size();
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::lookup(Id id) const {
+    const int handleIndex = (id & 0xFFFF) - 1;
+    if ((handleIndex < 0) || (handleIndex >= this->handles.Size())) {
+        return InvalidIndex;
+    }
+    const handle& h = this->handles[handleIndex];
+    if (!h.used || h.removed || (h.generation != (uint32_t(id) >> 16))) {
+        return InvalidIndex;
+    }
+    return handleIndex;
+}
+
+//------------------------------------------------------------------------------
+bool
+RunLoop::less(const item& a, const item& b) {
+    if (a.phase != b.phase) {
+        return a.phase < b.phase;
+    }
+    else if (a.priority != b.priority) {
+        return a.priority < b.priority;
+    }
+    else if (a.parallel != b.parallel) {
+        // parallel callbacks run before serial callbacks of the same priority
+        return a.parallel;
     }
-    this->toAdd.Clear();
+    else {
+        return a.order < b.order;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::upperBound(const item& key) const {
+    int lo = 0;
+    int hi = this->items.Size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (less(key, this->items[mid])) {
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::allocHandle() {
+    int handleIndex;
+    if (!this->freeHandles.Empty()) {
+        handleIndex = this->freeHandles.PopBack();
+    }
+    else {
+        o_assert2(this->handles.Size() < MaxNumHandles, "RunLoop: too many callbacks!\n");
+        handleIndex = this->handles.Size();
+        this->handles.Add(handle());
+    }
+    this->handles[handleIndex].used = true;
+    return handleIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::freeHandle(int handleIndex) {
+    handle& h = this->handles[handleIndex];
+    h.used = false;
+    h.removed = false;
+    h.inserted = false;
+    // NOTE: generation must fit into 15 bits to keep Ids positive
+    h.generation = (h.generation < 0x7FFF) ? (h.generation + 1) : 1;
+    this->freeHandles.Add(handleIndex);
 }
 
 //------------------------------------------------------------------------------
+/**
+ Applies deferred removes and adds to the sorted callback array. The
+ position of a removed callback is found by binary search with the sort
+ key stored in its handle. Erase and Insert only move the elements on
+ the shorter side of the array, and the arrays keep their capacity, so
+ this doesn't allocate once the RunLoop has reached its working size.
+*/
 void
-RunLoop::remCallbacks() {
-    for (Id id : this->toRemove) {
-        if (this->callbacks.Contains(id)) {
-            this->callbacks.Erase(id);
+RunLoop::update() {
+    if (this->removedHandles.Empty() && this->pending.Empty()) {
+        return;
+    }
+
+    // drop removed callbacks, removed pending callbacks are dropped below
+    for (int handleIndex : this->removedHandles) {
+        const handle& h = this->handles[handleIndex];
+        if (h.inserted) {
+            // the item is the last one which isn't called after its own key
+            const int index = this->upperBound(h.key) - 1;
+            o_assert_dbg((index >= 0) && (this->items[index].handleIndex == handleIndex));
+            if (h.key.parallel) {
+                this->numParallel--;
+            }
+            this->freeHandle(handleIndex);
+            this->items.Erase(index);
+            this->funcs.Erase(index);
         }
-        else if (this->toAdd.Contains(id)) {
-            this->toAdd.Erase(id);
+    }
+    this->removedHandles.Clear();
+    this->removedFuncs.Clear();
+
+    // insert pending callbacks at their sorted position
+    for (int i = 0; i < this->pending.Size(); i++) {
+        const item& cur = this->pending[i];
+        handle& h = this->handles[cur.handleIndex];
+        if (h.removed) {
+            this->freeHandle(cur.handleIndex);
+        }
+        else {
+            const int index = this->upperBound(cur);
+            h.inserted = true;
+            if (cur.parallel) {
+                this->numParallel++;
+            }
+            this->items.Insert(index, cur);
+            this->funcs.Insert(index, std::move(this->pendingFuncs[i]));
+        }
+    }
+    this->pending.Clear();
+    this->pendingFuncs.Clear();
+
+    // find the parallel groups, a single parallel callback is
+    // called like a serial callback
+    this->parallelGroups.Clear();
+    if (0 == this->numParallel) {
+        return;
+    }
+    const int num = this->items.Size();
+    for (int begin = 0; begin < num; ) {
+        const item& first = this->items[begin];
+        int end = begin + 1;
+        if (first.parallel) {
+            while ((end < num) && this->items[end].parallel &&
+                   (this->items[end].phase == first.phase) &&
+                   (this->items[end].priority == first.priority)) {
+                end++;
+            }
+            if ((end - begin) > 1) {
+                this->parallelGroups.Add(group{ begin, end });
+            }
+        }
+        begin = end;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::runSerial(int begin, int end) {
+    // NOTE: callbacks may add or remove callbacks, this never resizes
+    // the funcs array (see Remove())
+    const Func* func = this->funcs.begin();
+    for (int i = begin; i < end; i++) {
+        this->curIndex = i;
+        func[i]();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::runParallel(int begin, int end) {
+    o_trace_scoped(RunLoop_RunParallel);
+    // NOTE: no callbacks can be added or removed while the group runs
+    this->curIndex = end - 1;
+    if (JobSystem::IsValid()) {
+        this->inParallelGroup = true;
+        JobSystem::ParallelFor(begin, end, 1, [this](int first, int last) {
+            for (int i = first; i < last; i++) {
+                this->funcs[i]();
+            }
+        });
+        this->inParallelGroup = false;
+    }
+    else {
+        const Func* func = this->funcs.begin();
+        for (int i = begin; i < end; i++) {
+            func[i]();
         }
     }
-    this->toRemove.Clear();
 }
 
 } // namespace Oryol
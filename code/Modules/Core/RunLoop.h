@@ -4,29 +4,58 @@
     @class Oryol::RunLoop
     @ingroup Core
     @brief universal run-loop object for on-frame callbacks
-    
-    A runloop object manages a priority-sorted array of callback 
-    functions which are called per-frame. By default, each thread
-    has a RunLoop object which can be configured through the Core facade
-    singleton. Runloops can be nested by adding the Run() function
-    of one runloop to another runloop. NOTE that priority values are
-    inverted, lower values are called first).
-    
-    Examples for constructing callbacks:
-    
+
+    A runloop object manages a sorted array of callback functions which
+    are called per-frame. By default, each thread has a RunLoop object
+    which can be configured through the Core facade singleton. Runloops
+    can be nested by adding the Run() function of one runloop to another
+    runloop.
+
+    Callbacks are sorted by phase (Early, Default, Late), then by
+    priority within a phase (NOTE that priority values are inverted,
+    lower values are called first), and finally by the order in which
+    they have been added.
+
+    Callbacks are Delegates which store the callable object inline, so
+    adding a callback doesn't allocate memory for the callable. Adding
+    and removing callbacks is deferred (O(1) for adding, O(log n) for
+    removing), the sorted callback array is only updated at the start
+    or end of Run(). A callback which is removed during Run() will not
+    be called anymore in the same frame, a callback which is added
+    during Run() will be called for the first time in the next frame.
+    The per-frame loop calls the contiguous callback array without
+    any per-callback checks.
+
+    Callbacks added with AddParallel() are independent tasks: all
+    parallel callbacks with the same phase and priority form a group
+    which runs before the serial callbacks of that priority. If the
+    JobSystem has been setup, the callbacks of a group are executed
+    concurrently on the JobSystem's worker threads (and the calling
+    thread), and the group is joined before the next callback is
+    called. Callbacks which depend on each other must thus either be
+    serial, or have different priorities or phases. Parallel callbacks
+    must be thread-safe, must not assume that they run on the thread
+    which owns the RunLoop, and must not add or remove callbacks.
+
+    Examples for adding callbacks:
+
     1. from C function myFunc():
 
-        Callback("name", pri, std::function<void()>(&myFunc);
+        runLoop->Add(&myFunc);
     2. from an object's method (careful, object must not go out-of-scope
-       as long as the callback is added to the RunLoop!
+       as long as the callback is added to the RunLoop!):
+
+        runLoop->Add([this]() { this->MyMethod(); });
+    3. into a specific phase with a priority:
 
-        MyClass myObj;<br>
-        Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+        runLoop->Add([this]() { this->MyMethod(); }, RunLoop::Late, 10);
+    4. as an independent task which may run on a worker thread:
+
+        runLoop->AddParallel([this]() { this->MyThreadSafeMethod(); });
 */
-#include <functional>
-#include "Core/RefCounted.h"
-#include "Core/String/StringAtom.h"
-#include "Core/Containers/Map.h"
+#include "Core/Types.h"
+#include "Core/Delegate.h"
+#include "Core/Containers/Array.h"
 
 namespace Oryol {
 
@@ -37,38 +66,91 @@ public:
     /// invalid runloop Id const
     static const Id InvalidId = 0;
     /// runloop function typedef
-    typedef std::function<void()> Func;
+    typedef Delegate<void()> Func;
+    /// callback phases, executed in this order
+    enum Phase {
+        Early = 0,
+        Default,
+        Late,
+
+        NumPhases,
+    };
 
     /// constructor
     RunLoop();
     /// destructor
     ~RunLoop();
-    
+
     /// run one frame
     void Run();
-    
-    /// add a callback to the run loop, higher priorities run earlier, slow!
-    Id Add(Func func);
-    /// remove a callback, slow!
-    void Remove(Id);
-    /// test if a callback has been attached, slow!
-    bool HasCallback(Id) const;
-    
+
+    /// add a callback to the run loop (lower priorities run earlier)
+    Id Add(Func func, Phase phase = Default, int priority = 0);
+    /// add an independent callback which may run concurrently with other parallel callbacks
+    Id AddParallel(Func func, Phase phase = Default, int priority = 0);
+    /// remove a callback
+    void Remove(Id id);
+    /// test if a callback has been attached (and not removed)
+    bool HasCallback(Id id) const;
+    /// get number of callbacks (including pending adds)
+    int NumCallbacks() const;
+
 private:
-    /// add new callbacks that have been added (called at beginning of Run())
-    void addCallbacks();
-    /// remove callbacks that have been removed (called at end of Run())
-    void remCallbacks();
-    
+    /// add a serial or parallel callback
+    Id add(Func func, Phase phase, int priority, bool parallel);
+    /// merge pending adds and removes into the callback array
+    void update();
+    /// call a range of serial callbacks
+    void runSerial(int begin, int end);
+    /// call a range of callbacks which form a parallel group
+    void runParallel(int begin, int end);
+    /// allocate a handle
+    int allocHandle();
+    /// free a handle
+    void freeHandle(int handleIndex);
+    /// lookup a handle index by id, return InvalidIndex if id is invalid or removed
+    int lookup(Id id) const;
+
+    // NOTE: the delegates are kept separate from their sort keys so
+    // that the per-frame loop only touches the delegates
     struct item {
-        Func func;
-        bool valid;
+        int phase = Default;
+        int priority = 0;
+        uint32_t order = 0;
+        int handleIndex = InvalidIndex;
+        bool parallel = false;
     };
-    
-    Id curId;
-    Map<Id, item> callbacks;
-    Map<Id, item> toAdd;
-    Set<Id> toRemove;
+    /// return true if item a must be called before item b
+    static bool less(const item& a, const item& b);
+    /// binary search for the first item which must be called after key
+    int upperBound(const item& key) const;
+    struct handle {
+        item key;
+        uint16_t generation = 1;
+        bool used = false;
+        bool removed = false;
+        bool inserted = false;
+    };
+    static const int MaxNumHandles = (1<<16) - 1;
+    struct group {
+        int begin;
+        int end;
+    };
+
+    Array<Func> funcs;
+    Array<item> items;
+    Array<Func> pendingFuncs;
+    Array<item> pending;
+    Array<handle> handles;
+    Array<int> freeHandles;
+    Array<int> removedHandles;
+    Array<Func> removedFuncs;
+    Array<group> parallelGroups;
+    int numParallel = 0;
+    int curIndex = InvalidIndex;
+    uint32_t addCounter = 0;
+    bool running = false;
+    bool inParallelGroup = false;
 };
-    
+
 } // namespace Oryol
@@ -6,8 +6,11 @@
     @brief immutable, unique strings for fast comparison
     
     A unique string, relatively slow on creation, but fast for comparison.
-    String atoms are stored in thread-local stringAtomTables and comparison
-    is fastest in the creator thread.
+    String atoms are interned in a single process-wide, sharded table,
+    so copying and comparing atoms is a pointer operation on all threads.
+    With ORYOL_STRINGATOM_CACHE=1, each thread keeps a lock-free lookup
+    cache in front of the global table, this helps if many threads
+    create atoms from strings at the same time.
     
     @see String
 */
@@ -28,7 +31,7 @@ public:
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const unsigned char* str);
-    /// copy-constructor (fast if rhs was created in same thread)
+    /// copy-constructor (FAST)
     StringAtom(const StringAtom& rhs);
     /// move-constructor
     StringAtom(StringAtom&& rhs);
@@ -50,7 +53,7 @@ public:
     bool operator==(const StringAtom& rhs) const;
     /// inequality operator (FAST)
     bool operator!=(const StringAtom& rhs) const;
-    /// less-than operator (for storing in sets and maps)
+    /// less-than operator (for storing in sets and maps, NOT alphabetical)
     bool operator<(const StringAtom& rhs) const;
     
     /// equality operator with raw string (SLOW!)
@@ -80,8 +83,6 @@ public:
     String AsString() const;
 
 private:
-    /// copy content
-    void copy(const StringAtom& rhs);
     /// setup from C string
     void setupFromCString(const char* str);
     
@@ -116,14 +117,15 @@ StringAtom::StringAtom(const unsigned char* rhs) {
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(const StringAtom& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const StringAtom& rhs) :
+data(rhs.data) {
+    // empty
 }
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(StringAtom&& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(StringAtom&& rhs) :
+data(rhs.data) {
     rhs.data = nullptr;
 }
 
@@ -136,18 +138,14 @@ StringAtom::~StringAtom() {
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(const StringAtom& rhs) {
-    if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
-    }
+    this->data = rhs.data;
 }
 
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(StringAtom&& rhs) {
     if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
+        this->data = rhs.data;
         rhs.data = nullptr;
     }
 }
@@ -166,19 +164,22 @@ StringAtom::operator=(const unsigned char* rhs) {
     this->setupFromCString((const char*)rhs);
 }
 
+//------------------------------------------------------------------------------
+inline bool
+StringAtom::operator==(const StringAtom& rhs) const {
+    // all atoms live in the same table, so equal strings have the same data pointer
+    return rhs.data == this->data;
+}
+
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator!=(const StringAtom& rhs) const {
-    return !operator==(rhs);
+    return rhs.data != this->data;
 }
 
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator<(const StringAtom& rhs) const {
-    if (rhs.data && this->data) {
-        // it is forbidden to compare string from different threads!
-        o_assert(this->data->table == rhs.data->table);
-    }
     return this->data < rhs.data;
 }
 
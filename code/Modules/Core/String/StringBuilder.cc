@@ -6,6 +6,7 @@
 #include <cstdio>
 #include "StringBuilder.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/FrameAllocator.h"
 
 #if ORYOL_WINDOWS
 #define o_strtok strtok_s
@@ -19,7 +20,8 @@ namespace Oryol {
 StringBuilder::StringBuilder() :
 buffer(0),
 capacity(0),
-size(0) {
+size(0),
+useFrameAllocator(false) {
     // empty
 }
 
@@ -62,13 +64,31 @@ StringBuilder() {
 //------------------------------------------------------------------------------
 StringBuilder::~StringBuilder() {
     if (0 != this->buffer) {
-        Memory::Free(this->buffer);
+        this->freeBuffer();
     }
     this->buffer = 0;
     this->capacity = 0;
     this->size = 0;
 }
 
+//------------------------------------------------------------------------------
+void
+StringBuilder::UseFrameAllocator() {
+    o_assert_dbg(0 == this->buffer);
+    this->useFrameAllocator = FrameAllocator::IsValid();
+}
+
+//------------------------------------------------------------------------------
+void
+StringBuilder::freeBuffer() {
+    if (this->useFrameAllocator) {
+        FrameAllocator::Free(this->buffer);
+    }
+    else {
+        Memory::Free(this->buffer);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 StringBuilder::ensureRoom(int numBytes) {
@@ -81,7 +101,20 @@ StringBuilder::ensureRoom(int numBytes) {
         // need to make room
         int growBy = (numBytes < minGrowSize) ? minGrowSize : numBytes;
         const int newCapacity = this->capacity + growBy;
-        char* newBuffer = (char*) Memory::Alloc(newCapacity);
+
+        // frame memory can grow in place if it is the most recent frame allocation
+        if (this->useFrameAllocator && this->buffer && FrameAllocator::Grow(this->buffer, newCapacity)) {
+            this->capacity = newCapacity;
+            return;
+        }
+
+        char* newBuffer;
+        if (this->useFrameAllocator) {
+            newBuffer = (char*) FrameAllocator::Alloc(newCapacity);
+        }
+        else {
+            newBuffer = (char*) Memory::Alloc(newCapacity);
+        }
         if (this->buffer) {
             // copy over old content and free old buffer
             #if ORYOL_WINDOWS
@@ -90,7 +123,7 @@ StringBuilder::ensureRoom(int numBytes) {
             #else
             std::strcpy(newBuffer, this->buffer);
             #endif
-            Memory::Free(this->buffer);
+            this->freeBuffer();
             this->buffer = 0;
         }
         else {
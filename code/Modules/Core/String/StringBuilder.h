@@ -8,6 +8,13 @@
     Use the StringBuilder methods to build, manipulate and inspect
     string data. Internally a StringBuilder object has a dynamic
     buffer which grows as needed, but never shrinks.
+
+    Call UseFrameAllocator() on a new StringBuilder to allocate its
+    buffer from the thread's FrameAllocator, this is meant for scratch
+    builders which live inside a single function. As long as the
+    builder's buffer is the most recent frame allocation it grows in
+    place and is rolled back on destruction. If the calling thread
+    has no frame allocator, the buffer comes from the heap.
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
@@ -34,6 +41,8 @@ public:
     /// destructor
     ~StringBuilder();
     
+    /// allocate the buffer from the thread's FrameAllocator (builder must be empty)
+    void UseFrameAllocator();
     /// reserve space (numBytes excludes the terminating 0 byte)
     void Reserve(int numBytes);
     /// get capacity
@@ -155,11 +164,14 @@ private:
     static int findSubString(const char* str, int startIndex, int endIndex, const char* subStr);
     /// internal formatting method
     bool format(int maxLength, bool append, const char* fmt, va_list args);
+    /// free the buffer, either to the heap or the frame allocator
+    void freeBuffer();
     
     static const int minGrowSize = 128;
     char* buffer;
     int capacity;
     int size;
+    bool useFrameAllocator;
 };
     
 } // namespace Oryol
@@ -34,8 +34,7 @@ stringAtomBuffer::allocChunk() {
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomBuffer::AddString(stringAtomTable* table, int32_t hash, const char* str) {
-    o_assert(nullptr != table);
+stringAtomBuffer::AddString(int32_t hash, const char* str) {
     o_assert(nullptr != str);
     
     // no chunks allocated yet?
@@ -55,7 +54,6 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32_t hash, const char* st
     
     // copy over data
     Header* head = (Header*) this->curPointer;
-    head->table = table;
     head->hash = hash;
     head->length = strLen;
     head->str  = (char*) this->curPointer + sizeof(Header);
@@ -4,72 +4,103 @@
 #include "Pre.h"
 #include <cstring>
 #include "stringAtomTable.h"
+#include "Core/Memory/MemoryTracker.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
 namespace Oryol {
 
-ORYOL_THREADLOCAL_PTR(stringAtomTable) stringAtomTable::ptr = nullptr;
+ORYOL_THREADLOCAL_PTR(stringAtomCache) stringAtomCache::ptr = nullptr;
+
+//------------------------------------------------------------------------------
+static stringAtomTable*
+createStringAtomTable() {
+    // NOTE: the table is never released, since StringAtom objects can
+    // live until the end of the program, thus memory leak detectors
+    // will complain about these allocations on program exit
+    #if ORYOL_USE_VLD
+    VLDDisable();
+    #endif
+    stringAtomTable* table = Memory::New<stringAtomTable>();
+    #if ORYOL_USE_VLD
+    VLDEnable();
+    #endif
+    return table;
+}
 
 //------------------------------------------------------------------------------
 stringAtomTable*
-stringAtomTable::threadLocalPtr() {
-    // NOTE: this object can never be released, even if a thread is left
-    // since StringAtom object can move to other threads, thus memory
-    // leak detectors will complain about these allocations on program
-    // exit
-    if (!ptr) {
-        #if ORYOL_USE_VLD
-        VLDDisable();
-        #endif
-        ptr = Memory::New<stringAtomTable>();
-        #if ORYOL_USE_VLD
-        VLDEnable();
-        #endif
-    }
-    return ptr;
+stringAtomTable::instance() {
+    // NOTE: initialization of function-local statics is thread-safe
+    static stringAtomTable* table = createStringAtomTable();
+    return table;
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Find(int32_t hash, const char* str) const {
+stringAtomTable::Find(int32_t hash, const char* str) {
     
     // need to create a temp object for searching in the set
-    stringAtomBuffer::Header dummyHead(this, hash, 0, str);
+    stringAtomBuffer::Header dummyHead(hash, 0, str);
     Entry dummyEntry(&dummyHead);
-    auto ptr = this->table.Find(dummyEntry);
-    if (nullptr == ptr) {
-        return nullptr;
-    }
-    else {
-        o_assert(nullptr != ptr->header);
-        return ptr->header;
-    }
+    shard& s = this->shards[shardIndex(hash)];
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(s.lock);
+    #endif
+    auto ptr = s.table.Find(dummyEntry);
+    return ptr ? ptr->header : nullptr;
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Add(int32_t hash, const char* str) {
-    
-    #if ORYOL_DEBUG
-    o_assert(nullptr == this->Find(hash, str));
-    #endif    
+stringAtomTable::FindOrAdd(int32_t hash, const char* str) {
+
     #if ORYOL_USE_VLD
     VLDDisable();
     #endif
+    o_memory_scope("StringAtom");
 
-    // add new string to the string buffer
-    const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
-    o_assert(nullptr != newHeader);
-    
-    // add new entry to our lookup table
-    this->table.Add(Entry(newHeader));
+    // lookup and add must happen under the same lock, since another
+    // thread might want to add the same string at the same time
+    const stringAtomBuffer::Header* header = nullptr;
+    stringAtomBuffer::Header dummyHead(hash, 0, str);
+    Entry dummyEntry(&dummyHead);
+    shard& s = this->shards[shardIndex(hash)];
+    #if ORYOL_HAS_THREADS
+    s.lock.lock();
+    #endif
+    auto ptr = s.table.Find(dummyEntry);
+    if (ptr) {
+        header = ptr->header;
+    }
+    else {
+        // add new string to the string buffer, and new entry to lookup table
+        header = s.buffer.AddString(hash, str);
+        o_assert(nullptr != header);
+        s.table.Add(Entry(header));
+    }
+    #if ORYOL_HAS_THREADS
+    s.lock.unlock();
+    #endif
 
     #if ORYOL_USE_VLD
     VLDEnable();
     #endif
-    return newHeader;
+    return header;
+}
+
+//------------------------------------------------------------------------------
+int
+stringAtomTable::Size() {
+    int size = 0;
+    for (shard& s : this->shards) {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(s.lock);
+        #endif
+        size += s.table.Size();
+    }
+    return size;
 }
 
 //------------------------------------------------------------------------------
@@ -124,6 +155,47 @@ stringAtomTable::Entry::operator<(const Entry& rhs) const {
     return std::strcmp(this->header->str, rhs.header->str) < 0;
 }
 
-} // namespace Oryol
+//------------------------------------------------------------------------------
+stringAtomCache*
+stringAtomCache::threadLocalPtr() {
+    if (!ptr) {
+        #if ORYOL_USE_VLD
+        VLDDisable();
+        #endif
+        ptr = Memory::New<stringAtomCache>();
+        #if ORYOL_USE_VLD
+        VLDEnable();
+        #endif
+    }
+    return ptr;
+}
 
+//------------------------------------------------------------------------------
+void
+stringAtomCache::discardThreadLocal() {
+    // NOTE: the cache only contains pointers into the global table,
+    // so it can safely be released when a thread is left
+    if (ptr) {
+        Memory::Delete<stringAtomCache>(ptr);
+        ptr = nullptr;
+    }
+}
 
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomCache::Find(int32_t hash, const char* str) const {
+    stringAtomBuffer::Header dummyHead(hash, 0, str);
+    stringAtomTable::Entry dummyEntry(&dummyHead);
+    auto ptr = this->table.Find(dummyEntry);
+    return ptr ? ptr->header : nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomCache::Add(const stringAtomBuffer::Header* header) {
+    o_assert_dbg(header);
+    o_memory_scope("StringAtom");
+    this->table.Add(stringAtomTable::Entry(header));
+}
+
+} // namespace Oryol
@@ -3,28 +3,44 @@
 /*
     private class, do not use
     
-    A thread-local StringAtom table.
+    The process-wide StringAtom table, and the optional thread-local
+    lookup cache in front of it.
+
+    The table is split into shards (selected by the string hash), each
+    shard has its own lock, string buffer and hash set, so that threads
+    creating atoms rarely contend. Since there's only one table, each
+    string is interned exactly once, and StringAtom comparison is a
+    pointer comparison on all threads.
+
+    With ORYOL_STRINGATOM_CACHE, each thread additionally keeps a
+    lock-free lookup cache of the atoms it has already seen.
 */
 #include "Core/Types.h"
+#include "Core/Config.h"
 #include "Core/String/stringAtomBuffer.h"
 #include "Core/Containers/HashSet.h"
 #include "Core/Threading/ThreadLocalPtr.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
 
 namespace Oryol {
 
 class stringAtomTable {
 public:
-    /// access to thread-local stringAtomTable (created on demand)
-    static stringAtomTable* threadLocalPtr();
+    /// number of shards, must be 2^N
+    static const int NumShards = 16;
+
+    /// access to the process-wide stringAtomTable (created on demand)
+    static stringAtomTable* instance();
     /// compute hash value for string
     static int32_t HashForString(const char* str);
-    /// find a matching buffer header in the table
-    const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
-    /// add a string to the atom table
-    const stringAtomBuffer::Header* Add(int32_t hash, const char* str);
-    
-private:
-    static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
+    /// find a matching buffer header in the table (thread-safe)
+    const stringAtomBuffer::Header* Find(int32_t hash, const char* str);
+    /// find a matching buffer header, or add the string if not found (thread-safe)
+    const stringAtomBuffer::Header* FindOrAdd(int32_t hash, const char* str);
+    /// get number of strings in the table (thread-safe)
+    int Size();
 
     /// a bucket entry
     struct Entry {
@@ -39,15 +55,48 @@ private:
         
         const stringAtomBuffer::Header* header;
     };
-    
     /// hash function for bucket entry
     struct Hasher {
         int32_t operator()(const Entry& e) const {
             return e.header->hash;
         };
     };
-    stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+
+private:
+    /// get shard index for a hash
+    static int shardIndex(int32_t hash);
+
+    struct shard {
+        #if ORYOL_HAS_THREADS
+        std::mutex lock;
+        #endif
+        stringAtomBuffer buffer;
+        HashSet<Entry, Hasher> table;
+        char pad[ORYOL_CACHELINE_SIZE];
+    };
+    shard shards[NumShards];
 };
 
+class stringAtomCache {
+public:
+    /// access to thread-local stringAtomCache (created on demand)
+    static stringAtomCache* threadLocalPtr();
+    /// destroy the calling thread's stringAtomCache (called from Core::LeaveThread)
+    static void discardThreadLocal();
+    /// find a matching buffer header in the cache
+    const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
+    /// add a header from the global table to the cache
+    void Add(const stringAtomBuffer::Header* header);
+
+private:
+    static ORYOL_THREADLOCAL_PTR(stringAtomCache) ptr;
+    HashSet<stringAtomTable::Entry, stringAtomTable::Hasher> table;
+};
+
+//------------------------------------------------------------------------------
+inline int
+stringAtomTable::shardIndex(int32_t hash) {
+    return int(uint32_t(hash) >> 28) & (NumShards - 1);
+}
+
 } // namespace Oryol
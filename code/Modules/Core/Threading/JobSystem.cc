@@ -0,0 +1,416 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Assertion.h"
+#include "Core/Trace.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/poolAllocator.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/workStealingDeque.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+namespace _priv {
+struct job {
+    JobSystem::JobFunc func;
+    JobCounter* counter = nullptr;
+    job* next = nullptr;
+};
+} // namespace _priv
+
+using namespace _priv;
+
+struct JobSystem::_state {
+    static const int MaxNumWorkers = 63;
+    static const int DequeCapacity = 4096;
+    static const int SharedQueueCapacity = 4096;
+    static const int NumIdleSpins = 64;
+    typedef workStealingDeque<job, DequeCapacity> deque;
+
+    int numWorkers = 0;
+    deque* deques[MaxNumWorkers + 1] = { };
+    MPMCQueue<job*> sharedQueue{SharedQueueCapacity};
+    poolAllocator<job> jobPool;
+    std::atomic<int> numQueued{0};
+    std::atomic<int> numSleeping{0};
+    std::atomic<bool> stopRequested{false};
+    #if ORYOL_HAS_THREADS
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondVar;
+    std::thread threads[MaxNumWorkers];
+    #endif
+};
+JobSystem::_state* JobSystem::state = nullptr;
+
+namespace {
+// NOTE: the thread index is stored as (index + 1) in a thread-local
+// pointer, so that a nullptr means 'not a job system thread'
+ORYOL_THREADLOCAL_PTR(void) curThreadIndex = nullptr;
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+JobCounter::JobCounter() :
+count(0),
+locked(false),
+waitingJobs(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+JobCounter::~JobCounter() {
+    o_assert2(0 == this->count, "JobCounter destroyed before its jobs have finished!\n");
+    while (this->locked.load(std::memory_order_acquire)) {
+        // spinning...
+    }
+    o_assert_dbg(nullptr == this->waitingJobs);
+}
+
+//------------------------------------------------------------------------------
+bool
+JobCounter::IsDone() const {
+    // NOTE: the finishing thread still holds the lock for a short
+    // time after the count has reached zero
+    return (0 == this->count.load(std::memory_order_acquire)) && !this->locked.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+int
+JobCounter::Value() const {
+    return this->count.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+JobCounter::lock() {
+    while (this->locked.exchange(true, std::memory_order_acquire)) {
+        // spinning...
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobCounter::unlock() {
+    this->locked.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Setup(int numWorkers) {
+    o_assert(!IsValid());
+    o_assert(Core::IsValid());
+    state = Memory::New<_state>();
+    #if ORYOL_HAS_THREADS
+    if (numWorkers < 0) {
+        numWorkers = int(std::thread::hardware_concurrency()) - 1;
+    }
+    if (numWorkers < 0) {
+        numWorkers = 0;
+    }
+    else if (numWorkers > _state::MaxNumWorkers) {
+        numWorkers = _state::MaxNumWorkers;
+    }
+    #else
+    numWorkers = 0;
+    #endif
+    state->numWorkers = numWorkers;
+    for (int i = 0; i <= numWorkers; i++) {
+        state->deques[i] = Memory::New<_state::deque>();
+    }
+    curThreadIndex = (void*) intptr_t(1);
+    #if ORYOL_HAS_THREADS
+    for (int i = 0; i < numWorkers; i++) {
+        state->threads[i] = std::thread(workerFunc, i + 1);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Discard() {
+    o_assert(IsValid());
+    o_assert(0 == ThreadIndex());
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(state->wakeMutex);
+        state->stopRequested = true;
+    }
+    state->wakeCondVar.notify_all();
+    for (int i = 0; i < state->numWorkers; i++) {
+        state->threads[i].join();
+    }
+    #endif
+    o_assert2(0 == state->numQueued, "JobSystem::Discard(): there are still unfinished jobs!\n");
+    for (int i = 0; i <= state->numWorkers; i++) {
+        Memory::Delete(state->deques[i]);
+    }
+    curThreadIndex = nullptr;
+    Memory::Delete(state);
+    state = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsValid() {
+    return nullptr != state;
+}
+
+//------------------------------------------------------------------------------
+int
+JobSystem::NumWorkers() {
+    o_assert_dbg(IsValid());
+    return state->numWorkers;
+}
+
+//------------------------------------------------------------------------------
+int
+JobSystem::ThreadIndex() {
+    void* p = curThreadIndex;
+    return p ? int(intptr_t(p) - 1) : InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Run(JobFunc func, JobCounter* counter) {
+    o_assert_dbg(IsValid());
+    if (counter) {
+        counter->count++;
+    }
+    job* j = state->jobPool.Create();
+    j->func = std::move(func);
+    j->counter = counter;
+    schedule(j);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::RunAfter(JobCounter* dependency, JobFunc func, JobCounter* counter) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(dependency && (dependency != counter));
+    if (counter) {
+        counter->count++;
+    }
+    job* j = state->jobPool.Create();
+    j->func = std::move(func);
+    j->counter = counter;
+    dependency->lock();
+    if (dependency->count.load(std::memory_order_relaxed) > 0) {
+        // park the job on the dependency, finish() will schedule it
+        j->next = dependency->waitingJobs;
+        dependency->waitingJobs = j;
+        dependency->unlock();
+    }
+    else {
+        dependency->unlock();
+        schedule(j);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Wait(JobCounter* counter) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(counter);
+    const int threadIndex = ThreadIndex();
+    while (!counter->IsDone()) {
+        job* j = findJob(threadIndex);
+        if (j) {
+            execute(j);
+        }
+        else {
+            #if ORYOL_HAS_THREADS
+            std::this_thread::yield();
+            #endif
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::ParallelFor(int begin, int end, int grainSize, RangeFunc func) {
+    o_assert_dbg(IsValid());
+    if (end <= begin) {
+        return;
+    }
+    const int num = end - begin;
+    if (grainSize <= 0) {
+        // about 4 chunks per thread
+        grainSize = num / (4 * (state->numWorkers + 1));
+        if (grainSize < 1) {
+            grainSize = 1;
+        }
+    }
+    if (num <= grainSize) {
+        func(begin, end);
+        return;
+    }
+    // run all but the first chunk as jobs, and the first chunk
+    // directly on the calling thread
+    JobCounter counter;
+    for (int chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin += grainSize) {
+        const int chunkEnd = (end - chunkBegin) > grainSize ? chunkBegin + grainSize : end;
+        Run([&func, chunkBegin, chunkEnd] {
+            func(chunkBegin, chunkEnd);
+        }, &counter);
+    }
+    func(begin, begin + grainSize);
+    Wait(&counter);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::schedule(job* j) {
+    // NOTE: numQueued is incremented before the job becomes visible,
+    // so that it never goes negative
+    state->numQueued++;
+    const int threadIndex = ThreadIndex();
+    bool queued = false;
+    if (InvalidIndex != threadIndex) {
+        queued = state->deques[threadIndex]->Push(j);
+    }
+    if (!queued) {
+        queued = state->sharedQueue.Enqueue(j);
+    }
+    if (queued) {
+        wakeWorker();
+    }
+    else {
+        // all queues are full, run the job right here
+        state->numQueued--;
+        execute(j);
+    }
+}
+
+//------------------------------------------------------------------------------
+job*
+JobSystem::findJob(int threadIndex) {
+    job* j = nullptr;
+    if (InvalidIndex != threadIndex) {
+        j = state->deques[threadIndex]->Pop();
+    }
+    if (!j && !state->sharedQueue.Dequeue(j)) {
+        j = nullptr;
+    }
+    if (!j) {
+        // try to steal from the other threads
+        const int numDeques = state->numWorkers + 1;
+        const int first = (InvalidIndex != threadIndex) ? threadIndex + 1 : 0;
+        for (int i = 0; i < numDeques; i++) {
+            const int victim = (first + i) % numDeques;
+            if (victim != threadIndex) {
+                j = state->deques[victim]->Steal();
+                if (j) {
+                    break;
+                }
+            }
+        }
+    }
+    if (j) {
+        state->numQueued--;
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execute(job* j) {
+    {
+        o_trace_scoped(JobSystem_Job);
+        j->func();
+    }
+    JobCounter* counter = j->counter;
+    state->jobPool.Destroy(j);
+    if (counter) {
+        finish(counter);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::finish(JobCounter* counter) {
+    job* waiting = nullptr;
+    counter->lock();
+    if (0 == --counter->count) {
+        waiting = counter->waitingJobs;
+        counter->waitingJobs = nullptr;
+    }
+    // NOTE: the counter may be destroyed by a waiting thread after this point
+    counter->unlock();
+    while (waiting) {
+        job* next = waiting->next;
+        waiting->next = nullptr;
+        schedule(waiting);
+        waiting = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::wakeWorker() {
+    #if ORYOL_HAS_THREADS
+    // NOTE: numQueued has been incremented (seq_cst) before, so either
+    // the worker sees the new job, or we see the sleeping worker
+    if (state->numSleeping > 0) {
+        // taking the lock guarantees that the worker is inside wait()
+        { std::lock_guard<std::mutex> lock(state->wakeMutex); }
+        state->wakeCondVar.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::workerFunc(int threadIndex) {
+    #if ORYOL_HAS_THREADS
+    Core::EnterThread();
+    o_trace_thread_name("JobWorker");
+    curThreadIndex = (void*) intptr_t(threadIndex + 1);
+    bool idle = true;
+    int numSpins = 0;
+    for (;;) {
+        job* j = findJob(threadIndex);
+        if (j) {
+            if (idle) {
+                Core::PreRunLoop()->Run();
+                idle = false;
+            }
+            execute(j);
+            numSpins = 0;
+            continue;
+        }
+        if (++numSpins < _state::NumIdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (!idle) {
+            Core::PostRunLoop()->Run();
+            idle = true;
+        }
+        {
+            std::unique_lock<std::mutex> lock(state->wakeMutex);
+            state->numSleeping++;
+            while ((state->numQueued <= 0) && !state->stopRequested) {
+                state->wakeCondVar.wait(lock);
+            }
+            state->numSleeping--;
+            if (state->stopRequested && (state->numQueued <= 0)) {
+                break;
+            }
+        }
+        numSpins = 0;
+    }
+    curThreadIndex = nullptr;
+    Core::LeaveThread();
+    #endif
+}
+
+} // namespace Oryol
@@ -0,0 +1,129 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSystem
+    @ingroup Core
+    @brief work-stealing job scheduler for spreading CPU work across cores
+
+    The JobSystem owns a pool of worker threads (by default one less
+    than the number of hardware threads, since the main thread also
+    executes jobs while it waits). Each worker, and the thread which
+    called Setup(), owns a work-stealing deque; jobs are pushed to the
+    calling thread's deque, and idle workers steal from the other
+    deques. Jobs submitted from any other thread go through a shared
+    lock-free queue.
+
+    Completion is tracked with JobCounter objects: Run() increments the
+    counter, and the counter is decremented when the job has finished.
+    Wait() executes pending jobs until the counter reaches zero, so
+    waiting never blocks a core. A job can be made dependent on a
+    counter with RunAfter(), the job will be scheduled once the
+    dependency counter has reached zero:
+
+    ```cpp
+    JobCounter decoded, built;
+    JobSystem::Run([]{ decodeTextures(); }, &decoded);
+    JobSystem::RunAfter(&decoded, []{ buildMeshes(); }, &built);
+    JobSystem::ParallelFor(0, numParticles, 1024, [](int begin, int end) {
+        updateParticles(begin, end);
+    });
+    JobSystem::Wait(&built);
+    ```
+
+    Worker threads call Core::EnterThread()/Core::LeaveThread(), so they
+    have their own RunLoops, FrameAllocator and StringAtom table. A worker
+    runs its PreRunLoop when it picks up work after being idle, and its
+    PostRunLoop before it goes to sleep, NOTE that this resets the worker's
+    FrameAllocator, so frame-allocated memory must not be handed out of a job.
+
+    Without ORYOL_HAS_THREADS (or with 0 workers), jobs are executed
+    by the setup thread inside Wait() and ParallelFor().
+
+    JobCounter objects must stay alive until they have been waited on.
+*/
+#include <atomic>
+#include <functional>
+#include "Core/Config.h"
+#include "Core/Types.h"
+
+namespace Oryol {
+
+namespace _priv {
+struct job;
+}
+
+class JobCounter {
+public:
+    /// constructor
+    JobCounter();
+    /// destructor (counter must be done)
+    ~JobCounter();
+
+    /// no copying
+    JobCounter(const JobCounter& rhs) = delete;
+    /// no copy-assignment
+    void operator=(const JobCounter& rhs) = delete;
+
+    /// return true if all jobs associated with the counter have finished
+    bool IsDone() const;
+    /// get number of unfinished jobs
+    int Value() const;
+
+private:
+    friend class JobSystem;
+    /// lock the counter
+    void lock();
+    /// unlock the counter
+    void unlock();
+
+    std::atomic<int> count;
+    std::atomic<bool> locked;
+    _priv::job* waitingJobs;
+};
+
+class JobSystem {
+public:
+    /// job function typedef
+    typedef std::function<void()> JobFunc;
+    /// ParallelFor range function typedef (called with [begin, end))
+    typedef std::function<void(int begin, int end)> RangeFunc;
+
+    /// setup the job system with number of workers (< 0: number of hardware threads - 1)
+    static void Setup(int numWorkers = -1);
+    /// discard the job system (all jobs must have finished)
+    static void Discard();
+    /// return true if the job system has been setup
+    static bool IsValid();
+    /// get number of worker threads
+    static int NumWorkers();
+    /// get index of calling thread (0: setup thread, 1..NumWorkers: workers, InvalidIndex: other threads)
+    static int ThreadIndex();
+
+    /// run a job, the optional counter is decremented when the job has finished
+    static void Run(JobFunc func, JobCounter* counter = nullptr);
+    /// run a job once the dependency counter has reached zero
+    static void RunAfter(JobCounter* dependency, JobFunc func, JobCounter* counter = nullptr);
+    /// execute pending jobs until counter has reached zero
+    static void Wait(JobCounter* counter);
+    /// split an index range into chunks, run them as jobs and wait for completion
+    static void ParallelFor(int begin, int end, int grainSize, RangeFunc func);
+
+private:
+    /// schedule a job on the calling thread's deque or the shared queue
+    static void schedule(_priv::job* j);
+    /// try to find a job for the thread with index
+    static _priv::job* findJob(int threadIndex);
+    /// execute a job and signal its counter
+    static void execute(_priv::job* j);
+    /// signal that a job associated with a counter has finished
+    static void finish(JobCounter* counter);
+    /// the worker thread function
+    static void workerFunc(int threadIndex);
+    /// wake up a sleeping worker if there is one
+    static void wakeWorker();
+
+    struct _state;
+    static _state* state;
+};
+
+} // namespace Oryol
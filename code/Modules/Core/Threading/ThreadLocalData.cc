@@ -5,6 +5,7 @@
 #include "ThreadLocalData.h"
 #include "Core/Memory/Memory.h"
 #include "Core/Assertion.h"
+#include <cstdlib>
 
 #if ORYOL_THREADLOCAL_PTHREAD
 namespace Oryol {
@@ -30,10 +31,9 @@ ThreadLocalData::PointerTable() {
     void** table = (void**) pthread_getspecific(key);
     if (0 == table) {
         // not assigned yet, allocate thread-specific table and
-        // associate with key
-        int tableSize = MaxNumSlots * sizeof(void*);
-        table = (void**) Memory::Alloc(tableSize);
-        Memory::Clear(table, tableSize);
+        // associate with key, NOTE: this doesn't go through Memory::Alloc
+        // since the MemoryTracker needs thread-local data itself
+        table = (void**) std::calloc(MaxNumSlots, sizeof(void*));
         pthread_setspecific(key, table);
     }
     return table;
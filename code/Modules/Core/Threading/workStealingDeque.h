@@ -0,0 +1,116 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::workStealingDeque
+    @ingroup _priv
+    @brief fixed-capacity Chase-Lev work-stealing deque of pointers
+
+    The owner thread pushes and pops at the bottom (LIFO), any other
+    thread can steal from the top (FIFO). Push() returns false if the
+    deque is full, Pop() and Steal() return nullptr if the deque is empty
+    (or, for Steal(), if another thread won the race for the last item).
+*/
+#include <atomic>
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE, int CAPACITY> class workStealingDeque {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "workStealingDeque: CAPACITY must be power of 2!");
+public:
+    /// constructor
+    workStealingDeque();
+
+    /// push an item at the bottom (owner thread only), return false if full
+    bool Push(TYPE* item);
+    /// pop an item from the bottom (owner thread only)
+    TYPE* Pop();
+    /// steal an item from the top (any thread)
+    TYPE* Steal();
+    /// return true if the deque looks empty (any thread)
+    bool Empty() const;
+
+private:
+    static const int padSize = ORYOL_CACHELINE_SIZE;
+    std::atomic<int64_t> top;
+    char pad0[padSize];
+    std::atomic<int64_t> bottom;
+    char pad1[padSize];
+    std::atomic<TYPE*> items[CAPACITY];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CAPACITY>
+workStealingDeque<TYPE, CAPACITY>::workStealingDeque() :
+top(0),
+bottom(0) {
+    for (int i = 0; i < CAPACITY; i++) {
+        this->items[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CAPACITY> bool
+workStealingDeque<TYPE, CAPACITY>::Push(TYPE* item) {
+    o_assert_dbg(item);
+    const int64_t b = this->bottom.load(std::memory_order_relaxed);
+    const int64_t t = this->top.load(std::memory_order_acquire);
+    if ((b - t) >= CAPACITY) {
+        return false;
+    }
+    this->items[b & (CAPACITY - 1)].store(item, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CAPACITY> TYPE*
+workStealingDeque<TYPE, CAPACITY>::Pop() {
+    // NOTE: bottom must be published before top is read, otherwise
+    // a thief and the owner could both take the last item
+    const int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_seq_cst);
+    if (t > b) {
+        // was empty
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    TYPE* item = this->items[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last item, race against thieves
+        if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            item = nullptr;
+        }
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CAPACITY> TYPE*
+workStealingDeque<TYPE, CAPACITY>::Steal() {
+    int64_t t = this->top.load(std::memory_order_seq_cst);
+    const int64_t b = this->bottom.load(std::memory_order_seq_cst);
+    if (t >= b) {
+        return nullptr;
+    }
+    TYPE* item = this->items[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return item;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CAPACITY> bool
+workStealingDeque<TYPE, CAPACITY>::Empty() const {
+    const int64_t t = this->top.load(std::memory_order_relaxed);
+    const int64_t b = this->bottom.load(std::memory_order_relaxed);
+    return t >= b;
+}
+
+} // namespace _priv
+} // namespace Oryol
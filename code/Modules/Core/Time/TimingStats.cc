@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+//  TimingStats.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TimingStats.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/String/StringBuilder.h"
+#include <cstdio>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+TimingStats::TimingStats(int windowSize_) :
+windowSize(windowSize_),
+frameTimes(windowSize_) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+void
+TimingStats::FrameTick() {
+    const bool first = (0 == this->lastFrame.getRaw());
+    Duration frameTime = Clock::LapTime(this->lastFrame);
+    if (!first) {
+        this->frameTimes.Add(frameTime);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TimingStats::AddFrameTime(Duration d) {
+    this->frameTimes.Add(d);
+}
+
+//------------------------------------------------------------------------------
+int
+TimingStats::findTiming(const StringAtom& name) const {
+    for (int i = 0; i < this->names.Size(); i++) {
+        if (this->names[i] == name) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+TimingStats::Add(const StringAtom& name, Duration d) {
+    o_assert_dbg(name.IsValid());
+    int index = this->findTiming(name);
+    if (InvalidIndex == index) {
+        index = this->names.Size();
+        this->names.Add(name);
+        this->timings.Add(TimingWindow(this->windowSize));
+    }
+    this->timings[index].Add(d);
+}
+
+//------------------------------------------------------------------------------
+void
+TimingStats::Clear() {
+    this->frameTimes.Clear();
+    for (TimingWindow& window : this->timings) {
+        window.Clear();
+    }
+    this->lastFrame = TimePoint();
+}
+
+//------------------------------------------------------------------------------
+const TimingWindow&
+TimingStats::FrameTimes() const {
+    return this->frameTimes;
+}
+
+//------------------------------------------------------------------------------
+bool
+TimingStats::Has(const StringAtom& name) const {
+    return InvalidIndex != this->findTiming(name);
+}
+
+//------------------------------------------------------------------------------
+const TimingWindow&
+TimingStats::Timings(const StringAtom& name) const {
+    const int index = this->findTiming(name);
+    o_assert(InvalidIndex != index);
+    return this->timings[index];
+}
+
+//------------------------------------------------------------------------------
+int
+TimingStats::NumTimings() const {
+    return this->names.Size();
+}
+
+//------------------------------------------------------------------------------
+const StringAtom&
+TimingStats::TimingName(int index) const {
+    return this->names[index];
+}
+
+//------------------------------------------------------------------------------
+static void
+appendCSVLine(StringBuilder& builder, const char* name, const TimingWindow& window) {
+    const TimingWindow::Summary s = window.Summarize();
+    builder.AppendFormat(256, "%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+        name, s.NumSamples,
+        s.Min.AsMilliSeconds(), s.Max.AsMilliSeconds(), s.Mean.AsMilliSeconds(),
+        s.P50.AsMilliSeconds(), s.P95.AsMilliSeconds(), s.P99.AsMilliSeconds());
+}
+
+//------------------------------------------------------------------------------
+String
+TimingStats::AsCSV() const {
+    StringBuilder builder;
+    builder.Append("name,samples,min_ms,max_ms,mean_ms,p50_ms,p95_ms,p99_ms\n");
+    appendCSVLine(builder, "frame", this->frameTimes);
+    for (int i = 0; i < this->names.Size(); i++) {
+        appendCSVLine(builder, this->names[i].AsCStr(), this->timings[i]);
+    }
+    return builder.GetString();
+}
+
+//------------------------------------------------------------------------------
+bool
+TimingStats::WriteCSV(const char* path) const {
+    o_assert_dbg(path);
+    FILE* fp = std::fopen(path, "wb");
+    if (nullptr == fp) {
+        return false;
+    }
+    const String csv = this->AsCSV();
+    const bool success = (size_t(csv.Length()) == std::fwrite(csv.AsCStr(), 1, csv.Length(), fp));
+    std::fclose(fp);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+void
+TimingStats::Dump() const {
+    auto dumpLine = [](const char* name, const TimingWindow& window) {
+        const TimingWindow::Summary s = window.Summarize();
+        Log::Info("  %-16s n=%4d min=%7.3f max=%7.3f mean=%7.3f p50=%7.3f p95=%7.3f p99=%7.3f ms\n",
+            name, s.NumSamples,
+            s.Min.AsMilliSeconds(), s.Max.AsMilliSeconds(), s.Mean.AsMilliSeconds(),
+            s.P50.AsMilliSeconds(), s.P95.AsMilliSeconds(), s.P99.AsMilliSeconds());
+    };
+    Log::Info("TimingStats:\n");
+    dumpLine("frame", this->frameTimes);
+    for (int i = 0; i < this->names.Size(); i++) {
+        dumpLine(this->names[i].AsCStr(), this->timings[i]);
+    }
+
+    // frame time histogram in 2ms buckets (last bucket is >= 40ms)
+    const int numBuckets = 21;
+    const Array<int> histogram = this->frameTimes.Histogram(Duration::FromMilliSeconds(2.0), numBuckets);
+    for (int i = 0; i < numBuckets; i++) {
+        if (histogram[i] > 0) {
+            Log::Info("  %s%2d ms: %d\n", (i == numBuckets - 1) ? ">=" : "  ", i * 2, histogram[i]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+TimingStats::Scope::Scope(TimingStats& stats_, const StringAtom& name_) :
+stats(stats_),
+name(name_),
+start(Clock::Now()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+TimingStats::Scope::~Scope() {
+    this->stats.Add(this->name, Clock::Since(this->start));
+}
+
+} // namespace Oryol
@@ -0,0 +1,97 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::TimingStats
+    @ingroup Core
+    @brief per-frame and named timing statistics
+    
+    TimingStats records frame durations and named user timings into
+    rolling TimingWindows, and reports min/max/mean/p50/p95/p99 and
+    histograms. The results can be queried from code (for instance to
+    check frame-pacing thresholds in automated tests), dumped to the
+    log, or written to a CSV file.
+
+    ```cpp
+    TimingStats stats;
+    ...
+    // once per frame:
+    stats.FrameTick();
+    {
+        TimingStats::Scope scope(stats, "Update");
+        ...
+    }
+    ...
+    Duration p99 = stats.FrameTimes().Summarize().P99;
+    stats.WriteCSV("timings.csv");
+    ```
+
+    The number of named timings is expected to be small (they are
+    looked up linearly).
+
+    @see TimingWindow, Clock
+*/
+#include "Core/Types.h"
+#include "Core/Time/Clock.h"
+#include "Core/Time/TimingWindow.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/String.h"
+
+namespace Oryol {
+    
+class TimingStats {
+public:
+    /// constructor with number of samples per window
+    TimingStats(int windowSize = TimingWindow::DefaultCapacity);
+
+    /// record the frame time since the previous call (ignores the first call)
+    void FrameTick();
+    /// explicitly add a frame time
+    void AddFrameTime(Duration d);
+    /// add a named timing sample
+    void Add(const StringAtom& name, Duration d);
+    /// clear all samples (keeps named timings)
+    void Clear();
+
+    /// get the frame time window
+    const TimingWindow& FrameTimes() const;
+    /// test if a named timing exists
+    bool Has(const StringAtom& name) const;
+    /// get a named timing window (must exist)
+    const TimingWindow& Timings(const StringAtom& name) const;
+    /// get number of named timings
+    int NumTimings() const;
+    /// get name of named timing by index
+    const StringAtom& TimingName(int index) const;
+
+    /// get statistics as CSV (one line per timing, in milliseconds)
+    String AsCSV() const;
+    /// write statistics as CSV file
+    bool WriteCSV(const char* path) const;
+    /// dump statistics and frame time histogram to the log
+    void Dump() const;
+
+    /// scoped timer helper, adds a named timing sample on destruction
+    class Scope {
+    public:
+        /// constructor
+        Scope(TimingStats& stats, const StringAtom& name);
+        /// destructor
+        ~Scope();
+    private:
+        TimingStats& stats;
+        StringAtom name;
+        TimePoint start;
+    };
+
+private:
+    /// find named timing index, or InvalidIndex
+    int findTiming(const StringAtom& name) const;
+
+    int windowSize;
+    TimePoint lastFrame;
+    TimingWindow frameTimes;
+    Array<StringAtom> names;
+    Array<TimingWindow> timings;
+};
+
+} // namespace Oryol
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//  TimingWindow.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TimingWindow.h"
+#include "Core/Assertion.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+TimingWindow::TimingWindow(int capacity_) :
+capacity(capacity_) {
+    o_assert(capacity_ > 0);
+    this->samples.Reserve(capacity_);
+}
+
+//------------------------------------------------------------------------------
+void
+TimingWindow::Add(Duration d) {
+    if (this->samples.Size() < this->capacity) {
+        this->samples.Add(d.getRaw());
+    }
+    else {
+        this->samples[this->head] = d.getRaw();
+        this->head = (this->head + 1) % this->capacity;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TimingWindow::Clear() {
+    this->samples.Clear();
+    this->head = 0;
+}
+
+//------------------------------------------------------------------------------
+int
+TimingWindow::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+int
+TimingWindow::NumSamples() const {
+    return this->samples.Size();
+}
+
+//------------------------------------------------------------------------------
+Duration
+TimingWindow::Sample(int index) const {
+    const int num = this->samples.Size();
+    o_assert_range_dbg(index, num);
+    return Duration(this->samples[(this->head + index) % num]);
+}
+
+//------------------------------------------------------------------------------
+Duration
+TimingWindow::Last() const {
+    o_assert_dbg(!this->samples.Empty());
+    return this->Sample(this->samples.Size() - 1);
+}
+
+//------------------------------------------------------------------------------
+void
+TimingWindow::sorted(Array<int64_t>& outSorted) const {
+    outSorted = this->samples;
+    std::sort(outSorted.begin(), outSorted.end());
+}
+
+//------------------------------------------------------------------------------
+Duration
+TimingWindow::percentile(const Array<int64_t>& sorted, double p) {
+    const int num = sorted.Size();
+    if (0 == num) {
+        return Duration();
+    }
+    int index = int(std::ceil((p / 100.0) * num)) - 1;
+    if (index < 0) {
+        index = 0;
+    }
+    else if (index >= num) {
+        index = num - 1;
+    }
+    return Duration(sorted[index]);
+}
+
+//------------------------------------------------------------------------------
+TimingWindow::Summary
+TimingWindow::Summarize() const {
+    Summary summary;
+    const int num = this->samples.Size();
+    if (0 == num) {
+        return summary;
+    }
+    Array<int64_t> sortedSamples;
+    this->sorted(sortedSamples);
+    int64_t sum = 0;
+    for (int64_t s : sortedSamples) {
+        sum += s;
+    }
+    summary.NumSamples = num;
+    summary.Min = Duration(sortedSamples[0]);
+    summary.Max = Duration(sortedSamples[num - 1]);
+    summary.Mean = Duration(sum / num);
+    summary.P50 = percentile(sortedSamples, 50.0);
+    summary.P95 = percentile(sortedSamples, 95.0);
+    summary.P99 = percentile(sortedSamples, 99.0);
+    return summary;
+}
+
+//------------------------------------------------------------------------------
+Duration
+TimingWindow::Percentile(double p) const {
+    o_assert_dbg((p >= 0.0) && (p <= 100.0));
+    Array<int64_t> sortedSamples;
+    this->sorted(sortedSamples);
+    return percentile(sortedSamples, p);
+}
+
+//------------------------------------------------------------------------------
+Array<int>
+TimingWindow::Histogram(Duration bucketWidth, int numBuckets) const {
+    o_assert(bucketWidth.getRaw() > 0);
+    o_assert(numBuckets > 0);
+    Array<int> buckets;
+    buckets.Reserve(numBuckets);
+    for (int i = 0; i < numBuckets; i++) {
+        buckets.Add(0);
+    }
+    const int64_t width = bucketWidth.getRaw();
+    for (int64_t s : this->samples) {
+        int64_t index = (s > 0) ? (s / width) : 0;
+        if (index >= numBuckets) {
+            index = numBuckets - 1;
+        }
+        buckets[int(index)]++;
+    }
+    return buckets;
+}
+
+} // namespace Oryol
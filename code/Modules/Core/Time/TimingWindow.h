@@ -0,0 +1,70 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::TimingWindow
+    @ingroup Core
+    @brief fixed-size rolling window of Durations with statistics
+    
+    A TimingWindow keeps the most recent N Durations (older samples
+    are overwritten) and computes min/max/mean and percentiles, and
+    bucketed histograms over the samples in the window. Percentiles
+    use the nearest-rank method.
+
+    @see TimingStats, Duration
+*/
+#include "Core/Types.h"
+#include "Core/Time/Duration.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+    
+class TimingWindow {
+public:
+    /// default number of samples in the window
+    static const int DefaultCapacity = 256;
+    /// statistics over the samples in the window
+    struct Summary {
+        int NumSamples = 0;
+        Duration Min;
+        Duration Max;
+        Duration Mean;
+        Duration P50;
+        Duration P95;
+        Duration P99;
+    };
+
+    /// constructor
+    TimingWindow(int capacity = DefaultCapacity);
+
+    /// add a sample (overwrites the oldest sample when the window is full)
+    void Add(Duration d);
+    /// clear all samples
+    void Clear();
+    /// get max number of samples
+    int Capacity() const;
+    /// get number of samples in the window
+    int NumSamples() const;
+    /// get the most recent sample (window must not be empty)
+    Duration Last() const;
+    /// get sample by age (0 is the oldest sample in the window)
+    Duration Sample(int index) const;
+
+    /// compute min/max/mean/percentiles
+    Summary Summarize() const;
+    /// compute a single percentile (0.0 .. 100.0)
+    Duration Percentile(double p) const;
+    /// compute a histogram, the last bucket also counts all larger samples
+    Array<int> Histogram(Duration bucketWidth, int numBuckets) const;
+
+private:
+    /// sort samples into scratch array
+    void sorted(Array<int64_t>& outSorted) const;
+    /// pick a percentile from sorted samples
+    static Duration percentile(const Array<int64_t>& sorted, double p);
+
+    int capacity;
+    int head = 0;
+    Array<int64_t> samples;
+};
+
+} // namespace Oryol
@@ -4,12 +4,19 @@
 #if ORYOL_PROFILING
 #include "Pre.h"
 #include "Trace.h"
+#if ORYOL_USE_NATIVE_PROFILER
+#include "Core/Log.h"
+#include <cstdlib>
+#endif
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
 Trace::Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_NATIVE_PROFILER
+    Profiler::Setup();
+    Profiler::SetThreadName("MainThread");
+    #elif ORYOL_USE_REMOTERY
     rmt_CreateGlobalInstance(&this->rmt);
     rmt_SetCurrentThreadName("MainThread");
     #elif ORYOL_USE_EMSCTRACE
@@ -19,7 +26,19 @@ Trace::Trace() {
 
 //------------------------------------------------------------------------------
 Trace::~Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_NATIVE_PROFILER
+    const char* path = std::getenv("ORYOL_PROFILER_OUTPUT");
+    if (path) {
+        Profiler::SetEnabled(false);
+        if (Profiler::WriteChromeTrace(path)) {
+            Log::Info("Trace: wrote %d profiler events to '%s'\n", Profiler::NumEvents(), path);
+        }
+        else {
+            Log::Warn("Trace: failed to write profiler events to '%s'\n", path);
+        }
+    }
+    Profiler::Discard();
+    #elif ORYOL_USE_REMOTERY
     rmt_DestroyGlobalInstance(this->rmt);
     this->rmt = nullptr;
     #elif ORYOL_USE_EMSCTRACE
@@ -6,16 +6,24 @@
     @brief tracing support when ORYOL_PROFILING is enabled
 
     This file implements various macros that hook Oryol into
-    profiling/tracing tools.
+    profiling/tracing tools. With ORYOL_NATIVE_PROFILER, the
+    built-in Profiler is used instead of Remotery, and the
+    profile is written as Chrome trace JSON to the path in the
+    environment variable ORYOL_PROFILER_OUTPUT on shutdown.
  */
 #include "Core/Types.h"
-#if ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
+#if ORYOL_NATIVE_PROFILER
+#define ORYOL_USE_NATIVE_PROFILER (1)
+#elif ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
 #define ORYOL_USE_REMOTERY (1)
 #endif
-#if ORYOL_EMSCRIPTEN
+#if ORYOL_EMSCRIPTEN && !ORYOL_NATIVE_PROFILER
 #define ORYOL_USE_EMSCTRACE (1)
 #endif
 
+#if ORYOL_USE_NATIVE_PROFILER
+#include "Core/Profiler.h"
+#endif
 #if ORYOL_USE_REMOTERY
 #include "Remotery.h"
 #endif
@@ -50,24 +58,34 @@ struct emscScopedTrace {
 #endif
     
 // trace macros
-#if ORYOL_USE_REMOTERY
+#if ORYOL_USE_NATIVE_PROFILER
+#define o_trace_begin_frame() Oryol::Profiler::BeginFrame()
+#define o_trace_end_frame() Oryol::Profiler::EndFrame()
+#define o_trace_begin(name) Oryol::Profiler::Begin(#name)
+#define o_trace_end() Oryol::Profiler::End()
+#define o_trace_scoped(name) Oryol::Profiler::Scope oryolProfilerScope##name(#name)
+#define o_trace_thread_name(name) Oryol::Profiler::SetThreadName(name)
+#elif ORYOL_USE_REMOTERY
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) rmt_BeginCPUSample(name)
 #define o_trace_end() rmt_EndCPUSample()
 #define o_trace_scoped(name) rmt_ScopedCPUSample(name)
+#define o_trace_thread_name(name) rmt_SetCurrentThreadName(name)
 #elif ORYOL_USE_EMSCTRACE
 #define o_trace_begin_frame() emscripten_trace_record_frame_start()
 #define o_trace_end_frame() emscripten_trace_record_frame_end()
 #define o_trace_begin(name) emscripten_trace_enter_context(#name)
 #define o_trace_end(name) emscripten_trace_exit_context()
 #define o_trace_scoped(name) emscScopedTrace emscScopedTrace##name(#name)
+#define o_trace_thread_name(name) ((void)0)
 #else
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #endif
 
 } // namespace Oryol
@@ -77,4 +95,5 @@ struct emscScopedTrace {
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #endif
@@ -341,3 +341,36 @@ TEST(ArrayTest) {
     CHECK(popArray.Front() == 2);
 }
 
+struct alignas(32) vec8 {
+    float f[8];
+};
+
+TEST(ArrayAlignmentTest) {
+
+    // default alignment is alignof(TYPE), even if bigger than the platform alignment
+    Array<vec8> array0;
+    CHECK(array0.GetAlignment() == 32);
+    for (int i = 0; i < 100; i++) {
+        array0.Add(vec8());
+        CHECK((intptr_t(array0.begin()) & 31) == 0);
+    }
+
+    // explicit alignment override, copy and move keep the alignment
+    Array<float> array1;
+    CHECK(array1.GetAlignment() == int(alignof(float)));
+    array1.SetAlignment(64);
+    for (int i = 0; i < 100; i++) {
+        array1.Add(float(i));
+    }
+    CHECK((intptr_t(array1.begin()) & 63) == 0);
+    Array<float> array2(array1);
+    CHECK(array2.GetAlignment() == 64);
+    CHECK((intptr_t(array2.begin()) & 63) == 0);
+    CHECK(array2[99] == 99.0f);
+    Array<float> array3(std::move(array2));
+    CHECK(array3.GetAlignment() == 64);
+    CHECK((intptr_t(array3.begin()) & 63) == 0);
+    array3.Trim();
+    CHECK((intptr_t(array3.begin()) & 63) == 0);
+    CHECK(array3[0] == 0.0f);
+}
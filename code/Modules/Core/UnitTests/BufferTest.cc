@@ -111,3 +111,87 @@ TEST(BufferTest) {
     CHECK(6 == buf4.Remove(0, 6));
     CHECK(std::strcmp((const char*)buf4.Data(), "wonderful world!") == 0);
 }
+
+TEST(BufferAlignmentTest) {
+    Buffer buf;
+    CHECK(buf.GetAlignment() == ORYOL_MAX_PLATFORM_ALIGN);
+    buf.SetAlignment(64);
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    for (int i = 0; i < 20; i++) {
+        buf.Add(bytes, sizeof(bytes));
+        CHECK((intptr_t(buf.Data()) & 63) == 0);
+    }
+    CHECK(buf.Data()[159] == 8);
+    Buffer buf1(std::move(buf));
+    CHECK(buf1.GetAlignment() == 64);
+    buf1.Add(bytes, sizeof(bytes));
+    CHECK((intptr_t(buf1.Data()) & 63) == 0);
+}
+
+TEST(BufferWrapTest) {
+    static const uint8_t bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    int numReleased = 0;
+    Buffer::ReleaseFunc releaseFunc = [&numReleased](const uint8_t* ptr, int numBytes) {
+        CHECK(ptr == bytes);
+        CHECK(numBytes == 8);
+        numReleased++;
+    };
+
+    // wrapping doesn't copy, releasing happens on destruction
+    {
+        Buffer buf;
+        buf.Wrap(bytes, sizeof(bytes), releaseFunc);
+        CHECK(buf.IsWrapped());
+        CHECK(buf.Data() == bytes);
+        CHECK(buf.Size() == 8);
+        CHECK(buf.Spare() == 0);
+        CHECK(numReleased == 0);
+    }
+    CHECK(numReleased == 1);
+
+    // moving transfers ownership of the release function
+    {
+        Buffer buf0;
+        buf0.Wrap(bytes, sizeof(bytes), releaseFunc);
+        Buffer buf1(std::move(buf0));
+        CHECK(!buf0.IsWrapped());
+        CHECK(buf1.IsWrapped());
+        CHECK(buf1.Data() == bytes);
+        Buffer buf2;
+        buf2 = std::move(buf1);
+        CHECK(buf2.Data() == bytes);
+        CHECK(numReleased == 1);
+    }
+    CHECK(numReleased == 2);
+
+    // modifying copies into owned memory and releases the wrapped memory
+    Buffer buf;
+    buf.Wrap(bytes, sizeof(bytes), releaseFunc);
+    buf.Add(bytes, 2);
+    CHECK(numReleased == 3);
+    CHECK(!buf.IsWrapped());
+    CHECK(buf.Data() != bytes);
+    CHECK(buf.Size() == 10);
+    CHECK(buf.Data()[7] == 8);
+    CHECK(buf.Data()[9] == 2);
+    buf.Wrap(bytes, sizeof(bytes), releaseFunc);
+    CHECK(2 == buf.Remove(0, 2));
+    CHECK(numReleased == 4);
+    CHECK(buf.Size() == 6);
+    CHECK(buf.Data()[0] == 3);
+    CHECK(bytes[0] == 1);
+    buf.Wrap(bytes, sizeof(bytes), releaseFunc);
+    buf.Clear();
+    CHECK(numReleased == 5);
+    CHECK(buf.Empty());
+    CHECK(!buf.IsWrapped());
+    buf.Add(bytes, 4);
+    CHECK(buf.Size() == 4);
+
+    // wrapping without release function
+    buf.Wrap(bytes, sizeof(bytes));
+    CHECK(buf.Data() == bytes);
+    buf.Wrap(bytes, 4);
+    CHECK(buf.Size() == 4);
+    CHECK(numReleased == 5);
+}
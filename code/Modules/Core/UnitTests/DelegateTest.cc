@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+//  DelegateTest.cc
+//  Test Delegate class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Delegate.h"
+#include "Core/Ptr.h"
+#include "Core/RefCounted.h"
+
+using namespace Oryol;
+
+static int freeFunc(int x) {
+    return x * 3;
+}
+
+class delegateTestObj : public RefCounted {
+    OryolClassDecl(delegateTestObj);
+public:
+    int value = 5;
+};
+
+//------------------------------------------------------------------------------
+TEST(DelegateTest) {
+    Delegate<int(int)> d0;
+    CHECK(!d0);
+    d0 = &freeFunc;
+    CHECK(d0);
+    CHECK(d0(2) == 6);
+
+    int offset = 10;
+    Delegate<int(int)> d1 = [offset](int x) { return x + offset; };
+    CHECK(d1(1) == 11);
+
+    // copy and move
+    Delegate<int(int)> d2(d1);
+    CHECK(d1(2) == 12);
+    CHECK(d2(2) == 12);
+    Delegate<int(int)> d3(std::move(d2));
+    CHECK(!d2);
+    CHECK(d3(3) == 13);
+    d2 = d0;
+    CHECK(d2(3) == 9);
+    d2 = std::move(d3);
+    CHECK(!d3);
+    CHECK(d2(4) == 14);
+    d2 = nullptr;
+    CHECK(!d2);
+
+    // captured objects are properly copied and destroyed
+    Ptr<delegateTestObj> obj = delegateTestObj::Create();
+    CHECK(obj->GetRefCount() == 1);
+    {
+        Delegate<int()> d4 = [obj]() { return obj->value; };
+        CHECK(obj->GetRefCount() == 2);
+        Delegate<int()> d5 = d4;
+        CHECK(obj->GetRefCount() == 3);
+        Delegate<int()> d6 = std::move(d5);
+        CHECK(obj->GetRefCount() == 3);
+        CHECK(d6() == 5);
+        d4 = nullptr;
+        CHECK(obj->GetRefCount() == 2);
+    }
+    CHECK(obj->GetRefCount() == 1);
+
+    // mutable state inside the delegate
+    int calls = 0;
+    Delegate<void()> d7 = [&calls]() { calls++; };
+    d7();
+    d7();
+    CHECK(calls == 2);
+}
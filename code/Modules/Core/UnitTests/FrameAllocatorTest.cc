@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//  FrameAllocatorTest.cc
+//  Test per-thread frame allocator.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/String/StringBuilder.h"
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocatorTest) {
+    CHECK(!FrameAllocator::IsValid());
+    FrameAllocator::Setup(1024);
+    CHECK(FrameAllocator::IsValid());
+    CHECK(FrameAllocator::Capacity() == 1024);
+    CHECK(FrameAllocator::NumBytesUsed() == 0);
+
+    // allocations are aligned and linear
+    uint8_t* p0 = (uint8_t*) FrameAllocator::Alloc(10);
+    uint8_t* p1 = (uint8_t*) FrameAllocator::Alloc(20);
+    CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN-1)) == 0);
+    CHECK((intptr_t(p1) & (ORYOL_MAX_PLATFORM_ALIGN-1)) == 0);
+    CHECK(p1 == p0 + Memory::RoundUp(10, ORYOL_MAX_PLATFORM_ALIGN));
+    CHECK(FrameAllocator::IsOwned(p0));
+    CHECK(FrameAllocator::IsOwned(p1));
+    int x = 0;
+    CHECK(!FrameAllocator::IsOwned(&x));
+
+    // freeing the most recent allocation rolls it back, others are no-ops
+    const int used = FrameAllocator::NumBytesUsed();
+    FrameAllocator::Free(p1);
+    CHECK(FrameAllocator::NumBytesUsed() < used);
+    FrameAllocator::Free(p0);
+    uint8_t* p2 = (uint8_t*) FrameAllocator::Alloc(20);
+    CHECK(p2 == p1);
+
+    // overflow into a new chunk, merged on reset
+    void* p3 = FrameAllocator::Alloc(2000);
+    CHECK(nullptr != p3);
+    CHECK(FrameAllocator::IsOwned(p3));
+    CHECK(FrameAllocator::Capacity() > 1024);
+    const int highWater = FrameAllocator::NumBytesUsed();
+    FrameAllocator::Reset();
+    CHECK(FrameAllocator::NumBytesUsed() == 0);
+    CHECK(FrameAllocator::FrameHighWaterMark() == highWater);
+    CHECK(FrameAllocator::HighWaterMark() == highWater);
+    CHECK(FrameAllocator::FrameNumHeapAllocs() == 1);
+
+    // the same frame again must not allocate from the heap
+    FrameAllocator::Alloc(10);
+    FrameAllocator::Alloc(20);
+    FrameAllocator::Alloc(2000);
+    FrameAllocator::Reset();
+    CHECK(FrameAllocator::FrameNumHeapAllocs() == 0);
+    CHECK(FrameAllocator::FrameHighWaterMark() == highWater);
+
+    // frame-allocated Array
+    {
+        Array<int> array;
+        array.UseFrameAllocator();
+        for (int i = 0; i < 100; i++) {
+            array.Add(i);
+        }
+        CHECK(array.Size() == 100);
+        CHECK(FrameAllocator::IsOwned(array.begin()));
+        for (int i = 0; i < 100; i++) {
+            CHECK(array[i] == i);
+        }
+        // the array grew in place, so no old storage was left behind
+        CHECK(FrameAllocator::NumBytesUsed() == Memory::RoundUp(array.Capacity() * int(sizeof(int)), ORYOL_MAX_PLATFORM_ALIGN));
+        // move keeps the frame allocation, the moved-from array uses the heap
+        Array<int> array1(std::move(array));
+        CHECK(FrameAllocator::IsOwned(array1.begin()));
+        array.Add(1);
+        CHECK(!FrameAllocator::IsOwned(array.begin()));
+        // copy goes to heap
+        Array<int> array2(array1);
+        CHECK(!FrameAllocator::IsOwned(array2.begin()));
+        CHECK(array2[99] == 99);
+    }
+
+    // frame-allocated Buffer
+    {
+        Buffer buf;
+        buf.UseFrameAllocator();
+        const uint8_t bytes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        const int used = FrameAllocator::NumBytesUsed();
+        buf.Add(bytes, sizeof(bytes));
+        buf.Add(bytes, sizeof(bytes));
+        CHECK(buf.Size() == 16);
+        CHECK(FrameAllocator::NumBytesUsed() == (used + Memory::RoundUp(16, ORYOL_MAX_PLATFORM_ALIGN)));
+        CHECK(FrameAllocator::IsOwned(buf.Data()));
+        CHECK(buf.Data()[15] == 8);
+    }
+    FrameAllocator::Reset();
+
+    // frame-allocated StringBuilder grows in place and is rolled back
+    {
+        StringBuilder builder;
+        builder.UseFrameAllocator();
+        for (int i = 0; i < 100; i++) {
+            builder.Append("0123456789");
+        }
+        CHECK(builder.Length() == 1000);
+        CHECK(FrameAllocator::IsOwned(builder.AsCStr()));
+        CHECK(FrameAllocator::NumBytesUsed() == Memory::RoundUp(builder.Capacity(), ORYOL_MAX_PLATFORM_ALIGN));
+        CHECK(builder.GetSubString(990, EndOfString) == "0123456789");
+    }
+    CHECK(FrameAllocator::NumBytesUsed() == 0);
+    FrameAllocator::Reset();
+    CHECK(FrameAllocator::FrameNumHeapAllocs() == 0);
+    FrameAllocator::Discard();
+    CHECK(!FrameAllocator::IsValid());
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocatorRunLoopTest) {
+    // Core::Setup() creates the frame allocator, and the post-frame
+    // runloop resets it
+    Core::Setup();
+    CHECK(FrameAllocator::IsValid());
+    FrameAllocator::Alloc(128);
+    CHECK(FrameAllocator::NumBytesUsed() == 128);
+    Core::PreRunLoop()->Run();
+    Core::PostRunLoop()->Run();
+    CHECK(FrameAllocator::NumBytesUsed() == 0);
+    CHECK(FrameAllocator::FrameHighWaterMark() == 128);
+    Core::Discard();
+    CHECK(!FrameAllocator::IsValid());
+}
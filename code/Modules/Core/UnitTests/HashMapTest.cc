@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality and performance.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/ArrayMap.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <string>
+
+using namespace Oryol;
+
+struct IdentityHasher {
+    uint32_t operator()(int val) {
+        return val;
+    };
+};
+
+struct StringHasher {
+    uint32_t operator()(const String& str) {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (const char* p = str.AsCStr(); *p; p++) {
+            hash = (hash ^ uint8_t(*p)) * 16777619u;
+        }
+        return hash;
+    };
+};
+
+//------------------------------------------------------------------------------
+TEST(HashMapTest) {
+
+    HashMap<int, int, IdentityHasher> map;
+    CHECK(map.Size() == 0);
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(nullptr == map.Find(1));
+    CHECK(map.begin() == map.end());
+
+    map.Add(1, 10);
+    map.Add(2, 20);
+    map.Add(3, 30);
+    CHECK(map.Size() == 3);
+    CHECK(!map.Empty());
+    CHECK(map.Capacity() == 16);
+    CHECK(map.Contains(1));
+    CHECK(map.Contains(2));
+    CHECK(map.Contains(3));
+    CHECK(!map.Contains(4));
+    CHECK(map[1] == 10);
+    CHECK(map[2] == 20);
+    CHECK(map[3] == 30);
+    map[2] = 22;
+    CHECK(*map.Find(2) == 22);
+    CHECK(!map.AddUnique(2, 33));
+    CHECK(map.AddUnique(4, 40));
+    CHECK(map.Size() == 4);
+
+    // iteration visits each element once
+    int keySum = 0;
+    int numElements = 0;
+    for (const auto& kvp : map) {
+        keySum += kvp.Key();
+        numElements++;
+    }
+    CHECK(keySum == 10);
+    CHECK(numElements == 4);
+
+    // erase
+    map.Erase(2);
+    CHECK(map.Size() == 3);
+    CHECK(!map.Contains(2));
+    CHECK(map[1] == 10);
+    CHECK(map[3] == 30);
+    CHECK(map[4] == 40);
+    map.Erase(2);
+    CHECK(map.Size() == 3);
+
+    // copy and move
+    HashMap<int, int, IdentityHasher> map1(map);
+    CHECK(map1.Size() == 3);
+    CHECK(map1[4] == 40);
+    HashMap<int, int, IdentityHasher> map2(std::move(map1));
+    CHECK(map1.Size() == 0);
+    CHECK(map1.Capacity() == 0);
+    CHECK(map2.Size() == 3);
+    CHECK(map2[3] == 30);
+    map1 = map2;
+    CHECK(map1.Size() == 3);
+    map1.Clear();
+    CHECK(map1.Empty());
+    CHECK(map1.Capacity() == 16);
+    CHECK(!map1.Contains(3));
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapGrowEraseTest) {
+
+    // many elements with colliding hashes, grow and erase
+    HashMap<int, int, IdentityHasher> map;
+    const int num = 10000;
+    for (int i = 0; i < num; i++) {
+        map.Add(i * 1024, i);
+    }
+    CHECK(map.Size() == num);
+    CHECK(map.Capacity() >= num);
+    bool allFound = true;
+    for (int i = 0; i < num; i++) {
+        const int* val = map.Find(i * 1024);
+        allFound &= (val && (*val == i));
+    }
+    CHECK(allFound);
+
+    // erase every other element, no tombstones are left behind
+    for (int i = 0; i < num; i += 2) {
+        map.Erase(i * 1024);
+    }
+    CHECK(map.Size() == num / 2);
+    bool valid = true;
+    for (int i = 0; i < num; i++) {
+        valid &= (map.Contains(i * 1024) == ((i & 1) != 0));
+    }
+    CHECK(valid);
+
+    // re-add, capacity must not change
+    const int capacity = map.Capacity();
+    for (int i = 0; i < num; i += 2) {
+        map.Add(i * 1024, i);
+    }
+    CHECK(map.Capacity() == capacity);
+    CHECK(map.Size() == num);
+
+    // Reserve avoids rehashing
+    HashMap<int, int> map1;
+    map1.Reserve(1000);
+    const int reservedCapacity = map1.Capacity();
+    for (int i = 0; i < 1000; i++) {
+        map1.Add(i, i);
+    }
+    CHECK(map1.Capacity() == reservedCapacity);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapStringTest) {
+
+    // non-POD keys and values
+    HashMap<String, String, StringHasher> map;
+    for (int i = 0; i < 1000; i++) {
+        String str = String(std::to_string(i).c_str());
+        map.Add(str, str);
+    }
+    CHECK(map.Size() == 1000);
+    CHECK(map["123"] == "123");
+    for (int i = 0; i < 1000; i += 3) {
+        map.Erase(String(std::to_string(i).c_str()));
+    }
+    CHECK(!map.Contains("123"));
+    CHECK(map["124"] == "124");
+    map.Clear();
+    CHECK(map.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapBenchmark) {
+
+    for (int num = 1000; num <= 1000000; num *= 10) {
+        std::chrono::time_point<std::chrono::system_clock> start, end;
+        std::chrono::duration<double> hashMapAdd, hashMapFind, mapAdd, mapFind;
+        int sum = 0;
+
+        // pseudo-random keys
+        Array<int> keys;
+        keys.Reserve(num);
+        uint32_t x = 12345;
+        for (int i = 0; i < num; i++) {
+            x = x * 1664525 + 1013904223;
+            keys.Add(int(x >> 1));
+        }
+
+        HashMap<int, int> hashMap;
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < num; i++) {
+            hashMap.AddUnique(keys[i], i);
+        }
+        end = std::chrono::system_clock::now();
+        hashMapAdd = end - start;
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < num; i++) {
+            sum += *hashMap.Find(keys[i]);
+        }
+        end = std::chrono::system_clock::now();
+        hashMapFind = end - start;
+
+        // NOTE: Map uses bulk-mode, single Add() is O(N) per element
+        Map<int, int> map;
+        start = std::chrono::system_clock::now();
+        map.BeginBulk();
+        for (int i = 0; i < num; i++) {
+            map.AddBulk(keys[i], i);
+        }
+        map.EndBulk();
+        end = std::chrono::system_clock::now();
+        mapAdd = end - start;
+        start = std::chrono::system_clock::now();
+        for (int i = 0; i < num; i++) {
+            sum += map.ValueAtIndex(map.FindIndex(keys[i]));
+        }
+        end = std::chrono::system_clock::now();
+        mapFind = end - start;
+        Log::Info("%d entries: HashMap add %f find %f sec, Map (bulk) add %f find %f sec\n",
+            num, hashMapAdd.count(), hashMapFind.count(), mapAdd.count(), mapFind.count());
+
+        // ArrayMap inserts are O(N), only test small sizes
+        if (num <= 10000) {
+            ArrayMap<int, int> arrayMap;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < num; i++) {
+                if (!arrayMap.Contains(keys[i])) {
+                    arrayMap.Add(keys[i], i);
+                }
+            }
+            end = std::chrono::system_clock::now();
+            std::chrono::duration<double> arrayMapAdd = end - start;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < num; i++) {
+                sum += arrayMap[keys[i]];
+            }
+            end = std::chrono::system_clock::now();
+            std::chrono::duration<double> arrayMapFind = end - start;
+            Log::Info("%d entries: ArrayMap add %f find %f sec\n", num, arrayMapAdd.count(), arrayMapFind.count());
+        }
+        CHECK(sum != 0);
+    }
+}
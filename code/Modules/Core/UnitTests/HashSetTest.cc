@@ -16,9 +16,7 @@ struct IntHasher {
 
 TEST(HashSetTest) {
     
-    HashSet<int, IntHasher, 4> hashSet;
-    CHECK(hashSet.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
-    CHECK(hashSet.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    HashSet<int, IntHasher> hashSet;
     CHECK(hashSet.Size() == 0);
     CHECK(hashSet.Empty());
     CHECK(!hashSet.Contains(2));
@@ -45,7 +43,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet.Contains(123));
     
     // copy-construction
-    HashSet<int, IntHasher, 4> hashSet1(hashSet);
+    HashSet<int, IntHasher> hashSet1(hashSet);
     CHECK(hashSet1.Size() == 8);
     CHECK(!hashSet1.Empty());
     CHECK(hashSet1.Contains(1));
@@ -59,7 +57,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet1.Contains(123));
     
     // copy-assignment
-    HashSet<int, IntHasher, 4> hashSet2;
+    HashSet<int, IntHasher> hashSet2;
     hashSet2 = hashSet;
     CHECK(hashSet2.Size() == 8);
     CHECK(!hashSet2.Empty());
@@ -74,7 +72,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet2.Contains(123));
     
     // move-construction
-    HashSet<int, IntHasher, 4> hashSet3(std::move(hashSet2));
+    HashSet<int, IntHasher> hashSet3(std::move(hashSet2));
     CHECK(hashSet2.Size() == 0);
     CHECK(hashSet2.Empty());
     CHECK(hashSet3.Size() == 8);
@@ -90,7 +88,7 @@ TEST(HashSetTest) {
     CHECK(!hashSet3.Contains(123));
     
     // move-assignment
-    HashSet<int, IntHasher, 4> hashSet4;
+    HashSet<int, IntHasher> hashSet4;
     hashSet4 = std::move(hashSet3);
     CHECK(hashSet3.Size() == 0);
     CHECK(hashSet3.Empty());
@@ -137,3 +135,37 @@ TEST(HashSetTest) {
     CHECK(hashSet4.Size() == 0);
     CHECK(!hashSet4.Contains(10));
 }
+
+TEST(HashSetGrowTest) {
+
+    // the set grows and rehashes as needed
+    HashSet<int> hashSet;
+    CHECK(hashSet.Capacity() == 0);
+    for (int i = 0; i < 100000; i++) {
+        hashSet.Add(i * 3);
+    }
+    CHECK(hashSet.Size() == 100000);
+    CHECK(hashSet.Capacity() >= 100000);
+    bool valid = true;
+    for (int i = 0; i < 300000; i++) {
+        valid &= hashSet.Contains(i) == ((i % 3) == 0);
+    }
+    CHECK(valid);
+    CHECK(!hashSet.AddUnique(3));
+    CHECK(hashSet.AddUnique(4));
+    CHECK(*hashSet.Find(4) == 4);
+
+    // iteration
+    int64_t sum = 0;
+    int num = 0;
+    for (int val : hashSet) {
+        sum += val;
+        num++;
+    }
+    CHECK(num == 100001);
+    CHECK(sum == (int64_t(3) * 99999 * 100000 / 2) + 4);
+
+    hashSet.Clear();
+    CHECK(hashSet.Empty());
+    CHECK(!hashSet.Contains(3));
+}
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test the JobSystem.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Log.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static void
+testJobSystem(int numWorkers) {
+    Core::Setup();
+    JobSystem::Setup(numWorkers);
+    CHECK(JobSystem::IsValid());
+    CHECK(JobSystem::NumWorkers() == numWorkers);
+    CHECK(JobSystem::ThreadIndex() == 0);
+
+    // simple jobs with a counter
+    std::atomic<int> num(0);
+    JobCounter counter;
+    CHECK(counter.IsDone());
+    for (int i = 0; i < 10000; i++) {
+        JobSystem::Run([&num] { num++; }, &counter);
+    }
+    JobSystem::Wait(&counter);
+    CHECK(counter.IsDone());
+    CHECK(num == 10000);
+
+    // a chain of dependent jobs must run in order
+    Array<int> order;
+    JobCounter c0, c1, c2;
+    JobSystem::RunAfter(&c1, [&order] { order.Add(2); }, &c2);
+    JobSystem::RunAfter(&c0, [&order] { order.Add(1); }, &c1);
+    JobSystem::Run([&order] { order.Add(0); }, &c0);
+    JobSystem::Wait(&c2);
+    CHECK(c0.IsDone() && c1.IsDone() && c2.IsDone());
+    CHECK(order.Size() == 3);
+    CHECK((order[0] == 0) && (order[1] == 1) && (order[2] == 2));
+
+    // a dependency which is already done
+    JobCounter c3;
+    num = 0;
+    JobSystem::RunAfter(&c0, [&num] { num++; }, &c3);
+    JobSystem::Wait(&c3);
+    CHECK(num == 1);
+
+    // jobs which spawn and wait for other jobs
+    num = 0;
+    JobCounter outer;
+    for (int i = 0; i < 64; i++) {
+        JobSystem::Run([&num] {
+            CHECK(JobSystem::ThreadIndex() != InvalidIndex);
+            JobCounter inner;
+            for (int j = 0; j < 64; j++) {
+                JobSystem::Run([&num] { num++; }, &inner);
+            }
+            JobSystem::Wait(&inner);
+        }, &outer);
+    }
+    JobSystem::Wait(&outer);
+    CHECK(num == 64 * 64);
+
+    // ParallelFor must visit each index exactly once
+    const int numItems = 100000;
+    Array<int> items;
+    items.Reserve(numItems);
+    for (int i = 0; i < numItems; i++) {
+        items.Add(0);
+    }
+    JobSystem::ParallelFor(0, numItems, 1000, [&items](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            items[i]++;
+        }
+    });
+    JobSystem::ParallelFor(0, numItems, 0, [&items](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            items[i]++;
+        }
+    });
+    JobSystem::ParallelFor(5, 5, 0, [&items](int begin, int end) {
+        items[begin]++;
+    });
+    bool allTwo = true;
+    for (int i = 0; i < numItems; i++) {
+        allTwo &= (2 == items[i]);
+    }
+    CHECK(allTwo);
+
+    #if ORYOL_HAS_THREADS
+    // jobs submitted from a thread outside the job system
+    num = 0;
+    std::thread thread([&num] {
+        CHECK(JobSystem::ThreadIndex() == InvalidIndex);
+        JobCounter c;
+        for (int i = 0; i < 1000; i++) {
+            JobSystem::Run([&num] { num++; }, &c);
+        }
+        JobSystem::Wait(&c);
+    });
+    thread.join();
+    CHECK(num == 1000);
+    #endif
+
+    JobSystem::Discard();
+    CHECK(!JobSystem::IsValid());
+    CHECK(JobSystem::ThreadIndex() == InvalidIndex);
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+    testJobSystem(0);
+    #if ORYOL_HAS_THREADS
+    testJobSystem(1);
+    testJobSystem(4);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemBenchmark) {
+    // run a CPU-heavy per-item update serially and with ParallelFor
+    Core::Setup();
+    JobSystem::Setup();
+    const int numItems = 1 << 20;
+    Array<float> items;
+    items.Reserve(numItems);
+    for (int i = 0; i < numItems; i++) {
+        items.Add(float(i));
+    }
+    auto update = [&items](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            float f = items[i];
+            for (int j = 0; j < 16; j++) {
+                f = std::sqrt(f * f + 1.0f);
+            }
+            items[i] = f;
+        }
+    };
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    update(0, numItems);
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> serialDur = end - start;
+
+    start = std::chrono::system_clock::now();
+    JobSystem::ParallelFor(0, numItems, 4096, update);
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> parallelDur = end - start;
+
+    Log::Info("JobSystemBenchmark: %d items, serial: %f sec, ParallelFor with %d workers: %f sec\n",
+        numItems, serialDur.count(), JobSystem::NumWorkers(), parallelDur.count());
+    JobSystem::Discard();
+    Core::Discard();
+}
@@ -0,0 +1,317 @@
+//------------------------------------------------------------------------------
+//  LockFreeQueueTest.cc
+//  Test SPSCQueue, MPMCQueue and BlockingQueue.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Containers/BlockingQueue.h"
+#include "Core/Containers/Queue.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Log.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <chrono>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static String
+toString(int i) {
+    StringBuilder builder;
+    builder.Format(32, "%d", i);
+    return builder.GetString();
+}
+
+//------------------------------------------------------------------------------
+template<class QUEUE> void
+testSingleThreaded(QUEUE& queue) {
+    CHECK(queue.Capacity() == 16);
+    CHECK(queue.Empty());
+    CHECK(queue.Size() == 0);
+    String str;
+    CHECK(!queue.Dequeue(str));
+
+    // fill up, wrap around a couple of times
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 16; i++) {
+            CHECK(queue.Enqueue(toString(round * 100 + i)));
+        }
+        CHECK(queue.Size() == 16);
+        CHECK(!queue.Enqueue(String("full")));
+        for (int i = 0; i < 16; i++) {
+            CHECK(queue.Dequeue(str));
+            CHECK(str == toString(round * 100 + i));
+        }
+        CHECK(queue.Empty());
+        CHECK(!queue.Dequeue(str));
+    }
+
+    // copy-enqueue, and leave some elements in the queue for the destructor
+    const String abc("abc");
+    CHECK(queue.Enqueue(abc));
+    CHECK(queue.Enqueue(abc));
+    CHECK(abc == "abc");
+    CHECK(queue.Size() == 2);
+}
+
+//------------------------------------------------------------------------------
+TEST(SPSCQueueTest) {
+    SPSCQueue<String> queue(13);
+    testSingleThreaded(queue);
+    SPSCQueue<int> queue1(1);
+    CHECK(queue1.Capacity() == 1);
+    CHECK(queue1.Enqueue(1));
+    CHECK(!queue1.Enqueue(2));
+}
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueTest) {
+    MPMCQueue<String> queue(16);
+    testSingleThreaded(queue);
+}
+
+//------------------------------------------------------------------------------
+TEST(BlockingQueueTest) {
+    BlockingQueue<String> queue(16);
+    testSingleThreaded(queue);
+    String str;
+    CHECK(queue.WaitDequeue(str));
+    CHECK(queue.WaitDequeue(str, Duration::FromMilliSeconds(1.0)));
+    CHECK(!queue.WaitDequeue(str, Duration::FromMilliSeconds(1.0)));
+    queue.Close();
+    CHECK(queue.IsClosed());
+    CHECK(!queue.WaitDequeue(str));
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(SPSCQueueStressTest) {
+    // one producer, one consumer, the consumer checks the element order
+    const int num = 1000000;
+    SPSCQueue<int> queue(256);
+    int numErrors = 0;
+    std::thread consumer([&queue, &numErrors] {
+        int expected = 0;
+        int val;
+        while (expected < num) {
+            if (queue.Dequeue(val)) {
+                if (val != expected) {
+                    numErrors++;
+                }
+                expected++;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (int i = 0; i < num; ) {
+        if (queue.Enqueue(i)) {
+            i++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    CHECK(0 == numErrors);
+    CHECK(queue.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueStressTest) {
+    // 4 producers, 4 consumers, each value must arrive exactly once, and
+    // the values of one producer must arrive in order at each consumer
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int numPerProducer = 250000;
+    MPMCQueue<int> queue(1024);
+    std::atomic<int> numConsumed(0);
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> numErrors(0);
+    std::thread producers[numProducers];
+    std::thread consumers[numConsumers];
+    for (int c = 0; c < numConsumers; c++) {
+        consumers[c] = std::thread([&] {
+            int lastSeen[numProducers];
+            for (int p = 0; p < numProducers; p++) {
+                lastSeen[p] = -1;
+            }
+            int val;
+            while (numConsumed.load(std::memory_order_relaxed) < numProducers * numPerProducer) {
+                if (queue.Dequeue(val)) {
+                    const int p = val / numPerProducer;
+                    const int i = val % numPerProducer;
+                    if (i <= lastSeen[p]) {
+                        numErrors++;
+                    }
+                    lastSeen[p] = i;
+                    sum += val;
+                    numConsumed++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int p = 0; p < numProducers; p++) {
+        producers[p] = std::thread([&queue, p] {
+            for (int i = 0; i < numPerProducer; ) {
+                if (queue.Enqueue(p * numPerProducer + i)) {
+                    i++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int p = 0; p < numProducers; p++) {
+        producers[p].join();
+    }
+    for (int c = 0; c < numConsumers; c++) {
+        consumers[c].join();
+    }
+    const int64_t n = numProducers * numPerProducer;
+    CHECK(0 == numErrors);
+    CHECK(n == numConsumed);
+    CHECK((n * (n - 1)) / 2 == sum);
+    CHECK(queue.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(BlockingQueueStressTest) {
+    // consumers sleep in WaitDequeue() until producers wake them up,
+    // Close() must release all consumers once the queue is drained
+    const int numProducers = 2;
+    const int numConsumers = 4;
+    const int numPerProducer = 100000;
+    BlockingQueue<int> queue(64);
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> numConsumed(0);
+    std::thread producers[numProducers];
+    std::thread consumers[numConsumers];
+    for (int c = 0; c < numConsumers; c++) {
+        consumers[c] = std::thread([&] {
+            int val;
+            while (queue.WaitDequeue(val)) {
+                sum += val;
+                numConsumed++;
+            }
+        });
+    }
+    for (int p = 0; p < numProducers; p++) {
+        producers[p] = std::thread([&queue, p] {
+            for (int i = 0; i < numPerProducer; i++) {
+                while (!queue.Enqueue(p * numPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+                // give consumers a chance to go to sleep now and then
+                if (0 == (i & 1023)) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        });
+    }
+    for (int p = 0; p < numProducers; p++) {
+        producers[p].join();
+    }
+    while (!queue.Empty()) {
+        std::this_thread::yield();
+    }
+    queue.Close();
+    for (int c = 0; c < numConsumers; c++) {
+        consumers[c].join();
+    }
+    const int64_t n = numProducers * numPerProducer;
+    CHECK(n == numConsumed);
+    CHECK((n * (n - 1)) / 2 == sum);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Throughput benchmark: push the same number of elements through a
+    lock-free queue and a mutex-guarded Queue with N producers and
+    N consumers. Threads yield when the queue is full or empty, so that
+    the benchmark also behaves on machines with few cores.
+*/
+template<class ENQUEUE, class DEQUEUE> double
+runThroughput(int numThreads, int numPerThread, ENQUEUE enq, DEQUEUE deq) {
+    std::atomic<int> numConsumed(0);
+    const int total = numThreads * numPerThread;
+    std::thread producers[8];
+    std::thread consumers[8];
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numThreads; i++) {
+        consumers[i] = std::thread([&] {
+            int val;
+            while (numConsumed.load(std::memory_order_relaxed) < total) {
+                if (deq(val)) {
+                    numConsumed++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        producers[i] = std::thread([&] {
+            for (int j = 0; j < numPerThread; ) {
+                if (enq(j)) {
+                    j++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int i = 0; i < numThreads; i++) {
+        producers[i].join();
+        consumers[i].join();
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> dur = end - start;
+    return dur.count();
+}
+
+//------------------------------------------------------------------------------
+TEST(LockFreeQueueBenchmark) {
+    const int num = 1000000;
+
+    // SPSC vs mutex-guarded Queue with 1 producer and 1 consumer
+    {
+        SPSCQueue<int> spsc(1024);
+        const double spscTime = runThroughput(1, num,
+            [&spsc](int v) { return spsc.Enqueue(v); },
+            [&spsc](int& v) { return spsc.Dequeue(v); });
+        std::mutex mutex;
+        Queue<int> queue;
+        queue.Reserve(1024);
+        const double queueTime = runThroughput(1, num,
+            [&](int v) { std::lock_guard<std::mutex> lock(mutex); queue.Enqueue(v); return true; },
+            [&](int& v) { std::lock_guard<std::mutex> lock(mutex); if (queue.Empty()) return false; v = queue.Dequeue(); return true; });
+        Log::Info("LockFreeQueueBenchmark: 1P/1C %d elements: SPSCQueue %f sec, mutex+Queue %f sec\n", num, spscTime, queueTime);
+    }
+    // MPMC vs mutex-guarded Queue with N producers and N consumers
+    for (int numThreads = 1; numThreads <= 4; numThreads *= 2) {
+        MPMCQueue<int> mpmc(1024);
+        const double mpmcTime = runThroughput(numThreads, num / numThreads,
+            [&mpmc](int v) { return mpmc.Enqueue(v); },
+            [&mpmc](int& v) { return mpmc.Dequeue(v); });
+        std::mutex mutex;
+        Queue<int> queue;
+        queue.Reserve(1024);
+        const double queueTime = runThroughput(numThreads, num / numThreads,
+            [&](int v) { std::lock_guard<std::mutex> lock(mutex); queue.Enqueue(v); return true; },
+            [&](int& v) { std::lock_guard<std::mutex> lock(mutex); if (queue.Empty()) return false; v = queue.Dequeue(); return true; });
+        Log::Info("LockFreeQueueBenchmark: %dP/%dC %d elements: MPMCQueue %f sec, mutex+Queue %f sec\n",
+            numThreads, numThreads, num, mpmcTime, queueTime);
+    }
+}
+#endif
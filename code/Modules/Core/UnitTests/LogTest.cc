@@ -6,6 +6,15 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Log.h"
 #include "Core/Logger.h"
+#include "Core/Core.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#endif
 
 using namespace Oryol;
 
@@ -54,4 +63,184 @@ TEST(LogTest) {
     test_log();
 }
 
+#if ORYOL_HAS_THREADS
+// a logger which counts messages and checks their order per thread
+class CaptureLogger : public Logger {
+    OryolClassDecl(CaptureLogger);
+public:
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        numSync++;
+    };
+    virtual void PrintRecord(const Log::Record& rec) override {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        int threadIndex, msgIndex;
+        if (2 == std::sscanf(rec.Message, "async %d %d", &threadIndex, &msgIndex)) {
+            if ((threadIndex >= 0) && (threadIndex < MaxThreads)) {
+                if (msgIndex <= this->lastIndex[threadIndex]) {
+                    this->numOutOfOrder++;
+                }
+                this->lastIndex[threadIndex] = msgIndex;
+            }
+        }
+        if (0 == rec.ThreadId) {
+            this->numInvalid++;
+        }
+        this->numAsync++;
+    };
+    static const int MaxThreads = 8;
+    std::mutex mutex;
+    int lastIndex[MaxThreads] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+    int numOutOfOrder = 0;
+    int numInvalid = 0;
+    std::atomic<int> numAsync{0};
+    std::atomic<int> numSync{0};
+};
+
+TEST(AsyncLogTest) {
+    Ptr<CaptureLogger> logger = CaptureLogger::Create();
+    Log::AddLogger(logger);
+    Log::StartAsync();
+    CHECK(Log::IsAsync());
+    const int droppedBefore = Log::NumDropped();
 
+    // log from several threads, each thread enqueues less than
+    // its ring buffer can hold per wakeup, so nothing gets dropped
+    const int numThreads = 4;
+    const int numMsgs = 200;
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t] {
+            Core::EnterThread();
+            for (int i = 0; i < numMsgs; i++) {
+                Log::Info("async %d %d\n", t, i);
+                if (0 == (i % 100)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                }
+            }
+            Core::LeaveThread();
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    Log::Flush();
+    const int numDropped = Log::NumDropped() - droppedBefore;
+    CHECK(logger->numAsync + numDropped == numThreads * numMsgs);
+    CHECK(0 == logger->numOutOfOrder);
+    CHECK(0 == logger->numInvalid);
+
+    // overflow a ring buffer, messages must be dropped, not block
+    const int numBefore = logger->numAsync;
+    const int droppedBefore2 = Log::NumDropped();
+    for (int i = 0; i < Log::AsyncQueueSize * 4; i++) {
+        Log::Dbg("overflow %d\n", i);
+    }
+    Log::Flush();
+    CHECK((logger->numAsync - numBefore) + (Log::NumDropped() - droppedBefore2) == Log::AsyncQueueSize * 4);
+
+    // errors are written synchronously through VPrint()
+    const int numSyncBefore = logger->numSync;
+    Log::Error("a synchronous error\n");
+    CHECK(logger->numSync == numSyncBefore + 1);
+
+    Log::StopAsync();
+    CHECK(!Log::IsAsync());
+    Log::RemoveLogger(logger);
+}
+
+TEST(AsyncLogStopTest) {
+    // stopping async mode while other threads are logging must not lose messages
+    Ptr<CaptureLogger> logger = CaptureLogger::Create();
+    Log::AddLogger(logger);
+    const int droppedBefore = Log::NumDropped();
+    const int numThreads = 4;
+    const int numMsgs = 2000;
+    std::atomic<bool> started{false};
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t, &started] {
+            Core::EnterThread();
+            while (!started) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < numMsgs; i++) {
+                Log::Info("async %d %d\n", t, i);
+                if (0 == (i % 64)) {
+                    std::this_thread::yield();
+                }
+            }
+            Core::LeaveThread();
+        });
+    }
+    started = true;
+    for (int i = 0; i < 20; i++) {
+        Log::StartAsync();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Log::StopAsync();
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    const int numDropped = Log::NumDropped() - droppedBefore;
+    CHECK(logger->numAsync + logger->numSync + numDropped == numThreads * numMsgs);
+    Log::RemoveLogger(logger);
+}
+
+// a logger which writes to a file, to measure the cost of log calls
+class FileLogger : public Logger {
+    OryolClassDecl(FileLogger);
+public:
+    FileLogger() : fp(std::tmpfile()) { };
+    ~FileLogger() { if (fp) std::fclose(fp); };
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        if (fp) {
+            std::vfprintf(fp, msg, args);
+            std::fflush(fp);
+        }
+    };
+    FILE* fp;
+};
+
+TEST(AsyncLogBenchmark) {
+    // temporarily replace all loggers with a file logger
+    Array<Ptr<Logger>> prevLoggers;
+    while (Log::GetNumLoggers() > 0) {
+        prevLoggers.Add(Log::GetLogger(0));
+        Log::RemoveLogger(prevLoggers.Back());
+    }
+    Ptr<FileLogger> logger = FileLogger::Create();
+    Log::AddLogger(logger);
+    // simulate frames with a burst of log messages each, and only
+    // measure the time spent in the log calls
+    const int numFrames = 50;
+    const int numPerFrame = 200;
+    const int num = numFrames * numPerFrame;
+    for (int mode = 0; mode < 2; mode++) {
+        if (1 == mode) {
+            Log::StartAsync();
+        }
+        const int droppedBefore = Log::NumDropped();
+        std::chrono::duration<double> dur(0.0);
+        for (int frame = 0; frame < numFrames; frame++) {
+            std::chrono::time_point<std::chrono::system_clock> start, end;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < numPerFrame; i++) {
+                Log::Info("benchmark message %d with some payload %f\n", i, i * 0.5f);
+            }
+            end = std::chrono::system_clock::now();
+            dur += end - start;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        const int numDropped = Log::NumDropped() - droppedBefore;
+        if (1 == mode) {
+            Log::StopAsync();
+        }
+        std::printf("AsyncLogBenchmark: %d log calls (%s): %f sec (%d dropped)\n",
+            num, mode ? "async" : "sync", dur.count(), numDropped);
+    }
+    Log::RemoveLogger(logger);
+    for (const auto& l : prevLoggers) {
+        Log::AddLogger(l);
+    }
+}
+#endif
@@ -5,9 +5,17 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/smallObjectAllocator.h"
 #include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/String.h"
+#include <chrono>
+#include <cstdlib>
 
 using namespace Oryol;
+using namespace Oryol::_priv;
 
 //------------------------------------------------------------------------------
 TEST(Memory) {
@@ -75,4 +83,163 @@ TEST(Memory) {
     CHECK((intptr_t(ptr) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
 }
 
+//------------------------------------------------------------------------------
+TEST(SmallObjectAllocator) {
+
+    // size classes
+    CHECK(smallObjectAllocator::SizeClass(0) == 0);
+    CHECK(smallObjectAllocator::SizeClass(16) == 0);
+    CHECK(smallObjectAllocator::SizeClass(17) == 1);
+    CHECK(smallObjectAllocator::SizeClass(smallObjectAllocator::MaxSmallSize) == smallObjectAllocator::NumSizeClasses - 1);
+    CHECK(smallObjectAllocator::SizeClass(smallObjectAllocator::MaxSmallSize + 1) == -1);
+    bool classesValid = true;
+    for (int size = 0; size <= smallObjectAllocator::MaxSmallSize; size++) {
+        const int cls = smallObjectAllocator::SizeClass(size);
+        const int blockSize = smallObjectAllocator::BlockSize(cls);
+        classesValid &= (size + smallObjectAllocator::HeaderSize) <= blockSize;
+        if (cls > 0) {
+            classesValid &= (size + smallObjectAllocator::HeaderSize) > smallObjectAllocator::BlockSize(cls - 1);
+        }
+        classesValid &= (blockSize & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0;
+    }
+    CHECK(classesValid);
+
+    // alloc/free, freed blocks are reused
+    uint8_t* p0 = (uint8_t*) smallObjectAllocator::Alloc(24);
+    CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    smallObjectAllocator::Free(p0);
+    uint8_t* p1 = (uint8_t*) smallObjectAllocator::Alloc(30);
+    CHECK(p0 == p1);
+
+    // realloc within the same block, to another size class, and to a large block
+    for (int i = 0; i < 30; i++) {
+        p1[i] = i;
+    }
+    CHECK(smallObjectAllocator::ReAlloc(p1, 32) == p1);
+    p1 = (uint8_t*) smallObjectAllocator::ReAlloc(p1, 100);
+    CHECK(p1 != p0);
+    p1 = (uint8_t*) smallObjectAllocator::ReAlloc(p1, 4000);
+    bool contentValid = true;
+    for (int i = 0; i < 30; i++) {
+        contentValid &= (p1[i] == i);
+    }
+    CHECK(contentValid);
+    p1 = (uint8_t*) smallObjectAllocator::ReAlloc(p1, 8000);
+    CHECK(p1[29] == 29);
+    smallObjectAllocator::Free(p1);
+    smallObjectAllocator::Free(nullptr);
+
+    // many allocations in all size classes
+    Array<void*> ptrs;
+    for (int i = 0; i < 10000; i++) {
+        const int size = (i * 7) % (smallObjectAllocator::MaxSmallSize + 1);
+        uint8_t* p = (uint8_t*) smallObjectAllocator::Alloc(size);
+        Memory::Fill(p, size, uint8_t(i));
+        ptrs.Add(p);
+    }
+    for (void* p : ptrs) {
+        smallObjectAllocator::Free(p);
+    }
+    const int numSpans = smallObjectAllocator::NumSpans();
+    CHECK(numSpans > 0);
+
+    // returning the thread cache keeps the blocks for reuse
+    smallObjectAllocator::FlushThreadCache();
+    for (int i = 0; i < ptrs.Size(); i++) {
+        ptrs[i] = smallObjectAllocator::Alloc((i * 7) % (smallObjectAllocator::MaxSmallSize + 1));
+    }
+    CHECK(smallObjectAllocator::NumSpans() == numSpans);
+    for (void* p : ptrs) {
+        smallObjectAllocator::Free(p);
+    }
 
+    // disabled: everything goes to malloc, but can still be freed
+    smallObjectAllocator::SetEnabled(false);
+    void* p2 = smallObjectAllocator::Alloc(16);
+    smallObjectAllocator::SetEnabled(true);
+    smallObjectAllocator::Free(p2);
+    CHECK(smallObjectAllocator::IsEnabled());
+}
+
+//------------------------------------------------------------------------------
+static double
+containerWorkload() {
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int round = 0; round < 20; round++) {
+        Map<int, String> map;
+        Array<Array<int>> arrays;
+        for (int i = 0; i < 2000; i++) {
+            map.Add(i, String("a small string"));
+            Array<int> array;
+            for (int j = 0; j < (i & 31); j++) {
+                array.Add(j);
+            }
+            arrays.Add(std::move(array));
+            int* obj = Memory::New<int>(i);
+            Memory::Delete(obj);
+        }
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> dur = end - start;
+    return dur.count();
+}
+
+//------------------------------------------------------------------------------
+TEST(SmallObjectAllocatorBenchmark) {
+
+    // raw alloc/free of small random sizes
+    const int num = 100000;
+    Array<void*> ptrs;
+    ptrs.Reserve(num);
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < num; i++) {
+        ptrs.Add(std::malloc((i * 13) & 255));
+    }
+    for (void* p : ptrs) {
+        std::free(p);
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> mallocDur = end - start;
+
+    ptrs.Clear();
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < num; i++) {
+        ptrs.Add(smallObjectAllocator::Alloc((i * 13) & 255));
+    }
+    for (void* p : ptrs) {
+        smallObjectAllocator::Free(p);
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> smallDur = end - start;
+    Log::Info("%d small allocs+frees: malloc %f sec, smallObjectAllocator %f sec\n", num, mallocDur.count(), smallDur.count());
+
+    // Oryol container workload through Memory::Alloc
+    #if ORYOL_SMALL_OBJECT_ALLOCATOR
+    smallObjectAllocator::SetEnabled(false);
+    const double sysTime = containerWorkload();
+    smallObjectAllocator::SetEnabled(true);
+    const double soaTime = containerWorkload();
+    Log::Info("container workload: malloc %f sec, smallObjectAllocator %f sec\n", sysTime, soaTime);
+    #else
+    Log::Info("container workload: malloc %f sec (compile with ORYOL_SMALL_OBJECT_ALLOCATOR=1 to compare)\n", containerWorkload());
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryAligned) {
+    for (int align = 1; align <= 4096; align *= 2) {
+        uint8_t* ptr = (uint8_t*) Memory::AllocAligned(100, align);
+        CHECK(nullptr != ptr);
+        CHECK((intptr_t(ptr) & (align - 1)) == 0);
+        Memory::Fill(ptr, 100, 0xAB);
+        CHECK(ptr[99] == 0xAB);
+        Memory::FreeAligned(ptr);
+    }
+    Memory::FreeAligned(nullptr);
+
+    void* ptr = (void*) 0x1234567;
+    CHECK(intptr_t(Memory::AlignTo(ptr, 64)) == 0x1234580);
+    CHECK(intptr_t(Memory::AlignTo(ptr, 1)) == 0x1234567);
+}
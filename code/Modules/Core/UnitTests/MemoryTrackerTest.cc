@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+//  MemoryTrackerTest.cc
+//  Test allocation tracking (only meaningful with ORYOL_MEMORY_TRACKING).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/MemoryTracker.h"
+#include <cstring>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MemoryTrackerTest) {
+    #if ORYOL_MEMORY_TRACKING
+    CHECK(MemoryTracker::IsEnabled());
+    const int tag = MemoryTracker::RegisterTag("MemoryTrackerTest");
+    CHECK(tag != MemoryTracker::DefaultTag);
+    CHECK(MemoryTracker::RegisterTag("MemoryTrackerTest") == tag);
+    CHECK(MemoryTracker::NumTags() > tag);
+    CHECK(MemoryTracker::CurrentTag() == MemoryTracker::DefaultTag);
+
+    MemoryTracker::NewFrame();
+    void* p0 = nullptr;
+    void* p1 = nullptr;
+    {
+        o_memory_scope("MemoryTrackerTest");
+        CHECK(MemoryTracker::CurrentTag() == tag);
+        p0 = Memory::Alloc(100);
+        p1 = Memory::Alloc(28);
+    }
+    CHECK(MemoryTracker::CurrentTag() == MemoryTracker::DefaultTag);
+    MemoryTracker::TagStats stats = MemoryTracker::GetTagStats(tag);
+    CHECK(0 == std::strcmp(stats.Name, "MemoryTrackerTest"));
+    CHECK(stats.LiveBytes == 128);
+    CHECK(stats.NumLiveAllocs == 2);
+    CHECK(stats.NumAllocs == 2);
+    CHECK(stats.HighWaterBytes == 128);
+
+    // realloc stays with the original allocation's tag, and
+    // only counts the added bytes in the frame stats
+    p1 = Memory::ReAlloc(p1, 256);
+    stats = MemoryTracker::GetTagStats(tag);
+    CHECK(stats.LiveBytes == 356);
+    CHECK(stats.HighWaterBytes == 356);
+
+    Memory::Free(p0);
+    Memory::Free(p1);
+    stats = MemoryTracker::GetTagStats(tag);
+    CHECK(stats.LiveBytes == 0);
+    CHECK(stats.NumLiveAllocs == 0);
+    CHECK(stats.HighWaterBytes == 356);
+
+    // per-frame counters
+    MemoryTracker::FrameStats frameStats = MemoryTracker::GetCurrentFrameStats();
+    CHECK(frameStats.NumAllocs == 2);
+    CHECK(frameStats.NumFrees == 2);
+    MemoryTracker::NewFrame();
+    frameStats = MemoryTracker::GetFrameStats();
+    CHECK(frameStats.NumAllocs == 2);
+    CHECK(frameStats.NumFrees == 2);
+    CHECK(frameStats.NumBytes == 356);
+    frameStats = MemoryTracker::GetCurrentFrameStats();
+    CHECK(frameStats.NumAllocs == 0);
+    MemoryTracker::Dump();
+    #else
+    CHECK(!MemoryTracker::IsEnabled());
+    CHECK(MemoryTracker::NumTags() == 0);
+    #endif
+}
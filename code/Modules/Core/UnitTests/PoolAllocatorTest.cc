@@ -5,11 +5,19 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Log.h"
+#include "Core/Core.h"
 #include "Core/Types.h"
 #include "Core/RefCounted.h"
 #include "Core/Ptr.h"
+#include "Core/Containers/Array.h"
 #include "Core/Memory/poolAllocator.h"
 
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <atomic>
+#endif
+
 using namespace Oryol;
 using namespace Oryol::_priv;
 
@@ -28,3 +36,140 @@ TEST(PoolAllocator) {
     CHECK(obj == obj1);
     allocatorOne.Destroy(obj1);
 }
+
+struct poolTestObj {
+    poolTestObj(int v) : value(v) { };
+    int value;
+    int padding[3];
+};
+
+TEST(PoolAllocatorLarge) {
+
+    // more than the old 65536-element limit
+    poolAllocator<poolTestObj> allocator;
+    const int num = 200000;
+    Array<poolTestObj*> objs;
+    objs.Reserve(num);
+    for (int i = 0; i < num; i++) {
+        objs.Add(allocator.Create(i));
+    }
+    CHECK(allocator.Capacity() >= uint32_t(num));
+    bool allValid = true;
+    for (int i = 0; i < num; i++) {
+        allValid &= (objs[i]->value == i);
+    }
+    CHECK(allValid);
+    for (poolTestObj* obj : objs) {
+        allocator.Destroy(obj);
+    }
+
+    // the second round must not grow the pool
+    const uint32_t capacity = allocator.Capacity();
+    objs.Clear();
+    for (int i = 0; i < num; i++) {
+        objs.Add(allocator.Create(i));
+    }
+    CHECK(allocator.Capacity() == capacity);
+    for (poolTestObj* obj : objs) {
+        allocator.Destroy(obj);
+    }
+}
+
+#if ORYOL_HAS_THREADS
+const int numObjs = 1000;
+const int numRounds = 200;
+
+poolAllocator<poolTestObj>* sharedAllocator = nullptr;
+std::atomic<int> numErrors{0};
+
+void poolThreadFunc(int threadIndex) {
+    Core::EnterThread();
+    poolTestObj* objs[numObjs];
+    for (int round = 0; round < numRounds; round++) {
+        const int tag = (threadIndex << 16) | round;
+        for (int i = 0; i < numObjs; i++) {
+            objs[i] = sharedAllocator->Create(tag);
+        }
+        for (int i = 0; i < numObjs; i++) {
+            if (objs[i]->value != tag) {
+                numErrors++;
+            }
+            sharedAllocator->Destroy(objs[i]);
+        }
+    }
+    Core::LeaveThread();
+}
+
+TEST(PoolAllocatorMultiThreaded) {
+
+    // run the same amount of work per thread with 1..16 threads,
+    // with per-thread magazines the time should stay roughly flat
+    Core::Setup();
+    for (int numThreads = 1; numThreads <= 16; numThreads *= 2) {
+        poolAllocator<poolTestObj> allocator;
+        sharedAllocator = &allocator;
+        numErrors = 0;
+
+        std::chrono::time_point<std::chrono::system_clock> start, end;
+        start = std::chrono::system_clock::now();
+        std::thread threads[16];
+        for (int i = 0; i < numThreads; i++) {
+            threads[i] = std::thread(poolThreadFunc, i);
+        }
+        for (int i = 0; i < numThreads; i++) {
+            threads[i].join();
+        }
+        end = std::chrono::system_clock::now();
+        std::chrono::duration<double> dur = end - start;
+        CHECK(0 == numErrors);
+        Log::Info("PoolAllocatorMultiThreaded: %d create/destroy in %d threads: %f sec (capacity: %u)\n",
+            numObjs * numRounds * numThreads, numThreads, dur.count(), allocator.Capacity());
+        sharedAllocator = nullptr;
+    }
+    Core::Discard();
+}
+
+std::atomic<bool> startGrow{false};
+const int numGrowObjs = 2000;
+
+void poolGrowThreadFunc() {
+    Core::EnterThread();
+    while (!startGrow) {
+        std::this_thread::yield();
+    }
+    static poolTestObj* objs[16][numGrowObjs];
+    static std::atomic<int> threadCounter{0};
+    poolTestObj** myObjs = objs[threadCounter++ % 16];
+    for (int i = 0; i < numGrowObjs; i++) {
+        myObjs[i] = sharedAllocator->Create(i);
+    }
+    for (int i = 0; i < numGrowObjs; i++) {
+        sharedAllocator->Destroy(myObjs[i]);
+    }
+    Core::LeaveThread();
+}
+
+TEST(PoolAllocatorConcurrentGrow) {
+
+    // threads which find the depot empty at the same time must not
+    // each add a new puddle: the pool only grows when all elements are
+    // used or in magazines (at most 16 * (2000 + 64) = 33024 elements),
+    // so the pool can't grow beyond 8 puddles (65280 elements)
+    Core::Setup();
+    poolAllocator<poolTestObj> allocator;
+    sharedAllocator = &allocator;
+    startGrow = false;
+    const int numThreads = 16;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread(poolGrowThreadFunc);
+    }
+    startGrow = true;
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+    CHECK(allocator.Capacity() <= 65280);
+    sharedAllocator = nullptr;
+    Core::Discard();
+}
+#endif
@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+//  ProfilerTest.cc
+//  Test the built-in profiler.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Profiler.h"
+#include "Core/Log.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static std::string
+readFile(const char* path) {
+    std::string str;
+    FILE* fp = std::fopen(path, "rb");
+    if (fp) {
+        char buf[4096];
+        size_t num;
+        while ((num = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+            str.append(buf, num);
+        }
+        std::fclose(fp);
+    }
+    return str;
+}
+
+//------------------------------------------------------------------------------
+static int
+countOf(const std::string& str, const char* sub) {
+    int num = 0;
+    size_t pos = 0;
+    while ((pos = str.find(sub, pos)) != std::string::npos) {
+        num++;
+        pos += std::strlen(sub);
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+// if the profiler is already running (ORYOL_NATIVE_PROFILER), restart it
+// with the given settings, and restore it afterwards
+struct profilerScope {
+    profilerScope(int eventsPerThread) : wasValid(Profiler::IsValid()) {
+        if (this->wasValid) {
+            Profiler::Discard();
+        }
+        Profiler::Setup(eventsPerThread);
+    };
+    ~profilerScope() {
+        Profiler::Discard();
+        if (this->wasValid) {
+            Profiler::Setup();
+        }
+    };
+    bool wasValid;
+};
+
+//------------------------------------------------------------------------------
+TEST(ProfilerTest) {
+    profilerScope scope(1024);
+    CHECK(Profiler::IsValid());
+    CHECK(Profiler::IsEnabled());
+    CHECK(Profiler::NumEvents() == 0);
+
+    Profiler::SetThreadName("TestMain");
+    for (int frame = 0; frame < 3; frame++) {
+        Profiler::BeginFrame();
+        {
+            Profiler::Scope outer("Outer");
+            {
+                Profiler::Scope inner("Inner");
+            }
+            Profiler::Begin("Manual");
+            Profiler::End();
+        }
+        Profiler::EndFrame();
+    }
+    CHECK(Profiler::NumFrames() == 3);
+    CHECK(Profiler::NumEvents() == 3 * 8);
+
+    // disabled profiler doesn't record
+    Profiler::SetEnabled(false);
+    Profiler::Begin("Disabled");
+    Profiler::End();
+    CHECK(Profiler::NumEvents() == 3 * 8);
+    Profiler::SetEnabled(true);
+
+    // events from other threads go into their own buffers
+    std::thread t0([] {
+        Profiler::SetThreadName("Worker0");
+        for (int i = 0; i < 100; i++) {
+            Profiler::Scope s("Work");
+        }
+    });
+    std::thread t1([] {
+        for (int i = 0; i < 100; i++) {
+            Profiler::Scope s("Work");
+        }
+    });
+    t0.join();
+    t1.join();
+    CHECK(Profiler::NumEvents() == 3 * 8 + 2 * 200);
+
+    Profiler::SetEnabled(false);
+    const char* jsonPath = "ProfilerTest.json";
+    CHECK(Profiler::WriteChromeTrace(jsonPath));
+    std::string json = readFile(jsonPath);
+    std::remove(jsonPath);
+    CHECK(json.find("{\"traceEvents\":[") == 0);
+    CHECK(countOf(json, "\"ph\":\"M\"") == 3);
+    CHECK(countOf(json, "\"TestMain\"") == 1);
+    CHECK(countOf(json, "\"Worker0\"") == 1);
+    CHECK(countOf(json, "\"Thread ") == 1);
+    CHECK(countOf(json, "\"name\":\"Outer\"") == 3);
+    CHECK(countOf(json, "\"name\":\"Inner\"") == 3);
+    CHECK(countOf(json, "\"name\":\"Frame\"") == 3);
+    CHECK(countOf(json, "\"name\":\"Work\"") == 200);
+    CHECK(countOf(json, "\"ph\":\"B\"") == countOf(json, "\"ph\":\"E\""));
+
+    const char* binPath = "ProfilerTest.bin";
+    CHECK(Profiler::WriteBinary(binPath));
+    std::string bin = readFile(binPath);
+    std::remove(binPath);
+    CHECK(bin.size() > 12);
+    CHECK(bin.compare(0, 4, "ORYP") == 0);
+    // 1 version, 6 names ("", Frame, Outer, Inner, Manual, Work)
+    CHECK(uint8_t(bin[4]) == 1);
+    CHECK(uint8_t(bin[8]) == 6);
+    // binary should be much smaller than JSON
+    CHECK(bin.size() * 4 < json.size());
+
+    Profiler::Clear();
+    CHECK(Profiler::NumEvents() == 0);
+    CHECK(Profiler::NumFrames() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(ProfilerRingBufferTest) {
+    // overflow a small ring buffer, the export must still be balanced
+    profilerScope scope(64);
+    Profiler::Begin("Open");
+    for (int i = 0; i < 1000; i++) {
+        Profiler::Scope outer("Outer");
+        Profiler::Scope inner("Inner");
+    }
+    Profiler::Begin("Unclosed");
+    CHECK(Profiler::NumEvents() == 64);
+
+    Profiler::SetEnabled(false);
+    const char* jsonPath = "ProfilerRingBufferTest.json";
+    CHECK(Profiler::WriteChromeTrace(jsonPath));
+    std::string json = readFile(jsonPath);
+    std::remove(jsonPath);
+    CHECK(countOf(json, "\"name\":\"Open\"") == 0);
+    CHECK(countOf(json, "\"name\":\"Unclosed\"") == 1);
+    CHECK(countOf(json, "\"ph\":\"B\"") == countOf(json, "\"ph\":\"E\""));
+}
+
+//------------------------------------------------------------------------------
+TEST(ProfilerDiscardTest) {
+    // discarding the profiler while other threads are recording must
+    // not free their buffers under their feet
+    const bool wasValid = Profiler::IsValid();
+    for (int i = 0; i < 10; i++) {
+        if (!Profiler::IsValid()) {
+            Profiler::Setup(1024);
+        }
+        std::atomic<bool> stop{false};
+        std::thread threads[4];
+        for (auto& t : threads) {
+            t = std::thread([&stop] {
+                Profiler::SetThreadName("Worker");
+                while (!stop) {
+                    Profiler::Scope s("Work");
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Profiler::Discard();
+        CHECK(!Profiler::IsValid());
+        stop = true;
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    if (wasValid) {
+        Profiler::Setup();
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(ProfilerBenchmark) {
+    profilerScope scope(Profiler::DefaultEventsPerThread);
+    const int numZones = 1000000;
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numZones; i++) {
+        Profiler::Scope s("Zone");
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> enabledDur = end - start;
+
+    Profiler::SetEnabled(false);
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numZones; i++) {
+        Profiler::Scope s("Zone");
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> disabledDur = end - start;
+    CHECK(Profiler::NumEvents() == Profiler::DefaultEventsPerThread);
+
+    Log::Info("Profiler: %d zones enabled: %.4fs (%.1fns/zone), disabled: %.4fs (%.1fns/zone)\n",
+        numZones,
+        enabledDur.count(), (enabledDur.count() * 1e9) / numZones,
+        disabledDur.count(), (disabledDur.count() * 1e9) / numZones);
+}
@@ -79,4 +79,16 @@ TEST(QueueTest) {
     CHECK(queue0.Size() == 1);
     CHECK(queue0.Dequeue() == "Bla");
 }
-    
+
+TEST(QueueAlignmentTest) {
+    Queue<int> queue;
+    queue.SetAlignment(64);
+    CHECK(queue.GetAlignment() == 64);
+    for (int i = 0; i < 100; i++) {
+        queue.Enqueue(i);
+    }
+    CHECK((intptr_t(&queue.Front()) & 63) == 0);
+    for (int i = 0; i < 100; i++) {
+        CHECK(queue.Dequeue() == i);
+    }
+}
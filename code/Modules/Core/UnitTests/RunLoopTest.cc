@@ -1,10 +1,19 @@
 //------------------------------------------------------------------------------
-//  ArrayMapTest.cc
-//  Test ArrayMap class.
+//  RunLoopTest.cc
+//  Test RunLoop class.
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
 #include "Core/RunLoop.h"
+#include "Core/Log.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/String/String.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
 
 using namespace Oryol;
 
@@ -29,3 +38,374 @@ TEST(RunLoopTest) {
     CHECK(x == 2);
     CHECK(y == 4);
 }
+
+//------------------------------------------------------------------------------
+TEST(RunLoopOrderTest) {
+    RunLoop runLoop;
+    char str[16] = { };
+    int len = 0;
+    auto append = [&str, &len](char c) { str[len++] = c; };
+    runLoop.Add([&append]() { append('d'); });
+    runLoop.Add([&append]() { append('f'); }, RunLoop::Late);
+    runLoop.Add([&append]() { append('c'); }, RunLoop::Default, -5);
+    runLoop.Add([&append]() { append('a'); }, RunLoop::Early, 10);
+    runLoop.Add([&append]() { append('e'); });
+    runLoop.Add([&append]() { append('b'); }, RunLoop::Default, -10);
+    CHECK(runLoop.NumCallbacks() == 6);
+    runLoop.Run();
+    CHECK(String(str) == "abcdef");
+    len = 0;
+    runLoop.Run();
+    CHECK(String(str) == "abcdef");
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopDeferredTest) {
+    RunLoop runLoop;
+    int a = 0, b = 0, c = 0;
+    RunLoop::Id idA = RunLoop::InvalidId;
+    RunLoop::Id idB = RunLoop::InvalidId;
+    RunLoop::Id idC = RunLoop::InvalidId;
+
+    // a removes b (which runs later) and itself, and adds c
+    // NOTE: capturing everything by reference wouldn't fit into the Delegate
+    struct context {
+        RunLoop* runLoop;
+        int* a;
+        int* c;
+        RunLoop::Id* idA;
+        RunLoop::Id* idB;
+        RunLoop::Id* idC;
+    } ctx = { &runLoop, &a, &c, &idA, &idB, &idC };
+    idA = runLoop.Add([&ctx]() {
+        (*ctx.a)++;
+        ctx.runLoop->Remove(*ctx.idB);
+        ctx.runLoop->Remove(*ctx.idA);
+        int* c = ctx.c;
+        *ctx.idC = ctx.runLoop->Add([c]() { (*c)++; });
+    });
+    idB = runLoop.Add([&b]() { b++; }, RunLoop::Late);
+    CHECK(runLoop.HasCallback(idA));
+    CHECK(runLoop.HasCallback(idB));
+    CHECK(!runLoop.HasCallback(RunLoop::InvalidId));
+    runLoop.Run();
+    CHECK(a == 1);
+    CHECK(b == 0);      // removed before it was called
+    CHECK(c == 0);      // added during Run(), called next frame
+    CHECK(!runLoop.HasCallback(idA));
+    CHECK(!runLoop.HasCallback(idB));
+    CHECK(runLoop.HasCallback(idC));
+    CHECK(runLoop.NumCallbacks() == 1);
+    runLoop.Run();
+    CHECK(a == 1);
+    CHECK(b == 0);
+    CHECK(c == 1);
+
+    // add and remove before Run()
+    RunLoop::Id idD = runLoop.Add([&a]() { a += 100; });
+    runLoop.Remove(idD);
+    CHECK(!runLoop.HasCallback(idD));
+    runLoop.Run();
+    CHECK(a == 1);
+    CHECK(c == 2);
+
+    // handles are recycled, but old ids remain invalid
+    RunLoop::Id idE = runLoop.Add([&b]() { b++; });
+    CHECK(idE != idA);
+    CHECK(idE != idB);
+    CHECK(idE != idD);
+    CHECK(!runLoop.HasCallback(idA));
+    CHECK(!runLoop.HasCallback(idD));
+    runLoop.Run();
+    CHECK(b == 1);
+    runLoop.Remove(idC);
+    runLoop.Remove(idE);
+    runLoop.Run();
+    CHECK(runLoop.NumCallbacks() == 0);
+    CHECK(b == 1);
+    CHECK(c == 3);
+
+    // removing a callable which isn't trivially copyable during Run()
+    String str("removed");
+    int d = 0;
+    RunLoop::Id idF = RunLoop::InvalidId;
+    RunLoop::Id idG = runLoop.Add([&runLoop, &idF]() { runLoop.Remove(idF); });
+    idF = runLoop.Add([str, &d]() { d += str.Length(); }, RunLoop::Late);
+    runLoop.Run();
+    CHECK(d == 0);
+    CHECK(runLoop.NumCallbacks() == 1);
+    runLoop.Remove(idG);
+    runLoop.Run();
+    CHECK(runLoop.NumCallbacks() == 0);
+}
+
+//------------------------------------------------------------------------------
+static void
+testParallelRunLoop() {
+    // 3 groups of parallel callbacks separated by serial callbacks, the serial
+    // callbacks check that the previous group has completely finished
+    RunLoop runLoop;
+    struct context {
+        std::atomic<int> early{0};
+        std::atomic<int> defaultPri0{0};
+        std::atomic<int> defaultPri1{0};
+        int numFailed = 0;
+        int numSerial = 0;
+        int removedCalls = 0;
+    } ctx;
+    const int num = 16;
+    for (int i = 0; i < num; i++) {
+        runLoop.AddParallel([&ctx]() { ctx.early++; }, RunLoop::Early);
+        runLoop.AddParallel([&ctx]() {
+            if (ctx.early != num) {
+                ctx.numFailed++;
+            }
+            ctx.defaultPri0++;
+        });
+        runLoop.AddParallel([&ctx]() {
+            if (ctx.defaultPri0 != num) {
+                ctx.numFailed++;
+            }
+            ctx.defaultPri1++;
+        }, RunLoop::Default, 1);
+    }
+    // serial callback with same priority as the first default group runs after the group
+    runLoop.Add([&ctx]() {
+        ctx.numSerial++;
+        if ((ctx.defaultPri0 != num) || (ctx.defaultPri1 != 0)) {
+            ctx.numFailed++;
+        }
+    });
+    runLoop.Add([&ctx]() {
+        ctx.numSerial++;
+        if (ctx.defaultPri1 != num) {
+            ctx.numFailed++;
+        }
+    }, RunLoop::Late);
+    RunLoop::Id removedId = runLoop.AddParallel([&ctx]() { ctx.removedCalls++; }, RunLoop::Early);
+    runLoop.Remove(removedId);
+    // a removed parallel callback inside an existing group is skipped
+    RunLoop::Id lateRemovedId = runLoop.AddParallel([&ctx]() { ctx.removedCalls++; }, RunLoop::Default, 1);
+    runLoop.Add([&runLoop, lateRemovedId]() {
+        if (runLoop.HasCallback(lateRemovedId)) {
+            runLoop.Remove(lateRemovedId);
+        }
+    }, RunLoop::Early, -1);
+
+    for (int frame = 0; frame < 10; frame++) {
+        ctx.early = 0;
+        ctx.defaultPri0 = 0;
+        ctx.defaultPri1 = 0;
+        runLoop.Run();
+        CHECK(ctx.early == num);
+        CHECK(ctx.defaultPri0 == num);
+        CHECK(ctx.defaultPri1 == num);
+        CHECK(ctx.numFailed == 0);
+        CHECK(ctx.numSerial == 2 * (frame + 1));
+        CHECK(ctx.removedCalls == 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopParallelTest) {
+    // without JobSystem, parallel callbacks run on the calling thread
+    testParallelRunLoop();
+    Core::Setup();
+    JobSystem::Setup(3);
+    testParallelRunLoop();
+    JobSystem::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+static void
+busyWork(int iterations) {
+    volatile double sum = 0.0;
+    for (int i = 0; i < iterations; i++) {
+        sum = sum + double(i) * 0.5;
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopParallelBenchmark) {
+    const int numCallbacks = 8;
+    const int numFrames = 100;
+    const int iterations = 50000;
+    RunLoop serialLoop;
+    RunLoop parallelLoop;
+    for (int i = 0; i < numCallbacks; i++) {
+        serialLoop.Add([]() { busyWork(iterations); });
+        parallelLoop.AddParallel([]() { busyWork(iterations); });
+    }
+    Core::Setup();
+    JobSystem::Setup();
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numFrames; i++) {
+        serialLoop.Run();
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> serialDur = end - start;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numFrames; i++) {
+        parallelLoop.Run();
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> parallelDur = end - start;
+    Log::Info("RunLoop: %d callbacks x %d frames, serial: %.3fms/frame, parallel (%d workers): %.3fms/frame\n",
+        numCallbacks, numFrames,
+        (serialDur.count() * 1e3) / numFrames,
+        JobSystem::NumWorkers(),
+        (parallelDur.count() * 1e3) / numFrames);
+    JobSystem::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+// the previous RunLoop implementation, for comparison
+class mapRunLoop {
+public:
+    typedef int Id;
+    typedef std::function<void()> Func;
+    Id Add(Func func) {
+        Id newId = ++this->curId;
+        this->toAdd.Add(newId, item{func, false});
+        return newId;
+    };
+    void Remove(Id id) {
+        this->toRemove.Add(id);
+    };
+    void Run() {
+        this->remCallbacks();
+        this->addCallbacks();
+        for (const auto& entry : this->callbacks) {
+            if (entry.Value().valid) {
+                entry.Value().func();
+            }
+        }
+        this->remCallbacks();
+        this->addCallbacks();
+    };
+private:
+    void remCallbacks() {
+        for (Id id : this->toRemove) {
+            if (this->callbacks.Contains(id)) {
+                this->callbacks.Erase(id);
+            }
+            else if (this->toAdd.Contains(id)) {
+                this->toAdd.Erase(id);
+            }
+        }
+        this->toRemove.Clear();
+    };
+    void addCallbacks() {
+        for (auto& entry : this->toAdd) {
+            entry.Value().valid = true;
+            this->callbacks.Add(entry.Key(), entry.Value());
+        }
+        this->toAdd.Clear();
+    };
+    struct item {
+        Func func;
+        bool valid;
+    };
+    Id curId = 0;
+    Map<Id, item> callbacks;
+    Map<Id, item> toAdd;
+    Set<Id> toRemove;
+};
+
+//------------------------------------------------------------------------------
+// run a loop for numFrames frames and return the time per frame in
+// microseconds, the minimum of several rounds is used to filter out
+// scheduling noise
+template<class LOOP, class FUNC> static double
+measure(LOOP& loop, int numFrames, FUNC&& perFrame) {
+    double best = 0.0;
+    for (int round = 0; round < 5; round++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numFrames; i++) {
+            perFrame(loop, i);
+            loop.Run();
+        }
+        const std::chrono::duration<double> dur = std::chrono::steady_clock::now() - start;
+        const double us = (dur.count() * 1e6) / numFrames;
+        if ((0 == round) || (us < best)) {
+            best = us;
+        }
+    }
+    return best;
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopBenchmark) {
+    const int numCallbacks = 500;
+    const int numFrames = 2000;
+    const int numRounds = 5;
+    int counter = 0;
+    struct obj {
+        int* counter;
+        int value;
+        void update() { *this->counter += this->value; };
+    };
+    obj objs[numCallbacks];
+    for (int i = 0; i < numCallbacks; i++) {
+        objs[i].counter = &counter;
+        objs[i].value = 1;
+    }
+    auto noChurn = [](auto&, int) { };
+
+    RunLoop runLoop;
+    mapRunLoop mapLoop;
+    for (int i = 0; i < numCallbacks; i++) {
+        obj* o = &objs[i];
+        runLoop.Add([o]() { o->update(); }, RunLoop::Default, i % 7);
+        mapLoop.Add([o]() { o->update(); });
+    }
+
+    // add/remove churn: each frame removes one callback and adds a new one
+    RunLoop churnLoop;
+    mapRunLoop mapChurnLoop;
+    Array<RunLoop::Id> ids;
+    Array<mapRunLoop::Id> mapIds;
+    for (int i = 0; i < numCallbacks; i++) {
+        obj* o = &objs[i];
+        ids.Add(churnLoop.Add([o]() { o->update(); }));
+        mapIds.Add(mapChurnLoop.Add([o]() { o->update(); }));
+    }
+    auto addRemove = [&objs, numCallbacks](RunLoop& loop, Array<RunLoop::Id>& ids, int i) {
+        const int index = i % numCallbacks;
+        loop.Remove(ids[index]);
+        obj* o = &objs[index];
+        ids[index] = loop.Add([o]() { o->update(); }, RunLoop::Default, i % 7);
+    };
+    auto mapAddRemove = [&objs, numCallbacks](mapRunLoop& loop, Array<mapRunLoop::Id>& ids, int i) {
+        const int index = i % numCallbacks;
+        loop.Remove(ids[index]);
+        obj* o = &objs[index];
+        ids[index] = loop.Add([o]() { o->update(); });
+    };
+
+    // the variants are measured interleaved so that they all see the
+    // same cache and clock-frequency conditions
+    double flat = 0.0, map = 0.0, flatChurn = 0.0, mapChurn = 0.0;
+    for (int round = 0; round < numRounds; round++) {
+        const double t0 = measure(runLoop, numFrames, noChurn);
+        const double t1 = measure(mapLoop, numFrames, noChurn);
+        const double t2 = measure(churnLoop, numFrames, [&](RunLoop& l, int i) { addRemove(l, ids, i); });
+        const double t3 = measure(mapChurnLoop, numFrames, [&](mapRunLoop& l, int i) { mapAddRemove(l, mapIds, i); });
+        if ((0 == round) || (t0 < flat)) flat = t0;
+        if ((0 == round) || (t1 < map)) map = t1;
+        if ((0 == round) || (t2 < flatChurn)) flatChurn = t2;
+        if ((0 == round) || (t3 < mapChurn)) mapChurn = t3;
+    }
+    CHECK(counter == 4 * numCallbacks * numFrames * numRounds * 5);
+    CHECK(churnLoop.NumCallbacks() == numCallbacks);
+
+    Log::Info("RunLoop: %d callbacks, best of %d x %d frames:\n"
+              "  flat:               %.3fus/frame\n"
+              "  map+std::function:  %.3fus/frame\n"
+              "  flat, add+remove:   %.3fus/frame\n"
+              "  map, add+remove:    %.3fus/frame\n",
+        numCallbacks, numRounds * 5, numFrames, flat, map, flatChurn, mapChurn);
+}
@@ -7,8 +7,11 @@
 #include "Core/String/StringAtom.h"
 #include "Core/String/String.h"
 #include "Core/Core.h"
+#include "Core/Log.h"
+#include "Core/Containers/Array.h"
 
 #include <cstring>
+#include <cstdio>
 #include <thread>
 #include <array>
 
@@ -109,4 +112,137 @@ TEST(StringAtomPerformance) {
         chrono::duration<double> dur = end - start;
         Log::Info("run %d: %dx StringAtoms created: %f sec\n", i, numStringAtoms, dur.count());
     }
-}
\ No newline at end of file
+}
+
+// test creation performance with many unique string atoms
+TEST(StringAtomUniquePerformance) {
+
+    const int numUniqueStrings = 200000;
+    Array<String> strings;
+    strings.Reserve(numUniqueStrings);
+    char buf[64];
+    for (int i = 0; i < numUniqueStrings; i++) {
+        std::snprintf(buf, sizeof(buf), "unique_atom_%d", i);
+        strings.Add(String(buf));
+    }
+    const int batchSize = 25000;
+    for (int first = 0; first < numUniqueStrings; first += batchSize) {
+        // NOTE: each batch uses new strings, so every StringAtom is a new table entry
+        chrono::time_point<chrono::system_clock> start, end;
+        start = chrono::system_clock::now();
+        Array<StringAtom> stringAtoms;
+        stringAtoms.Reserve(batchSize);
+        for (int j = first; j < (first + batchSize); j++) {
+            stringAtoms.Add(strings[j].AsCStr());
+        }
+        end = chrono::system_clock::now();
+        chrono::duration<double> dur = end - start;
+        Log::Info("%d unique StringAtoms created (%d atoms already in table): %f sec\n", batchSize, first, dur.count());
+        CHECK(stringAtoms.Back() == strings[first + batchSize - 1].AsCStr());
+    }
+}
+
+#if ORYOL_HAS_THREADS
+// atoms with the same string created in different threads must be identical
+TEST(StringAtomCrossThreadIdentity) {
+    const int numThreads = 4;
+    const int numStrings = 10000;
+    Array<StringAtom> atoms[numThreads];
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&atoms, t] {
+            Core::EnterThread();
+            char buf[64];
+            atoms[t].Reserve(numStrings);
+            for (int i = 0; i < numStrings; i++) {
+                std::snprintf(buf, sizeof(buf), "shared_atom_%d", i);
+                atoms[t].Add(StringAtom(buf));
+            }
+            Core::LeaveThread();
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    bool allIdentical = true;
+    for (int i = 0; i < numStrings; i++) {
+        for (int t = 1; t < numThreads; t++) {
+            allIdentical &= (atoms[0][i] == atoms[t][i]);
+            allIdentical &= (atoms[0][i].AsCStr() == atoms[t][i].AsCStr());
+        }
+    }
+    CHECK(allIdentical);
+    StringAtom atom("shared_atom_1234");
+    CHECK(atom.AsCStr() == atoms[2][1234].AsCStr());
+}
+
+// create atoms on a worker thread, copy and compare them on the main thread
+TEST(StringAtomCrossThreadPerformance) {
+    const int numStrings = 100000;
+    Array<String> strings;
+    strings.Reserve(numStrings);
+    char buf[64];
+    for (int i = 0; i < numStrings; i++) {
+        std::snprintf(buf, sizeof(buf), "cross_thread_atom_%d", i);
+        strings.Add(String(buf));
+    }
+    Array<StringAtom> workerAtoms;
+    workerAtoms.Reserve(numStrings);
+    std::thread worker([&strings, &workerAtoms] {
+        Core::EnterThread();
+        for (const String& str : strings) {
+            workerAtoms.Add(StringAtom(str));
+        }
+        Core::LeaveThread();
+    });
+    worker.join();
+    Array<StringAtom> mainAtoms;
+    mainAtoms.Reserve(numStrings);
+    for (const String& str : strings) {
+        mainAtoms.Add(StringAtom(str));
+    }
+
+    chrono::time_point<chrono::system_clock> start, end;
+    start = chrono::system_clock::now();
+    Array<StringAtom> copies;
+    copies.Reserve(numStrings);
+    for (const StringAtom& atom : workerAtoms) {
+        copies.Add(atom);
+    }
+    end = chrono::system_clock::now();
+    chrono::duration<double> copyDur = end - start;
+
+    start = chrono::system_clock::now();
+    int numEqual = 0;
+    for (int i = 0; i < numStrings; i++) {
+        if (copies[i] == mainAtoms[i]) {
+            numEqual++;
+        }
+    }
+    end = chrono::system_clock::now();
+    chrono::duration<double> compareDur = end - start;
+    CHECK(numEqual == numStrings);
+    Log::Info("%d StringAtoms from worker thread: copy to main thread: %f sec, compare: %f sec\n",
+        numStrings, copyDur.count(), compareDur.count());
+
+    // concurrent creation of the same atoms in several threads
+    const int numThreads = 4;
+    std::thread threads[numThreads];
+    start = chrono::system_clock::now();
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&strings] {
+            Core::EnterThread();
+            for (const String& str : strings) {
+                StringAtom atom(str.AsCStr());
+            }
+            Core::LeaveThread();
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    end = chrono::system_clock::now();
+    chrono::duration<double> createDur = end - start;
+    Log::Info("%d StringAtoms created in %d threads concurrently: %f sec\n", numStrings, numThreads, createDur.count());
+}
+#endif
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//  TimingStatsTest.cc
+//  Test TimingWindow and TimingStats.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Time/TimingStats.h"
+#include "Core/String/StringBuilder.h"
+#include <cstdio>
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(TimingWindowTest) {
+    TimingWindow window(100);
+    CHECK(window.Capacity() == 100);
+    CHECK(window.NumSamples() == 0);
+    TimingWindow::Summary empty = window.Summarize();
+    CHECK(empty.NumSamples == 0);
+    CHECK(empty.Max == Duration());
+
+    // add samples 1..100 in shuffled order
+    for (int i = 0; i < 100; i++) {
+        window.Add(Duration::FromMilliSeconds(double(((i * 37) % 100) + 1)));
+    }
+    CHECK(window.NumSamples() == 100);
+    CHECK(window.Last() == Duration::FromMilliSeconds(double(((99 * 37) % 100) + 1)));
+    TimingWindow::Summary s = window.Summarize();
+    CHECK(s.NumSamples == 100);
+    CHECK(s.Min == Duration::FromMilliSeconds(1.0));
+    CHECK(s.Max == Duration::FromMilliSeconds(100.0));
+    CHECK_CLOSE(50.5, s.Mean.AsMilliSeconds(), 0.001);
+    CHECK(s.P50 == Duration::FromMilliSeconds(50.0));
+    CHECK(s.P95 == Duration::FromMilliSeconds(95.0));
+    CHECK(s.P99 == Duration::FromMilliSeconds(99.0));
+    CHECK(window.Percentile(0.0) == Duration::FromMilliSeconds(1.0));
+    CHECK(window.Percentile(100.0) == Duration::FromMilliSeconds(100.0));
+
+    // histogram with 10ms buckets, last bucket collects everything >= 40ms
+    Array<int> hist = window.Histogram(Duration::FromMilliSeconds(10.0), 5);
+    CHECK(hist.Size() == 5);
+    CHECK(hist[0] == 9);
+    CHECK(hist[1] == 10);
+    CHECK(hist[2] == 10);
+    CHECK(hist[3] == 10);
+    CHECK(hist[4] == 61);
+
+    // rolling: overwrite the oldest samples
+    for (int i = 0; i < 50; i++) {
+        window.Add(Duration::FromMilliSeconds(200.0));
+    }
+    CHECK(window.NumSamples() == 100);
+    CHECK(window.Sample(99) == Duration::FromMilliSeconds(200.0));
+    CHECK(window.Sample(0) == Duration::FromMilliSeconds(double(((50 * 37) % 100) + 1)));
+    s = window.Summarize();
+    CHECK(s.Max == Duration::FromMilliSeconds(200.0));
+    CHECK(s.P50 < Duration::FromMilliSeconds(200.0));
+    CHECK(s.P95 == Duration::FromMilliSeconds(200.0));
+
+    window.Clear();
+    CHECK(window.NumSamples() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(TimingStatsTest) {
+    TimingStats stats(16);
+    CHECK(stats.NumTimings() == 0);
+    CHECK(!stats.Has("Update"));
+
+    // the first FrameTick() only starts measuring
+    stats.FrameTick();
+    CHECK(stats.FrameTimes().NumSamples() == 0);
+    for (int i = 0; i < 3; i++) {
+        {
+            TimingStats::Scope scope(stats, "Update");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        stats.Add("Draw", Duration::FromMilliSeconds(double(i + 1)));
+        stats.FrameTick();
+    }
+    CHECK(stats.FrameTimes().NumSamples() == 3);
+    CHECK(stats.FrameTimes().Summarize().Min >= Duration::FromMilliSeconds(2.0));
+    CHECK(stats.NumTimings() == 2);
+    CHECK(stats.TimingName(0) == "Update");
+    CHECK(stats.TimingName(1) == "Draw");
+    CHECK(stats.Has("Update"));
+    CHECK(stats.Timings("Update").NumSamples() == 3);
+    CHECK(stats.Timings("Update").Summarize().Min >= Duration::FromMilliSeconds(2.0));
+    CHECK(stats.Timings("Draw").Summarize().Max == Duration::FromMilliSeconds(3.0));
+
+    String csv = stats.AsCSV();
+    CHECK(StringBuilder::FindSubString(csv.AsCStr(), 0, EndOfString, "name,samples,min_ms,max_ms,mean_ms,p50_ms,p95_ms,p99_ms\nframe,3,") == 0);
+    CHECK(StringBuilder::FindSubString(csv.AsCStr(), 0, EndOfString, "\nDraw,3,1.000,3.000,2.000,2.000,3.000,3.000\n") != InvalidIndex);
+    stats.Dump();
+
+    const char* path = "TimingStatsTest.csv";
+    CHECK(stats.WriteCSV(path));
+    FILE* fp = std::fopen(path, "rb");
+    CHECK(fp);
+    if (fp) {
+        char buf[1024] = { };
+        const size_t num = std::fread(buf, 1, sizeof(buf) - 1, fp);
+        std::fclose(fp);
+        CHECK(int(num) == csv.Length());
+        CHECK(csv == buf);
+    }
+    std::remove(path);
+
+    stats.Clear();
+    CHECK(stats.FrameTimes().NumSamples() == 0);
+    CHECK(stats.Timings("Draw").NumSamples() == 0);
+    stats.FrameTick();
+    CHECK(stats.FrameTimes().NumSamples() == 0);
+}
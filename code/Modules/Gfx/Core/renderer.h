@@ -5,7 +5,13 @@
     @ingroup _priv
     @brief main rendering API wrapper
  */
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+#include "Gfx/headless/headlessRenderer.h"
+namespace Oryol {
+namespace _priv {
+class renderer : public headlessRenderer { };
+} }
+#elif ORYOL_OPENGL
 #include "Gfx/gl/glRenderer.h"
 namespace Oryol {
 namespace _priv {
@@ -123,6 +123,7 @@ Gfx::FrameInfo() {
 //------------------------------------------------------------------------------
 void
 Gfx::BeginPass() {
+    o_trace_scoped(Gfx_BeginPass);
     o_assert_dbg(IsValid());
     o_assert_dbg(!state->inPass);
     state->inPass = true;
@@ -133,6 +134,7 @@ Gfx::BeginPass() {
 //------------------------------------------------------------------------------
 void
 Gfx::BeginPass(const PassAction& action) {
+    o_trace_scoped(Gfx_BeginPass);
     o_assert_dbg(IsValid());
     o_assert_dbg(!state->inPass);
     state->inPass = true;
@@ -143,6 +145,7 @@ Gfx::BeginPass(const PassAction& action) {
 //------------------------------------------------------------------------------
 void
 Gfx::BeginPass(const Id& id) {
+    o_trace_scoped(Gfx_BeginPass);
     o_assert_dbg(IsValid());
     o_assert_dbg(!state->inPass);
     state->inPass = true;
@@ -155,6 +158,7 @@ Gfx::BeginPass(const Id& id) {
 //------------------------------------------------------------------------------
 void
 Gfx::BeginPass(const Id& id, const PassAction& passAction) {
+    o_trace_scoped(Gfx_BeginPass);
     o_assert_dbg(IsValid());
     o_assert_dbg(!state->inPass);
     state->inPass = true;
@@ -167,6 +171,7 @@ Gfx::BeginPass(const Id& id, const PassAction& passAction) {
 //------------------------------------------------------------------------------
 void
 Gfx::EndPass() {
+    o_trace_scoped(Gfx_EndPass);
     o_assert_dbg(IsValid());
     o_assert_dbg(state->inPass);
     state->inPass = false;
@@ -391,6 +396,9 @@ Gfx::Draw(int primGroupIndex, int numInstances) {
     o_assert_dbg(IsValid());
     o_assert_dbg(state->inPass);
     state->gfxFrameInfo.NumDraw++;
+    if (numInstances > 1) {
+        state->gfxFrameInfo.NumDrawInstanced++;
+    }
     state->renderer.draw(primGroupIndex, numInstances);
 }
 
@@ -401,6 +409,9 @@ Gfx::Draw(const PrimitiveGroup& primGroup, int numInstances) {
     o_assert_dbg(IsValid());
     o_assert_dbg(state->inPass);
     state->gfxFrameInfo.NumDraw++;
+    if (numInstances > 1) {
+        state->gfxFrameInfo.NumDrawInstanced++;
+    }
     state->renderer.draw(primGroup.BaseElement, primGroup.NumElements, numInstances);
 }
 
@@ -634,6 +645,7 @@ Gfx::validateShaderSetup(const ShaderSetup& setup) {
 //------------------------------------------------------------------------------
 template<> Id
 Gfx::CreateResource(const TextureSetup& setup, const void* data, int size) {
+    o_trace_scoped(Gfx_CreateResource);
     o_assert_dbg(IsValid());
     #if ORYOL_DEBUG
     validateTextureSetup(setup, data, size);
@@ -644,6 +656,7 @@ Gfx::CreateResource(const TextureSetup& setup, const void* data, int size) {
 //------------------------------------------------------------------------------
 template<> Id
 Gfx::CreateResource(const MeshSetup& setup, const void* data, int size) {
+    o_trace_scoped(Gfx_CreateResource);
     o_assert_dbg(IsValid());
     #if ORYOL_DEBUG
     validateMeshSetup(setup, data, size);
@@ -654,6 +667,7 @@ Gfx::CreateResource(const MeshSetup& setup, const void* data, int size) {
 //------------------------------------------------------------------------------
 template<> Id
 Gfx::CreateResource(const ShaderSetup& setup, const void* data, int size) {
+    o_trace_scoped(Gfx_CreateResource);
     o_assert_dbg(IsValid());
     #if ORYOL_DEBUG
     validateShaderSetup(setup);
@@ -664,6 +678,7 @@ Gfx::CreateResource(const ShaderSetup& setup, const void* data, int size) {
 //------------------------------------------------------------------------------
 template<> Id
 Gfx::CreateResource(const PipelineSetup& setup, const void* data, int size) {
+    o_trace_scoped(Gfx_CreateResource);
     o_assert_dbg(IsValid());
     #if ORYOL_DEBUG
     validatePipelineSetup(setup);
@@ -674,6 +689,7 @@ Gfx::CreateResource(const PipelineSetup& setup, const void* data, int size) {
 //------------------------------------------------------------------------------
 template<> Id
 Gfx::CreateResource(const PassSetup& setup, const void* data, int size) {
+    o_trace_scoped(Gfx_CreateResource);
     o_assert_dbg(IsValid());
     #if ORYOL_DEBUG
     validatePassSetup(setup);
@@ -8,6 +8,7 @@
     @ingroup Gfx
     @brief Gfx module facade
 */
+#include <functional>
 #include "Core/RunLoop.h"
 #include "Gfx/Core/GfxTypes.h"
 #include "Resource/ResourceLabel.h"
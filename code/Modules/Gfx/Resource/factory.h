@@ -1,6 +1,12 @@
 #pragma once
 //------------------------------------------------------------------------------
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+#include "Gfx/headless/headlessMeshFactory.h"
+#include "Gfx/headless/headlessShaderFactory.h"
+#include "Gfx/headless/headlessTextureFactory.h"
+#include "Gfx/Resource/pipelineFactoryBase.h"
+#include "Gfx/Resource/renderPassFactoryBase.h"
+#elif ORYOL_OPENGL
 #include "Gfx/gl/glMeshFactory.h"
 #include "Gfx/gl/glPipelineFactory.h"
 #include "Gfx/gl/glShaderFactory.h"
@@ -24,7 +30,13 @@
 
 namespace Oryol {
 namespace _priv {
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+class meshFactory : public headlessMeshFactory { };
+class pipelineFactory : public pipelineFactoryBase { };
+class shaderFactory : public headlessShaderFactory { };
+class textureFactory : public headlessTextureFactory { };
+class renderPassFactory : public renderPassFactoryBase { };
+#elif ORYOL_OPENGL
 class meshFactory : public glMeshFactory { };
 class pipelineFactory : public glPipelineFactory { };
 class shaderFactory : public glShaderFactory { };
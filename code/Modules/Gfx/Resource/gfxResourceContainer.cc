@@ -3,6 +3,8 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "Core/Core.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Trace.h"
 #include "gfxResourceContainer.h"
 #include "Gfx/Core/displayMgr.h"
 
@@ -13,6 +15,7 @@ namespace _priv {
 void
 gfxResourceContainer::setup(const GfxSetup& setup, const gfxPointers& ptrs) {
     o_assert(!this->isValid());
+    o_memory_scope("Gfx");
     
     this->pointers = ptrs;
     this->pendingLoaders.Reserve(128);
@@ -382,6 +385,8 @@ gfxResourceContainer::Destroy(const ResourceLabel& label) {
 void
 gfxResourceContainer::update() {
     o_assert_dbg(this->isValid());
+    o_trace_scoped(Gfx_ResourceUpdate);
+    o_memory_scope("Gfx");
     
     /// call update method on resource pools (this is cheap)
     this->meshPool.Update();
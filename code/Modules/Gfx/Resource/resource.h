@@ -1,6 +1,8 @@
 #pragma once
 //------------------------------------------------------------------------------
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+#include "Gfx/headless/headlessResource.h"
+#elif ORYOL_OPENGL
 #include "Gfx/gl/glResource.h"
 #elif ORYOL_D3D11
 #include "Gfx/d3d11/d3d11Resource.h"
@@ -23,7 +25,9 @@
 namespace Oryol {
 namespace _priv {
 
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+class mesh : public headlessMesh { };
+#elif ORYOL_OPENGL
 class mesh : public glMesh { };
 #elif ORYOL_D3D11
 class mesh : public d3d11Mesh { };
@@ -37,7 +41,9 @@ class mesh : public mtlMesh { };
     @ingroup _priv
     @brief wraps all the pipeline state required for rendering
 */
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+class pipeline : public headlessPipeline { };
+#elif ORYOL_OPENGL
 class pipeline : public glPipeline { };
 #elif ORYOL_D3D11
 class pipeline : public d3d11Pipeline { };
@@ -57,7 +63,9 @@ class pipeline : public mtlPipeline { };
     bundle also maps shader variables to common slot indices across
     all contained programs.
 */
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+class shader : public headlessShader { };
+#elif ORYOL_OPENGL
 class shader : public glShader { };
 #elif ORYOL_D3D11
 class shader : public d3d11Shader { };
@@ -76,7 +84,9 @@ class shader : public mtlShader { };
     A texture object can be a normal 2D, 3D or cube texture, as well
     as a render target with optional depth buffer.
 */
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+class texture : public headlessTexture { };
+#elif ORYOL_OPENGL
 class texture : public glTexture { };
 #elif ORYOL_D3D11
 class texture : public d3d11Texture { };
@@ -92,7 +102,9 @@ class texture : public mtlTexture { };
     @ingroup _priv
     @brief render-pass frontend class
 */
-#if ORYOL_OPENGL
+#if ORYOL_HEADLESS
+class renderPass : public headlessRenderPass { };
+#elif ORYOL_OPENGL
 class renderPass : public glRenderPass { };
 #elif ORYOL_D3D11
 class renderPass : public d3d11RenderPass { };
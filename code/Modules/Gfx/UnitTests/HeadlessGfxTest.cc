@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+//  HeadlessGfxTest.cc
+//  Test the Gfx module with the headless backend, and measure the
+//  CPU overhead of the Gfx API.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Time/Clock.h"
+#include "Gfx/Gfx.h"
+
+#if ORYOL_HEADLESS
+using namespace Oryol;
+
+namespace {
+
+struct vsParams {
+    static const int _bindSlotIndex = 0;
+    static const ShaderStage::Code _bindShaderStage = ShaderStage::VS;
+    static const uint32_t _layoutHash = 0x12345678;
+    float color[4];
+};
+
+Id setupShader() {
+    UniformBlockLayout ubLayout;
+    ubLayout.TypeHash = vsParams::_layoutHash;
+    ubLayout.Add("color", UniformType::Vec4);
+    ShaderSetup shdSetup("headlessShader");
+    shdSetup.AddUniformBlock("vsParams", ubLayout, vsParams::_bindShaderStage, vsParams::_bindSlotIndex);
+    return Gfx::CreateResource(shdSetup);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(HeadlessGfxTest) {
+    Core::Setup();
+    Gfx::Setup(GfxSetup::Window(400, 300, "Headless Test"));
+    CHECK(Gfx::IsValid());
+    CHECK(!Gfx::QuitRequested());
+    CHECK(Gfx::DisplayAttrs().FramebufferWidth == 400);
+    CHECK(Gfx::DisplayAttrs().FramebufferHeight == 300);
+
+    // create resources
+    Id shd = setupShader();
+    CHECK(Gfx::QueryResourceInfo(shd).State == ResourceState::Valid);
+
+    Id quad = Gfx::CreateResource(MeshSetup::FullScreenQuad());
+    CHECK(Gfx::QueryResourceInfo(quad).State == ResourceState::Valid);
+
+    const float vertices[6] = { };
+    auto meshSetup = MeshSetup::Empty(3, Usage::Stream);
+    meshSetup.Layout.Add(VertexAttr::Position, VertexFormat::Float2);
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(0, 3));
+    Id dynMesh = Gfx::CreateResource(meshSetup);
+    CHECK(Gfx::QueryResourceInfo(dynMesh).State == ResourceState::Valid);
+
+    auto pipSetup = PipelineSetup::FromLayoutAndShader(meshSetup.Layout, shd);
+    Id pip = Gfx::CreateResource(pipSetup);
+    CHECK(Gfx::QueryResourceInfo(pip).State == ResourceState::Valid);
+
+    Id rt = Gfx::CreateResource(TextureSetup::RenderTarget2D(128, 64, PixelFormat::RGBA8, PixelFormat::DEPTHSTENCIL));
+    CHECK(Gfx::QueryResourceInfo(rt).State == ResourceState::Valid);
+    Id pass = Gfx::CreateResource(PassSetup::From(rt, rt));
+    CHECK(Gfx::QueryResourceInfo(pass).State == ResourceState::Valid);
+
+    // render a few frames and check the frame statistics
+    DrawState drawState;
+    drawState.Pipeline = pip;
+    drawState.Mesh[0] = dynMesh;
+    vsParams params = { };
+    for (int frame = 0; frame < 3; frame++) {
+        Gfx::UpdateVertices(dynMesh, vertices, sizeof(vertices));
+        Gfx::BeginPass(pass);
+        CHECK(Gfx::PassAttrs().FramebufferWidth == 128);
+        CHECK(Gfx::PassAttrs().FramebufferHeight == 64);
+        Gfx::EndPass();
+        Gfx::BeginPass();
+        CHECK(Gfx::PassAttrs().FramebufferWidth == 400);
+        Gfx::ApplyViewPort(0, 0, 200, 150);
+        Gfx::ApplyDrawState(drawState);
+        Gfx::ApplyUniformBlock(params);
+        Gfx::Draw();
+        Gfx::Draw(0, 16);
+        Gfx::Draw(PrimitiveGroup(0, 3));
+        Gfx::EndPass();
+        const GfxFrameInfo& info = Gfx::FrameInfo();
+        CHECK(info.NumPasses == 2);
+        CHECK(info.NumApplyViewPort == 1);
+        CHECK(info.NumApplyDrawState == 1);
+        CHECK(info.NumApplyUniformBlock == 1);
+        CHECK(info.NumUpdateVertices == 1);
+        CHECK(info.NumDraw == 3);
+        CHECK(info.NumDrawInstanced == 1);
+        Gfx::CommitFrame();
+        CHECK(Gfx::FrameInfo().NumDraw == 0);
+    }
+
+    // destroy resources
+    CHECK(Gfx::QueryFreeResourceSlots(GfxResourceType::Mesh) < GfxSetup().ResourcePoolSize[GfxResourceType::Mesh]);
+    Gfx::DestroyResources(ResourceLabel::All);
+    Gfx::CommitFrame();
+    CHECK(Gfx::QueryResourceInfo(dynMesh).State == ResourceState::InvalidState);
+    CHECK(Gfx::QueryFreeResourceSlots(GfxResourceType::Mesh) == GfxSetup().ResourcePoolSize[GfxResourceType::Mesh]);
+
+    Gfx::Discard();
+    CHECK(!Gfx::IsValid());
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(HeadlessGfxBenchmark) {
+    Core::Setup();
+    Gfx::Setup(GfxSetup::Window(400, 300, "Headless Benchmark"));
+    Id shd = setupShader();
+    auto meshSetup = MeshSetup::FromData();
+    meshSetup.NumVertices = 3;
+    meshSetup.Layout.Add(VertexAttr::Position, VertexFormat::Float2);
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(0, 3));
+    const float vertices[6] = { };
+    Id msh = Gfx::CreateResource(meshSetup, vertices, sizeof(vertices));
+    DrawState drawState;
+    drawState.Pipeline = Gfx::CreateResource(PipelineSetup::FromLayoutAndShader(meshSetup.Layout, shd));
+    drawState.Mesh[0] = msh;
+
+    // same structure as the DrawCallPerf sample: one draw state, and
+    // one uniform block update and draw call per object
+    const int numFrames = 100;
+    const int numDraws = 10000;
+    vsParams params = { };
+    TimePoint start = Clock::Now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        Gfx::BeginPass();
+        Gfx::ApplyDrawState(drawState);
+        for (int i = 0; i < numDraws; i++) {
+            params.color[0] = float(i);
+            Gfx::ApplyUniformBlock(params);
+            Gfx::Draw();
+        }
+        Gfx::EndPass();
+        Gfx::CommitFrame();
+    }
+    const double ms = Clock::Since(start).AsMilliSeconds();
+    Log::Info("HeadlessGfxBenchmark: %d frames x %d draws, %.3f ms/frame (%.1f ns per uniform update + draw)\n",
+        numFrames, numDraws, ms / numFrames, (ms * 1000000.0) / (double(numFrames) * numDraws));
+
+    Gfx::Discard();
+    Core::Discard();
+}
+#endif
@@ -44,8 +44,10 @@ TEST(RenderTargetCreationTest) {
     texture tex0;
     tex0.Setup = texSetup;
     factory.SetupResource(tex0, nullptr, 0);
+    #if ORYOL_OPENGL
     CHECK(tex0.glTextures[0] != 0);
     CHECK(tex0.glDepthRenderbuffer == 0);
+    #endif
     const TextureAttrs& attrs0 = tex0.textureAttrs;
     CHECK(attrs0.Locator == Locator::NonShared());
     CHECK(attrs0.Type == TextureType::Texture2D);
@@ -66,8 +68,10 @@ TEST(RenderTargetCreationTest) {
     texture tex1;
     tex1.Setup = rtSetup;
     factory.SetupResource(tex1, nullptr, 0);
+    #if ORYOL_OPENGL
     CHECK(tex1.glTextures[0] != 0);
     CHECK(tex1.glDepthRenderbuffer != 0);
+    #endif
     const TextureAttrs& attrs1 = tex1.textureAttrs;
     CHECK(attrs1.Locator == Locator::NonShared());
     CHECK(attrs1.Type == TextureType::Texture2D);
@@ -83,8 +87,10 @@ TEST(RenderTargetCreationTest) {
 
     // cleanup
     factory.DestroyResource(tex1);
+    #if ORYOL_OPENGL
     CHECK(tex1.glTextures[0] == 0);
     CHECK(tex1.glDepthRenderbuffer == 0);
+    #endif
     
     factory.DestroyResource(tex0);
     factory.Discard();
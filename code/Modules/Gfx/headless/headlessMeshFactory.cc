@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//  headlessMeshFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "headlessMeshFactory.h"
+#include "Gfx/Resource/resource.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+headlessMeshFactory::~headlessMeshFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+headlessMeshFactory::Setup(const gfxPointers& ptrs) {
+    o_assert_dbg(!this->isValid);
+    this->pointers = ptrs;
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessMeshFactory::Discard() {
+    o_assert_dbg(this->isValid);
+    this->pointers = gfxPointers();
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+headlessMeshFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+headlessMeshFactory::SetupResource(mesh& msh, const void* data, int size) {
+    o_assert_dbg(this->isValid);
+    if (msh.Setup.ShouldSetupFullScreenQuad()) {
+        return this->createFullscreenQuad(msh);
+    }
+    else {
+        return this->createMesh(msh, data, size);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+headlessMeshFactory::DestroyResource(mesh& msh) {
+    o_assert_dbg(this->isValid);
+    msh.Clear();
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+headlessMeshFactory::createFullscreenQuad(mesh& msh) {
+    o_assert_dbg(msh.Setup.Layout.NumComponents() == 2);
+    o_assert_dbg(msh.Setup.Layout.ComponentAt(0).Attr == VertexAttr::Position);
+    o_assert_dbg(msh.Setup.Layout.ComponentAt(1).Attr == VertexAttr::TexCoord0);
+
+    VertexBufferAttrs vbAttrs;
+    vbAttrs.NumVertices = 4;
+    vbAttrs.BufferUsage = Usage::Immutable;
+    vbAttrs.Layout = msh.Setup.Layout;
+    msh.vertexBufferAttrs = vbAttrs;
+
+    IndexBufferAttrs ibAttrs;
+    ibAttrs.NumIndices = 6;
+    ibAttrs.Type = IndexType::Index16;
+    ibAttrs.BufferUsage = Usage::Immutable;
+    msh.indexBufferAttrs = ibAttrs;
+
+    msh.numPrimGroups = 1;
+    msh.primGroups[0] = PrimitiveGroup(0, 6);
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+headlessMeshFactory::createMesh(mesh& msh, const void* data, int size) {
+    const MeshSetup& setup = msh.Setup;
+
+    VertexBufferAttrs vbAttrs;
+    vbAttrs.NumVertices = setup.NumVertices;
+    vbAttrs.Layout = setup.Layout;
+    vbAttrs.BufferUsage = setup.VertexUsage;
+    msh.vertexBufferAttrs = vbAttrs;
+
+    IndexBufferAttrs ibAttrs;
+    ibAttrs.NumIndices = setup.NumIndices;
+    ibAttrs.Type = setup.IndicesType;
+    ibAttrs.BufferUsage = setup.IndexUsage;
+    msh.indexBufferAttrs = ibAttrs;
+
+    msh.numPrimGroups = setup.NumPrimitiveGroups();
+    o_assert_dbg(msh.numPrimGroups < GfxConfig::MaxNumPrimGroups);
+    for (int i = 0; i < msh.numPrimGroups; i++) {
+        msh.primGroups[i] = setup.PrimitiveGroup(i);
+    }
+
+    // validate that the provided data covers the vertex and index data,
+    // like the 3D API backends do when creating the buffers
+    const uint8_t* ptr = (const uint8_t*)data;
+    if (ptr && (setup.NumVertices > 0)) {
+        const int vbSize = vbAttrs.NumVertices * vbAttrs.Layout.ByteSize();
+        o_assert_dbg(setup.VertexDataOffset >= 0);
+        o_assert_dbg(size >= (setup.VertexDataOffset + vbSize));
+    }
+    if (ptr && (ibAttrs.Type != IndexType::None)) {
+        const int ibSize = ibAttrs.NumIndices * IndexType::ByteSize(ibAttrs.Type);
+        o_assert_dbg(setup.IndexDataOffset >= 0);
+        o_assert_dbg(size >= (setup.IndexDataOffset + ibSize));
+    }
+    return ResourceState::Valid;
+}
+
+} // namespace _priv
+} // namespace Oryol
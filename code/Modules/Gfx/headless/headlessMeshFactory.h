@@ -0,0 +1,48 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessMeshFactory
+    @ingroup _priv
+    @brief headless implementation of meshFactory
+
+    Sets up the mesh attributes and primitive groups like the real 3D API
+    backends, but doesn't create any buffers.
+*/
+#include "Resource/ResourceState.h"
+#include "Gfx/Core/GfxTypes.h"
+#include "Gfx/Core/gfxPointers.h"
+
+namespace Oryol {
+namespace _priv {
+
+class mesh;
+
+class headlessMeshFactory {
+public:
+    /// destructor
+    ~headlessMeshFactory();
+
+    /// setup the factory
+    void Setup(const gfxPointers& ptrs);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup with 'raw' data
+    ResourceState::Code SetupResource(mesh& msh, const void* data, int size);
+    /// discard the resource
+    void DestroyResource(mesh& msh);
+
+private:
+    /// setup mesh attributes for a fullscreen quad
+    ResourceState::Code createFullscreenQuad(mesh& msh);
+    /// setup mesh attributes from mesh setup
+    ResourceState::Code createMesh(mesh& msh, const void* data, int size);
+
+    gfxPointers pointers;
+    bool isValid = false;
+};
+
+} // namespace _priv
+} // namespace Oryol
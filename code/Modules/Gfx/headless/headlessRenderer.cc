@@ -0,0 +1,285 @@
+//------------------------------------------------------------------------------
+//  headlessRenderer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "headlessRenderer.h"
+#include "Gfx/Core/displayMgr.h"
+#include "Gfx/Resource/resource.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+headlessRenderer::headlessRenderer() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+headlessRenderer::~headlessRenderer() {
+    o_assert_dbg(!this->valid);
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::setup(const GfxSetup& setup, const gfxPointers& ptrs) {
+    o_assert_dbg(!this->valid);
+    this->valid = true;
+    this->pointers = ptrs;
+    this->gfxSetup = setup;
+    this->frameIndex = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::discard() {
+    o_assert_dbg(this->valid);
+    this->resetStateCache();
+    this->pointers = gfxPointers();
+    this->valid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+headlessRenderer::isValid() const {
+    return this->valid;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::resetStateCache() {
+    o_assert_dbg(this->valid);
+    this->curPipeline = nullptr;
+    this->curPrimaryMesh = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+headlessRenderer::queryFeature(GfxFeature::Code feat) const {
+    o_assert_dbg(this->valid);
+    switch (feat) {
+        // everything is 'supported' so that applications run the same
+        // code paths as on a capable GPU, except for features which
+        // would require a real 3D API
+        case GfxFeature::OriginTopLeft:
+        case GfxFeature::NativeTexture:
+            return false;
+        default:
+            return true;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::commitFrame() {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(!this->rpValid, "CommitFrame() called inside BeginPass / EndPass!\n");
+    this->rpValid = false;
+    this->curPipeline = nullptr;
+    this->curPrimaryMesh = nullptr;
+    this->frameIndex++;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::beginPass(renderPass* pass, const PassAction* action) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(action);
+    o_assert2_dbg(!this->rpValid, "BeginPass() called inside BeginPass / EndPass!\n");
+
+    if (nullptr == pass) {
+        this->rpAttrs = this->pointers.displayMgr->GetDisplayAttrs();
+    }
+    else {
+        o_assert_dbg(pass->colorTextures[0]);
+        this->rpAttrs = DisplayAttrs::FromTextureAttrs(pass->colorTextures[0]->textureAttrs);
+    }
+    this->curRenderPass = pass;
+    this->rpValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::endPass() {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rpValid, "EndPass() called without BeginPass()!\n");
+    this->curRenderPass = nullptr;
+    this->rpValid = false;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::applyViewPort(int x, int y, int width, int height, bool originTopLeft) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rpValid, "Not inside BeginPass / EndPass!\n");
+    o_assert_dbg((width >= 0) && (height >= 0));
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::applyScissorRect(int x, int y, int width, int height, bool originTopLeft) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rpValid, "Not inside BeginPass / EndPass!\n");
+    o_assert_dbg((width >= 0) && (height >= 0));
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::applyDrawState(pipeline* pip, mesh** meshes, int numMeshes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(pip);
+    o_assert_dbg(meshes && (numMeshes > 0));
+    o_assert2_dbg(this->rpValid, "Not inside BeginPass / EndPass!\n");
+
+    #if ORYOL_DEBUG
+    const PipelineSetup& setup = pip->Setup;
+    o_assert2(setup.BlendState.ColorFormat == this->rpAttrs.ColorPixelFormat, "ColorFormat in BlendState must match current render target!\n");
+    o_assert2(setup.BlendState.DepthFormat == this->rpAttrs.DepthPixelFormat, "DepthFormat in BlendState must match current render target!\n");
+    o_assert2(setup.RasterizerState.SampleCount == this->rpAttrs.SampleCount, "SampleCount in RasterizerState must match current render target!\n");
+    if (this->curRenderPass) {
+        for (int i = 0; i < GfxConfig::MaxNumColorAttachments; i++) {
+            const texture* tex = this->curRenderPass->colorTextures[i];
+            if (tex) {
+                o_assert2(setup.BlendState.ColorFormat == tex->textureAttrs.ColorFormat, "ColorFormat in BlendState must match MRT color attachments!\n");
+                o_assert2(setup.RasterizerState.SampleCount == tex->textureAttrs.SampleCount, "SampleCount in RasterizerState must match MRT color attachments!\n");
+            }
+        }
+        const texture* dsTex = this->curRenderPass->depthStencilTexture;
+        if (dsTex) {
+            o_assert2(setup.BlendState.DepthFormat == dsTex->textureAttrs.DepthFormat, "DepthFormat in BlendState must match depth/stencil attachment!\n");
+        }
+    }
+    #endif
+
+    // if any of the meshes is still loading, cancel the next draw state
+    for (int i = 0; i < numMeshes; i++) {
+        if (nullptr == meshes[i]) {
+            this->curPipeline = nullptr;
+            return;
+        }
+    }
+    o_assert_dbg(pip->shd);
+    this->curPipeline = pip;
+    this->curPrimaryMesh = meshes[0];
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::applyUniformBlock(ShaderStage::Code bindStage, int bindSlot, uint32_t layoutHash, const uint8_t* ptr, int byteSize) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(0 != layoutHash);
+    o_assert_dbg(ptr);
+    if (!this->curPipeline) {
+        // currently no valid draw state set
+        return;
+    }
+    const shader* shd = this->curPipeline->shd;
+    o_assert_dbg(shd);
+    int ubIndex = shd->Setup.UniformBlockIndexByStageAndSlot(bindStage, bindSlot);
+    o_assert_dbg(InvalidIndex != ubIndex);
+    const UniformBlockLayout& layout = shd->Setup.UniformBlockLayout(ubIndex);
+    o_assert2(layout.TypeHash == layoutHash, "incompatible uniform block!\n");
+    #if !ORYOL_WIN32 // NOTE: VS 32-bit sometimes adds useless padding bytes at end of structs
+    o_assert_dbg(layout.ByteSize() == byteSize);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::applyTextures(ShaderStage::Code bindStage, texture** textures, int numTextures) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(((ShaderStage::VS == bindStage) && (numTextures <= GfxConfig::MaxNumVertexTextures)) ||
+                 ((ShaderStage::FS == bindStage) && (numTextures <= GfxConfig::MaxNumFragmentTextures)));
+    if (nullptr == this->curPipeline) {
+        return;
+    }
+    // if any texture is still loading, disable rendering for the next draw call
+    for (int i = 0; i < numTextures; i++) {
+        if (nullptr == textures[i]) {
+            this->curPipeline = nullptr;
+            return;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::draw(int baseElementIndex, int numElements, int numInstances) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(numInstances >= 1);
+    o_assert2_dbg(this->rpValid, "Not inside BeginPass / EndPass!\n");
+    if (nullptr == this->curPipeline) {
+        return;
+    }
+    const mesh* msh = this->curPrimaryMesh;
+    o_assert_dbg(msh);
+    o_assert_dbg((baseElementIndex >= 0) && (numElements >= 0));
+    if (IndexType::None != msh->indexBufferAttrs.Type) {
+        o_assert2_dbg((baseElementIndex + numElements) <= msh->indexBufferAttrs.NumIndices, "Draw call exceeds index buffer!\n");
+    }
+    else {
+        o_assert2_dbg((baseElementIndex + numElements) <= msh->vertexBufferAttrs.NumVertices, "Draw call exceeds vertex buffer!\n");
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::draw(int primGroupIndex, int numInstances) {
+    o_assert_dbg(this->valid);
+    o_assert2_dbg(this->rpValid, "Not inside BeginPass / EndPass!\n");
+    if (nullptr == this->curPipeline) {
+        return;
+    }
+    const mesh* msh = this->curPrimaryMesh;
+    o_assert_dbg(msh);
+    if (primGroupIndex >= msh->numPrimGroups) {
+        // same as the 3D API renderers: this may happen when rendering
+        // a placeholder mesh, and isn't a serious error
+        return;
+    }
+    const PrimitiveGroup& primGroup = msh->primGroups[primGroupIndex];
+    this->draw(primGroup.BaseElement, primGroup.NumElements, numInstances);
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::updateVertices(mesh* msh, const void* data, int numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg((numBytes > 0) && (numBytes <= msh->vertexBufferAttrs.ByteSize()));
+    o_assert_dbg(Usage::Immutable != msh->vertexBufferAttrs.BufferUsage);
+    o_assert2(msh->vbUpdateFrameIndex != this->frameIndex, "Only one data update allowed per buffer and frame!\n");
+    msh->vbUpdateFrameIndex = this->frameIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::updateIndices(mesh* msh, const void* data, int numBytes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != msh);
+    o_assert_dbg(nullptr != data);
+    o_assert_dbg(IndexType::None != msh->indexBufferAttrs.Type);
+    o_assert_dbg((numBytes > 0) && (numBytes <= msh->indexBufferAttrs.ByteSize()));
+    o_assert_dbg(Usage::Immutable != msh->indexBufferAttrs.BufferUsage);
+    o_assert2(msh->ibUpdateFrameIndex != this->frameIndex, "Only one data update allowed per buffer and frame!\n");
+    msh->ibUpdateFrameIndex = this->frameIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessRenderer::updateTexture(texture* tex, const void* data, const ImageDataAttrs& offsetsAndSizes) {
+    o_assert_dbg(this->valid);
+    o_assert_dbg(nullptr != tex);
+    o_assert_dbg(nullptr != data);
+    const TextureAttrs& attrs = tex->textureAttrs;
+    o_assert_dbg(TextureType::Texture2D == attrs.Type);
+    o_assert_dbg(Usage::Immutable != attrs.TextureUsage);
+    o_assert_dbg(!PixelFormat::IsCompressedFormat(attrs.ColorFormat));
+    o_assert_dbg(offsetsAndSizes.NumMipMaps <= attrs.NumMipMaps);
+    o_assert_dbg(offsetsAndSizes.NumFaces == 1);
+    o_assert2(tex->updateFrameIndex != this->frameIndex, "Only one data update allowed per texture and frame!\n");
+    tex->updateFrameIndex = this->frameIndex;
+}
+
+} // namespace _priv
+} // namespace Oryol
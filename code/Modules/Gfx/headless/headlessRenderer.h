@@ -0,0 +1,99 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessRenderer
+    @ingroup _priv
+    @brief renderer implementation without a 3D API
+
+    The headless renderer tracks the same render state as the 3D API
+    renderers (current pass, pipeline and meshes) and performs the same
+    validation checks, but doesn't issue any rendering commands. This
+    allows running Oryol applications without a window and GPU, for
+    instance to measure the CPU overhead of the Gfx module.
+*/
+#include "Core/Types.h"
+#include "Gfx/Core/GfxTypes.h"
+#include "Gfx/Core/gfxPointers.h"
+
+namespace Oryol {
+namespace _priv {
+
+class texture;
+class pipeline;
+class mesh;
+class shader;
+class renderPass;
+
+class headlessRenderer {
+public:
+    /// constructor
+    headlessRenderer();
+    /// destructor
+    ~headlessRenderer();
+
+    /// setup the renderer
+    void setup(const GfxSetup& setup, const gfxPointers& ptrs);
+    /// discard the renderer
+    void discard();
+    /// return true if renderer has been setup
+    bool isValid() const;
+
+    /// reset the internal state cache
+    void resetStateCache();
+    /// test if a feature is supported
+    bool queryFeature(GfxFeature::Code feat) const;
+    /// commit current frame
+    void commitFrame();
+    /// get the current render pass attributes
+    const DisplayAttrs& renderPassAttrs() const;
+
+    /// begin rendering pass (pass can be nullptr for default framebuffer)
+    void beginPass(renderPass* pass, const PassAction* action);
+    /// end current rendering pass
+    void endPass();
+
+    /// apply viewport
+    void applyViewPort(int x, int y, int width, int height, bool originTopLeft);
+    /// apply scissor rect
+    void applyScissorRect(int x, int y, int width, int height, bool originTopLeft);
+    /// apply draw state
+    void applyDrawState(pipeline* pip, mesh** meshes, int numMeshes);
+    /// apply a shader uniform block (called after applyDrawState)
+    void applyUniformBlock(ShaderStage::Code bindStage, int bindSlot, uint32_t layoutHash, const uint8_t* ptr, int byteSize);
+    /// apply a group of textures
+    void applyTextures(ShaderStage::Code bindStage, texture** textures, int numTextures);
+
+    /// submit a draw call with primitive group index in current mesh
+    void draw(int primGroupIndex, int numInstances);
+    /// submit a draw call with element range
+    void draw(int baseElementIndex, int numElements, int numInstances);
+
+    /// update vertex data
+    void updateVertices(mesh* msh, const void* data, int numBytes);
+    /// update index data
+    void updateIndices(mesh* msh, const void* data, int numBytes);
+    /// update texture pixel data
+    void updateTexture(texture* tex, const void* data, const ImageDataAttrs& offsetsAndSizes);
+
+private:
+    bool valid = false;
+    gfxPointers pointers;
+    GfxSetup gfxSetup;
+    int frameIndex = 0;
+
+    bool rpValid = false;
+    DisplayAttrs rpAttrs;
+
+    renderPass* curRenderPass = nullptr;
+    pipeline* curPipeline = nullptr;
+    mesh* curPrimaryMesh = nullptr;
+};
+
+//------------------------------------------------------------------------------
+inline const DisplayAttrs&
+headlessRenderer::renderPassAttrs() const {
+    return this->rpAttrs;
+}
+
+} // namespace _priv
+} // namespace Oryol
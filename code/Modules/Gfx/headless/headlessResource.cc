@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+//  headlessResource.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "headlessResource.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+void
+headlessMesh::Clear() {
+    this->vbUpdateFrameIndex = -1;
+    this->ibUpdateFrameIndex = -1;
+    meshBase::Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+headlessTexture::Clear() {
+    this->updateFrameIndex = -1;
+    textureBase::Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,66 @@
+#pragma once
+//------------------------------------------------------------------------------
+#include "Gfx/Resource/resourceBase.h"
+#include "Gfx/Core/GfxTypes.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessMesh
+    @ingroup _priv
+    @brief headless implementation of mesh
+*/
+class headlessMesh : public meshBase {
+public:
+    /// clear the object (called from meshFactory::DestroyResource())
+    void Clear();
+
+    /// frame index of last vertex buffer update (for update validation)
+    int vbUpdateFrameIndex = -1;
+    /// frame index of last index buffer update (for update validation)
+    int ibUpdateFrameIndex = -1;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessPipeline
+    @ingroup _priv
+    @brief headless implementation of pipeline
+*/
+class headlessPipeline : public pipelineBase { };
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessShader
+    @ingroup _priv
+    @brief headless implementation of shader
+*/
+class headlessShader : public shaderBase { };
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessTexture
+    @ingroup _priv
+    @brief headless implementation of texture
+*/
+class headlessTexture : public textureBase {
+public:
+    /// clear the object
+    void Clear();
+
+    /// frame index of last texture update (for update validation)
+    int updateFrameIndex = -1;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessRenderPass
+    @ingroup _priv
+    @brief headless implementation of renderPass
+*/
+class headlessRenderPass : public renderPassBase { };
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+//  headlessShaderFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "headlessShaderFactory.h"
+#include "Gfx/Resource/resource.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+headlessShaderFactory::~headlessShaderFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+headlessShaderFactory::Setup(const gfxPointers& ptrs) {
+    o_assert_dbg(!this->isValid);
+    this->pointers = ptrs;
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessShaderFactory::Discard() {
+    o_assert_dbg(this->isValid);
+    this->pointers = gfxPointers();
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+headlessShaderFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+headlessShaderFactory::SetupResource(shader& shd) {
+    o_assert_dbg(this->isValid);
+    #if ORYOL_DEBUG
+    const ShaderSetup& setup = shd.Setup;
+    for (int i = 0; i < setup.NumUniformBlocks(); i++) {
+        o_assert_dbg(0 != setup.UniformBlockLayout(i).TypeHash);
+    }
+    #endif
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessShaderFactory::DestroyResource(shader& shd) {
+    o_assert_dbg(this->isValid);
+    shd.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
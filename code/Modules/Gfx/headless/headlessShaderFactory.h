@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessShaderFactory
+    @ingroup _priv
+    @brief headless implementation of shaderFactory
+
+    Shader setups don't need to contain shader code for the headless
+    backend, only the uniform- and texture-block layouts are used
+    (for validation in the renderer).
+*/
+#include "Resource/ResourceState.h"
+#include "Gfx/Core/GfxTypes.h"
+#include "Gfx/Core/gfxPointers.h"
+
+namespace Oryol {
+namespace _priv {
+
+class shader;
+
+class headlessShaderFactory {
+public:
+    /// destructor
+    ~headlessShaderFactory();
+
+    /// setup the factory
+    void Setup(const gfxPointers& ptrs);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup resource
+    ResourceState::Code SetupResource(shader& shd);
+    /// destroy resource
+    void DestroyResource(shader& shd);
+
+private:
+    gfxPointers pointers;
+    bool isValid = false;
+};
+
+} // namespace _priv
+} // namespace Oryol
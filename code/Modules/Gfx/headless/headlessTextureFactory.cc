@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+//  headlessTextureFactory.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "headlessTextureFactory.h"
+#include "Gfx/Resource/resource.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+headlessTextureFactory::~headlessTextureFactory() {
+    o_assert_dbg(!this->isValid);
+}
+
+//------------------------------------------------------------------------------
+void
+headlessTextureFactory::Setup(const gfxPointers& ptrs) {
+    o_assert_dbg(!this->isValid);
+    this->pointers = ptrs;
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessTextureFactory::Discard() {
+    o_assert_dbg(this->isValid);
+    this->pointers = gfxPointers();
+    this->isValid = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+headlessTextureFactory::IsValid() const {
+    return this->isValid;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+headlessTextureFactory::SetupResource(texture& tex, const void* data, int size) {
+    o_assert_dbg(this->isValid);
+    const TextureSetup& setup = tex.Setup;
+
+    // validate that the provided data covers all faces and mipmaps
+    #if ORYOL_DEBUG
+    if (data) {
+        for (int faceIndex = 0; faceIndex < setup.ImageData.NumFaces; faceIndex++) {
+            for (int mipIndex = 0; mipIndex < setup.ImageData.NumMipMaps; mipIndex++) {
+                const int offset = setup.ImageData.Offsets[faceIndex][mipIndex];
+                const int mipSize = setup.ImageData.Sizes[faceIndex][mipIndex];
+                o_assert_dbg((offset >= 0) && (mipSize > 0) && ((offset + mipSize) <= size));
+            }
+        }
+    }
+    #endif
+
+    TextureAttrs attrs;
+    attrs.Locator = setup.Locator;
+    attrs.Type = setup.Type;
+    attrs.ColorFormat = setup.ColorFormat;
+    attrs.DepthFormat = setup.DepthFormat;
+    attrs.SampleCount = setup.SampleCount;
+    attrs.TextureUsage = setup.TextureUsage;
+    attrs.Width = setup.Width;
+    attrs.Height = setup.Height;
+    attrs.Depth = setup.Depth;
+    attrs.NumMipMaps = setup.NumMipMaps;
+    attrs.IsRenderTarget = setup.IsRenderTarget;
+    attrs.HasDepthBuffer = setup.HasDepth();
+    tex.textureAttrs = attrs;
+    tex.nativeHandles = setup.ShouldSetupFromNativeTexture();
+    return ResourceState::Valid;
+}
+
+//------------------------------------------------------------------------------
+void
+headlessTextureFactory::DestroyResource(texture& tex) {
+    o_assert_dbg(this->isValid);
+    tex.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,40 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::headlessTextureFactory
+    @ingroup _priv
+    @brief headless implementation of textureFactory
+*/
+#include "Resource/ResourceState.h"
+#include "Gfx/Core/GfxTypes.h"
+#include "Gfx/Core/gfxPointers.h"
+
+namespace Oryol {
+namespace _priv {
+
+class texture;
+
+class headlessTextureFactory {
+public:
+    /// destructor
+    ~headlessTextureFactory();
+
+    /// setup the factory
+    void Setup(const gfxPointers& ptrs);
+    /// discard the factory
+    void Discard();
+    /// return true if the object has been setup
+    bool IsValid() const;
+
+    /// setup with input data
+    ResourceState::Code SetupResource(texture& tex, const void* data, int size);
+    /// discard the resource
+    void DestroyResource(texture& tex);
+
+private:
+    gfxPointers pointers;
+    bool isValid = false;
+};
+
+} // namespace _priv
+} // namespace Oryol
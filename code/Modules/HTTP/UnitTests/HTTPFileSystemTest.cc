@@ -37,6 +37,21 @@ TEST(HTTPFileSystemTest) {
         Log::Info("%s\n", content.AsCStr());
     }
     req = 0;
+
+    // stream the same file in small chunks
+    Ptr<IOStreamRead> stream = IO::StreamFile("http://www.flohofwoe.net/index.html", 256);
+    int numBytes = 0;
+    Buffer chunk;
+    while (!stream->Finished()) {
+        while (stream->PopChunk(chunk)) {
+            CHECK(chunk.Size() <= 256);
+            numBytes += chunk.Size();
+        }
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(stream->Status == IOStatus::OK);
+    CHECK(numBytes > 0);
+    stream = 0;
     
     IO::Discard();
     Core::Discard();
@@ -97,6 +97,41 @@ curlURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void*
     }
 }
 
+//------------------------------------------------------------------------------
+size_t
+curlURLLoader::curlStreamDataCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
+    // userData is expected to point to a streamState object
+    streamState* stream = (streamState*) userData;
+    const int numBytes = (int) (size * nmemb);
+
+    // only the body of a successful response is streamed
+    long curlHttpCode = 0;
+    curl_easy_getinfo(stream->curlSession, CURLINFO_RESPONSE_CODE, &curlHttpCode);
+    if ((curlHttpCode < 200) || (curlHttpCode >= 300)) {
+        return numBytes;
+    }
+
+    // fill the current chunk, and push it once it is full,
+    // returning 0 aborts the download if the request was cancelled
+    IOStreamRead* req = stream->req;
+    int offset = 0;
+    while (offset < numBytes) {
+        int bytesToCopy = req->ChunkSize - stream->chunk.Size();
+        if (bytesToCopy > (numBytes - offset)) {
+            bytesToCopy = numBytes - offset;
+        }
+        stream->chunk.Add((const uint8_t*)ptr + offset, bytesToCopy);
+        offset += bytesToCopy;
+        if (stream->chunk.Size() >= req->ChunkSize) {
+            if (!req->WaitCanPushChunk() || !req->PushChunk(std::move(stream->chunk))) {
+                stream->cancelled = true;
+                return 0;
+            }
+        }
+    }
+    return numBytes;
+}
+
 //------------------------------------------------------------------------------
 bool
 curlURLLoader::doRequest(const Ptr<IORead>& req) {
@@ -139,8 +174,20 @@ curlURLLoader::doRequestInternal(const Ptr<IORead>& req) {
     requestHeaders = curl_slist_append(requestHeaders, "Accept-Encoding: gzip, deflate");
     curl_easy_setopt(this->curlSession, CURLOPT_HTTPHEADER, requestHeaders);
 
-    // prepare the HTTPResponse and the response-body stream
-    curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, &(req->Data));
+    // prepare the response-body, streaming reads push the
+    // body in chunks while the download is in progress
+    streamState stream;
+    Ptr<IOStreamRead> streamReq = req->DynamicCast<IOStreamRead>();
+    if (streamReq.isValid()) {
+        stream.curlSession = this->curlSession;
+        stream.req = streamReq.get();
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEFUNCTION, curlStreamDataCallback);
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, &stream);
+    }
+    else {
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEFUNCTION, curlWriteDataCallback);
+        curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, &(req->Data));
+    }
 
     // perform the request
     CURLcode performResult = curl_easy_perform(this->curlSession);
@@ -150,8 +197,16 @@ curlURLLoader::doRequestInternal(const Ptr<IORead>& req) {
     curl_easy_getinfo(this->curlSession, CURLINFO_RESPONSE_CODE, &curlHttpCode);
     req->Status = (IOStatus::Code) curlHttpCode;
 
+    // push the last, partially filled chunk of a streaming read
+    if (streamReq.isValid() && !stream.cancelled && !stream.chunk.Empty()) {
+        stream.cancelled = !streamReq->PushChunk(std::move(stream.chunk));
+    }
+
     // check for error codes
-    if (CURLE_PARTIAL_FILE == performResult) {
+    if (stream.cancelled) {
+        req->Status = IOStatus::Cancelled;
+    }
+    else if (CURLE_PARTIAL_FILE == performResult) {
         // this seems to happen quite often even though all data has been received,
         // not sure what to do about this, but don't treat it as an error
         Log::Warn("curlURLLoader: CURLE_PARTIAL_FILE received for '%s', httpStatus='%ld'\n", req->Url.AsCStr(), curlHttpCode);
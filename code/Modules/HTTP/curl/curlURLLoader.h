@@ -5,6 +5,12 @@
     @ingroup _priv
     @brief urlLoader implementation on top of curl
     @see urlLoader
+
+    IOStreamRead requests push the response body in chunks while the
+    download is in progress. curl_easy_perform() can't return in the
+    middle of a download, so instead of suspending the stream, a full
+    chunk queue stalls the download (the IO worker is busy with the
+    download until it is finished anyway).
 */
 #include "HTTP/base/baseURLLoader.h"
 #include <mutex>
@@ -30,9 +36,19 @@ private:
     void doRequestInternal(const Ptr<IORead>& req);
     /// curl write-data callback
     static size_t curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+    /// curl write-data callback for streaming reads
+    static size_t curlStreamDataCallback(char* ptr, size_t size, size_t nmemb, void* userData);
     /// curl header-data callback
     static size_t curlHeaderCallback(char* ptr, size_t size, size_t nmenb, void* userData);
 
+    /// state of a streaming read, passed to curlStreamDataCallback
+    struct streamState {
+        void* curlSession = nullptr;
+        IOStreamRead* req = nullptr;
+        Buffer chunk;
+        bool cancelled = false;
+    };
+
     static bool curlInitCalled;
     static std::mutex curlInitMutex;
     void* curlSession;
@@ -0,0 +1,30 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOCacheStats
+    @ingroup IO
+    @brief statistics of the IO read cache
+    
+    @see IO::CacheStats()
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class IOCacheStats {
+public:
+    /// number of reads which were served from the cache
+    int Hits = 0;
+    /// number of cache-enabled reads which were not in the cache
+    int Misses = 0;
+    /// number of entries dropped to stay within the byte budget
+    int Evictions = 0;
+    /// number of currently cached entries
+    int NumEntries = 0;
+    /// number of currently cached bytes
+    int64_t NumBytes = 0;
+    /// the byte budget of the cache
+    int64_t MaxBytes = 0;
+};
+
+} // namespace Oryol
@@ -13,6 +13,8 @@ class IOConfig {
 public:
     /// number of IO workers (== number of HTTP connections)
     static const int NumWorkers = 4;
+    /// default byte budget of the IO read cache (see IOSetup::CacheSize)
+    static const int CacheSize = 16 * 1024 * 1024;
 };
 
 } // namespace Oryol
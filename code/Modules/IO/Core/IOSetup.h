@@ -6,9 +6,11 @@
     @brief configure the IO system
 */
 #include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
 #include "Core/Containers/Map.h"
 #include "Core/Containers/KeyValuePair.h"
 #include "IO/FS/FileSystem.h"
+#include "IO/Core/IOConfig.h"
 #include <functional>
 
 namespace Oryol {
@@ -19,6 +21,14 @@ public:
     Map<String, String> Assigns;
     /// initial file systems
     Map<StringAtom, std::function<Ptr<FileSystem>()>> FileSystems;
+    /// number of IO workers in the default worker pool
+    int NumWorkers = IOConfig::NumWorkers;
+    /// dedicated worker pools for URL schemes (scheme => number of workers)
+    Map<StringAtom, int> SchemeWorkers;
+    /// merge concurrent reads of the same URL and byte range into one read
+    bool CoalesceReads = true;
+    /// byte budget of the read cache for IORead::CacheReadEnabled/CacheWriteEnabled (0 disables)
+    int CacheSize = IOConfig::CacheSize;
 };
     
 } // namespace Oryol
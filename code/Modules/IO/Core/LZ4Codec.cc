@@ -0,0 +1,210 @@
+//------------------------------------------------------------------------------
+//  LZ4Codec.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LZ4Codec.h"
+#include "Core/Assertion.h"
+#include <cstring>
+#include <climits>
+
+namespace Oryol {
+
+namespace {
+
+const int MinMatch = 4;
+const int LastLiterals = 5;     // the last 5 bytes are always literals
+const int MFLimit = 12;         // the last match must start 12 bytes before the end
+const int MaxOffset = 65535;
+const int HashLog = 12;
+
+//------------------------------------------------------------------------------
+inline uint32_t
+read32(const uint8_t* ptr) {
+    uint32_t val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+hash(uint32_t seq) {
+    return (seq * 2654435761U) >> (32 - HashLog);
+}
+
+//------------------------------------------------------------------------------
+inline int
+writeLength(uint8_t* dst, int len) {
+    int num = 0;
+    while (len >= 255) {
+        dst[num++] = 255;
+        len -= 255;
+    }
+    dst[num++] = uint8_t(len);
+    return num;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+readLength(const uint8_t* src, int srcSize, int& ip, int& len) {
+    uint8_t b;
+    do {
+        if ((ip >= srcSize) || (len > (INT_MAX - 255))) {
+            return false;
+        }
+        b = src[ip++];
+        len += b;
+    }
+    while (255 == b);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// emit a sequence of literals followed by an optional match,
+// return number of bytes written, or 0 if it doesn't fit
+int
+writeSequence(uint8_t* dst, int dstCapacity, const uint8_t* lit, int litLen, int offset, int matchLen) {
+    const int maxSize = 1 + (litLen / 255 + 1) + litLen + 2 + (matchLen / 255 + 1);
+    if (maxSize > dstCapacity) {
+        return 0;
+    }
+    int op = 1;
+    uint8_t token;
+    if (litLen >= 15) {
+        token = 15 << 4;
+        op += writeLength(dst + op, litLen - 15);
+    }
+    else {
+        token = uint8_t(litLen << 4);
+    }
+    std::memcpy(dst + op, lit, litLen);
+    op += litLen;
+    if (matchLen > 0) {
+        dst[op++] = uint8_t(offset & 0xFF);
+        dst[op++] = uint8_t(offset >> 8);
+        const int len = matchLen - MinMatch;
+        if (len >= 15) {
+            token |= 15;
+            op += writeLength(dst + op, len - 15);
+        }
+        else {
+            token |= uint8_t(len);
+        }
+    }
+    dst[0] = token;
+    return op;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int
+LZ4Codec::CompressBound(int srcSize) {
+    o_assert_dbg(srcSize >= 0);
+    return srcSize + (srcSize / 255) + 16;
+}
+
+//------------------------------------------------------------------------------
+int
+LZ4Codec::Compress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity) {
+    o_assert_dbg(src && dst && (srcSize >= 0));
+    int table[1 << HashLog];
+    for (int& pos : table) {
+        pos = -1;
+    }
+    int ip = 0;
+    int anchor = 0;
+    int op = 0;
+    const int matchLimit = srcSize - LastLiterals;
+    const int mfLimit = srcSize - MFLimit;
+    while (ip < mfLimit) {
+        const uint32_t seq = read32(src + ip);
+        const uint32_t h = hash(seq);
+        int ref = table[h];
+        table[h] = ip;
+        if ((ref < 0) || ((ip - ref) > MaxOffset) || (read32(src + ref) != seq)) {
+            ip++;
+            continue;
+        }
+        // extend the match backward and forward
+        while ((ip > anchor) && (ref > 0) && (src[ip - 1] == src[ref - 1])) {
+            ip--;
+            ref--;
+        }
+        int len = MinMatch;
+        while (((ip + len) < matchLimit) && (src[ip + len] == src[ref + len])) {
+            len++;
+        }
+        const int num = writeSequence(dst + op, dstCapacity - op, src + anchor, ip - anchor, ip - ref, len);
+        if (0 == num) {
+            return 0;
+        }
+        op += num;
+        ip += len;
+        anchor = ip;
+    }
+    // the last sequence only has literals
+    const int num = writeSequence(dst + op, dstCapacity - op, src + anchor, srcSize - anchor, 0, 0);
+    if (0 == num) {
+        return 0;
+    }
+    return op + num;
+}
+
+//------------------------------------------------------------------------------
+int
+LZ4Codec::Decompress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity) {
+    o_assert_dbg(src && dst && (srcSize >= 0) && (dstCapacity >= 0));
+    int ip = 0;
+    int op = 0;
+    while (ip < srcSize) {
+        const uint8_t token = src[ip++];
+
+        // literals
+        int litLen = token >> 4;
+        if ((15 == litLen) && !readLength(src, srcSize, ip, litLen)) {
+            return -1;
+        }
+        if ((litLen > (srcSize - ip)) || (litLen > (dstCapacity - op))) {
+            return -1;
+        }
+        std::memcpy(dst + op, src + ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip == srcSize) {
+            // end of block
+            break;
+        }
+
+        // match
+        if ((ip + 2) > srcSize) {
+            return -1;
+        }
+        const int offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if ((0 == offset) || (offset > op)) {
+            return -1;
+        }
+        int matchLen = token & 15;
+        if ((15 == matchLen) && !readLength(src, srcSize, ip, matchLen)) {
+            return -1;
+        }
+        matchLen += MinMatch;
+        if (matchLen > (dstCapacity - op)) {
+            return -1;
+        }
+        const uint8_t* from = dst + op - offset;
+        if (offset >= matchLen) {
+            std::memcpy(dst + op, from, matchLen);
+        }
+        else {
+            // overlapping match, repeats the last offset bytes
+            for (int i = 0; i < matchLen; i++) {
+                dst[op + i] = from[i];
+            }
+        }
+        op += matchLen;
+    }
+    return op;
+}
+
+} // namespace Oryol
@@ -0,0 +1,30 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::LZ4Codec
+    @ingroup IO
+    @brief fast LZ77-style block compression (LZ4 block format)
+
+    A small, dependency-free implementation of the LZ4 block format
+    for compressing asset data offline and decompressing it on the
+    IO worker threads. The compressor is a simple greedy single-pass
+    matcher, it doesn't reach the compression ratio of the reference
+    implementation's high-compression mode, but produces compatible
+    blocks. The decompressor validates its input and never reads or
+    writes out of bounds on malformed data.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class LZ4Codec {
+public:
+    /// max compressed size for an input of srcSize bytes
+    static int CompressBound(int srcSize);
+    /// compress a block, return compressed size, or 0 if dstCapacity is too small
+    static int Compress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity);
+    /// decompress a block, return decompressed size, or -1 on malformed input
+    static int Decompress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity);
+};
+
+} // namespace Oryol
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+//  LZ4Stream.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LZ4Stream.h"
+#include "IO/Core/LZ4Codec.h"
+#include "Core/Assertion.h"
+#include <cstring>
+
+namespace Oryol {
+
+namespace {
+
+const uint32_t StoredFlag = 0x80000000;
+
+struct header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t uncompressedSize;
+    uint32_t blockSize;
+};
+static_assert(sizeof(header) == LZ4Stream::HeaderSize, "LZ4Stream header size mismatch");
+
+//------------------------------------------------------------------------------
+inline uint32_t
+read32(const uint8_t* ptr) {
+    uint32_t val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+//------------------------------------------------------------------------------
+inline void
+write32(uint8_t* ptr, uint32_t val) {
+    std::memcpy(ptr, &val, sizeof(val));
+}
+
+//------------------------------------------------------------------------------
+bool
+readHeader(const uint8_t* data, int size, header& outHeader) {
+    if (!data || (size < LZ4Stream::HeaderSize)) {
+        return false;
+    }
+    std::memcpy(&outHeader, data, sizeof(outHeader));
+    return (LZ4Stream::Magic == outHeader.magic) &&
+           (LZ4Stream::Version == outHeader.version) &&
+           (outHeader.uncompressedSize <= uint32_t(INT32_MAX)) &&
+           (outHeader.blockSize > 0) &&
+           (outHeader.blockSize <= uint32_t(LZ4Stream::MaxBlockSize));
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+bool
+LZ4Stream::IsCompressed(const uint8_t* data, int size) {
+    header hdr;
+    return readHeader(data, size, hdr);
+}
+
+//------------------------------------------------------------------------------
+bool
+LZ4Stream::IsCompressedUrl(const URL& url) {
+    // NOTE: this is called for each read, so the path is checked in
+    // place instead of extracting it into a String
+    const char* str = url.AsCStr();
+    if (nullptr == str) {
+        return false;
+    }
+    const int pathEnd = int(std::strcspn(str, "?#"));
+    return (pathEnd >= 4) && (0 == std::strncmp(str + pathEnd - 4, ".olz", 4));
+}
+
+//------------------------------------------------------------------------------
+int
+LZ4Stream::UncompressedSize(const uint8_t* data, int size) {
+    header hdr;
+    if (readHeader(data, size, hdr)) {
+        return int(hdr.uncompressedSize);
+    }
+    else {
+        return -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+LZ4Stream::Compress(const uint8_t* src, int srcSize, Buffer& dst, int blockSize) {
+    o_assert_dbg(src || (0 == srcSize));
+    o_assert_dbg(srcSize >= 0);
+    o_assert_dbg((blockSize > 0) && (blockSize <= MaxBlockSize));
+
+    // reserve the worst case up front, so that the buffer only grows once
+    const int numBlocks = (srcSize + blockSize - 1) / blockSize;
+    const int bound = LZ4Codec::CompressBound(blockSize);
+    const int start = dst.Size();
+    dst.Reserve(HeaderSize + numBlocks * (4 + bound));
+
+    header hdr;
+    hdr.magic = Magic;
+    hdr.version = Version;
+    hdr.uncompressedSize = uint32_t(srcSize);
+    hdr.blockSize = uint32_t(blockSize);
+    std::memcpy(dst.Add(HeaderSize), &hdr, sizeof(hdr));
+
+    for (int offset = 0; offset < srcSize; offset += blockSize) {
+        const int size = (srcSize - offset) < blockSize ? (srcSize - offset) : blockSize;
+        const int blockStart = dst.Size();
+        uint8_t* ptr = dst.Add(4 + bound);
+        int compressedSize = LZ4Codec::Compress(src + offset, size, ptr + 4, bound);
+        if ((0 == compressedSize) || (compressedSize >= size)) {
+            // store incompressible blocks as is
+            std::memcpy(ptr + 4, src + offset, size);
+            write32(ptr, uint32_t(size) | StoredFlag);
+            compressedSize = size;
+        }
+        else {
+            write32(ptr, uint32_t(compressedSize));
+        }
+        dst.Remove(blockStart + 4 + compressedSize, bound - compressedSize);
+    }
+    o_assert_dbg(IsCompressed(dst.Data() + start, dst.Size() - start));
+}
+
+//------------------------------------------------------------------------------
+bool
+LZ4Stream::Decompress(const uint8_t* src, int srcSize, Buffer& dst) {
+    dst.Clear();
+    header hdr;
+    if (!readHeader(src, srcSize, hdr)) {
+        return false;
+    }
+    const int uncompressedSize = int(hdr.uncompressedSize);
+    const int blockSize = int(hdr.blockSize);
+    if (0 == uncompressedSize) {
+        return HeaderSize == srcSize;
+    }
+    // reject sizes the input can't possibly decompress to before allocating
+    // (each block has a 4 byte header, and LZ4 can't compress better than 1:255)
+    const int64_t numBlocks = (int64_t(uncompressedSize) + blockSize - 1) / blockSize;
+    if (((numBlocks * 4) > (srcSize - HeaderSize)) || ((uncompressedSize / 256) > srcSize)) {
+        return false;
+    }
+    uint8_t* dstPtr = dst.Add(uncompressedSize);
+    int pos = HeaderSize;
+    for (int offset = 0; offset < uncompressedSize; offset += blockSize) {
+        const int size = (uncompressedSize - offset) < blockSize ? (uncompressedSize - offset) : blockSize;
+        if ((srcSize - pos) < 4) {
+            dst.Clear();
+            return false;
+        }
+        const uint32_t word = read32(src + pos);
+        const int blockDataSize = int(word & ~StoredFlag);
+        pos += 4;
+        if (blockDataSize > (srcSize - pos)) {
+            dst.Clear();
+            return false;
+        }
+        if (word & StoredFlag) {
+            if (blockDataSize != size) {
+                dst.Clear();
+                return false;
+            }
+            std::memcpy(dstPtr + offset, src + pos, size);
+        }
+        else if (LZ4Codec::Decompress(src + pos, blockDataSize, dstPtr + offset, size) != size) {
+            dst.Clear();
+            return false;
+        }
+        pos += blockDataSize;
+    }
+    if (pos != srcSize) {
+        // trailing garbage
+        dst.Clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace Oryol
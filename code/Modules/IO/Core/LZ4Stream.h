@@ -0,0 +1,53 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::LZ4Stream
+    @ingroup IO
+    @brief compressed-stream container for asset files
+
+    A compressed stream is a complete file compressed as a sequence of
+    independent LZ4 blocks (see LZ4Codec), recognized by its header magic
+    'OLZS'. Compressed files get an additional '.olz' extension, IO
+    workers transparently decompress complete-file reads of such files
+    which start with a valid stream header (see IORead::DecompressEnabled),
+    so compressed files are loaded like uncompressed files.
+    All values are little-endian:
+
+    - header: magic, version, uncompressed size, block size
+    - one block per blockSize bytes of uncompressed data (the last block
+      may be smaller), each block starts with a 32-bit word: the size of
+      the block data in the low 31 bits, and the top bit set if the block
+      is stored uncompressed because it didn't compress
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Buffer.h"
+#include "IO/Core/URL.h"
+
+namespace Oryol {
+
+class LZ4Stream {
+public:
+    /// file magic 'OLZS'
+    static const uint32_t Magic = 'O' | ('L' << 8) | ('Z' << 16) | ('S' << 24);
+    /// current version
+    static const uint32_t Version = 1;
+    /// size of the stream header in bytes
+    static const int HeaderSize = 16;
+    /// default uncompressed block size
+    static const int DefaultBlockSize = 256 * 1024;
+    /// max uncompressed block size
+    static const int MaxBlockSize = 16 * 1024 * 1024;
+
+    /// test if data starts with a valid stream header
+    static bool IsCompressed(const uint8_t* data, int size);
+    /// test if the path of a URL has the '.olz' extension of compressed files
+    static bool IsCompressedUrl(const URL& url);
+    /// get the uncompressed size from the stream header, or -1 if not a valid header
+    static int UncompressedSize(const uint8_t* data, int size);
+    /// compress data into a stream, the stream is appended to dst
+    static void Compress(const uint8_t* src, int srcSize, Buffer& dst, int blockSize=DefaultBlockSize);
+    /// decompress a stream into dst (replacing its content), return false on malformed input
+    static bool Decompress(const uint8_t* src, int srcSize, Buffer& dst);
+};
+
+} // namespace Oryol
@@ -162,6 +162,7 @@ URL::crack(String urlString) {
     if (urlString.IsValid()) {
     
         StringBuilder builder;
+        builder.UseFrameAllocator();
         builder.Set(urlString);
         this->content = urlString;
         
@@ -426,6 +427,7 @@ URL::Query() const {
     if (this->HasQuery()) {
         Map<String, String> query;
         StringBuilder builder;
+        builder.UseFrameAllocator();
         builder.Set(this->content.AsCStr(), this->indices[queryStart], this->indices[queryEnd]);
         int kvpStartIndex = 0;
         int kvpEndIndex = 0;
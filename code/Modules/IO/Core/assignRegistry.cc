@@ -57,6 +57,7 @@ assignRegistry::ResolveAssigns(const String& str) const {
     this->rwLock.LockRead();
     
     StringBuilder builder;
+    builder.UseFrameAllocator();
     builder.Set(str);
     
     // while there are assigns to replace...
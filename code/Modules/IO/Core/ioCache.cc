@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+//  ioCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioCache.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+ioCache::~ioCache() {
+    this->discard();
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::setup(int64_t maxBytes_) {
+    o_assert(maxBytes_ >= 0);
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    this->maxBytes = maxBytes_;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::discard() {
+    this->clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCache::isEnabled() const {
+    return this->maxBytes > 0;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::wrap(const Ptr<entry>& e, Buffer& outData) {
+    // the buffer keeps the entry alive, even if it is evicted meanwhile
+    outData.Wrap(e->data.Data(), e->data.Size(), [e](const uint8_t*, int) { });
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::linkFront(entry* e) {
+    e->prev = nullptr;
+    e->next = this->head;
+    if (this->head) {
+        this->head->prev = e;
+    }
+    this->head = e;
+    if (nullptr == this->tail) {
+        this->tail = e;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::unlink(entry* e) {
+    if (e->prev) {
+        e->prev->next = e->next;
+    }
+    else {
+        this->head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    }
+    else {
+        this->tail = e->prev;
+    }
+    e->prev = e->next = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::remove(entry* e) {
+    this->unlink(e);
+    this->numBytes -= e->data.Size();
+    // NOTE: this may destroy the entry, so need a copy of the key
+    const ioReadKey key = e->key;
+    this->entries.Erase(key);
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCache::get(const ioReadKey& key, Buffer& outData) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    Ptr<entry>* e = this->entries.Find(key);
+    if (e) {
+        this->hits++;
+        this->unlink(e->get());
+        this->linkFront(e->get());
+        wrap(*e, outData);
+        return true;
+    }
+    else {
+        this->misses++;
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::put(const ioReadKey& key, Buffer& inOutData) {
+    const int size = inOutData.Size();
+    if ((0 == size) || (size > this->maxBytes)) {
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    if (this->entries.Contains(key)) {
+        // already cached (e.g. the data came from the cache)
+        return;
+    }
+    Ptr<entry> e = entry::Create();
+    e->key = key;
+    e->data = std::move(inOutData);
+    wrap(e, inOutData);
+    this->linkFront(e.get());
+    this->numBytes += size;
+    this->entries.Add(key, e);
+
+    // evict least recently used entries to stay within the budget
+    while (this->numBytes > this->maxBytes) {
+        o_assert_dbg(this->tail && (this->tail != e.get()));
+        this->remove(this->tail);
+        this->evictions++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::invalidate(const URL& url) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    entry* e = this->head;
+    while (e) {
+        entry* next = e->next;
+        if (e->key.url == url.Get()) {
+            this->remove(e);
+        }
+        e = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::clear() {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    // entries may outlive the cache in wrapped buffers, so unlink them
+    entry* e = this->head;
+    while (e) {
+        entry* next = e->next;
+        e->prev = e->next = nullptr;
+        e = next;
+    }
+    this->head = this->tail = nullptr;
+    this->entries.Clear();
+    this->numBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+IOCacheStats
+ioCache::stats() const {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    IOCacheStats s;
+    s.Hits = this->hits;
+    s.Misses = this->misses;
+    s.Evictions = this->evictions;
+    s.NumEntries = this->entries.Size();
+    s.NumBytes = this->numBytes;
+    s.MaxBytes = this->maxBytes;
+    return s;
+}
+
+} // namespace _priv
+} // namespace Oryol
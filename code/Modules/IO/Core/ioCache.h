@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioCache
+    @ingroup _priv
+    @brief thread-safe LRU cache for the data of IO reads
+
+    A byte-budgeted least-recently-used cache of read data, keyed by
+    URL and byte range. IO workers look up reads which have
+    IORead::CacheReadEnabled set before handing them to a FileSystem.
+    Successful reads with IORead::CacheWriteEnabled are added on the
+    main thread by the ioCoalescer once they have been handled (the
+    request's data is then moved into the cache and replaced by a
+    read-only view into the cached data).
+
+    Cache entries are refcounted, requests served from the cache get a
+    Buffer wrapping the cached data instead of a copy, and an evicted
+    entry is only freed after the last of those buffers is gone.
+    Writes to an URL drop all cached ranges of the URL.
+*/
+#include "Core/RefCounted.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/Containers/HashMap.h"
+#include "IO/Core/IOCacheStats.h"
+#include "IO/FS/ioReadKey.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class ioCache {
+public:
+    /// destructor
+    ~ioCache();
+    /// setup the cache with a byte budget (0 disables the cache)
+    void setup(int64_t maxBytes);
+    /// discard the cache
+    void discard();
+    /// return true if the cache is enabled
+    bool isEnabled() const;
+
+    /// lookup data, on hit, let data wrap the cached data and return true
+    bool get(const ioReadKey& key, Buffer& outData);
+    /// add data (moved into the cache) if not cached yet, data is replaced with a view into the cached data
+    void put(const ioReadKey& key, Buffer& inOutData);
+    /// drop all cached ranges of an URL
+    void invalidate(const URL& url);
+    /// drop all entries
+    void clear();
+    /// get cache statistics
+    IOCacheStats stats() const;
+
+private:
+    class entry : public RefCounted {
+        OryolClassDecl(entry);
+    public:
+        ioReadKey key;
+        Buffer data;
+        entry* prev = nullptr;
+        entry* next = nullptr;
+    };
+    /// let a buffer wrap the data of an entry
+    static void wrap(const Ptr<entry>& e, Buffer& outData);
+    /// add entry at the front of the LRU list
+    void linkFront(entry* e);
+    /// remove entry from the LRU list
+    void unlink(entry* e);
+    /// remove entry from the LRU list and map
+    void remove(entry* e);
+
+    #if ORYOL_HAS_THREADS
+    mutable std::mutex mutex;
+    #endif
+    HashMap<ioReadKey, Ptr<entry>, ioReadKey::hasher> entries;
+    entry* head = nullptr;      // most recently used
+    entry* tail = nullptr;      // least recently used
+    int64_t maxBytes = 0;
+    int64_t numBytes = 0;
+    int hits = 0;
+    int misses = 0;
+    int evictions = 0;
+};
+
+} // namespace _priv
+} // namespace Oryol
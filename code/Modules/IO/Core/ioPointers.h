@@ -12,10 +12,14 @@ namespace _priv {
 
 class assignRegistry;
 class schemeRegistry;
+class ioCache;
+class ioCompletionQueue;
 
 struct ioPointers {
     class assignRegistry* assignRegistry;
     class schemeRegistry* schemeRegistry;
+    class ioCache* cache;
+    class ioCompletionQueue* completionQueue;
 };
 
 } // namespace _priv
@@ -11,107 +11,143 @@ namespace Oryol {
 
 //------------------------------------------------------------------------------
 void
-loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail) {
+loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail, int priority) {
     o_assert_dbg(onSuccess);
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
+    ioReq->Priority = priority;
+    this->items.Add(ioReq.get(), item{ ioReq, onSuccess, onFail });
     IO::Put(ioReq);
-    this->items.Add(item{ ioReq, onSuccess, onFail });
 }
 
 //------------------------------------------------------------------------------
 void
-loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail) {
+loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail, int priority) {
     o_assert_dbg(onSuccess);
-    
-    groupItem item;
+
+    // an empty group is complete right away, there are no
+    // requests which could finish it later
+    if (urls.Empty()) {
+        onSuccess(Array<result>());
+        return;
+    }
+
+    int groupIndex;
+    if (this->freeGroupSlots.Empty()) {
+        groupIndex = this->groupItems.Size();
+        this->groupItems.Add(groupItem());
+    }
+    else {
+        groupIndex = this->freeGroupSlots.PopBack();
+    }
+    this->numActiveGroups++;
+    groupItem& item = this->groupItems[groupIndex];
+    item.onSuccess = onSuccess;
+    item.onFail = onFail;
+    item.numPending = urls.Size();
+    item.anyFailed = false;
     item.ioRequests.Reserve(urls.Size());
     for (const URL& url : urls) {
         Ptr<IORead> ioReq = IORead::Create();
         ioReq->Url = url;
-        IO::Put(ioReq);
+        ioReq->Priority = priority;
         item.ioRequests.Add(ioReq);
-        item.onSuccess = onSuccess;
-        item.onFail = onFail;
+        this->groupRequests.Add(ioReq.get(), groupIndex);
+    }
+    // NOTE: the requests are put after setting up the group, since
+    // IO::Put() may finish them immediately (e.g. cancelled or cached)
+    for (const auto& ioReq : this->groupItems[groupIndex].ioRequests) {
+        IO::Put(ioReq);
     }
-    this->groupItems.Add(item);
 }
 
 //------------------------------------------------------------------------------
 int
 loadQueue::numPending() const {
-    return this->items.Size() + this->groupItems.Size();
+    return this->items.Size() + this->numActiveGroups;
 }
 
 //------------------------------------------------------------------------------
 void
-loadQueue::update() {
+loadQueue::warnFailed(const IORequest* req) {
+    o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
+        req->Url.AsCStr(), IOStatus::ToString(req->Status));
+}
 
-    // check single items
-    for (int i = this->items.Size() - 1; i >= 0; --i) {
-        const item& curItem = this->items[i];
-        const auto& ioReq = curItem.ioRequest;
-        if (ioReq->Handled) {
-            // io request has been handled
-            if (IOStatus::OK == ioReq->Status) {
-                // io request was successful
-                curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
-            }
-            else {
-                // io request failed
-                if (curItem.onFail) {
-                    curItem.onFail(ioReq->Url, ioReq->Status);
-                }
-                else {
-                    // no fail handler was set, just print a warning
-                    o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                        ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                }
+//------------------------------------------------------------------------------
+void
+loadQueue::update(const Array<Ptr<IORequest>>& completed) {
+    for (const auto& req : completed) {
+        o_assert_dbg(req->Handled);
+        if (this->items.Contains(req.get())) {
+            this->onItemHandled(req.get());
+        }
+        else {
+            const int* groupIndex = this->groupRequests.Find(req.get());
+            if (groupIndex) {
+                this->onGroupRequestHandled(req.get(), *groupIndex);
             }
-            // remove the handled io request from the queue
-            this->items.Erase(i);
         }
     }
-    
-    // check group items
-    for (int i = this->groupItems.Size() - 1; i >= 0; --i) {
-        const groupItem& curItem = this->groupItems[i];
-        bool allHandled = true;
-        bool anyFailed = false;
-        for (const auto& ioReq : curItem.ioRequests) {
-            if (ioReq->Handled) {
-                if (IOStatus::OK != ioReq->Status) {
-                    anyFailed = true;
-                    if (curItem.onFail) {
-                        curItem.onFail(ioReq->Url, ioReq->Status);
-                    }
-                    else {
-                        o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                            ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                    }
-                }
-            }
-            else {
-                allHandled = false;
-                break;
-            }
+}
+
+//------------------------------------------------------------------------------
+void
+loadQueue::onItemHandled(const IORequest* req) {
+    // remove the item before calling the callbacks, they may add new items
+    item curItem = std::move(this->items[req]);
+    this->items.Erase(req);
+    const auto& ioReq = curItem.ioRequest;
+    if (IOStatus::OK == ioReq->Status) {
+        // io request was successful
+        curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
+    }
+    else {
+        // io request failed
+        if (curItem.onFail) {
+            curItem.onFail(ioReq->Url, ioReq->Status);
         }
-        
-        // if all request in this group have been handled, remove item, and
-        // if all were successful, call the success-callback
-        if (allHandled) {
-            if (!anyFailed) {
-                Array<result> result;
-                result.Reserve(curItem.ioRequests.Size());
-                for (const auto& ioReq : curItem.ioRequests) {
-                    result.Add(ioReq->Url, std::move(ioReq->Data));
-                }
-                curItem.onSuccess(std::move(result));
+        else {
+            // no fail handler was set, just print a warning
+            warnFailed(ioReq.get());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+loadQueue::onGroupRequestHandled(const IORequest* req, int groupIndex) {
+    this->groupRequests.Erase(req);
+    groupItem& curItem = this->groupItems[groupIndex];
+    if (IOStatus::OK != req->Status) {
+        curItem.anyFailed = true;
+        if (curItem.onFail) {
+            curItem.onFail(req->Url, req->Status);
+        }
+        else {
+            warnFailed(req);
+        }
+    }
+
+    // if all request in this group have been handled, free the group
+    // slot, and if all were successful, call the success-callback
+    if (0 == --curItem.numPending) {
+        groupItem doneItem = std::move(curItem);
+        curItem = groupItem();
+        this->freeGroupSlots.Add(groupIndex);
+        this->numActiveGroups--;
+        if (!doneItem.anyFailed) {
+            // the result array only lives through the callback,
+            // so it can come from the frame allocator
+            Array<result> result;
+            result.UseFrameAllocator();
+            result.Reserve(doneItem.ioRequests.Size());
+            for (const auto& ioReq : doneItem.ioRequests) {
+                result.Add(ioReq->Url, std::move(ioReq->Data));
             }
-            this->groupItems.Erase(i);
+            doneItem.onSuccess(std::move(result));
         }
     }
 }
 
 } // namespace Oryol
-
@@ -6,10 +6,17 @@
     @brief asynchronously load multiple files, invoke callbacks with result
 
     This is the class behind the IO::Load() and LoadGroup() functions.
+
+    Instead of polling all outstanding requests, update() is called
+    with the requests which have been handled since the last update
+    (see ioRouter::doWork()), items are found through a hash lookup,
+    so the per-frame cost only depends on the number of finished
+    requests, not on the number of outstanding requests.
 */
 #include "Core/Types.h"
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Array.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/Containers/Buffer.h"
 #include "IO/Core/URL.h"
 #include "IO/Core/IOStatus.h"
@@ -37,33 +44,45 @@ public:
 
     /// callback function signature for success
     typedef std::function<void(result result)> successFunc;
-    /// callback function signature for success when loading URL groups
+    /// callback function signature for success when loading URL groups (array is frame-allocated)
     typedef std::function<void(Array<result>)> groupSuccessFunc;
     /// callback function signature for failure
     typedef std::function<void(const URL& url, IOStatus::Code ioStatus)> failFunc;
 
     /// add a file load request to the queue
-    void add(const URL& url, successFunc onSuccess, failFunc onFail=failFunc());
+    void add(const URL& url, successFunc onSuccess, failFunc onFail=failFunc(), int priority=IORequest::DefaultPriority);
     /// add a file group request to the queue
-    void addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail=failFunc());
-    /// update the queue, called per frame from runloop
-    void update();
+    void addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail=failFunc(), int priority=IORequest::DefaultPriority);
+    /// update the queue with the requests which have been handled since last update, called per frame
+    void update(const Array<Ptr<IORequest>>& completed);
     /// get number of pending load actions
     int numPending() const;
 
 private:
+    /// a request of a single item has been handled
+    void onItemHandled(const IORequest* req);
+    /// a request of a group has been handled
+    void onGroupRequestHandled(const IORequest* req, int groupIndex);
+    /// print a warning for a failed request without fail-callback
+    static void warnFailed(const IORequest* req);
+
     struct item {
         Ptr<IORead> ioRequest;
         successFunc onSuccess;
         failFunc onFail;
     };
-    Array<item> items;
+    HashMap<const IORequest*, item> items;
     struct groupItem {
         Array<Ptr<IORead>> ioRequests;
         groupSuccessFunc onSuccess;
         failFunc onFail;
+        int numPending = 0;
+        bool anyFailed = false;
     };
-    Array<groupItem> groupItems;
+    Array<groupItem> groupItems;        // slots are recycled through freeGroupSlots
+    Array<int> freeGroupSlots;
+    HashMap<const IORequest*, int> groupRequests;
+    int numActiveGroups = 0;
 };
 
 } // namespace Oryol
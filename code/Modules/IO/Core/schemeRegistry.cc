@@ -23,8 +23,13 @@ schemeRegistry::~schemeRegistry() {
 void
 schemeRegistry::RegisterFileSystem(const StringAtom& scheme, std::function<Ptr<FileSystem>()> fsCreator) {
     this->rwLock.LockWrite();
-    o_assert(!this->registry.Contains(scheme));
-    this->registry.Add(scheme, fsCreator);
+    if (this->registry.Contains(scheme)) {
+        // replace an existing filesystem
+        this->registry[scheme] = fsCreator;
+    }
+    else {
+        this->registry.Add(scheme, fsCreator);
+    }
     this->rwLock.UnlockWrite();
     // create temp FileSystem object on main-thread to call the Init method
     Ptr<FileSystem> fs = this->CreateFileSystem(scheme);
@@ -23,7 +23,7 @@ public:
     /// destructor
     ~schemeRegistry();
     
-    /// associate URL scheme with filesystem
+    /// associate URL scheme with filesystem (replaces an existing association)
     void RegisterFileSystem(const StringAtom& scheme, std::function<Ptr<FileSystem>()> fsCreator);
     /// unregister a filesystem
     void UnregisterFileSystem(const StringAtom& scheme);
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//  ioChunkQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioChunkQueue.h"
+#if ORYOL_HAS_THREADS
+#include <chrono>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+void
+ioChunkQueue::push(Buffer&& chunk) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    this->chunks.Enqueue(std::move(chunk));
+}
+
+//------------------------------------------------------------------------------
+bool
+#if ORYOL_HAS_ATOMIC
+ioChunkQueue::wait(int maxChunks, const std::atomic<bool>& cancelled) {
+#else
+ioChunkQueue::wait(int maxChunks, const bool& cancelled) {
+#endif
+    o_assert_dbg(maxChunks > 0);
+    #if ORYOL_HAS_THREADS
+    std::unique_lock<std::mutex> lock(this->mutex);
+    // the cancelled flag is set without notifying the condition
+    // variable, so only wait for a short time before checking again
+    while ((this->chunks.Size() >= maxChunks) && !cancelled) {
+        this->condVar.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    #endif
+    return !cancelled;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioChunkQueue::pop(Buffer& outChunk) {
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->chunks.Empty()) {
+            return false;
+        }
+        this->chunks.Dequeue(outChunk);
+    }
+    this->condVar.notify_one();
+    return true;
+    #else
+    if (this->chunks.Empty()) {
+        return false;
+    }
+    this->chunks.Dequeue(outChunk);
+    return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+ioChunkQueue::size() {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    return this->chunks.Size();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioChunkQueue::empty() {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    return this->chunks.Empty();
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,54 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioChunkQueue
+    @ingroup IO
+    @brief bounded queue of data chunks for streaming reads
+
+    The chunk queue connects the filesystem on an IO worker thread
+    (the producer) with the consumer of an IOStreamRead on the main
+    thread. Pushing and popping never blocks, the producer checks the
+    number of queued chunks and suspends the stream while the queue
+    is full, so that the amount of data in flight is bounded. Producers
+    which can't suspend (because they are driven by a library callback)
+    can wait for room instead, a waiting producer gives up when the
+    owning request is cancelled.
+*/
+#include "Core/Containers/Queue.h"
+#include "Core/Containers/Buffer.h"
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class ioChunkQueue {
+public:
+    /// push a chunk without waiting
+    void push(Buffer&& chunk);
+    /// wait while maxChunks are queued, return false if cancelled
+    #if ORYOL_HAS_ATOMIC
+    bool wait(int maxChunks, const std::atomic<bool>& cancelled);
+    #else
+    bool wait(int maxChunks, const bool& cancelled);
+    #endif
+    /// pop a chunk without waiting, return false if the queue is empty
+    bool pop(Buffer& outChunk);
+    /// return number of queued chunks
+    int size();
+    /// return true if no chunks are queued
+    bool empty();
+
+private:
+    #if ORYOL_HAS_THREADS
+    std::mutex mutex;
+    std::condition_variable condVar;
+    #endif
+    Queue<Buffer> chunks;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+//  ioCoalescer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioCoalescer.h"
+#include "IO/Core/ioCache.h"
+#include "IO/FS/ioWorker.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+/// refcounted owner of the data which is shared by coalesced reads
+class ioSharedData : public RefCounted {
+    OryolClassDecl(ioSharedData);
+public:
+    Buffer Data;
+};
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::setup(const ioPointers& ptrs) {
+    this->pointers = ptrs;
+}
+
+//------------------------------------------------------------------------------
+Ptr<IORead>
+ioCoalescer::makeCarrier(const Ptr<IORead>& req) {
+    Ptr<IORead> carrier = IORead::Create();
+    carrier->Url = req->Url;
+    carrier->StartOffset = req->StartOffset;
+    carrier->EndOffset = req->EndOffset;
+    carrier->Priority = req->Priority;
+    carrier->Deadline = req->Deadline;
+    carrier->CacheReadEnabled = req->CacheReadEnabled;
+    carrier->CacheWriteEnabled = req->CacheWriteEnabled;
+    carrier->MapEnabled = req->MapEnabled;
+    carrier->DecompressEnabled = req->DecompressEnabled;
+    return carrier;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::updatePriority(entry& e, Array<Ptr<ioMsg>>& outMsgs) {
+    o_assert_dbg(!e.requests.Empty());
+    // the carrier takes the priority and deadline of the most urgent
+    // request, in the same order as the IO worker's pending-heap
+    const IORead* urgent = e.requests[0].get();
+    for (const auto& req : e.requests) {
+        if (ioWorker::moreUrgent(req->Priority, req->Deadline, urgent->Priority, urgent->Deadline)) {
+            urgent = req.get();
+        }
+    }
+    if ((urgent->Priority != e.priority) || (urgent->Deadline != e.deadline)) {
+        e.priority = urgent->Priority;
+        e.deadline = urgent->Deadline;
+        Ptr<rescheduleRequest> msg = rescheduleRequest::Create();
+        msg->Request = e.carrier;
+        msg->Priority = e.priority;
+        msg->Deadline = e.deadline;
+        outMsgs.Add(msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::finishCancelled(const Ptr<IORead>& req) {
+    req->Cancelled = true;
+    req->Status = IOStatus::Cancelled;
+    req->Handled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::add(const Ptr<IORead>& req, Array<Ptr<ioMsg>>& outMsgs) {
+    const ioReadKey k(req.get());
+    entry* e = this->inFlight.Find(k);
+    if (e) {
+        // an equal read is already in flight, attach the request to it
+        e->requests.Add(req);
+        updatePriority(*e, outMsgs);
+    }
+    else {
+        entry newEntry;
+        newEntry.carrier = makeCarrier(req);
+        newEntry.requests.Add(req);
+        newEntry.priority = req->Priority;
+        newEntry.deadline = req->Deadline;
+        outMsgs.Add(newEntry.carrier);
+        this->inFlight.Add(k, newEntry);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::reschedule(const Ptr<rescheduleRequest>& msg, Array<Ptr<ioMsg>>& outMsgs, Array<Ptr<IORequest>>& outCompleted) {
+    o_assert_dbg(msg->Request->IsA<IORead>());
+    const Ptr<IORead> req = msg->Request->DynamicCast<IORead>();
+    const ioReadKey k(req.get());
+    entry* e = this->inFlight.Find(k);
+    if (!e) {
+        return;
+    }
+    const int index = e->requests.FindIndexLinear(req);
+    if (InvalidIndex == index) {
+        return;
+    }
+    if (msg->Cancel) {
+        // finish the request right away, and if it was the last
+        // request waiting for the read, cancel the read itself
+        e->requests.Erase(index);
+        finishCancelled(req);
+        outCompleted.Add(req);
+        if (e->requests.Empty()) {
+            Ptr<rescheduleRequest> cancelMsg = rescheduleRequest::Create();
+            cancelMsg->Request = e->carrier;
+            cancelMsg->Cancel = true;
+            e->carrier->Cancelled = true;
+            outMsgs.Add(cancelMsg);
+            this->inFlight.Erase(k);
+        }
+        else {
+            updatePriority(*e, outMsgs);
+        }
+    }
+    else {
+        // attached requests never reach an IO worker, so their
+        // priority can be changed directly on the main thread
+        req->Priority = msg->Priority;
+        req->Deadline = msg->Deadline;
+        updatePriority(*e, outMsgs);
+    }
+    msg->Handled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::distribute(entry& e) {
+    IORead* carrier = e.carrier.get();
+    if (carrier->CacheWriteEnabled && (IOStatus::OK == carrier->Status) &&
+        this->pointers.cache && this->pointers.cache->isEnabled()) {
+        this->pointers.cache->put(ioReadKey(carrier), carrier->Data);
+    }
+    if (1 == e.requests.Size()) {
+        // only one reader, just hand over the data
+        const Ptr<IORead>& req = e.requests[0];
+        req->Data = std::move(carrier->Data);
+    }
+    else if (!carrier->Data.Empty()) {
+        // several readers share the same read-only data
+        Ptr<ioSharedData> shared = ioSharedData::Create();
+        shared->Data = std::move(carrier->Data);
+        for (const auto& req : e.requests) {
+            req->Data.Wrap(shared->Data.Data(), shared->Data.Size(), [shared](const uint8_t*, int) { });
+        }
+    }
+    for (const auto& req : e.requests) {
+        if (req->Cancelled) {
+            req->Status = IOStatus::Cancelled;
+            req->Data.Clear();
+        }
+        else {
+            req->Status = carrier->Status;
+            req->ErrorDesc = carrier->ErrorDesc;
+        }
+        req->Handled = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCoalescer::complete(const Ptr<IORequest>& req, Array<Ptr<IORequest>>& outCompleted) {
+    o_assert_dbg(req->Handled);
+    if (!req->IsA<IORead>()) {
+        return false;
+    }
+    const ioReadKey k(req.get());
+    entry* e = this->inFlight.Find(k);
+    if (!e || (e->carrier.get() != req.get())) {
+        return false;
+    }
+    this->distribute(*e);
+    for (const auto& attachedReq : e->requests) {
+        outCompleted.Add(attachedReq);
+    }
+    this->inFlight.Erase(k);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+ioCoalescer::numInFlight() const {
+    return this->inFlight.Size();
+}
+
+//------------------------------------------------------------------------------
+void
+ioCoalescer::clear() {
+    this->inFlight.Clear();
+}
+
+} // namespace _priv
+} // namespace Oryol
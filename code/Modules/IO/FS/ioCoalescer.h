@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioCoalescer
+    @ingroup IO
+    @brief merge concurrent IO reads of the same URL and byte range
+
+    The ioCoalescer is owned by the ioRouter and lives on the main thread.
+    Instead of the IORead requests themselves, an internal 'carrier'
+    IORead is dispatched to the IO workers for each distinct URL+range.
+    Further reads of the same URL+range which are issued while the
+    carrier is in flight are attached to the carrier and don't cause
+    another read. Once the carrier has been reported through the
+    completion queue, complete() copies the result into the attached
+    requests and sets them to handled.
+    If more than one request is attached, the data is shared through
+    refcounted read-only buffers (see Buffer::Wrap()), not copied.
+
+    Attached requests are cancelled on the main thread without touching
+    the IO workers, the carrier is only cancelled if no attached request
+    is left. The carrier always has the priority and deadline of the
+    most urgent attached request (highest priority, then earliest
+    deadline, like the IO worker's scheduling order).
+
+    Successful carriers with IORead::CacheWriteEnabled are added to the
+    read cache before their result is distributed, the attached requests
+    then share the cached data.
+*/
+#include "Core/Containers/Array.h"
+#include "Core/Containers/HashMap.h"
+#include "IO/FS/ioRequests.h"
+#include "IO/FS/ioReadKey.h"
+#include "IO/Core/ioPointers.h"
+
+namespace Oryol {
+namespace _priv {
+
+class ioCoalescer {
+public:
+    /// setup the coalescer
+    void setup(const ioPointers& ptrs);
+    /// add a read request, appends messages which must be dispatched to outMsgs
+    void add(const Ptr<IORead>& req, Array<Ptr<ioMsg>>& outMsgs);
+    /// reschedule or cancel an attached request, appends messages which must be dispatched to outMsgs
+    /// (a cancelled request is handled immediately and appended to outCompleted)
+    void reschedule(const Ptr<rescheduleRequest>& msg, Array<Ptr<ioMsg>>& outMsgs, Array<Ptr<IORequest>>& outCompleted);
+    /// if req is a handled carrier, distribute its result to the attached requests and append them to outCompleted
+    bool complete(const Ptr<IORequest>& req, Array<Ptr<IORequest>>& outCompleted);
+    /// get number of in-flight carrier requests
+    int numInFlight() const;
+    /// drop all in-flight reads
+    void clear();
+
+private:
+    struct entry {
+        Ptr<IORead> carrier;
+        Array<Ptr<IORead>> requests;
+        int priority = 0;
+        TimePoint deadline;
+    };
+    /// create a carrier request for an entry from its first attached request
+    static Ptr<IORead> makeCarrier(const Ptr<IORead>& req);
+    /// update carrier priority from attached requests, append reschedule message if changed
+    static void updatePriority(entry& e, Array<Ptr<ioMsg>>& outMsgs);
+    /// finish an attached request as cancelled
+    static void finishCancelled(const Ptr<IORead>& req);
+    /// copy the result of a handled carrier into the attached requests
+    void distribute(entry& e);
+
+    ioPointers pointers;
+    HashMap<ioReadKey, entry, ioReadKey::hasher> inFlight;
+};
+
+} // namespace _priv
+} // namespace Oryol
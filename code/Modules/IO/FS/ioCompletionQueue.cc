@@ -0,0 +1,31 @@
+//------------------------------------------------------------------------------
+//  ioCompletionQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioCompletionQueue.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+void
+ioCompletionQueue::push(const Ptr<IORequest>& req) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    this->requests.Add(req);
+}
+
+//------------------------------------------------------------------------------
+void
+ioCompletionQueue::drain(Array<Ptr<IORequest>>& outRequests) {
+    o_assert_dbg(outRequests.Empty());
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->mutex);
+    #endif
+    // swap instead of move, so that both arrays keep their capacity
+    std::swap(this->requests, outRequests);
+}
+
+} // namespace _priv
+} // namespace Oryol
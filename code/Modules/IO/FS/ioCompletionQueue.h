@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioCompletionQueue
+    @ingroup IO
+    @brief IO workers report processed requests to the main thread
+
+    IO workers push each IO request onto the completion queue after it
+    has been processed, and the ioRouter drains the queue once per frame
+    on the main thread. This way the main thread only needs to look at
+    requests which have actually finished, instead of polling all
+    outstanding requests each frame.
+
+    Pushing and draining is guarded by a mutex, draining swaps the
+    internal array, so the lock is only held very briefly.
+*/
+#include "Core/Containers/Array.h"
+#include "IO/FS/ioRequests.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class ioCompletionQueue {
+public:
+    /// push a processed request (called from IO worker threads)
+    void push(const Ptr<IORequest>& req);
+    /// move all pushed requests into an empty array (called from main thread)
+    void drain(Array<Ptr<IORequest>>& outRequests);
+
+private:
+    #if ORYOL_HAS_THREADS
+    std::mutex mutex;
+    #endif
+    Array<Ptr<IORequest>> requests;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,57 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioReadKey
+    @ingroup IO
+    @brief identifies the data of an IO read by URL, byte range and decompression
+
+    The URL is stored as a String with a precomputed hash instead of a
+    StringAtom, so that cache and in-flight keys never add strings to
+    the process-wide StringAtom table (which never shrinks).
+*/
+#include "Core/String/String.h"
+#include "Core/String/stringAtomTable.h"
+#include "IO/FS/ioRequests.h"
+
+namespace Oryol {
+namespace _priv {
+
+struct ioReadKey {
+    String url;
+    uint32_t urlHash = 0;
+    int startOffset = 0;
+    int endOffset = 0;
+    bool decompress = false;
+
+    /// default constructor
+    ioReadKey() { };
+    /// construct from IO request
+    ioReadKey(const IORequest* req) :
+        url(req->Url.Get().AsCStr()),
+        urlHash(uint32_t(stringAtomTable::HashForString(this->url.AsCStr()))),
+        startOffset(req->StartOffset),
+        endOffset(req->EndOffset),
+        decompress(req->IsA<IORead>() && static_cast<const IORead*>(req)->DecompressEnabled) { };
+    /// equality
+    bool operator==(const ioReadKey& rhs) const {
+        return (this->urlHash == rhs.urlHash) &&
+               (this->startOffset == rhs.startOffset) &&
+               (this->endOffset == rhs.endOffset) &&
+               (this->decompress == rhs.decompress) &&
+               (this->url == rhs.url);
+    };
+
+    /// hash function object for HashMap
+    struct hasher {
+        uint32_t operator()(const ioReadKey& k) const {
+            uint32_t h = k.urlHash;
+            h = (h * 31) ^ uint32_t(k.startOffset);
+            h = (h * 31) ^ uint32_t(k.endOffset);
+            h = (h * 31) ^ uint32_t(k.decompress);
+            return h;
+        };
+    };
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+//  ioRequests.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioRequests.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+bool
+IOStreamRead::PopChunk(Buffer& outChunk) {
+    // check Handled before the queue, all chunks have been
+    // pushed before the filesystem sets the Handled flag
+    const bool handled = this->Handled;
+    if (this->chunks.pop(outChunk)) {
+        return true;
+    }
+    else if (handled && !this->Data.Empty()) {
+        // the filesystem doesn't support streaming
+        outChunk = std::move(this->Data);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+IOStreamRead::Finished() {
+    const bool handled = this->Handled;
+    return handled && this->chunks.empty() && this->Data.Empty();
+}
+
+//------------------------------------------------------------------------------
+bool
+IOStreamRead::PushChunk(Buffer&& chunk) {
+    if (this->Cancelled) {
+        return false;
+    }
+    this->numBytesPushed += chunk.Size();
+    this->chunks.push(std::move(chunk));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+IOStreamRead::NumBytesPushed() const {
+    return this->numBytesPushed;
+}
+
+//------------------------------------------------------------------------------
+bool
+IOStreamRead::CanPushChunk() {
+    return this->chunks.size() < this->MaxQueuedChunks;
+}
+
+//------------------------------------------------------------------------------
+void
+IOStreamRead::Suspend() {
+    this->suspended = true;
+}
+
+//------------------------------------------------------------------------------
+bool
+IOStreamRead::WaitCanPushChunk() {
+    return this->chunks.wait(this->MaxQueuedChunks, this->Cancelled);
+}
+
+} // namespace Oryol
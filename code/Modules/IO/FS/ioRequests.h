@@ -10,11 +10,16 @@
 */
 #include "Core/RefCounted.h"
 #include "Core/Containers/Buffer.h"
+#include "Core/Time/TimePoint.h"
 #include "IO/Core/URL.h"
 #include "IO/Core/IOStatus.h"
+#include "IO/FS/ioChunkQueue.h"
 
 namespace Oryol {
 namespace _priv {
+class ioWorker;
+class ioRouter;
+
 //------------------------------------------------------------------------------
 class ioMsg : public RefCounted {
     OryolClassDecl(ioMsg);
@@ -42,6 +47,22 @@ public:
     Buffer Data;
     IOStatus::Code Status = IOStatus::InvalidIOStatus;
     String ErrorDesc;
+    /// scheduling priority, higher values are handled first
+    int Priority = DefaultPriority;
+    /// optional deadline, requests of same priority are handled earliest-deadline-first
+    TimePoint Deadline;
+
+    /// the default priority
+    static const int DefaultPriority = 0;
+
+private:
+    friend class _priv::ioWorker;
+    friend class _priv::ioRouter;
+    /// index of the IO worker the request was routed to (set by ioRouter)
+    int workerIndex = InvalidIndex;
+    /// IO worker scheduling state (only touched by the IO worker thread)
+    int schedGeneration = 0;
+    bool scheduled = false;
 };
 
 //------------------------------------------------------------------------------
@@ -51,6 +72,67 @@ class IORead : public IORequest {
 public:
     bool CacheReadEnabled = false;
     bool CacheWriteEnabled = false;
+    /// allow the filesystem to return a read-only memory-mapped view in Data (the file must not be rewritten while Data is alive)
+    bool MapEnabled = false;
+    /// decompress LZ4Stream data on the IO worker (only for complete '.olz' files)
+    bool DecompressEnabled = true;
+};
+
+//------------------------------------------------------------------------------
+/**
+    A streaming read: instead of materializing the complete file in Data,
+    the filesystem delivers the data in chunks of ChunkSize bytes as it
+    is read or downloaded. The consumer pops chunks on the main thread
+    until Finished() returns true, and then checks Status. Filesystems
+    which don't support streaming fill Data as usual, which is then
+    popped as a single chunk. Streaming reads are never coalesced or
+    cached.
+
+    At most MaxQueuedChunks wait for the consumer. A filesystem which
+    finds the queue full (CanPushChunk() returns false) calls Suspend()
+    and returns from FileSystem::onMsg() without setting Handled. The
+    IO worker then handles other requests, and requeues the stream once
+    the consumer has popped a chunk or the request has been cancelled,
+    the filesystem continues the stream in the next onMsg() call. If the
+    filesystem has been replaced meanwhile, a new instance gets that
+    call, it must resume after NumBytesPushed() instead of restarting.
+*/
+class IOStreamRead : public IORead {
+    OryolClassDecl(IOStreamRead);
+    OryolTypeDecl(IOStreamRead, IORead);
+public:
+    /// size of the delivered chunks (the last chunk may be smaller)
+    int ChunkSize = DefaultChunkSize;
+    /// max number of chunks waiting for the consumer
+    int MaxQueuedChunks = DefaultMaxQueuedChunks;
+
+    /// the default chunk size
+    static const int DefaultChunkSize = 64 * 1024;
+    /// the default number of queued chunks
+    static const int DefaultMaxQueuedChunks = 4;
+
+    /// consumer: pop the next chunk, return false if no chunk is available
+    bool PopChunk(Buffer& outChunk);
+    /// consumer: return true if the request is handled and all chunks have been popped
+    bool Finished();
+    /// filesystem: push a chunk without waiting, return false if cancelled
+    bool PushChunk(Buffer&& chunk);
+    /// filesystem: return true if less than MaxQueuedChunks are waiting for the consumer
+    bool CanPushChunk();
+    /// filesystem: number of bytes pushed so far, a continued stream resumes after these
+    int NumBytesPushed() const;
+    /// filesystem: continue the stream in a later onMsg() call, once a chunk can be pushed
+    void Suspend();
+    /// filesystem: block until a chunk can be pushed, return false if cancelled (only for filesystems which can't suspend)
+    bool WaitCanPushChunk();
+
+private:
+    friend class _priv::ioWorker;
+    _priv::ioChunkQueue chunks;
+    /// set by Suspend(), only touched by the IO worker thread
+    bool suspended = false;
+    /// only touched by the IO worker thread
+    int numBytesPushed = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -59,6 +141,18 @@ class IOWrite : public IORequest {
     OryolTypeDecl(IOWrite, IORequest);
 };
 
+//------------------------------------------------------------------------------
+class rescheduleRequest : public _priv::ioMsg {
+    OryolClassDecl(rescheduleRequest);
+    OryolTypeDecl(rescheduleRequest, ioMsg);
+public:
+    Ptr<IORequest> Request;
+    int Priority = IORequest::DefaultPriority;
+    TimePoint Deadline;
+    /// if true, cancel the request if it hasn't started yet
+    bool Cancel = false;
+};
+
 //------------------------------------------------------------------------------
 class notifyWorkers : public _priv::ioMsg {
     OryolClassDecl(notifyWorkers);
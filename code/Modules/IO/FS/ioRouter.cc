@@ -3,51 +3,203 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "ioRouter.h"
+#include "Core/Memory/Memory.h"
+#include "IO/Core/ioCache.h"
+#include "IO/FS/ioCompletionQueue.h"
 
 namespace Oryol {
 namespace _priv {
 
 //------------------------------------------------------------------------------
 void
-ioRouter::setup(const ioPointers& ptrs) {
-    for (auto& worker : this->workers) {
-        worker.start(ptrs);
+ioRouter::setup(const IOSetup& setup, const ioPointers& ptrs) {
+    o_assert(this->workers.Empty());
+    o_assert(setup.NumWorkers > 0);
+    this->pointers = ptrs;
+    this->coalesceReads = setup.CoalesceReads;
+    this->coalescer.setup(ptrs);
+    this->addPool(setup.NumWorkers, ptrs);
+    for (const auto& kvp : setup.SchemeWorkers) {
+        o_assert(kvp.Value() > 0);
+        this->schemePools.Add(kvp.Key(), this->addPool(kvp.Value(), ptrs));
     }
 }
 
+//------------------------------------------------------------------------------
+int
+ioRouter::addPool(int numWorkers, const ioPointers& ptrs) {
+    pool p;
+    p.firstWorker = this->workers.Size();
+    p.numWorkers = numWorkers;
+    this->pools.Add(p);
+    for (int i = 0; i < numWorkers; i++) {
+        ioWorker* worker = Memory::New<ioWorker>();
+        worker->start(ptrs);
+        this->workers.Add(worker);
+    }
+    return this->pools.Size() - 1;
+}
+
 //------------------------------------------------------------------------------
 void
 ioRouter::discard() {
-    for (auto& worker : this->workers) {
-        worker.stop();
+    // unblock streaming reads which are waiting for a consumer
+    for (const auto& stream : this->streams) {
+        stream->Cancelled = true;
+    }
+    this->streams.Clear();
+    for (ioWorker* worker : this->workers) {
+        worker->stop();
+        Memory::Delete(worker);
     }
+    this->workers.Clear();
+    this->pools.Clear();
+    this->schemePools.Clear();
+    this->coalescer.clear();
+    this->processed.Clear();
+    this->asyncPending.Clear();
+    this->completed.Clear();
 }
 
 //------------------------------------------------------------------------------
 void
-ioRouter::doWork() {
-    for (auto& worker : this->workers) {
-        worker.doWork();
+ioRouter::doWork(Array<Ptr<IORequest>>& outCompleted) {
+    for (ioWorker* worker : this->workers) {
+        worker->doWork();
+    }
+
+    // look at the requests which have been processed by the IO workers
+    this->pointers.completionQueue->drain(this->processed);
+    for (const auto& req : this->processed) {
+        if (req->Handled) {
+            this->complete(req);
+        }
+        else {
+            this->asyncPending.Add(req);
+        }
+    }
+    this->processed.Clear();
+    for (int i = this->asyncPending.Size() - 1; i >= 0; --i) {
+        if (this->asyncPending[i]->Handled) {
+            this->complete(this->asyncPending[i]);
+            this->asyncPending.EraseSwap(i);
+        }
+    }
+
+    for (const auto& req : this->completed) {
+        outCompleted.Add(req);
     }
+    this->completed.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+ioRouter::complete(const Ptr<IORequest>& req) {
+    if (req->IsA<IOStreamRead>()) {
+        const int index = this->streams.FindIndexLinear(req->DynamicCast<IOStreamRead>());
+        if (InvalidIndex != index) {
+            this->streams.EraseSwap(index);
+        }
+    }
+    if (!this->coalescer.complete(req, this->completed)) {
+        this->completed.Add(req);
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+ioRouter::numWorkers() const {
+    return this->workers.Size();
+}
+
+//------------------------------------------------------------------------------
+int
+ioRouter::leastLoadedWorker(int poolIndex) {
+    pool& p = this->pools[poolIndex];
+    int bestIndex = InvalidIndex;
+    int bestLoad = 0;
+    for (int i = 0; i < p.numWorkers; i++) {
+        const int index = p.firstWorker + ((p.nextWorker + i) % p.numWorkers);
+        const int load = this->workers[index]->numPending();
+        if ((InvalidIndex == bestIndex) || (load < bestLoad)) {
+            bestIndex = index;
+            bestLoad = load;
+            if (0 == load) {
+                break;
+            }
+        }
+    }
+    p.nextWorker = (bestIndex - p.firstWorker + 1) % p.numWorkers;
+    return bestIndex;
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::put(const Ptr<ioMsg>& msg) {
+    if (msg->IsA<IOWrite>() && this->pointers.cache->isEnabled()) {
+        this->pointers.cache->invalidate(msg->DynamicCast<IOWrite>()->Url);
+    }
+    // reads, and reschedule messages for reads which are waiting
+    // for an in-flight read go through the coalescer
+    bool coalesce = false;
+    if (msg->IsA<IOStreamRead>()) {
+        this->streams.Add(msg->DynamicCast<IOStreamRead>());
+    }
+    else if (msg->IsA<IORead>()) {
+        coalesce = this->coalesceReads || msg->DynamicCast<IORead>()->CacheWriteEnabled;
+    }
+    else if (msg->IsA<rescheduleRequest>()) {
+        const Ptr<IORequest>& req = msg->DynamicCast<rescheduleRequest>()->Request;
+        coalesce = (InvalidIndex == req->workerIndex) && req->IsA<IORead>();
+    }
+    if (coalesce) {
+        if (msg->IsA<IORead>()) {
+            this->coalescer.add(msg->DynamicCast<IORead>(), this->coalescedMsgs);
+        }
+        else {
+            this->coalescer.reschedule(msg->DynamicCast<rescheduleRequest>(), this->coalescedMsgs, this->completed);
+        }
+        for (const auto& coalescedMsg : this->coalescedMsgs) {
+            this->dispatch(coalescedMsg);
+        }
+        this->coalescedMsgs.Clear();
+    }
+    else {
+        this->dispatch(msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioRouter::dispatch(const Ptr<ioMsg>& msg) {
     if (msg->IsA<notifyWorkers>()) {
         // notifyWorker messages must be distributed to all workers
-        for (auto& worker : this->workers) {
-            worker.put(msg);
+        for (ioWorker* worker : this->workers) {
+            worker->put(msg);
         }
     }
+    else if (msg->IsA<rescheduleRequest>()) {
+        // reschedule messages must go to the worker which owns the request
+        const int workerIndex = msg->DynamicCast<rescheduleRequest>()->Request->workerIndex;
+        o_assert_dbg(InvalidIndex != workerIndex);
+        this->workers[workerIndex]->put(msg);
+    }
     else {
-        // for all other messages, use a round-robin dispatch
-        this->curWorker = (this->curWorker + 1) % IOConfig::NumWorkers;
-        this->workers[this->curWorker].put(msg);
+        // IO requests go to the least-loaded worker of their scheme's pool
+        int poolIndex = DefaultPool;
+        if (msg->IsA<IORequest>() && !this->schemePools.Empty()) {
+            const int index = this->schemePools.FindIndex(msg->DynamicCast<IORequest>()->Url.Scheme());
+            if (InvalidIndex != index) {
+                poolIndex = this->schemePools.ValueAtIndex(index);
+            }
+        }
+        const int workerIndex = this->leastLoadedWorker(poolIndex);
+        if (msg->IsA<IORequest>()) {
+            msg->DynamicCast<IORequest>()->workerIndex = workerIndex;
+        }
+        this->workers[workerIndex]->put(msg);
     }
 }
 
 } // namespace _priv
 } // namespace Oryol
-
-
@@ -4,11 +4,43 @@
     @class Oryol::_priv::ioRouter
     @ingroup IO
     @brief route IO requests to ioWorkers
+
+    The ioWorkers are organized in pools, one default pool, and one
+    dedicated pool per URL scheme configured in IOSetup::SchemeWorkers.
+    An IO request is dispatched to the least-loaded worker of the pool
+    associated with its URL scheme (or the default pool), so that slow
+    requests of one scheme (e.g. HTTP downloads) don't block requests
+    of another scheme (e.g. local file reads) queued behind them.
+
+    The router remembers the worker index in the IORequest, so that
+    rescheduleRequest messages can be sent to the worker which
+    owns the request.
+
+    If IOSetup::CoalesceReads is enabled, IORead requests go through
+    an ioCoalescer which merges concurrent reads of the same data.
+    Reads with IORead::CacheWriteEnabled always go through the ioCoalescer,
+    which adds their data to the read cache once they are handled, and
+    writes drop the written URL from the read cache.
+
+    IO workers report processed requests through the ioCompletionQueue,
+    doWork() drains it and returns the finished requests (with coalesced
+    reads replaced by their attached requests), so that the loadQueue
+    doesn't need to poll outstanding requests. Requests which are
+    finished asynchronously by their filesystem (i.e. after
+    FileSystem::onMsg() has returned) are polled until they are handled.
+
+    IOStreamRead requests bypass the coalescer, the router keeps track
+    of unfinished streaming reads and cancels them in discard(), since
+    they may be suspended (or their filesystem may be waiting) until a
+    consumer pops chunks.
 */
-#include "Core/Containers/StaticArray.h"
-#include "IO/Core/IOConfig.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/StringAtom.h"
+#include "IO/Core/IOSetup.h"
 #include "IO/Core/ioPointers.h"
 #include "IO/FS/ioWorker.h"
+#include "IO/FS/ioCoalescer.h"
 
 namespace Oryol {
 namespace _priv {
@@ -16,19 +48,44 @@ namespace _priv {
 class ioRouter {
 public:
     /// setup the router
-    void setup(const ioPointers& ptrs);
+    void setup(const IOSetup& setup, const ioPointers& ptrs);
     /// discard the router
     void discard();
     /// route a ioMsg to one or more workers
     void put(const Ptr<ioMsg>& msg);
-    /// perform per-frame work
-    void doWork();
+    /// perform per-frame work, append requests which have been handled since last call
+    void doWork(Array<Ptr<IORequest>>& outCompleted);
+    /// get number of workers (in all pools)
+    int numWorkers() const;
 
 private:
-    int curWorker = 0;
-    StaticArray<ioWorker, IOConfig::NumWorkers> workers;
+    /// add a worker pool, return pool index
+    int addPool(int numWorkers, const ioPointers& ptrs);
+    /// find the least-loaded worker in a pool, return worker index
+    int leastLoadedWorker(int poolIndex);
+    /// route a message to its worker(s)
+    void dispatch(const Ptr<ioMsg>& msg);
+    /// a request has been handled
+    void complete(const Ptr<IORequest>& req);
+
+    struct pool {
+        int firstWorker = 0;
+        int numWorkers = 0;
+        int nextWorker = 0;     // round-robin start for breaking ties
+    };
+    static const int DefaultPool = 0;
+    Array<ioWorker*> workers;
+    Array<pool> pools;
+    Map<StringAtom, int> schemePools;
+    ioPointers pointers;
+    bool coalesceReads = false;
+    ioCoalescer coalescer;
+    Array<Ptr<ioMsg>> coalescedMsgs;
+    Array<Ptr<IORequest>> processed;     // drained from the completion queue
+    Array<Ptr<IORequest>> asyncPending;  // processed, but not yet handled by filesystem
+    Array<Ptr<IORequest>> completed;
+    Array<Ptr<IOStreamRead>> streams;    // unfinished streaming reads
 };
 
 } // namespace _priv
 } // namespace Oryol
-
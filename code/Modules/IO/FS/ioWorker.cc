@@ -4,13 +4,23 @@
 #include "Pre.h"
 #include "ioWorker.h"
 #include "IO/Core/schemeRegistry.h"
+#include "IO/Core/ioCache.h"
+#include "IO/FS/ioReadKey.h"
+#include "IO/FS/ioCompletionQueue.h"
+#include "IO/Core/LZ4Stream.h"
+#include "Core/Core.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Trace.h"
+#include <algorithm>
+#include <climits>
 
 namespace Oryol {
 namespace _priv {
 
 //------------------------------------------------------------------------------
 ioWorker::ioWorker() :
-threadStopRequested(false) {
+threadStopRequested(false),
+numPendingRequests(0) {
     // empty
 }
 
@@ -30,10 +40,19 @@ ioWorker::start(const ioPointers& ptrs) {
 void
 ioWorker::stop() {
     o_assert(this->threadStartRequested);
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(this->transferMutex);
+        this->threadStopRequested = true;
+    }
+    #else
     this->threadStopRequested = true;
+    #endif
     #if ORYOL_HAS_THREADS
         this->transferCondVar.notify_one();
         this->thread.join();
+    #else
+        this->discardStreams();
     #endif
     this->threadStopped = true;
 }
@@ -44,9 +63,18 @@ ioWorker::put(const Ptr<ioMsg>& msg) {
     o_assert(this->isSendThread());
     o_assert(this->threadStartRequested);
     o_assert(!this->threadStopped);
+    if (msg->IsA<IORequest>()) {
+        this->numPendingRequests++;
+    }
     this->writeQueue.Enqueue(msg);
 }
 
+//------------------------------------------------------------------------------
+int
+ioWorker::numPending() const {
+    return this->numPendingRequests;
+}
+
 //------------------------------------------------------------------------------
 void
 ioWorker::doWork() {
@@ -72,9 +100,15 @@ ioWorker::doWork() {
         // if platform has no threads, pump the message queue right
         // FIXME: we could do without all those queue transfers here!
         this->moveTransferToReadQueue();
-        while (!this->readQueue.Empty()) {
-            this->onMsg(std::move(this->readQueue.Dequeue()));
+        this->scheduleReadQueue();
+        while (!this->pending.Empty()) {
+            Ptr<IORequest> req = this->popPending();
+            if (req) {
+                this->onMsg(req);
+            }
         }
+        this->pollDecompress();
+        this->pollStreams();
     #endif
 }
 
@@ -82,25 +116,52 @@ ioWorker::doWork() {
 #if ORYOL_HAS_THREADS
 void
 ioWorker::threadFunc(ioWorker* self) {
+    // filesystems may use per-thread state (e.g. StringAtom lookups,
+    // thread-cached allocations or log buffers) on the worker thread,
+    // which must be given up when the thread exits
+    Core::EnterThread();
     self->workThreadId = std::this_thread::get_id();
+    o_trace_thread_name("IOWorker");
 
     // the message processing loop waits for messages to arrive,
-    // moves them from the transfer queue, processes them then goes back to sleep
+    // moves them from the transfer queue into the pending-heap, and
+    // processes the most urgent request, new messages are picked
+    // up after each request, so that urgent requests can overtake
+    // queued requests, if no requests are pending, go back to sleep
+    // (but wake up regularly while asynchronously handled
+    // decompression proxies or suspended streams need to be polled)
     while (!self->threadStopRequested) {
 
         // wait for messages to arrive, and if so, transfer to read queue
         {
             std::unique_lock<std::mutex> lock(self->transferMutex);
-            self->transferCondVar.wait(lock);
-            self->moveTransferToReadQueue();
-            lock.unlock();
+            if (self->pending.Empty()) {
+                auto hasWork = [self] {
+                    return self->threadStopRequested || !self->transferQueue.Empty();
+                };
+                if (self->decompressing.Empty() && self->suspended.Empty()) {
+                    self->transferCondVar.wait(lock, hasWork);
+                }
+                else {
+                    self->transferCondVar.wait_for(lock, std::chrono::milliseconds(1), hasWork);
+                }
+            }
+            if (!self->transferQueue.Empty()) {
+                self->moveTransferToReadQueue();
+            }
         }
 
         // now process the messages, this happens without locking
-        while (!self->readQueue.Empty()) {
-            self->onMsg(std::move(self->readQueue.Dequeue()));
+        self->scheduleReadQueue();
+        Ptr<IORequest> req = self->popPending();
+        if (req) {
+            self->onMsg(req);
         }
+        self->pollDecompress();
+        self->pollStreams();
     }
+    self->discardStreams();
+    Core::LeaveThread();
 }
 #endif
 
@@ -153,6 +214,104 @@ ioWorker::moveTransferToReadQueue() {
     this->readQueue = std::move(this->transferQueue);
 }
 
+//------------------------------------------------------------------------------
+bool
+ioWorker::pendingEntry::operator<(const pendingEntry& rhs) const {
+    if (this->priority != rhs.priority) {
+        return this->priority < rhs.priority;
+    }
+    else if (this->deadline != rhs.deadline) {
+        return this->deadline > rhs.deadline;
+    }
+    else {
+        return this->seq > rhs.seq;
+    }
+}
+
+//------------------------------------------------------------------------------
+int64_t
+ioWorker::deadlineKey(const TimePoint& deadline) {
+    return (deadline.getRaw() != 0) ? deadline.getRaw() : INT64_MAX;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioWorker::moreUrgent(int priority, const TimePoint& deadline, int otherPriority, const TimePoint& otherDeadline) {
+    if (priority != otherPriority) {
+        return priority > otherPriority;
+    }
+    else {
+        return deadlineKey(deadline) < deadlineKey(otherDeadline);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::scheduleReadQueue() {
+    o_assert_dbg(this->isWorkerThread());
+    while (!this->readQueue.Empty()) {
+        Ptr<ioMsg> msg = this->readQueue.Dequeue();
+        if (msg->IsA<IORequest>()) {
+            Ptr<IORequest> req = msg->DynamicCast<IORequest>();
+            this->pushPending(req, req->Priority, req->Deadline);
+        }
+        else {
+            // control messages are handled immediately
+            this->onMsg(msg);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::pushPending(const Ptr<IORequest>& req, int priority, const TimePoint& deadline) {
+    // a new entry invalidates all older heap entries of the same request
+    req->schedGeneration++;
+    req->scheduled = true;
+    pendingEntry entry;
+    entry.priority = priority;
+    entry.deadline = deadlineKey(deadline);
+    entry.seq = this->pendingSeq++;
+    entry.generation = req->schedGeneration;
+    entry.request = req;
+    this->pending.Add(std::move(entry));
+    std::push_heap(this->pending.begin(), this->pending.end());
+}
+
+//------------------------------------------------------------------------------
+Ptr<IORequest>
+ioWorker::popPending() {
+    while (!this->pending.Empty()) {
+        std::pop_heap(this->pending.begin(), this->pending.end());
+        pendingEntry entry = this->pending.PopBack();
+        IORequest* req = entry.request.get();
+        if (req->scheduled && (entry.generation == req->schedGeneration)) {
+            req->scheduled = false;
+            return std::move(entry.request);
+        }
+        // otherwise this is a stale entry of a rescheduled or cancelled request
+    }
+    return Ptr<IORequest>();
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::onReschedule(const Ptr<rescheduleRequest>& msg) {
+    const Ptr<IORequest>& req = msg->Request;
+    if (req->scheduled) {
+        if (msg->Cancel) {
+            // drop the request from the pending-heap and finish it right away
+            req->schedGeneration++;
+            req->scheduled = false;
+            this->onMsg(req);
+        }
+        else {
+            this->pushPending(req, msg->Priority, msg->Deadline);
+        }
+    }
+    msg->Handled = true;
+}
+
 //------------------------------------------------------------------------------
 Ptr<FileSystem>
 ioWorker::fileSystemForURL(const URL& url) {
@@ -179,20 +338,181 @@ ioWorker::checkCancelled(const Ptr<IORequest>& msg) {
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+ioWorker::checkCache(const Ptr<IORequest>& msg) {
+    ioCache* cache = this->pointers.cache;
+    if (cache && cache->isEnabled() && msg->IsA<IORead>() && !msg->IsA<IOStreamRead>() && msg->DynamicCast<IORead>()->CacheReadEnabled) {
+        if (cache->get(ioReadKey(msg.get()), msg->Data)) {
+            msg->Status = IOStatus::OK;
+            msg->Handled = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioWorker::needsDecompress(const Ptr<IORequest>& msg) const {
+    // streams are delivered chunk by chunk, and a byte range
+    // of a compressed stream can't be decompressed, only files
+    // named as compressed files pay for the proxy request
+    return msg->IsA<IORead>() && !msg->IsA<IOStreamRead>() &&
+           msg->DynamicCast<IORead>()->DecompressEnabled &&
+           (0 == msg->StartOffset) && (EndOfFile == msg->EndOffset) &&
+           LZ4Stream::IsCompressedUrl(msg->Url);
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::readDecompressed(const Ptr<FileSystem>& fs, const Ptr<IORead>& req) {
+    Ptr<IORead> proxy = IORead::Create();
+    proxy->Url = req->Url;
+    proxy->Priority = req->Priority;
+    proxy->Deadline = req->Deadline;
+    proxy->MapEnabled = req->MapEnabled;
+    proxy->Cancelled = bool(req->Cancelled);
+    fs->onMsg(proxy);
+    if (proxy->Handled) {
+        this->finishDecompress(req, proxy);
+    }
+    else {
+        decompressEntry entry;
+        entry.request = req;
+        entry.proxy = proxy;
+        this->decompressing.Add(std::move(entry));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::finishDecompress(const Ptr<IORead>& req, const Ptr<IORead>& proxy) {
+    o_trace_scoped(IO_decompress);
+    req->Status = proxy->Status;
+    req->ErrorDesc = proxy->ErrorDesc;
+    const Buffer& data = proxy->Data;
+    if ((IOStatus::OK == proxy->Status) && LZ4Stream::IsCompressed(data.Empty() ? nullptr : data.Data(), data.Size())) {
+        if (!LZ4Stream::Decompress(data.Data(), data.Size(), req->Data)) {
+            req->Status = IOStatus::UnsupportedMediaType;
+            req->ErrorDesc = "malformed compressed stream";
+            o_warn("ioWorker: malformed compressed stream '%s'\n", req->Url.AsCStr());
+        }
+    }
+    else {
+        req->Data = std::move(proxy->Data);
+    }
+    req->Handled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::pollDecompress() {
+    for (int i = this->decompressing.Size() - 1; i >= 0; i--) {
+        decompressEntry& entry = this->decompressing[i];
+        if (entry.request->Cancelled) {
+            entry.proxy->Cancelled = true;
+        }
+        if (entry.proxy->Handled) {
+            this->finishDecompress(entry.request, entry.proxy);
+            this->decompressing.Erase(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::readStream(const Ptr<FileSystem>& fs, const Ptr<IOStreamRead>& req) {
+    fs->onMsg(req);
+    if (req->suspended) {
+        o_assert_dbg(!req->Handled);
+        this->suspended.Add(req);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::continueStream(const Ptr<IOStreamRead>& req) {
+    req->suspended = false;
+    Ptr<FileSystem> fs = this->fileSystemForURL(req->Url);
+    if (fs) {
+        this->readStream(fs, req);
+    }
+    else {
+        // the filesystem has been removed while the stream was suspended
+        req->Status = IOStatus::Cancelled;
+        req->Handled = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::pollStreams() {
+    for (int i = this->suspended.Size() - 1; i >= 0; i--) {
+        const Ptr<IOStreamRead>& req = this->suspended[i];
+        if (req->Cancelled || req->CanPushChunk()) {
+            // the request is already reported, continue it with its priority
+            this->pushPending(req, req->Priority, req->Deadline);
+            this->suspended.EraseSwap(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::discardStreams() {
+    // collect suspended streams, including those which have been
+    // requeued but not yet continued
+    Array<Ptr<IOStreamRead>> streams = std::move(this->suspended);
+    while (!this->pending.Empty()) {
+        Ptr<IORequest> req = this->popPending();
+        if (req && req->IsA<IOStreamRead>() && req->DynamicCast<IOStreamRead>()->suspended) {
+            streams.Add(req->DynamicCast<IOStreamRead>());
+        }
+    }
+    for (const auto& stream : streams) {
+        stream->Cancelled = true;
+        this->continueStream(stream);
+        if (!stream->Handled) {
+            stream->Status = IOStatus::Cancelled;
+            stream->Handled = true;
+        }
+    }
+    this->suspended.Clear();
+}
+
 //------------------------------------------------------------------------------
 void
 ioWorker::onMsg(const Ptr<ioMsg>& msg) {
-    if (msg->IsA<IORequest>()) {
+    o_trace_scoped(IO_onMsg);
+    o_memory_scope("IO");
+    if (msg->IsA<IOStreamRead>() && msg->DynamicCast<IOStreamRead>()->suspended) {
+        // a requeued stream, this has already been reported
+        this->continueStream(msg->DynamicCast<IOStreamRead>());
+    }
+    else if (msg->IsA<IORequest>()) {
         // find filesystem and forward request, NOTE:
         // the filesystem is responsible to set the
         // request to 'handled'!
         Ptr<IORequest> ioReq = msg->DynamicCast<IORequest>();
-        if (!this->checkCancelled(ioReq)) {
+        if (!this->checkCancelled(ioReq) && !this->checkCache(ioReq)) {
             Ptr<FileSystem> fs = this->fileSystemForURL(ioReq->Url);
             if (fs) {
-                fs->onMsg(ioReq);
+                if (this->needsDecompress(ioReq)) {
+                    this->readDecompressed(fs, ioReq->DynamicCast<IORead>());
+                }
+                else if (ioReq->IsA<IOStreamRead>()) {
+                    this->readStream(fs, ioReq->DynamicCast<IOStreamRead>());
+                }
+                else {
+                    fs->onMsg(ioReq);
+                }
             }
         }
+        // report the request to the main thread (even if the filesystem
+        // will only finish it asynchronously)
+        this->pointers.completionQueue->push(ioReq);
+        this->numPendingRequests--;
     }
     else if (msg->IsA<notifyWorkers>()) {
         // add, remove or replace a filesystem association
@@ -213,6 +533,9 @@ ioWorker::onMsg(const Ptr<ioMsg>& msg) {
         }
         msg->Handled = true;
     }
+    else if (msg->IsA<rescheduleRequest>()) {
+        this->onReschedule(msg->DynamicCast<rescheduleRequest>());
+    }
 }
 
 } // namespace _priv
@@ -11,8 +11,37 @@
     'transfer queue', and the worker thread will be signaled. The 
     worker thread wakes up, moves the messages from the transfer queue
     to a read-queue, processes them and goes back to sleep.
+
+    IO requests from the read-queue are not processed in FIFO order,
+    but go into a pending-heap ordered by priority, deadline (earliest
+    first) and arrival. After each handled request the worker thread
+    checks the transfer queue for new messages, so that an urgent
+    request doesn't need to wait for queued lower-priority requests.
+    Queued requests can be reprioritized or cancelled with a
+    rescheduleRequest message, this pushes a new heap entry and
+    invalidates the old one through the request's schedGeneration.
+    Control messages (notifyWorkers) are handled immediately.
+
+    Complete-file IORead requests for '.olz' files with DecompressEnabled
+    are forwarded to the filesystem as a private proxy request, all other
+    requests are passed to the filesystem directly. When the filesystem
+    has handled the proxy, the worker decompresses LZ4Stream data into
+    the original request, and only then sets it to handled, so that
+    the main thread never sees compressed data. Proxies which are
+    handled asynchronously by their filesystem are polled by the
+    worker (or in doWork() on platforms without threads).
+
+    An IOStreamRead whose chunk queue is full is suspended by its
+    filesystem instead of blocking the worker thread. The worker polls
+    suspended streams, and puts a stream back into the pending-heap
+    once the consumer has popped a chunk (or the stream has been
+    cancelled), the filesystem then continues the stream in another
+    onMsg() call. When the worker is stopped, suspended streams are
+    cancelled and passed to their filesystem a last time, so that it
+    can release its state.
 */
 #include "Core/Containers/Queue.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/StringAtom.h"
 #include "IO/Core/ioPointers.h"
@@ -40,12 +69,36 @@ public:
     void put(const Ptr<ioMsg>& msg);
     /// do work on the main thread, this moves queued messages to transfer queue
     void doWork();
+    /// get number of IO requests which have been put but not yet processed
+    int numPending() const;
+    /// scheduling order: true if (priority, deadline) is handled before (otherPriority, otherDeadline)
+    static bool moreUrgent(int priority, const TimePoint& deadline, int otherPriority, const TimePoint& otherDeadline);
 
 private:
+    /// convert a deadline into a pending-heap key (requests without deadline come last)
+    static int64_t deadlineKey(const TimePoint& deadline);
     /// lookup filesystem for URL
     Ptr<FileSystem> fileSystemForURL(const URL& url);
     /// check for and handle cancelled message
     bool checkCancelled(const Ptr<IORequest>& msg);
+    /// try to handle a read request from the read cache
+    bool checkCache(const Ptr<IORequest>& msg);
+    /// test if a request is read through a decompression proxy
+    bool needsDecompress(const Ptr<IORequest>& msg) const;
+    /// forward a read request to the filesystem through a decompression proxy
+    void readDecompressed(const Ptr<FileSystem>& fs, const Ptr<IORead>& req);
+    /// finish a read request from its handled proxy
+    void finishDecompress(const Ptr<IORead>& req, const Ptr<IORead>& proxy);
+    /// check asynchronously handled proxies
+    void pollDecompress();
+    /// forward a streaming read to the filesystem, and keep track of it if suspended
+    void readStream(const Ptr<FileSystem>& fs, const Ptr<IOStreamRead>& req);
+    /// continue a suspended streaming read which has been popped from the pending-heap
+    void continueStream(const Ptr<IOStreamRead>& req);
+    /// requeue suspended streams which can continue
+    void pollStreams();
+    /// cancel and finish all suspended streams (called when the worker stops)
+    void discardStreams();
     /// called from thread to handle a generic message
     void onMsg(const Ptr<ioMsg>& msg);
     /// the thread worker func
@@ -60,6 +113,14 @@ private:
     void moveWriteToTransferQueue();
     /// move messages from transfer queue to read queue
     void moveTransferToReadQueue();
+    /// move messages from read queue into the pending-heap
+    void scheduleReadQueue();
+    /// push an IO request onto the pending-heap
+    void pushPending(const Ptr<IORequest>& req, int priority, const TimePoint& deadline);
+    /// pop the most urgent IO request from the pending-heap, or nullptr if only stale entries
+    Ptr<IORequest> popPending();
+    /// handle a reschedule message
+    void onReschedule(const Ptr<rescheduleRequest>& msg);
 
     ioPointers pointers;
     Map<StringAtom, Ptr<FileSystem>> fileSystems;
@@ -68,6 +129,25 @@ private:
     Queue<Ptr<ioMsg>> transferQueue;  // written by sender, read by worker thread (locked)
     Queue<Ptr<ioMsg>> readQueue;      // read by worker thread
 
+    struct pendingEntry {
+        int priority = 0;
+        int64_t deadline = 0;       // raw TimePoint, or INT64_MAX if no deadline
+        uint64_t seq = 0;           // arrival order for equal priority and deadline
+        int generation = 0;         // entry is stale if != request's schedGeneration
+        Ptr<IORequest> request;
+        /// heap ordering, true if this entry is less urgent than rhs
+        bool operator<(const pendingEntry& rhs) const;
+    };
+    Array<pendingEntry> pending;     // binary heap, only touched by worker thread
+    uint64_t pendingSeq = 0;
+
+    struct decompressEntry {
+        Ptr<IORead> request;
+        Ptr<IORead> proxy;
+    };
+    Array<decompressEntry> decompressing;   // proxies not yet handled by their filesystem
+    Array<Ptr<IOStreamRead>> suspended;     // streams waiting for their consumer
+
     #if ORYOL_HAS_THREADS
     std::thread::id sendThreadId;
     std::thread::id workThreadId;
@@ -77,8 +157,10 @@ private:
     #endif
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> threadStopRequested;
+    std::atomic<int> numPendingRequests;
     #else
     bool threadStopRequested;
+    int numPendingRequests;
     #endif
     bool threadStartRequested = false;
     bool threadStopped = false;
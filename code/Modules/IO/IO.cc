@@ -22,7 +22,10 @@ IO::Setup(const IOSetup& setup) {
     ioPointers ptrs;
     ptrs.schemeRegistry = &state->schemeReg;
     ptrs.assignRegistry = &state->assignReg;
-    state->router.setup(ptrs);
+    ptrs.cache = &state->cache;
+    ptrs.completionQueue = &state->completionQueue;
+    state->cache.setup(setup.CacheSize);
+    state->router.setup(setup, ptrs);
 
     // setup initial assigns
     for (const auto& assign : setup.Assigns) {
@@ -43,6 +46,7 @@ IO::Discard() {
     o_assert(IsValid());
     Core::PreRunLoop()->Remove(state->runLoopId);
     state->router.discard();
+    state->cache.discard();
     Memory::Delete(state);
     state = nullptr;
 }
@@ -52,8 +56,9 @@ void
 IO::doWork() {
     o_assert_dbg(IsValid());
     o_assert_dbg(Core::IsMainThread());
-    state->router.doWork();
-    state->loadQueue.update();
+    state->router.doWork(state->completedRequests);
+    state->loadQueue.update(state->completedRequests);
+    state->completedRequests.Clear();
 }
 
 //------------------------------------------------------------------------------
@@ -126,16 +131,16 @@ IO::IsFileSystemRegistered(const StringAtom& scheme) {
 
 //------------------------------------------------------------------------------
 void
-IO::Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed) {
+IO::Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed, int priority) {
     o_assert_dbg(IsValid());
-    state->loadQueue.add(url, onSuccess, onFailed);
+    state->loadQueue.add(url, onSuccess, onFailed, priority);
 }
 
 //------------------------------------------------------------------------------
 void
-IO::LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed) {
+IO::LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed, int priority) {
     o_assert_dbg(IsValid());
-    state->loadQueue.addGroup(urls, onSuccess, onFailed);
+    state->loadQueue.addGroup(urls, onSuccess, onFailed, priority);
 }
 
 //------------------------------------------------------------------------------
@@ -145,12 +150,40 @@ IO::NumPendingLoads() {
     return state->loadQueue.numPending();
 }
 
+//------------------------------------------------------------------------------
+IOCacheStats
+IO::CacheStats() {
+    o_assert_dbg(IsValid());
+    return state->cache.stats();
+}
+
+//------------------------------------------------------------------------------
+void
+IO::ClearCache() {
+    o_assert_dbg(IsValid());
+    state->cache.clear();
+}
+
 //------------------------------------------------------------------------------
 Ptr<IORead>
-IO::LoadFile(const URL& url) {
+IO::LoadFile(const URL& url, int priority) {
     o_assert_dbg(IsValid());
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
+    ioReq->Priority = priority;
+    state->router.put(ioReq);
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+Ptr<IOStreamRead>
+IO::StreamFile(const URL& url, int chunkSize, int priority) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(chunkSize > 0);
+    Ptr<IOStreamRead> ioReq = IOStreamRead::Create();
+    ioReq->Url = url;
+    ioReq->ChunkSize = chunkSize;
+    ioReq->Priority = priority;
     state->router.put(ioReq);
     return ioReq;
 }
@@ -173,4 +206,32 @@ IO::Put(const Ptr<IORequest>& ioReq) {
     state->router.put(ioReq);
 }
 
+//------------------------------------------------------------------------------
+void
+IO::Reprioritize(const Ptr<IORequest>& ioReq, int priority, const TimePoint& deadline) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(ioReq);
+    if (!ioReq->Handled) {
+        Ptr<rescheduleRequest> msg = rescheduleRequest::Create();
+        msg->Request = ioReq;
+        msg->Priority = priority;
+        msg->Deadline = deadline;
+        state->router.put(msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IO::Cancel(const Ptr<IORequest>& ioReq) {
+    o_assert_dbg(IsValid());
+    o_assert_dbg(ioReq);
+    ioReq->Cancelled = true;
+    if (!ioReq->Handled) {
+        Ptr<rescheduleRequest> msg = rescheduleRequest::Create();
+        msg->Request = ioReq;
+        msg->Cancel = true;
+        state->router.put(msg);
+    }
+}
+
 } // namespace Oryol
@@ -8,10 +8,14 @@
     @ingroup IO
     @brief IO module facade
 */
+#include <functional>
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
 #include "IO/Core/IOSetup.h"
+#include "IO/Core/IOCacheStats.h"
+#include "IO/Core/ioCache.h"
 #include "IO/FS/ioRouter.h"
+#include "IO/FS/ioCompletionQueue.h"
 #include "IO/Core/assignRegistry.h"
 #include "IO/Core/schemeRegistry.h"
 #include "IO/Core/loadQueue.h"
@@ -46,7 +50,7 @@ public:
 
     /// success-callback for Load()
     typedef loadQueue::successFunc LoadSuccessFunc;
-    /// success-callback for LoadGroup()
+    /// success-callback for LoadGroup() (results array is frame-allocated, don't keep it)
     typedef loadQueue::groupSuccessFunc LoadGroupSuccessFunc;
     /// failed-callback for Load functions
     typedef loadQueue::failFunc LoadFailedFunc;
@@ -54,18 +58,29 @@ public:
     typedef loadQueue::result LoadResult;
     
     /// async load a file, with success and fail callbacks
-    static void Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc());
+    static void Load(const URL& url, LoadSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc(), int priority=IORequest::DefaultPriority);
     /// async load a group of files, with success and fail callbacks
-    static void LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc());
+    static void LoadGroup(const Array<URL>& urls, LoadGroupSuccessFunc onSuccess, LoadFailedFunc onFailed=LoadFailedFunc(), int priority=IORequest::DefaultPriority);
     /// get number of pending Load() and LoadGroup() actions
     static int NumPendingLoads();
 
     /// low-level: start async loading of file from URL, return message for polling result
-    static Ptr<IORead> LoadFile(const URL& url);
+    static Ptr<IORead> LoadFile(const URL& url, int priority=IORequest::DefaultPriority);
+    /// low-level: start streaming a file from URL, pop the data chunks from the returned request
+    static Ptr<IOStreamRead> StreamFile(const URL& url, int chunkSize=IOStreamRead::DefaultChunkSize, int priority=IORequest::DefaultPriority);
     /// low-level: start async writing of file via URL, return message for polling result
     static Ptr<IOWrite> WriteFile(const URL& url, const Buffer& data);
+    /// get statistics of the read cache
+    static IOCacheStats CacheStats();
+    /// drop all entries from the read cache
+    static void ClearCache();
+
     /// low-level: push a generic asynchronous IO request
     static void Put(const Ptr<IORequest>& ioReq);
+    /// low-level: change priority and deadline of a queued IO request
+    static void Reprioritize(const Ptr<IORequest>& ioReq, int priority, const TimePoint& deadline=TimePoint());
+    /// low-level: cancel an IO request, a queued request is dropped immediately
+    static void Cancel(const Ptr<IORequest>& ioReq);
     
 private:
     /// pump the ioRequestRouter
@@ -74,7 +89,10 @@ private:
     struct _state {
         _priv::assignRegistry assignReg;
         _priv::schemeRegistry schemeReg;
+        _priv::ioCache cache;
+        _priv::ioCompletionQueue completionQueue;
         _priv::ioRouter router;
+        Array<Ptr<IORequest>> completedRequests;
         RunLoop::Id runLoopId = RunLoop::InvalidId;
         class loadQueue loadQueue;
     };
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+//  IOCacheTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IOTestHelpers.h"
+
+using namespace Oryol;
+
+static std::atomic<int> numFSRequests{0};
+
+// a filesystem which returns 4 bytes for each read and counts requests
+class CacheTestFileSystem : public FileSystem {
+    OryolClassDecl(CacheTestFileSystem);
+    OryolClassCreator(CacheTestFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        numFSRequests++;
+        if (msg->IsA<IORead>()) {
+            static const uint8_t payload[] = { 'A', 'B', 'C', 'D' };
+            msg->Data.Add(payload, sizeof(payload));
+        }
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+//------------------------------------------------------------------------------
+static void
+setupCacheIO(int cacheSize) {
+    numFSRequests = 0;
+    IOSetup ioSetup;
+    ioSetup.CacheSize = cacheSize;
+    IOTest::setup(ioSetup);
+    IO::RegisterFileSystem("test", CacheTestFileSystem::Creator());
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IORead>
+cachedRead(const URL& url) {
+    Ptr<IORead> req = IORead::Create();
+    req->Url = url;
+    req->CacheReadEnabled = true;
+    req->CacheWriteEnabled = true;
+    IO::Put(req);
+    IOTest::waitHandled(req);
+    return req;
+}
+
+#if !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+TEST(IOCacheTest) {
+    setupCacheIO(1024);
+
+    // first read goes to the filesystem and into the cache
+    Ptr<IORead> req0 = cachedRead("test://bla.com/blub.txt");
+    CHECK(req0->Status == IOStatus::OK);
+    CHECK(req0->Data.Size() == 4);
+    CHECK(numFSRequests == 1);
+    IOCacheStats stats = IO::CacheStats();
+    CHECK(stats.Hits == 0);
+    CHECK(stats.Misses == 1);
+    CHECK(stats.NumEntries == 1);
+    CHECK(stats.NumBytes == 4);
+    CHECK(stats.MaxBytes == 1024);
+
+    // second read is served from the cache, and shares the data
+    Ptr<IORead> req1 = cachedRead("test://bla.com/blub.txt");
+    CHECK(req1->Status == IOStatus::OK);
+    CHECK(req1->Data.Size() == 4);
+    CHECK(req1->Data.Data()[0] == 'A');
+    CHECK(req1->Data.Data() == req0->Data.Data());
+    CHECK(numFSRequests == 1);
+    stats = IO::CacheStats();
+    CHECK(stats.Hits == 1);
+    CHECK(stats.Misses == 1);
+
+    // reads without CacheReadEnabled don't look into the cache
+    Ptr<IORead> req2 = IO::LoadFile("test://bla.com/blub.txt");
+    IOTest::waitHandled(req2);
+    CHECK(numFSRequests == 2);
+    CHECK(IO::CacheStats().Hits == 1);
+
+    // a different byte range is a different cache entry
+    Ptr<IORead> req3 = IORead::Create();
+    req3->Url = "test://bla.com/blub.txt";
+    req3->StartOffset = 2;
+    req3->CacheReadEnabled = true;
+    IO::Put(req3);
+    IOTest::waitHandled(req3);
+    CHECK(numFSRequests == 3);
+    CHECK(IO::CacheStats().Misses == 2);
+
+    // a write drops the cached data of the URL
+    Buffer data;
+    data.Add((const uint8_t*)"XY", 2);
+    Ptr<IOWrite> write = IO::WriteFile("test://bla.com/blub.txt", data);
+    IOTest::waitHandled(write);
+    CHECK(IO::CacheStats().NumEntries == 0);
+    cachedRead("test://bla.com/blub.txt");
+    CHECK(numFSRequests == 5);
+
+    // clear the cache, the data of earlier reads is still valid
+    IO::ClearCache();
+    CHECK(IO::CacheStats().NumEntries == 0);
+    CHECK(IO::CacheStats().NumBytes == 0);
+    CHECK(req1->Data.Data()[3] == 'D');
+
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCacheEvictionTest) {
+    // a cache with room for 2 reads
+    setupCacheIO(8);
+    cachedRead("test://bla.com/a.txt");
+    cachedRead("test://bla.com/b.txt");
+    CHECK(IO::CacheStats().NumEntries == 2);
+    // touch a, so that b is the least recently used entry
+    cachedRead("test://bla.com/a.txt");
+    CHECK(IO::CacheStats().Hits == 1);
+    // c evicts b
+    cachedRead("test://bla.com/c.txt");
+    IOCacheStats stats = IO::CacheStats();
+    CHECK(stats.Evictions == 1);
+    CHECK(stats.NumEntries == 2);
+    CHECK(stats.NumBytes == 8);
+    CHECK(numFSRequests == 3);
+    cachedRead("test://bla.com/a.txt");
+    CHECK(numFSRequests == 3);
+    cachedRead("test://bla.com/b.txt");
+    CHECK(numFSRequests == 4);
+
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCacheDisabledTest) {
+    setupCacheIO(0);
+    cachedRead("test://bla.com/blub.txt");
+    cachedRead("test://bla.com/blub.txt");
+    CHECK(numFSRequests == 2);
+    IOCacheStats stats = IO::CacheStats();
+    CHECK(stats.Hits == 0);
+    CHECK(stats.Misses == 0);
+    CHECK(stats.NumEntries == 0);
+    IOTest::discard();
+}
+#endif
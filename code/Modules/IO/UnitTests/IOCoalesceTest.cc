@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+//  IOCoalesceTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/FS/ioCoalescer.h"
+#include "IOTestHelpers.h"
+#include "Core/Time/Clock.h"
+#include <thread>
+
+using namespace Oryol;
+
+static std::atomic<bool> readGateOpen{false};
+static std::atomic<int> numReads{0};
+
+// a filesystem which counts reads, and blocks until the gate is opened
+class CountingFileSystem : public FileSystem {
+    OryolClassDecl(CountingFileSystem);
+    OryolClassCreator(CountingFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        while (!readGateOpen) {
+            std::this_thread::yield();
+        }
+        numReads++;
+        static const uint8_t payload[] = { 'A', 'B', 'C', 'D' };
+        msg->Data.Add(payload, sizeof(payload));
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+#if ORYOL_HAS_THREADS && !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+static void
+setupCountingIO(bool coalesce) {
+    readGateOpen = false;
+    numReads = 0;
+    IOSetup ioSetup;
+    ioSetup.CoalesceReads = coalesce;
+    IOTest::setup(ioSetup);
+    IO::RegisterFileSystem("count", CountingFileSystem::Creator());
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCoalesceTest) {
+    setupCountingIO(true);
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 8; i++) {
+        reqs.Add(IO::LoadFile("count://bla.com/blub.txt"));
+    }
+    // a different byte range is a different read
+    Ptr<IORead> rangeReq = IORead::Create();
+    rangeReq->Url = "count://bla.com/blub.txt";
+    rangeReq->StartOffset = 2;
+    IO::Put(rangeReq);
+    reqs.Add(rangeReq);
+    readGateOpen = true;
+    IOTest::waitHandled(reqs);
+    CHECK(numReads == 2);
+
+    // all requests of the same read share the same data
+    const uint8_t* data = reqs[0]->Data.Data();
+    for (int i = 0; i < 8; i++) {
+        CHECK(reqs[i]->Status == IOStatus::OK);
+        CHECK(reqs[i]->Data.Size() == 4);
+        CHECK(reqs[i]->Data.IsWrapped());
+        CHECK(reqs[i]->Data.Data() == data);
+    }
+    CHECK(rangeReq->Status == IOStatus::OK);
+    CHECK(rangeReq->Data.Size() == 4);
+    CHECK(!rangeReq->Data.IsWrapped());
+
+    // modifying a shared buffer doesn't affect the others
+    reqs[0]->Data.Add((const uint8_t*)"E", 1);
+    CHECK(reqs[0]->Data.Size() == 5);
+    CHECK(reqs[1]->Data.Size() == 4);
+    CHECK(reqs[1]->Data.Data()[3] == 'D');
+
+    // after the read has finished, a new read goes to the filesystem
+    Ptr<IORead> req = IO::LoadFile("count://bla.com/blub.txt");
+    reqs.Clear();
+    reqs.Add(req);
+    IOTest::waitHandled(reqs);
+    CHECK(numReads == 3);
+    CHECK(req->Data.Size() == 4);
+
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCoalesceLoadTest) {
+    setupCountingIO(true);
+    int numLoaded = 0;
+    for (int i = 0; i < 4; i++) {
+        IO::Load("count://bla.com/blub.txt", [&numLoaded](IO::LoadResult res) {
+            CHECK(res.Data.Size() == 4);
+            numLoaded++;
+        });
+    }
+    readGateOpen = true;
+    IOTest::waitLoaded();
+    CHECK(numLoaded == 4);
+    CHECK(numReads == 1);
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCoalesceCancelTest) {
+    setupCountingIO(true);
+    Ptr<IORead> req0 = IO::LoadFile("count://bla.com/blub.txt");
+    Ptr<IORead> req1 = IO::LoadFile("count://bla.com/blub.txt");
+    Ptr<IORead> req2 = IO::LoadFile("count://bla.com/blob.txt");
+
+    // cancelling one of several readers doesn't cancel the read,
+    // the cancelled request is finished immediately
+    IO::Cancel(req0);
+    CHECK(req0->Handled);
+    CHECK(req0->Status == IOStatus::Cancelled);
+    // cancelling the only reader cancels the read
+    IO::Cancel(req2);
+    CHECK(req2->Handled);
+    CHECK(req2->Status == IOStatus::Cancelled);
+
+    readGateOpen = true;
+    Array<Ptr<IORead>> reqs;
+    reqs.Add(req1);
+    IOTest::waitHandled(reqs);
+    CHECK(req1->Status == IOStatus::OK);
+    CHECK(req1->Data.Size() == 4);
+    CHECK(req0->Data.Empty());
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IONoCoalesceTest) {
+    setupCountingIO(false);
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 8; i++) {
+        reqs.Add(IO::LoadFile("count://bla.com/blub.txt"));
+    }
+    readGateOpen = true;
+    IOTest::waitHandled(reqs);
+    CHECK(numReads == 8);
+    IOTest::discard();
+}
+#endif
+
+//------------------------------------------------------------------------------
+static Ptr<IORead>
+makeRead(int priority, const TimePoint& deadline) {
+    Ptr<IORead> req = IORead::Create();
+    req->Url = "count://bla.com/blub.txt";
+    req->Priority = priority;
+    req->Deadline = deadline;
+    return req;
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCoalescePriorityTest) {
+    // the carrier takes priority and deadline of the most urgent
+    // attached request: highest priority, then earliest deadline
+    Core::Setup();
+    _priv::ioCoalescer coalescer;
+    coalescer.setup(_priv::ioPointers());
+    const TimePoint now = Clock::Now();
+    Array<Ptr<_priv::ioMsg>> msgs;
+
+    coalescer.add(makeRead(1, TimePoint()), msgs);
+    CHECK(msgs.Size() == 1);
+    const Ptr<IORead> carrier = msgs[0]->DynamicCast<IORead>();
+    msgs.Clear();
+
+    // same priority with a deadline is more urgent than no deadline
+    coalescer.add(makeRead(1, now + Duration::FromSeconds(2.0)), msgs);
+    CHECK(msgs.Size() == 1);
+    if (msgs.Size() == 1) {
+        CHECK(msgs[0]->IsA<rescheduleRequest>());
+        const auto msg = msgs[0]->DynamicCast<rescheduleRequest>();
+        CHECK(msg->Request == carrier);
+        CHECK(msg->Priority == 1);
+        CHECK(msg->Deadline == now + Duration::FromSeconds(2.0));
+    }
+    msgs.Clear();
+
+    // an earlier deadline at the same priority reschedules the carrier
+    coalescer.add(makeRead(1, now + Duration::FromSeconds(1.0)), msgs);
+    CHECK(msgs.Size() == 1);
+    if (msgs.Size() == 1) {
+        CHECK(msgs[0]->DynamicCast<rescheduleRequest>()->Deadline == now + Duration::FromSeconds(1.0));
+    }
+    msgs.Clear();
+
+    // a later deadline or lower priority doesn't change anything
+    coalescer.add(makeRead(1, now + Duration::FromSeconds(3.0)), msgs);
+    coalescer.add(makeRead(0, now), msgs);
+    CHECK(msgs.Empty());
+
+    // a higher priority wins over an earlier deadline
+    coalescer.add(makeRead(2, TimePoint()), msgs);
+    CHECK(msgs.Size() == 1);
+    if (msgs.Size() == 1) {
+        const auto msg = msgs[0]->DynamicCast<rescheduleRequest>();
+        CHECK(msg->Priority == 2);
+        CHECK(msg->Deadline == TimePoint());
+    }
+    msgs.Clear();
+
+    coalescer.clear();
+    Core::Discard();
+}
@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+//  IODecompressTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/Core/LZ4Stream.h"
+#include "IOTestHelpers.h"
+#include <cstring>
+#include <thread>
+
+using namespace Oryol;
+
+static Buffer original;
+static Buffer compressed;
+
+// a filesystem which returns compressed data, either right away ('sync.olz'),
+// or later from another thread ('async.olz'), uncompressed data for 'raw.olz',
+// and a corrupted stream for 'bad.olz', all other files are compressed
+class CompressedFileSystem : public FileSystem {
+    OryolClassDecl(CompressedFileSystem);
+    OryolClassCreator(CompressedFileSystem);
+public:
+    ~CompressedFileSystem() {
+        if (this->asyncThread.joinable()) {
+            this->asyncThread.join();
+        }
+    };
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        const String path = msg->Url.Path();
+        if (path == "async.olz") {
+            if (this->asyncThread.joinable()) {
+                this->asyncThread.join();
+            }
+            this->asyncThread = std::thread([msg] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                msg->Data.Add(compressed.Data(), compressed.Size());
+                msg->Status = IOStatus::OK;
+                msg->Handled = true;
+            });
+            return;
+        }
+        if (path == "raw.olz") {
+            msg->Data.Add(original.Data(), original.Size());
+        }
+        else {
+            msg->Data.Add(compressed.Data(), compressed.Size());
+            if (path == "bad.olz") {
+                ((uint8_t*)msg->Data.Data())[LZ4Stream::HeaderSize + 4] ^= 0xFF;
+            }
+        }
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+private:
+    std::thread asyncThread;
+};
+
+#if ORYOL_HAS_THREADS && !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+static void
+setupCompressedIO() {
+    const int size = 300 * 1000;
+    uint8_t* ptr = original.Add(size);
+    for (int i = 0; i < size; i++) {
+        ptr[i] = uint8_t((i / 64) % 7 + i % 3);
+    }
+    LZ4Stream::Compress(original.Data(), size, compressed, 64 * 1024);
+    IOTest::setup();
+    IO::RegisterFileSystem("olz", CompressedFileSystem::Creator());
+}
+
+//------------------------------------------------------------------------------
+static void
+discardCompressedIO() {
+    IOTest::discard();
+    original.Clear();
+    compressed.Clear();
+}
+
+//------------------------------------------------------------------------------
+static bool
+isOriginal(const Buffer& data) {
+    return (data.Size() == original.Size()) && (0 == std::memcmp(data.Data(), original.Data(), data.Size()));
+}
+
+//------------------------------------------------------------------------------
+TEST(IODecompressTest) {
+    setupCompressedIO();
+
+    // compressed data is decompressed on the IO worker, no matter
+    // whether the filesystem handles the read right away or later
+    Ptr<IORead> sync = IO::LoadFile("olz://bla.com/sync.olz");
+    Ptr<IORead> async = IO::LoadFile("olz://bla.com/async.olz");
+    Ptr<IORead> raw = IO::LoadFile("olz://bla.com/raw.olz");
+    IOTest::waitHandled(sync);
+    CHECK(sync->Status == IOStatus::OK);
+    CHECK(isOriginal(sync->Data));
+    IOTest::waitHandled(async);
+    CHECK(async->Status == IOStatus::OK);
+    CHECK(isOriginal(async->Data));
+    IOTest::waitHandled(raw);
+    CHECK(raw->Status == IOStatus::OK);
+    CHECK(isOriginal(raw->Data));
+
+    // the same through IO::Load()
+    int numLoaded = 0;
+    IO::Load("olz://bla.com/async.olz", [&numLoaded](IO::LoadResult res) {
+        CHECK(isOriginal(res.Data));
+        numLoaded++;
+    });
+    IOTest::waitLoaded();
+    CHECK(1 == numLoaded);
+
+    // a malformed stream fails
+    Ptr<IORead> bad = IO::LoadFile("olz://bla.com/bad.olz");
+    IOTest::waitHandled(bad);
+    CHECK(bad->Status == IOStatus::UnsupportedMediaType);
+    CHECK(bad->Data.Empty());
+
+    // files without the '.olz' extension are never decompressed
+    Ptr<IORead> plain = IO::LoadFile("olz://bla.com/plain.bin");
+    IOTest::waitHandled(plain);
+    CHECK(plain->Status == IOStatus::OK);
+    CHECK(LZ4Stream::IsCompressed(plain->Data.Data(), plain->Data.Size()));
+    CHECK(LZ4Stream::IsCompressedUrl("olz://bla.com/sync.olz?v=2"));
+    CHECK(!LZ4Stream::IsCompressedUrl("olz://bla.com/sync.olz.bin"));
+
+    // decompression can be disabled, and byte ranges are never decompressed
+    Ptr<IORead> noDecompress = IORead::Create();
+    noDecompress->Url = "olz://bla.com/sync.olz";
+    noDecompress->DecompressEnabled = false;
+    IO::Put(noDecompress);
+    Ptr<IORead> range = IORead::Create();
+    range->Url = "olz://bla.com/sync.olz";
+    range->EndOffset = LZ4Stream::HeaderSize;
+    IO::Put(range);
+    IOTest::waitHandled(noDecompress);
+    CHECK(LZ4Stream::IsCompressed(noDecompress->Data.Data(), noDecompress->Data.Size()));
+    IOTest::waitHandled(range);
+    CHECK(LZ4Stream::IsCompressed(range->Data.Data(), range->Data.Size()));
+
+    discardCompressedIO();
+}
+#endif
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+//  IOLoadQueueTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IOTestHelpers.h"
+#include "Core/Time/Clock.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Memory/FrameAllocator.h"
+#include <thread>
+
+using namespace Oryol;
+
+// a filesystem which returns the URL path as content, and fails for 'fail'
+class EchoFileSystem : public FileSystem {
+    OryolClassDecl(EchoFileSystem);
+    OryolClassCreator(EchoFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        const String path = msg->Url.Path();
+        if (path == "fail") {
+            msg->Status = IOStatus::NotFound;
+        }
+        else {
+            msg->Data.Add((const uint8_t*)path.AsCStr(), path.Length());
+            msg->Status = IOStatus::OK;
+        }
+        msg->Handled = true;
+    };
+};
+
+#if ORYOL_HAS_THREADS && !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+static void
+setupEchoIO() {
+    IOTest::setup();
+    IO::RegisterFileSystem("echo", EchoFileSystem::Creator());
+}
+
+//------------------------------------------------------------------------------
+TEST(IOLoadQueueTest) {
+    setupEchoIO();
+
+    int numLoaded = 0;
+    int numFailed = 0;
+    IO::Load("echo://bla.com/a", [&numLoaded](IO::LoadResult res) {
+        CHECK(res.Url.Path() == "a");
+        CHECK(res.Data.Size() == 1);
+        numLoaded++;
+    });
+    IO::Load("echo://bla.com/fail", [&numLoaded](IO::LoadResult res) {
+        numLoaded++;
+    },
+    [&numFailed](const URL& url, IOStatus::Code ioStatus) {
+        CHECK(ioStatus == IOStatus::NotFound);
+        numFailed++;
+    });
+    Array<URL> urls({ "echo://bla.com/b", "echo://bla.com/cc", "echo://bla.com/ddd" });
+    IO::LoadGroup(urls, [&numLoaded](Array<IO::LoadResult> results) {
+        CHECK(results.Size() == 3);
+        CHECK(FrameAllocator::IsOwned(results.begin()));
+        if (results.Size() == 3) {
+            CHECK(results[0].Data.Size() == 1);
+            CHECK(results[1].Data.Size() == 2);
+            CHECK(results[2].Data.Size() == 3);
+        }
+        numLoaded++;
+    });
+    // a group with a failed request only calls the fail callback
+    Array<URL> failUrls({ "echo://bla.com/e", "echo://bla.com/fail" });
+    IO::LoadGroup(failUrls, [&numLoaded](Array<IO::LoadResult> results) {
+        numLoaded++;
+    },
+    [&numFailed](const URL& url, IOStatus::Code ioStatus) {
+        numFailed++;
+    });
+    CHECK(IO::NumPendingLoads() == 4);
+    IOTest::waitLoaded();
+    CHECK(numLoaded == 2);
+    CHECK(numFailed == 2);
+
+    // new loads can be issued from a load callback
+    IO::Load("echo://bla.com/f", [&numLoaded](IO::LoadResult res) {
+        IO::Load("echo://bla.com/g", [&numLoaded](IO::LoadResult res) {
+            numLoaded++;
+        });
+    });
+    IOTest::waitLoaded();
+    CHECK(numLoaded == 3);
+
+    // an empty group completes immediately
+    IO::LoadGroup(Array<URL>(), [&numLoaded](Array<IO::LoadResult> results) {
+        CHECK(results.Empty());
+        numLoaded++;
+    });
+    CHECK(numLoaded == 4);
+    CHECK(IO::NumPendingLoads() == 0);
+
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOLoadQueueBenchmark) {
+    setupEchoIO();
+
+    // many outstanding loads, the per-frame cost of the load queue
+    // only depends on the number of loads which finished in that frame
+    const int numLoads = 10000;
+    StringBuilder strBuilder;
+    int numLoaded = 0;
+    const TimePoint start = Clock::Now();
+    for (int i = 0; i < numLoads; i++) {
+        strBuilder.Format(64, "echo://bla.com/%d", i);
+        IO::Load(strBuilder.GetString(), [&numLoaded](IO::LoadResult res) {
+            numLoaded++;
+        });
+    }
+    const int numFrames = IOTest::waitLoaded();
+    const Duration time = Clock::Since(start);
+    CHECK(numLoaded == numLoads);
+    Log::Info("IOLoadQueueBenchmark: %d loads finished in %.3f ms (%d frames)\n",
+        numLoads, time.AsMilliSeconds(), numFrames);
+
+    IOTest::discard();
+}
+#endif
@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+//  IOPriorityTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IOTestHelpers.h"
+#include "Core/Time/Clock.h"
+#include <thread>
+#include <mutex>
+
+using namespace Oryol;
+
+static std::atomic<bool> gateOpen{false};
+static std::mutex handledMutex;
+static Array<String> handledPaths;
+
+// a filesystem which blocks the IO worker until the gate is opened
+class GateFileSystem : public FileSystem {
+    OryolClassDecl(GateFileSystem);
+    OryolClassCreator(GateFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        while (!gateOpen) {
+            std::this_thread::yield();
+        }
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+// a filesystem which records the order in which requests are handled
+class RecordFileSystem : public FileSystem {
+    OryolClassDecl(RecordFileSystem);
+    OryolClassCreator(RecordFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        {
+            std::lock_guard<std::mutex> lock(handledMutex);
+            handledPaths.Add(msg->Url.Path());
+        }
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+#if ORYOL_HAS_THREADS && !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+// setup IO with a single worker which is blocked by a gate request,
+// so that the following requests are queued up
+static Ptr<IORead>
+setupBlockedIO() {
+    gateOpen = false;
+    handledPaths.Clear();
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 1;
+    IOTest::setup(ioSetup);
+    IO::RegisterFileSystem("gate", GateFileSystem::Creator());
+    IO::RegisterFileSystem("rec", RecordFileSystem::Creator());
+    Ptr<IORead> gateReq = IO::LoadFile("gate://bla.com/gate");
+    IOTest::runFrame();
+    return gateReq;
+}
+
+//------------------------------------------------------------------------------
+TEST(IOPriorityOrderTest) {
+    Ptr<IORead> gateReq = setupBlockedIO();
+    Array<Ptr<IORead>> reqs;
+    reqs.Add(IO::LoadFile("rec://bla.com/low", -10));
+    reqs.Add(IO::LoadFile("rec://bla.com/normal0"));
+    reqs.Add(IO::LoadFile("rec://bla.com/high", 10));
+    reqs.Add(IO::LoadFile("rec://bla.com/normal1"));
+
+    // requests of same priority are handled earliest-deadline-first
+    const TimePoint now = Clock::Now();
+    Ptr<IORead> late = IORead::Create();
+    late->Url = "rec://bla.com/late";
+    late->Priority = 5;
+    late->Deadline = now + Duration::FromSeconds(2.0);
+    IO::Put(late);
+    reqs.Add(late);
+    Ptr<IORead> early = IORead::Create();
+    early->Url = "rec://bla.com/early";
+    early->Priority = 5;
+    early->Deadline = now + Duration::FromSeconds(1.0);
+    IO::Put(early);
+    reqs.Add(early);
+
+    IOTest::runFrame();
+    gateOpen = true;
+    reqs.Add(gateReq);
+    IOTest::waitHandled(reqs);
+
+    CHECK(handledPaths.Size() == 6);
+    if (handledPaths.Size() == 6) {
+        CHECK(handledPaths[0] == "high");
+        CHECK(handledPaths[1] == "early");
+        CHECK(handledPaths[2] == "late");
+        CHECK(handledPaths[3] == "normal0");
+        CHECK(handledPaths[4] == "normal1");
+        CHECK(handledPaths[5] == "low");
+    }
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOReprioritizeTest) {
+    Ptr<IORead> gateReq = setupBlockedIO();
+    Array<Ptr<IORead>> reqs;
+    reqs.Add(IO::LoadFile("rec://bla.com/a"));
+    reqs.Add(IO::LoadFile("rec://bla.com/b"));
+    reqs.Add(IO::LoadFile("rec://bla.com/c"));
+    IO::Reprioritize(reqs[2], 10);
+    IO::Reprioritize(reqs[0], -10);
+    IO::Reprioritize(reqs[0], -20);
+    IOTest::runFrame();
+    gateOpen = true;
+    reqs.Add(gateReq);
+    IOTest::waitHandled(reqs);
+
+    // each request must only be handled once
+    CHECK(handledPaths.Size() == 3);
+    if (handledPaths.Size() == 3) {
+        CHECK(handledPaths[0] == "c");
+        CHECK(handledPaths[1] == "b");
+        CHECK(handledPaths[2] == "a");
+    }
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOCancelTest) {
+    Ptr<IORead> gateReq = setupBlockedIO();
+    Ptr<IORead> req0 = IO::LoadFile("rec://bla.com/a");
+    Ptr<IORead> req1 = IO::LoadFile("rec://bla.com/b");
+    IOTest::runFrame();
+
+    // a cancelled request doesn't need to wait for the blocked worker,
+    // it is finished as soon as the worker picks up new messages,
+    // which happens after the gate request
+    IO::Cancel(req0);
+    IOTest::runFrame();
+    gateOpen = true;
+    Array<Ptr<IORead>> reqs;
+    reqs.Add(gateReq);
+    reqs.Add(req0);
+    reqs.Add(req1);
+    IOTest::waitHandled(reqs);
+    CHECK(req0->Status == IOStatus::Cancelled);
+    CHECK(req1->Status == IOStatus::OK);
+    CHECK(handledPaths.Size() == 1);
+    if (handledPaths.Size() == 1) {
+        CHECK(handledPaths[0] == "b");
+    }
+    IOTest::discard();
+}
+#endif
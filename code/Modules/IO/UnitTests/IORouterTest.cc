@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  IORouterTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IOTestHelpers.h"
+#include "Core/Time/Clock.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Log.h"
+#include <thread>
+#include <chrono>
+
+using namespace Oryol;
+
+// a filesystem which takes a long time to handle a request (like a HTTP download)
+class SlowFileSystem : public FileSystem {
+    OryolClassDecl(SlowFileSystem);
+    OryolClassCreator(SlowFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+// a filesystem which handles requests immediately (like a local file read)
+class FastFileSystem : public FileSystem {
+    OryolClassDecl(FastFileSystem);
+    OryolClassCreator(FastFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+#if ORYOL_HAS_THREADS && !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+// issue a batch of slow requests, followed by a batch of fast requests,
+// and return the time until all fast requests have been handled
+static Duration
+runRouterBenchmark(const IOSetup& ioSetup) {
+    IOTest::setup(ioSetup);
+    IO::RegisterFileSystem("slow", SlowFileSystem::Creator());
+    IO::RegisterFileSystem("fast", FastFileSystem::Creator());
+    IOTest::runFrame();
+
+    // NOTE: use different URLs, reads of the same URL would be coalesced
+    StringBuilder strBuilder;
+    Array<Ptr<IORead>> slowReqs;
+    Array<Ptr<IORead>> fastReqs;
+    for (int i = 0; i < 16; i++) {
+        strBuilder.Format(64, "slow://bla.com/blub%d.txt", i);
+        slowReqs.Add(IO::LoadFile(strBuilder.GetString()));
+    }
+    const TimePoint start = Clock::Now();
+    for (int i = 0; i < 16; i++) {
+        strBuilder.Format(64, "fast://bla.com/blub%d.txt", i);
+        fastReqs.Add(IO::LoadFile(strBuilder.GetString()));
+    }
+    IOTest::waitHandled(fastReqs);
+    const Duration fastTime = Clock::Since(start);
+    IOTest::waitHandled(slowReqs);
+    IOTest::discard();
+    return fastTime;
+}
+
+#if ORYOL_MEMORY_TRACKING
+// a filesystem which logs on the IO worker thread, with async
+// logging this creates a per-thread log buffer
+class LogFileSystem : public FileSystem {
+    OryolClassDecl(LogFileSystem);
+    OryolClassCreator(LogFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        Log::Dbg("LogFileSystem: %s\n", msg->Url.AsCStr());
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+//------------------------------------------------------------------------------
+static int64_t
+numLiveAllocs() {
+    int64_t num = 0;
+    for (int i = 0; i < MemoryTracker::NumTags(); i++) {
+        num += MemoryTracker::GetTagStats(i).NumLiveAllocs;
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+TEST(IOWorkerThreadTest) {
+    // IO worker threads give up their per-thread state when they
+    // exit, so repeatedly setting up and discarding the IO module
+    // doesn't leak
+    Core::Setup();
+    Log::StartAsync();
+    int64_t liveAllocs[3] = { };
+    for (int i = 0; i < 3; i++) {
+        IO::Setup(IOSetup());
+        IO::RegisterFileSystem("log", LogFileSystem::Creator());
+        Ptr<IORead> req = IO::LoadFile("log://bla.com/blub.txt");
+        IOTest::waitHandled(req);
+        CHECK(req->Status == IOStatus::OK);
+        req = nullptr;
+        IO::Discard();
+        Log::Flush();
+        liveAllocs[i] = numLiveAllocs();
+    }
+    CHECK(liveAllocs[2] == liveAllocs[1]);
+    Log::StopAsync();
+    Core::Discard();
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(IORouterBenchmark) {
+    // head-of-line blocking: a shared pool vs. a dedicated pool for the slow scheme,
+    // the fast requests must not be queued behind the slow requests if the
+    // slow scheme has its own worker pool
+    IOSetup sharedSetup;
+    sharedSetup.NumWorkers = 6;
+    const Duration sharedTime = runRouterBenchmark(sharedSetup);
+
+    IOSetup poolSetup;
+    poolSetup.NumWorkers = 2;
+    poolSetup.SchemeWorkers.Add("slow", 4);
+    const Duration poolTime = runRouterBenchmark(poolSetup);
+
+    Log::Info("IORouterBenchmark: 16 fast reads behind 16 slow reads: shared pool %.3f ms, scheme pools %.3f ms\n",
+        sharedTime.AsMilliSeconds(), poolTime.AsMilliSeconds());
+    CHECK(poolTime < sharedTime);
+}
+#endif
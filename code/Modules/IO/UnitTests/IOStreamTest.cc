@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+//  IOStreamTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IOTestHelpers.h"
+#include <thread>
+
+using namespace Oryol;
+
+static std::atomic<int> numPushed{0};
+
+// a filesystem which streams 16 chunks with the chunk index as content,
+// and doesn't stream non-streaming reads, a stream is suspended while
+// the chunk queue is full
+class ChunkFileSystem : public FileSystem {
+    OryolClassDecl(ChunkFileSystem);
+    OryolClassCreator(ChunkFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        Ptr<IOStreamRead> stream = msg->DynamicCast<IOStreamRead>();
+        const bool streaming = stream.isValid() && (msg->Url.Path() == "stream");
+        int i = 0;
+        const int index = streaming ? this->suspended.FindIndexLinear(stream.get()) : InvalidIndex;
+        if (InvalidIndex != index) {
+            i = this->progress[index];
+            this->suspended.EraseSwap(index);
+            this->progress.EraseSwap(index);
+        }
+        else {
+            msg->Status = IOStatus::OK;
+        }
+        for (; i < 16; i++) {
+            Buffer chunk;
+            Memory::Fill(chunk.Add(4), 4, uint8_t(i));
+            if (streaming) {
+                if (!stream->Cancelled && !stream->CanPushChunk()) {
+                    this->suspended.Add(stream.get());
+                    this->progress.Add(i);
+                    stream->Suspend();
+                    return;
+                }
+                if (!stream->PushChunk(std::move(chunk))) {
+                    msg->Status = IOStatus::Cancelled;
+                    break;
+                }
+                numPushed++;
+            }
+            else {
+                msg->Data.Add(chunk.Data(), chunk.Size());
+            }
+        }
+        msg->Handled = true;
+    };
+private:
+    Array<IOStreamRead*> suspended;
+    Array<int> progress;
+};
+
+#if ORYOL_HAS_THREADS && !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+static void
+setupChunkIO() {
+    numPushed = 0;
+    IOTest::setup();
+    IO::RegisterFileSystem("chunk", ChunkFileSystem::Creator());
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IOStreamRead>
+streamFile(const URL& url, int maxQueuedChunks) {
+    Ptr<IOStreamRead> req = IOStreamRead::Create();
+    req->Url = url;
+    req->ChunkSize = 4;
+    req->MaxQueuedChunks = maxQueuedChunks;
+    IO::Put(req);
+    return req;
+}
+
+//------------------------------------------------------------------------------
+TEST(IOStreamTest) {
+    setupChunkIO();
+    Ptr<IOStreamRead> req = streamFile("chunk://bla.com/stream", 2);
+
+    // the stream is suspended until the consumer pops chunks
+    IOTest::runFrames(20);
+    CHECK(!req->Handled);
+    CHECK(numPushed == 2);
+
+    int numChunks = 0;
+    bool inOrder = true;
+    Buffer chunk;
+    while (!req->Finished()) {
+        if (req->PopChunk(chunk)) {
+            CHECK(chunk.Size() == 4);
+            inOrder &= chunk.Data()[0] == uint8_t(numChunks);
+            numChunks++;
+        }
+        IOTest::runFrames(1);
+    }
+    CHECK(inOrder);
+    CHECK(numChunks == 16);
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Empty());
+
+    // a filesystem which doesn't stream delivers a single chunk
+    req = IO::StreamFile("chunk://bla.com/nostream");
+    while (!req->Handled) {
+        IOTest::runFrames(1);
+    }
+    CHECK(!req->Finished());
+    CHECK(req->PopChunk(chunk));
+    CHECK(chunk.Size() == 64);
+    CHECK(req->Finished());
+    CHECK(!req->PopChunk(chunk));
+
+    IOTest::discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOStreamCancelTest) {
+    setupChunkIO();
+
+    // cancelling finishes a suspended stream
+    Ptr<IOStreamRead> req = streamFile("chunk://bla.com/stream", 1);
+    IOTest::runFrames(10);
+    CHECK(numPushed == 1);
+    IO::Cancel(req);
+    while (!req->Handled) {
+        IOTest::runFrames(1);
+    }
+    CHECK(req->Status == IOStatus::Cancelled);
+    CHECK(numPushed == 1);
+
+    // discarding the IO module with a suspended stream must not hang
+    req = streamFile("chunk://bla.com/stream", 1);
+    IOTest::runFrames(10);
+    IO::Discard();
+    CHECK(req->Handled);
+    CHECK(req->Status == IOStatus::Cancelled);
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(IOStreamSuspendTest) {
+    // a stream waiting for its consumer doesn't block other requests
+    // on the same IO worker
+    numPushed = 0;
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 1;
+    IOTest::setup(ioSetup);
+    IO::RegisterFileSystem("chunk", ChunkFileSystem::Creator());
+    Ptr<IOStreamRead> stream = streamFile("chunk://bla.com/stream", 1);
+    IOTest::runFrames(10);
+    CHECK(numPushed == 1);
+    Array<Ptr<IORead>> reqs;
+    for (int i = 0; i < 4; i++) {
+        reqs.Add(IO::LoadFile("chunk://bla.com/nostream"));
+    }
+    IOTest::waitHandled(reqs);
+    for (const auto& req : reqs) {
+        CHECK(req->Status == IOStatus::OK);
+        CHECK(req->Data.Size() == 64);
+    }
+    CHECK(!stream->Handled);
+    CHECK(numPushed == 1);
+
+    // the stream continues once the consumer pops chunks
+    int numChunks = 0;
+    Buffer chunk;
+    while (!stream->Finished()) {
+        while (stream->PopChunk(chunk)) {
+            numChunks++;
+        }
+        IOTest::runFrame();
+    }
+    CHECK(numChunks == 16);
+    CHECK(stream->Status == IOStatus::OK);
+    IOTest::discard();
+}
+#endif
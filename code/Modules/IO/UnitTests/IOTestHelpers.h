@@ -0,0 +1,103 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @file IO/UnitTests/IOTestHelpers.h
+    @brief helper functions shared by the IO unit tests
+
+    The IO tests run the main thread's runloop until the IO threads
+    have handled their requests, these functions implement the
+    common setup, discard and wait loops.
+*/
+#include "IO/IO.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Containers/Array.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+namespace Oryol {
+namespace IOTest {
+
+//------------------------------------------------------------------------------
+/// setup the Core and IO modules
+inline void
+setup(const IOSetup& ioSetup = IOSetup()) {
+    Core::Setup();
+    IO::Setup(ioSetup);
+}
+
+//------------------------------------------------------------------------------
+/// discard the IO and Core modules
+inline void
+discard() {
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+/// run the main thread's runloop once, and give the IO threads time to run
+inline void
+runFrame() {
+    Core::PreRunLoop()->Run();
+    #if ORYOL_HAS_THREADS
+    std::this_thread::yield();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/// run a number of frames which are at least 1 millisecond apart
+inline void
+runFrames(int num) {
+    for (int i = 0; i < num; i++) {
+        Core::PreRunLoop()->Run();
+        #if ORYOL_HAS_THREADS
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+/// test if all requests have been handled
+template<class TYPE> bool
+allHandled(const Array<Ptr<TYPE>>& reqs) {
+    for (const auto& req : reqs) {
+        if (!req->Handled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// run frames until a request has been handled
+template<class TYPE> void
+waitHandled(const Ptr<TYPE>& req) {
+    while (!req->Handled) {
+        runFrame();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// run frames until all requests have been handled
+template<class TYPE> void
+waitHandled(const Array<Ptr<TYPE>>& reqs) {
+    while (!allHandled(reqs)) {
+        runFrame();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// run frames until all IO::Load() callbacks have been called, return number of frames
+inline int
+waitLoaded() {
+    int numFrames = 0;
+    while (IO::NumPendingLoads() > 0) {
+        runFrame();
+        numFrames++;
+    }
+    return numFrames;
+}
+
+} // namespace IOTest
+} // namespace Oryol
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+//  LZ4CodecTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/Core/LZ4Codec.h"
+#include "Core/Containers/Buffer.h"
+#include <cstring>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static bool
+roundTrip(const uint8_t* src, int size, int& outCompressedSize) {
+    Buffer compressed;
+    const int bound = LZ4Codec::CompressBound(size);
+    outCompressedSize = LZ4Codec::Compress(src, size, compressed.Add(bound), bound);
+    if (0 == outCompressedSize) {
+        return false;
+    }
+    Buffer decompressed;
+    uint8_t* dst = decompressed.Add(size + 1);
+    const int decompressedSize = LZ4Codec::Decompress(compressed.Data(), outCompressedSize, dst, size + 1);
+    return (decompressedSize == size) && (0 == std::memcmp(src, dst, size));
+}
+
+//------------------------------------------------------------------------------
+TEST(LZ4CodecTest) {
+    int compressedSize = 0;
+
+    // empty and tiny inputs
+    const uint8_t tiny[] = { 1, 2, 3 };
+    CHECK(roundTrip(tiny, 0, compressedSize));
+    CHECK(roundTrip(tiny, sizeof(tiny), compressedSize));
+
+    // repetitive data compresses well, including long overlapping matches
+    const int size = 256 * 1024;
+    Buffer data;
+    uint8_t* ptr = data.Add(size);
+    for (int i = 0; i < size; i++) {
+        ptr[i] = (i < 1000) ? uint8_t(i % 7) : ((i < 100000) ? 0x55 : uint8_t((i / 16) % 13));
+    }
+    CHECK(roundTrip(ptr, size, compressedSize));
+    CHECK(compressedSize < (size / 20));
+
+    // random data still roundtrips, and doesn't grow beyond the bound
+    uint32_t x = 12345;
+    for (int i = 0; i < size; i++) {
+        x = x * 1103515245 + 12345;
+        ptr[i] = uint8_t(x >> 16);
+    }
+    CHECK(roundTrip(ptr, size, compressedSize));
+    CHECK(compressedSize <= LZ4Codec::CompressBound(size));
+
+    // a too small destination buffer fails
+    uint8_t small[16];
+    CHECK(0 == LZ4Codec::Compress(ptr, size, small, sizeof(small)));
+}
+
+//------------------------------------------------------------------------------
+TEST(LZ4CodecMalformedTest) {
+    uint8_t dst[64];
+    // literal length past end of input
+    const uint8_t lit[] = { 0xF0, 0x20, 'a' };
+    CHECK(-1 == LZ4Codec::Decompress(lit, sizeof(lit), dst, sizeof(dst)));
+    // match offset before start of output
+    const uint8_t off[] = { 0x10, 'a', 0x05, 0x00 };
+    CHECK(-1 == LZ4Codec::Decompress(off, sizeof(off), dst, sizeof(dst)));
+    // zero offset
+    const uint8_t zero[] = { 0x10, 'a', 0x00, 0x00 };
+    CHECK(-1 == LZ4Codec::Decompress(zero, sizeof(zero), dst, sizeof(dst)));
+    // output too small
+    const uint8_t big[] = { 0x1F, 'a', 0x01, 0x00, 0xFF, 0x00 };
+    CHECK(-1 == LZ4Codec::Decompress(big, sizeof(big), dst, sizeof(dst)));
+    // the same sequence fits into a big enough buffer (1 + 4 + 15 + 255 bytes)
+    uint8_t bigDst[512];
+    CHECK(275 == LZ4Codec::Decompress(big, sizeof(big), bigDst, sizeof(bigDst)));
+    CHECK((bigDst[0] == 'a') && (bigDst[274] == 'a'));
+}
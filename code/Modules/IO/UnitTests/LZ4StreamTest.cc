@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+//  LZ4StreamTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/Core/LZ4Stream.h"
+#include "Core/Log.h"
+#include "Core/Time/Clock.h"
+#include <cstring>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+// fill with texture-like data: smooth gradients with some noise
+static void
+fillTextureData(uint8_t* ptr, int size) {
+    uint32_t x = 12345;
+    for (int i = 0; i < size; i++) {
+        x = x * 1103515245 + 12345;
+        const int noise = ((x >> 16) & 0xF) < 2 ? int((x >> 20) & 3) : 0;
+        ptr[i] = uint8_t(((i / 4) % 256) / 8 + (i % 4) * 32 + noise);
+    }
+}
+
+//------------------------------------------------------------------------------
+static bool
+roundTrip(const uint8_t* src, int size, int blockSize, int& outCompressedSize) {
+    Buffer compressed;
+    LZ4Stream::Compress(src, size, compressed, blockSize);
+    outCompressedSize = compressed.Size();
+    if (!LZ4Stream::IsCompressed(compressed.Data(), compressed.Size()) ||
+        (LZ4Stream::UncompressedSize(compressed.Data(), compressed.Size()) != size)) {
+        return false;
+    }
+    Buffer decompressed;
+    if (!LZ4Stream::Decompress(compressed.Data(), compressed.Size(), decompressed)) {
+        return false;
+    }
+    return (decompressed.Size() == size) && ((0 == size) || (0 == std::memcmp(src, decompressed.Data(), size)));
+}
+
+//------------------------------------------------------------------------------
+TEST(LZ4StreamTest) {
+    int compressedSize = 0;
+
+    // empty and tiny inputs
+    const uint8_t tiny[] = { 1, 2, 3 };
+    CHECK(roundTrip(tiny, 0, LZ4Stream::DefaultBlockSize, compressedSize));
+    CHECK(compressedSize == LZ4Stream::HeaderSize);
+    CHECK(roundTrip(tiny, sizeof(tiny), LZ4Stream::DefaultBlockSize, compressedSize));
+
+    // several blocks, the last one smaller
+    const int size = 1000 * 1000;
+    Buffer data;
+    uint8_t* ptr = data.Add(size);
+    fillTextureData(ptr, size);
+    CHECK(roundTrip(ptr, size, 64 * 1024, compressedSize));
+    CHECK(compressedSize < (size / 2));
+
+    // incompressible blocks are stored, and barely grow
+    uint32_t x = 54321;
+    for (int i = 0; i < size / 2; i++) {
+        x = x * 1103515245 + 12345;
+        ptr[i] = uint8_t(x >> 16);
+    }
+    CHECK(roundTrip(ptr, size, 64 * 1024, compressedSize));
+    CHECK(compressedSize <= (size + LZ4Stream::HeaderSize + 16 * 4));
+
+    // appending to a non-empty buffer
+    Buffer compressed;
+    compressed.Add(tiny, sizeof(tiny));
+    LZ4Stream::Compress(ptr, size, compressed);
+    CHECK(!LZ4Stream::IsCompressed(compressed.Data(), compressed.Size()));
+    Buffer decompressed;
+    CHECK(LZ4Stream::Decompress(compressed.Data() + sizeof(tiny), compressed.Size() - sizeof(tiny), decompressed));
+    CHECK((decompressed.Size() == size) && (0 == std::memcmp(ptr, decompressed.Data(), size)));
+}
+
+//------------------------------------------------------------------------------
+TEST(LZ4StreamMalformedTest) {
+    const int size = 100 * 1000;
+    Buffer data;
+    fillTextureData(data.Add(size), size);
+    Buffer compressed;
+    LZ4Stream::Compress(data.Data(), size, compressed, 16 * 1024);
+    const uint8_t* src = compressed.Data();
+    const int srcSize = compressed.Size();
+    Buffer dst;
+
+    // too short for a header, or not a stream at all
+    CHECK(!LZ4Stream::IsCompressed(src, LZ4Stream::HeaderSize - 1));
+    CHECK(-1 == LZ4Stream::UncompressedSize(src, LZ4Stream::HeaderSize - 1));
+    CHECK(!LZ4Stream::IsCompressed(data.Data(), size));
+    CHECK(!LZ4Stream::Decompress(data.Data(), size, dst));
+    CHECK(dst.Empty());
+
+    // truncated stream, and trailing garbage
+    CHECK(!LZ4Stream::Decompress(src, srcSize - 1, dst));
+    CHECK(dst.Empty());
+    Buffer padded;
+    padded.Add(src, srcSize);
+    padded.Add(src, 4);
+    CHECK(!LZ4Stream::Decompress(padded.Data(), padded.Size(), dst));
+
+    // corrupted block header
+    Buffer corrupt;
+    corrupt.Add(src, srcSize);
+    uint8_t* ptr = (uint8_t*) corrupt.Data();
+    ptr[LZ4Stream::HeaderSize + 1] ^= 0x40;
+    CHECK(!LZ4Stream::Decompress(ptr, corrupt.Size(), dst));
+
+    // an uncompressed size the data can't possibly have is rejected up front
+    Buffer huge;
+    huge.Add(src, LZ4Stream::HeaderSize);
+    const uint32_t hugeSize = 0x7FFFFFFF;
+    std::memcpy((uint8_t*)huge.Data() + 8, &hugeSize, sizeof(hugeSize));
+    huge.Add(src + LZ4Stream::HeaderSize, 64);
+    CHECK(LZ4Stream::IsCompressed(huge.Data(), huge.Size()));
+    CHECK(!LZ4Stream::Decompress(huge.Data(), huge.Size(), dst));
+}
+
+//------------------------------------------------------------------------------
+TEST(LZ4StreamBenchmark) {
+    // decompression throughput for texture-like data, this is the work
+    // which IO workers do after reading a compressed file
+    const int size = 16 * 1024 * 1024;
+    const int numIterations = 8;
+    Buffer data;
+    fillTextureData(data.Add(size), size);
+    Buffer compressed;
+    TimePoint start = Clock::Now();
+    LZ4Stream::Compress(data.Data(), size, compressed);
+    Duration compressTime = Clock::Since(start);
+
+    Buffer decompressed;
+    start = Clock::Now();
+    bool ok = true;
+    for (int i = 0; i < numIterations; i++) {
+        ok &= LZ4Stream::Decompress(compressed.Data(), compressed.Size(), decompressed);
+    }
+    Duration decompressTime = Clock::Since(start);
+    CHECK(ok);
+    CHECK((decompressed.Size() == size) && (0 == std::memcmp(data.Data(), decompressed.Data(), size)));
+
+    const double mb = double(size) / (1024.0 * 1024.0);
+    Log::Info("LZ4StreamBenchmark: %.1f MB -> %.1f MB (%.1f%%)\n",
+        mb, compressed.Size() / (1024.0 * 1024.0), 100.0 * compressed.Size() / size);
+    Log::Info("LZ4StreamBenchmark: compress %.1f MB/s, decompress %.1f MB/s\n",
+        mb / compressTime.AsSeconds(), (mb * numIterations) / decompressTime.AsSeconds());
+}
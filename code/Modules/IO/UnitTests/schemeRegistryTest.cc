@@ -68,6 +68,12 @@ TEST(schemeRegistryTest) {
     CHECK(fsc);
     CHECK(fsc->GetType() == 2);
 
+    // registering an existing scheme replaces the filesystem
+    reg.RegisterFileSystem(file, TestFS_B::Creator());
+    CHECK(reg.IsFileSystemRegistered(file));
+    Ptr<TestFS_A> fsr = reg.CreateFileSystem(file);
+    CHECK(fsr->GetType() == 1);
+
     Core::Discard();
 }
 
@@ -5,7 +5,13 @@
     @ingroup _priv
     @brief frontend inputMgr class
 */
-#if ORYOL_D3D11
+#if ORYOL_HEADLESS
+#include "Input/Core/inputMgrBase.h"
+namespace Oryol {
+namespace _priv {
+class inputMgr : public inputMgrBase { };
+} }
+#elif ORYOL_D3D11
 #include "Input/win/winInputMgr.h"
 namespace Oryol {
 namespace _priv {
@@ -11,6 +11,13 @@ namespace Oryol {
 
 using namespace _priv;
 
+//------------------------------------------------------------------------------
+LocalFileSystem::~LocalFileSystem() {
+    for (const auto& s : this->streams) {
+        fsWrapper::close(s.file);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::init(const StringAtom& scheme_) {
@@ -29,7 +36,13 @@ LocalFileSystem::init(const StringAtom& scheme_) {
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::onMsg(const Ptr<IORequest>& req) {
-    if (req->IsA<IORead>()) {
+    if (req->IsA<IOStreamRead>()) {
+        if (!this->onStreamRead(req->DynamicCast<IOStreamRead>())) {
+            // suspended, continued in a later onMsg() call
+            return;
+        }
+    }
+    else if (req->IsA<IORead>()) {
         this->onRead(req->DynamicCast<IORead>());
     }
     else if (req->IsA<IOWrite>()) {
@@ -49,14 +62,26 @@ LocalFileSystem::onRead(const Ptr<IORead>& msg) {
             if (startOffset > 0) {
                 fsWrapper::seek(h, startOffset);
             }
+            const int fileSize = fsWrapper::size(h);
             int size;
             if (endOffset == EndOfFile) {
-                size = fsWrapper::size(h) - startOffset;
+                size = fileSize - startOffset;
             }
             else {
                 size = endOffset - startOffset;
             }
-            if (size > 0) {
+            const uint8_t* mapPtr = nullptr;
+            if (msg->MapEnabled && (size >= MinMapSize) && ((startOffset + size) <= fileSize) && msg->Data.Empty()) {
+                mapPtr = fsWrapper::map(h, startOffset, size);
+            }
+            if (mapPtr) {
+                // zero-copy: the mapping outlives the file handle
+                msg->Data.Wrap(mapPtr, size, [](const uint8_t* ptr, int numBytes) {
+                    fsWrapper::unmap(ptr, numBytes);
+                });
+                msg->Status = IOStatus::OK;
+            }
+            else if (size > 0) {
                 uint8_t* ptr = msg->Data.Add(size);
                 int bytesRead = fsWrapper::read(h, ptr, size);
                 if (bytesRead != size) {
@@ -80,6 +105,85 @@ LocalFileSystem::onRead(const Ptr<IORead>& msg) {
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+LocalFileSystem::onStreamRead(const Ptr<IOStreamRead>& msg) {
+    stream s;
+    int index = InvalidIndex;
+    for (int i = 0; i < this->streams.Size(); i++) {
+        if (this->streams[i].req == msg.get()) {
+            index = i;
+            break;
+        }
+    }
+    if (InvalidIndex != index) {
+        // continue a suspended stream
+        s = this->streams[index];
+        this->streams.EraseSwap(index);
+    }
+    else if (msg->Url.HasPath()) {
+        // a new stream, or a suspended stream which has been started by
+        // a replaced filesystem instance, this resumes after the bytes
+        // which have already been pushed
+        s.file = fsWrapper::openRead(msg->Url.Path().AsCStr());
+        if (fsWrapper::invalidHandle != s.file) {
+            const int startOffset = msg->StartOffset;
+            const int endOffset = msg->EndOffset;
+            if (endOffset == EndOfFile) {
+                s.size = fsWrapper::size(s.file) - startOffset;
+            }
+            else {
+                s.size = endOffset - startOffset;
+            }
+            const int numPushed = msg->NumBytesPushed();
+            if ((startOffset + numPushed) > 0) {
+                fsWrapper::seek(s.file, startOffset + numPushed);
+            }
+            s.size -= numPushed;
+            msg->Status = IOStatus::OK;
+        }
+        else {
+            msg->Status = IOStatus::NotFound;
+            msg->ErrorDesc = "Failed to open file";
+            return true;
+        }
+    }
+    else {
+        msg->Status = IOStatus::BadRequest;
+        msg->ErrorDesc = "No path in URL";
+        return true;
+    }
+
+    while (s.size > 0) {
+        if (msg->Cancelled) {
+            msg->Status = IOStatus::Cancelled;
+            break;
+        }
+        if (!msg->CanPushChunk()) {
+            // don't block the IO worker while the consumer is behind
+            s.req = msg.get();
+            this->streams.Add(s);
+            msg->Suspend();
+            return false;
+        }
+        const int chunkSize = s.size < msg->ChunkSize ? s.size : msg->ChunkSize;
+        Buffer chunk;
+        uint8_t* ptr = chunk.Add(chunkSize);
+        if (fsWrapper::read(s.file, ptr, chunkSize) != chunkSize) {
+            msg->Status = IOStatus::DownloadError;
+            msg->ErrorDesc = "Fewer bytes read then expected";
+            break;
+        }
+        if (!msg->PushChunk(std::move(chunk))) {
+            msg->Status = IOStatus::Cancelled;
+            break;
+        }
+        s.size -= chunkSize;
+    }
+    fsWrapper::close(s.file);
+    return true;
+}
+
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::onWrite(const Ptr<IOWrite>& msg) {
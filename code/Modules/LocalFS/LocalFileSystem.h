@@ -7,9 +7,26 @@
     @class Oryol::LocalFileSystem
     @ingroup LocalFS
     @brief FileSystem subclass to access the local host file system
+
+    Reads of at least MinMapSize bytes are memory-mapped instead of
+    copied if IORead::MapEnabled is set (it is off by default) and the
+    platform supports it, the IORead's Data buffer then wraps a read-only
+    view into the file which is unmapped when the buffer is destroyed.
+    Since IOWrite truncates the file, a file must not be written while
+    a mapped view of it is alive (also in coalesced reads or the IO
+    cache), this is why mapping is opt-in.
+
+    IOStreamRead requests are read in chunks of IOStreamRead::ChunkSize
+    bytes, each chunk is handed to the consumer as soon as it has been
+    read. While the consumer's chunk queue is full, the stream is
+    suspended and its file stays open until the stream is continued.
+    If the filesystem is replaced in the meantime, the new instance
+    reopens the file after IOStreamRead::NumBytesPushed().
 */
 #include "IO/FS/FileSystem.h"
 #include "Core/Creator.h"
+#include "Core/Containers/Array.h"
+#include "LocalFS/Core/fsWrapper.h"
 
 namespace Oryol {
 
@@ -17,6 +34,12 @@ class LocalFileSystem : public FileSystem {
     OryolClassDecl(LocalFileSystem);
     OryolClassCreator(LocalFileSystem);
 public:
+    /// minimum read size for memory-mapping
+    static const int MinMapSize = 64 * 1024;
+
+    /// destructor
+    virtual ~LocalFileSystem();
+
     /// called once on main-thread
     virtual void init(const StringAtom& scheme) override;
     /// called when IO message should be handled
@@ -25,8 +48,19 @@ public:
 private:
     /// handle IORead msg
     void onRead(const Ptr<IORead>& ioRead);
+    /// handle IOStreamRead msg, return false if the stream has been suspended
+    bool onStreamRead(const Ptr<IOStreamRead>& ioStreamRead);
     /// handle IOWrite msg
     void onWrite(const Ptr<IOWrite>& ioWrite);
+
+    /// an open file of a suspended stream
+    struct stream {
+        IOStreamRead* req = nullptr;
+        _priv::fsWrapper::handle file = _priv::fsWrapper::invalidHandle;
+        int size = 0;   // remaining bytes
+    };
+    /// only few streams are suspended at a time, so this is searched linearly
+    Array<stream> streams;
 };
 
 } // namespace Oryol
@@ -62,4 +62,14 @@ TEST(FSWrapperTest) {
     readStr.Assign(buf, 0, 6);
     CHECK(readStr == "World\n");
     fsWrapper::close(hs);
+
+    // memory-mapped views (not supported on all platforms)
+    const fsWrapper::handle hm = fsWrapper::openRead(strBuilder.AsCStr());
+    const uint8_t* ptr = fsWrapper::map(hm, 6, 5);
+    fsWrapper::close(hm);
+    if (ptr) {
+        readStr.Assign((const char*)ptr, 0, 5);
+        CHECK(readStr == "World");
+        fsWrapper::unmap(ptr, 5);
+    }
 }
@@ -5,7 +5,9 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Core.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Time/Clock.h"
 #include "IO/IO.h"
+#include "IO/UnitTests/IOTestHelpers.h"
 #include "LocalFS/LocalFileSystem.h"
 #include "LocalFS/Core/fsWrapper.h"
 
@@ -192,3 +194,304 @@ TEST(SameExtensionTest) {
 
 
 
+
+TEST(MappedReadTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    // write a file which is big enough to be memory-mapped
+    const int size = LocalFileSystem::MinMapSize * 2 + 123;
+    auto write = IOWrite::Create();
+    write->Url = "root:mapped.bin";
+    uint8_t* dst = write->Data.Add(size);
+    for (int i = 0; i < size; i++) {
+        dst[i] = uint8_t(i * 7);
+    }
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // read from a non-page-aligned offset
+    const int startOffset = 4097;
+    auto read = IORead::Create();
+    read->Url = "root:mapped.bin";
+    read->StartOffset = startOffset;
+    read->MapEnabled = true;
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(read->Data.Size() == size - startOffset);
+    #if ORYOL_POSIX && !ORYOL_WINDOWS
+    CHECK(read->Data.IsWrapped());
+    #endif
+    bool match = true;
+    const uint8_t* src = read->Data.Data();
+    for (int i = 0; i < read->Data.Size(); i++) {
+        match &= src[i] == uint8_t((i + startOffset) * 7);
+    }
+    CHECK(match);
+
+    // the mapped data must survive being moved out of the request
+    Buffer data(std::move(read->Data));
+    read = nullptr;
+    CHECK(data.Data()[0] == uint8_t(startOffset * 7));
+
+    // small reads and reads without MapEnabled (the default) are copied
+    read = IORead::Create();
+    read->Url = "root:mapped.bin";
+    read->EndOffset = 16;
+    read->MapEnabled = true;
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(!read->Data.IsWrapped());
+    CHECK(read->Data.Size() == 16);
+    read = IORead::Create();
+    read->Url = "root:mapped.bin";
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(!read->Data.IsWrapped());
+    CHECK(read->Data.Size() == size);
+
+    // rewriting the file doesn't affect the data of a default read
+    Buffer oldData(std::move(read->Data));
+    write = IOWrite::Create();
+    write->Url = "root:mapped.bin";
+    write->Data.Add(16);
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+    match = true;
+    for (int i = 0; i < oldData.Size(); i++) {
+        match &= oldData.Data()[i] == uint8_t(i * 7);
+    }
+    CHECK(match);
+
+    // reading past the end of file must fail instead of mapping
+    read = IORead::Create();
+    read->Url = "root:mapped.bin";
+    read->EndOffset = size + LocalFileSystem::MinMapSize;
+    read->MapEnabled = true;
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Status == IOStatus::DownloadError);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(MappedReadBenchmark) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    const int size = 32 * 1024 * 1024;
+    auto write = IOWrite::Create();
+    write->Url = "root:mapped_bench.bin";
+    Memory::Fill(write->Data.Add(size), size, 0x55);
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // read and touch every byte, with and without memory-mapping
+    for (int mapEnabled = 0; mapEnabled < 2; mapEnabled++) {
+        TimePoint start = Clock::Now();
+        auto read = IORead::Create();
+        read->Url = "root:mapped_bench.bin";
+        read->MapEnabled = 0 != mapEnabled;
+        IO::Put(read);
+        IOTest::waitHandled(read);
+        CHECK(read->Status == IOStatus::OK);
+        uint32_t sum = 0;
+        const uint8_t* ptr = read->Data.Data();
+        for (int i = 0; i < read->Data.Size(); i++) {
+            sum += ptr[i];
+        }
+        CHECK(sum == uint32_t(size) * 0x55);
+        Log::Info("MappedReadBenchmark: mapped=%d, %d MB: %.3f ms\n",
+            mapEnabled, size / (1024 * 1024), Clock::Since(start).AsMilliSeconds());
+    }
+
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(StreamReadTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    const int size = 1000;
+    auto write = IOWrite::Create();
+    write->Url = "root:stream.bin";
+    uint8_t* dst = write->Data.Add(size);
+    for (int i = 0; i < size; i++) {
+        dst[i] = uint8_t(i * 3);
+    }
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // stream a range of the file in small chunks
+    const int startOffset = 10;
+    auto read = IOStreamRead::Create();
+    read->Url = "root:stream.bin";
+    read->StartOffset = startOffset;
+    read->ChunkSize = 64;
+    read->MaxQueuedChunks = 2;
+    IO::Put(read);
+    Buffer data;
+    Buffer chunk;
+    int numChunks = 0;
+    while (!read->Finished()) {
+        while (read->PopChunk(chunk)) {
+            CHECK(chunk.Size() <= 64);
+            data.Add(chunk.Data(), chunk.Size());
+            numChunks++;
+        }
+        IOTest::runFrame();
+    }
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(numChunks == 16);
+    CHECK(data.Size() == size - startOffset);
+    bool match = true;
+    for (int i = 0; i < data.Size(); i++) {
+        match &= data.Data()[i] == uint8_t((i + startOffset) * 3);
+    }
+    CHECK(match);
+
+    // streaming a non-existing file fails without chunks
+    read = IOStreamRead::Create();
+    read->Url = "root:does_not_exist.bin";
+    IO::Put(read);
+    wait(read);
+    CHECK(read->Finished());
+    CHECK(read->Status == IOStatus::NotFound);
+    CHECK(!read->PopChunk(chunk));
+
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(StreamReadBenchmark) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    const int size = 32 * 1024 * 1024;
+    auto write = IOWrite::Create();
+    write->Url = "root:stream_bench.bin";
+    Memory::Fill(write->Data.Add(size), size, 0x55);
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // time until the first byte can be looked at, and until all bytes are
+    // processed, for a complete read vs. a streaming read
+    TimePoint start = Clock::Now();
+    auto read = IORead::Create();
+    read->Url = "root:stream_bench.bin";
+    IO::Put(read);
+    IOTest::waitHandled(read);
+    const Duration readFirstByte = Clock::Since(start);
+    uint32_t sum = 0;
+    for (int i = 0; i < read->Data.Size(); i++) {
+        sum += read->Data.Data()[i];
+    }
+    CHECK(sum == uint32_t(size) * 0x55);
+    const Duration readTotal = Clock::Since(start);
+    read = nullptr;
+
+    start = Clock::Now();
+    auto stream = IO::StreamFile("root:stream_bench.bin");
+    Duration streamFirstByte;
+    bool firstChunk = true;
+    sum = 0;
+    Buffer chunk;
+    while (!stream->Finished()) {
+        while (stream->PopChunk(chunk)) {
+            if (firstChunk) {
+                streamFirstByte = Clock::Since(start);
+                firstChunk = false;
+            }
+            for (int i = 0; i < chunk.Size(); i++) {
+                sum += chunk.Data()[i];
+            }
+        }
+        IOTest::runFrame();
+    }
+    CHECK(stream->Status == IOStatus::OK);
+    CHECK(sum == uint32_t(size) * 0x55);
+    const Duration streamTotal = Clock::Since(start);
+    Log::Info("StreamReadBenchmark: %d MB: read first byte %.3f ms, total %.3f ms; stream first byte %.3f ms, total %.3f ms\n",
+        size / (1024 * 1024),
+        readFirstByte.AsMilliSeconds(), readTotal.AsMilliSeconds(),
+        streamFirstByte.AsMilliSeconds(), streamTotal.AsMilliSeconds());
+    CHECK(streamFirstByte < readFirstByte);
+
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(StreamReadReplacedFileSystemTest) {
+    // a suspended stream must not restart when the filesystem is
+    // replaced, the new instance resumes after the pushed bytes
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 1;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    const int size = 1000;
+    auto write = IOWrite::Create();
+    write->Url = "root:stream.bin";
+    uint8_t* dst = write->Data.Add(size);
+    for (int i = 0; i < size; i++) {
+        dst[i] = uint8_t(i * 3);
+    }
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    auto read = IOStreamRead::Create();
+    read->Url = "root:stream.bin";
+    read->ChunkSize = 64;
+    read->MaxQueuedChunks = 2;
+    IO::Put(read);
+    while (read->CanPushChunk()) {
+        IOTest::runFrame();
+    }
+
+    // replace the filesystem while the stream is suspended, the
+    // read behind it makes sure the single worker has seen it
+    IO::RegisterFileSystem("file", LocalFileSystem::Creator());
+    auto fence = IORead::Create();
+    fence->Url = "root:stream.bin";
+    IO::Put(fence);
+    IOTest::waitHandled(fence);
+
+    Buffer data;
+    Buffer chunk;
+    while (!read->Finished()) {
+        while (read->PopChunk(chunk)) {
+            data.Add(chunk.Data(), chunk.Size());
+        }
+        IOTest::runFrame();
+    }
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(data.Size() == size);
+    bool match = true;
+    for (int i = 0; i < data.Size(); i++) {
+        match &= data.Data()[i] == uint8_t(i * 3);
+    }
+    CHECK(match);
+
+    IO::Discard();
+    Core::Discard();
+}
@@ -32,6 +32,10 @@ public:
     static int size(handle f);
     /// close file
     static void close(handle f);
+    /// map a range of an open file read-only into memory, return nullptr if not supported
+    static const uint8_t* map(handle f, int offset, int numBytes);
+    /// unmap a memory range returned by map()
+    static void unmap(const uint8_t* ptr, int numBytes);
     
     /// get path to own executable
     static String getExecutableDir();
@@ -8,8 +8,11 @@
 #include "LocalFS/whereami/whereami.h"
 #if ORYOL_WINDOWS
 #include <direct.h>
+#include <io.h>
+#include <Windows.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 namespace Oryol {
@@ -73,6 +76,60 @@ posixFSWrapper::close(handle h) {
     fclose((FILE*)h);
 }
 
+//------------------------------------------------------------------------------
+const uint8_t*
+posixFSWrapper::map(handle h, int offset, int numBytes) {
+    o_assert_dbg(invalidHandle != h);
+    o_assert_dbg((offset >= 0) && (numBytes > 0));
+    #if ORYOL_WINDOWS
+    // the file offset of a view must be aligned to the allocation granularity,
+    // the view keeps the file mapping object alive after its handle is closed
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    const int pageOffset = offset % (int) sysInfo.dwAllocationGranularity;
+    HANDLE file = (HANDLE) _get_osfhandle(_fileno((FILE*)h));
+    if (INVALID_HANDLE_VALUE == file) {
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (NULL == mapping) {
+        return nullptr;
+    }
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, DWORD(offset - pageOffset), SIZE_T(numBytes + pageOffset));
+    CloseHandle(mapping);
+    if (nullptr == ptr) {
+        return nullptr;
+    }
+    return ((const uint8_t*)ptr) + pageOffset;
+    #else
+    // the file offset of a mapping must be page-aligned
+    const int pageSize = (int) sysconf(_SC_PAGESIZE);
+    const int pageOffset = offset % pageSize;
+    void* ptr = mmap(nullptr, numBytes + pageOffset, PROT_READ, MAP_PRIVATE, fileno((FILE*)h), offset - pageOffset);
+    if (MAP_FAILED == ptr) {
+        return nullptr;
+    }
+    return ((const uint8_t*)ptr) + pageOffset;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+posixFSWrapper::unmap(const uint8_t* ptr, int numBytes) {
+    o_assert_dbg(ptr && (numBytes > 0));
+    #if ORYOL_WINDOWS
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    const uintptr_t granularity = (uintptr_t) sysInfo.dwAllocationGranularity;
+    UnmapViewOfFile((const void*)(((uintptr_t)ptr) & ~(granularity - 1)));
+    #else
+    const uintptr_t pageSize = (uintptr_t) sysconf(_SC_PAGESIZE);
+    const uintptr_t addr = (uintptr_t) ptr;
+    const uintptr_t base = addr & ~(pageSize - 1);
+    munmap((void*)base, numBytes + (addr - base));
+    #endif
+}
+
 //------------------------------------------------------------------------------
 String
 posixFSWrapper::getExecutableDir() {
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+//  pakArchive.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "pakArchive.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include "LocalFS/Core/fsWrapper.h"
+#include <cstring>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+pakArchive::~pakArchive() {
+    this->unload();
+}
+
+//------------------------------------------------------------------------------
+void
+pakArchive::unload() {
+    if (this->ptr) {
+        if (this->mapped) {
+            fsWrapper::unmap(this->ptr, this->size);
+        }
+        else {
+            Memory::Free((void*)this->ptr);
+        }
+    }
+    this->ptr = nullptr;
+    this->size = 0;
+    this->mapped = false;
+    this->header = nullptr;
+    this->entries = nullptr;
+    this->hashTable = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+pakArchive::open(const char* path) {
+    o_assert_dbg(path);
+    o_assert(nullptr == this->ptr);
+
+    fsWrapper::handle h = fsWrapper::openRead(path);
+    if (fsWrapper::invalidHandle == h) {
+        Log::Warn("pakArchive: failed to open '%s'\n", path);
+        return false;
+    }
+    const int fileSize = fsWrapper::size(h);
+    if (fileSize >= int(sizeof(pakFormat::header))) {
+        this->ptr = fsWrapper::map(h, 0, fileSize);
+        if (this->ptr) {
+            this->mapped = true;
+        }
+        else {
+            // no memory-mapping, load the whole file
+            uint8_t* buf = (uint8_t*) Memory::Alloc(fileSize);
+            if (fsWrapper::read(h, buf, fileSize) == fileSize) {
+                this->ptr = buf;
+            }
+            else {
+                Memory::Free(buf);
+            }
+        }
+        this->size = fileSize;
+    }
+    fsWrapper::close(h);
+
+    if (this->ptr) {
+        this->header = (const pakFormat::header*) this->ptr;
+        this->entries = (const pakFormat::entry*) (this->ptr + this->header->entriesOffset);
+        this->hashTable = (const uint32_t*) (this->ptr + this->header->hashTableOffset);
+        if (this->validate()) {
+            return true;
+        }
+    }
+    Log::Warn("pakArchive: '%s' is not a valid pak archive\n", path);
+    this->unload();
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+pakArchive::validate() const {
+    const pakFormat::header& hdr = *this->header;
+    const uint64_t fileSize = uint64_t(this->size);
+    if ((pakFormat::Magic != hdr.magic) || (pakFormat::Version != hdr.version)) {
+        return false;
+    }
+    if ((0 == hdr.hashTableSize) || (0 != (hdr.hashTableSize & (hdr.hashTableSize - 1))) || (hdr.hashTableSize <= hdr.numEntries)) {
+        return false;
+    }
+    if ((0 != (hdr.entriesOffset % sizeof(uint32_t))) || (0 != (hdr.hashTableOffset % sizeof(uint32_t)))) {
+        return false;
+    }
+    if (((uint64_t(hdr.entriesOffset) + uint64_t(hdr.numEntries) * sizeof(pakFormat::entry)) > fileSize) ||
+        ((uint64_t(hdr.hashTableOffset) + uint64_t(hdr.hashTableSize) * sizeof(uint32_t)) > fileSize)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < hdr.numEntries; i++) {
+        const pakFormat::entry& e = this->entries[i];
+        if (((uint64_t(e.nameOffset) + e.nameLength) > fileSize) ||
+            ((uint64_t(e.dataOffset) + e.size) > fileSize) ||
+            (e.compression > pakFormat::LZ4) ||
+            ((pakFormat::None == e.compression) && (e.size != e.uncompressedSize)) ||
+            (e.uncompressedSize > 0x7FFFFFFF)) {
+            return false;
+        }
+    }
+    // lookups rely on at least one empty hash table slot
+    uint32_t numUsedSlots = 0;
+    for (uint32_t i = 0; i < hdr.hashTableSize; i++) {
+        if (pakFormat::InvalidIndex != this->hashTable[i]) {
+            if (this->hashTable[i] >= hdr.numEntries) {
+                return false;
+            }
+            numUsedSlots++;
+        }
+    }
+    return numUsedSlots <= hdr.numEntries;
+}
+
+//------------------------------------------------------------------------------
+int
+pakArchive::numEntries() const {
+    o_assert_dbg(this->header);
+    return int(this->header->numEntries);
+}
+
+//------------------------------------------------------------------------------
+const pakFormat::entry&
+pakArchive::entryAt(int index) const {
+    o_assert_range_dbg(index, this->numEntries());
+    return this->entries[index];
+}
+
+//------------------------------------------------------------------------------
+const char*
+pakArchive::name(const pakFormat::entry& e) const {
+    return (const char*) (this->ptr + e.nameOffset);
+}
+
+//------------------------------------------------------------------------------
+const pakFormat::entry*
+pakArchive::find(const char* name, int length) const {
+    o_assert_dbg(this->header);
+    const uint32_t h = pakFormat::hash(name, length);
+    const uint32_t mask = this->header->hashTableSize - 1;
+    // the hash table is never full, so there's always an empty slot
+    for (uint32_t slot = h & mask; ; slot = (slot + 1) & mask) {
+        const uint32_t index = this->hashTable[slot];
+        if (pakFormat::InvalidIndex == index) {
+            return nullptr;
+        }
+        const pakFormat::entry& e = this->entries[index];
+        if ((e.nameHash == h) && (int(e.nameLength) == length) && (0 == std::memcmp(this->name(e), name, length))) {
+            return &e;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+const uint8_t*
+pakArchive::data(const pakFormat::entry& e) const {
+    return this->ptr + e.dataOffset;
+}
+
+} // namespace _priv
+} // namespace Oryol
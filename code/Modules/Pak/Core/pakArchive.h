@@ -0,0 +1,58 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::pakArchive
+    @ingroup _priv
+    @brief a memory-mapped pak archive
+
+    The archive file is mapped into memory once when it is opened, the
+    header and directory are validated, and after that the archive is
+    immutable and can be accessed from any thread without locking.
+    If the platform doesn't support memory-mapping, the whole file
+    is read into memory instead.
+
+    Buffers which point into the mapped archive keep a reference to
+    the pakArchive object, so the mapping stays alive until the
+    last of those buffers has been destroyed.
+*/
+#include "Core/RefCounted.h"
+#include "Pak/Core/pakFormat.h"
+
+namespace Oryol {
+namespace _priv {
+
+class pakArchive : public RefCounted {
+    OryolClassDecl(pakArchive);
+public:
+    /// destructor
+    ~pakArchive();
+
+    /// open and map an archive file by native path, return false on error
+    bool open(const char* path);
+    /// get number of entries
+    int numEntries() const;
+    /// get entry by index
+    const pakFormat::entry& entryAt(int index) const;
+    /// get the name of an entry (not 0-terminated)
+    const char* name(const pakFormat::entry& e) const;
+    /// find an entry by name, return nullptr if not found
+    const pakFormat::entry* find(const char* name, int length) const;
+    /// get pointer to the (possibly compressed) data of an entry
+    const uint8_t* data(const pakFormat::entry& e) const;
+
+private:
+    /// validate header and directory after loading
+    bool validate() const;
+    /// release the mapped or loaded file
+    void unload();
+
+    const uint8_t* ptr = nullptr;
+    int size = 0;
+    bool mapped = false;
+    const pakFormat::header* header = nullptr;
+    const pakFormat::entry* entries = nullptr;
+    const uint32_t* hashTable = nullptr;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,81 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::pakFormat
+    @ingroup _priv
+    @brief the pak archive file format
+
+    A pak archive is a single file with a directory and the data of
+    many small files, so that loading a file is a hash table lookup
+    and a pointer into a memory-mapped file instead of an
+    open/stat/read/close sequence. All values are little-endian.
+
+    - header
+    - entry table: numEntries entries, sorted by name hash and name
+    - hash table: hashTableSize entry indices (power of 2), open
+      addressing with linear probing, InvalidIndex marks empty slots
+    - name table: the entry names (not 0-terminated)
+    - entry data, each entry starts at a multiple of header.alignment
+
+    Entry names are relative paths with '/' separators. An entry is
+    either stored uncompressed, or compressed as a single LZ4 block
+    (see LZ4Codec).
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace _priv {
+
+class pakFormat {
+public:
+    /// file magic 'OPAK'
+    static const uint32_t Magic = 'O' | ('P' << 8) | ('A' << 16) | ('K' << 24);
+    /// current version
+    static const uint32_t Version = 1;
+    /// default data alignment
+    static const uint32_t DefaultAlignment = 16;
+    /// marks an empty hash table slot
+    static const uint32_t InvalidIndex = 0xFFFFFFFF;
+
+    /// entry compression
+    enum compression : uint32_t {
+        None = 0,
+        LZ4 = 1,
+    };
+
+    /// file header
+    struct header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numEntries;
+        uint32_t hashTableSize;
+        uint32_t entriesOffset;
+        uint32_t hashTableOffset;
+        uint32_t namesOffset;
+        uint32_t alignment;
+    };
+
+    /// directory entry
+    struct entry {
+        uint32_t nameHash;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t dataOffset;
+        uint32_t size;              // size of data in archive
+        uint32_t uncompressedSize;  // same as size if not compressed
+        uint32_t compression;
+        uint32_t reserved;
+    };
+
+    /// compute the hash of an entry name (FNV-1a)
+    static uint32_t hash(const char* name, int length) {
+        uint32_t h = 2166136261U;
+        for (int i = 0; i < length; i++) {
+            h = (h ^ uint8_t(name[i])) * 16777619U;
+        }
+        return h;
+    }
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+//  pakWriter.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "pakWriter.h"
+#include "IO/Core/LZ4Codec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+bool
+pakWriter::add(const String& name, const uint8_t* data, int size, bool compress) {
+    o_assert_dbg(!name.Empty() && (size >= 0));
+    for (const item& it : this->items) {
+        if (it.name == name) {
+            return false;
+        }
+    }
+    item it;
+    it.name = name;
+    it.hash = pakFormat::hash(name.AsCStr(), name.Length());
+    it.uncompressedSize = uint32_t(size);
+    if (compress && (size > 0)) {
+        const int bound = LZ4Codec::CompressBound(size);
+        uint8_t* dst = it.data.Add(bound);
+        const int compressedSize = LZ4Codec::Compress(data, size, dst, bound);
+        if ((compressedSize > 0) && (compressedSize < size)) {
+            it.data.Remove(compressedSize, bound - compressedSize);
+            it.compression = pakFormat::LZ4;
+        }
+        else {
+            it.data.Clear();
+        }
+    }
+    if ((pakFormat::None == it.compression) && (size > 0)) {
+        it.data.Add(data, size);
+    }
+    this->items.Add(std::move(it));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+pakWriter::numEntries() const {
+    return this->items.Size();
+}
+
+//------------------------------------------------------------------------------
+Buffer
+pakWriter::build(uint32_t alignment) const {
+    o_assert((alignment > 0) && (0 == (alignment & (alignment - 1))));
+
+    // sort entries by hash and name
+    Array<int> order;
+    order.Reserve(this->items.Size());
+    for (int i = 0; i < this->items.Size(); i++) {
+        order.Add(i);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        const item& ia = this->items[a];
+        const item& ib = this->items[b];
+        if (ia.hash != ib.hash) {
+            return ia.hash < ib.hash;
+        }
+        return std::strcmp(ia.name.AsCStr(), ib.name.AsCStr()) < 0;
+    });
+
+    // the hash table is at most half full
+    const uint32_t numEntries = uint32_t(this->items.Size());
+    uint32_t hashTableSize = 16;
+    while (hashTableSize < (numEntries * 2)) {
+        hashTableSize *= 2;
+    }
+
+    // layout
+    pakFormat::header hdr;
+    hdr.magic = pakFormat::Magic;
+    hdr.version = pakFormat::Version;
+    hdr.numEntries = numEntries;
+    hdr.hashTableSize = hashTableSize;
+    hdr.entriesOffset = sizeof(pakFormat::header);
+    hdr.hashTableOffset = hdr.entriesOffset + numEntries * sizeof(pakFormat::entry);
+    hdr.namesOffset = hdr.hashTableOffset + hashTableSize * sizeof(uint32_t);
+    hdr.alignment = alignment;
+    uint32_t namesSize = 0;
+    for (const item& it : this->items) {
+        namesSize += it.name.Length();
+    }
+    uint64_t dataOffset = hdr.namesOffset + namesSize;
+
+    Array<pakFormat::entry> entries;
+    entries.Reserve(numEntries);
+    uint32_t nameOffset = hdr.namesOffset;
+    for (int index : order) {
+        const item& it = this->items[index];
+        dataOffset = (dataOffset + alignment - 1) & ~uint64_t(alignment - 1);
+        pakFormat::entry e;
+        e.nameHash = it.hash;
+        e.nameOffset = nameOffset;
+        e.nameLength = uint32_t(it.name.Length());
+        e.dataOffset = uint32_t(dataOffset);
+        e.size = uint32_t(it.data.Size());
+        e.uncompressedSize = it.uncompressedSize;
+        e.compression = it.compression;
+        e.reserved = 0;
+        entries.Add(e);
+        nameOffset += e.nameLength;
+        dataOffset += e.size;
+    }
+    o_assert2(dataOffset <= 0x7FFFFFFF, "pakWriter: archive too big!\n");
+
+    Array<uint32_t> hashTable;
+    hashTable.Reserve(hashTableSize);
+    for (uint32_t i = 0; i < hashTableSize; i++) {
+        hashTable.Add(uint32_t(pakFormat::InvalidIndex));
+    }
+    for (uint32_t i = 0; i < numEntries; i++) {
+        uint32_t slot = entries[i].nameHash & (hashTableSize - 1);
+        while (pakFormat::InvalidIndex != hashTable[slot]) {
+            slot = (slot + 1) & (hashTableSize - 1);
+        }
+        hashTable[slot] = i;
+    }
+
+    // write everything
+    Buffer buf;
+    buf.Reserve(int(dataOffset));
+    buf.Add((const uint8_t*)&hdr, sizeof(hdr));
+    if (numEntries > 0) {
+        buf.Add((const uint8_t*)&entries[0], numEntries * sizeof(pakFormat::entry));
+    }
+    buf.Add((const uint8_t*)&hashTable[0], hashTableSize * sizeof(uint32_t));
+    for (int index : order) {
+        const String& name = this->items[index].name;
+        buf.Add((const uint8_t*)name.AsCStr(), name.Length());
+    }
+    for (uint32_t i = 0; i < numEntries; i++) {
+        const int padding = int(entries[i].dataOffset) - buf.Size();
+        if (padding > 0) {
+            Memory::Clear(buf.Add(padding), padding);
+        }
+        const Buffer& data = this->items[order[i]].data;
+        if (!data.Empty()) {
+            buf.Add(data.Data(), data.Size());
+        }
+    }
+    return buf;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,41 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::pakWriter
+    @ingroup _priv
+    @brief build a pak archive in memory
+
+    Used by the pak packer tool and the unit tests. Add entries with
+    add(), then call build() to get the archive file content. Entries
+    are only stored compressed if that makes them smaller.
+*/
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/String/String.h"
+#include "Pak/Core/pakFormat.h"
+
+namespace Oryol {
+namespace _priv {
+
+class pakWriter {
+public:
+    /// add an entry, return false if an entry of that name already exists
+    bool add(const String& name, const uint8_t* data, int size, bool compress=false);
+    /// get number of added entries
+    int numEntries() const;
+    /// build the archive with the given data alignment (power of 2)
+    Buffer build(uint32_t alignment=pakFormat::DefaultAlignment) const;
+
+private:
+    struct item {
+        String name;
+        uint32_t hash = 0;
+        uint32_t uncompressedSize = 0;
+        uint32_t compression = pakFormat::None;
+        Buffer data;
+    };
+    Array<item> items;
+};
+
+} // namespace _priv
+} // namespace Oryol
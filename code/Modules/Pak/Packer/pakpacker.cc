@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//  pakpacker.cc
+//  Command line tool to pack files into a pak archive.
+//
+//  pakpacker -o out.pak [-root dir] [-align n] [-compress] files...
+//
+//  The entry names are the file paths relative to the -root directory,
+//  with '/' separators. With -compress, entries are LZ4-compressed
+//  if that makes them smaller.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Core.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/String/StringConverter.h"
+#include "LocalFS/Core/fsWrapper.h"
+#include "Pak/Core/pakWriter.h"
+#include <cstring>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+static bool
+readFile(const String& path, Buffer& outData) {
+    fsWrapper::handle h = fsWrapper::openRead(path.AsCStr());
+    if (fsWrapper::invalidHandle == h) {
+        return false;
+    }
+    const int size = fsWrapper::size(h);
+    bool success = true;
+    if (size > 0) {
+        success = fsWrapper::read(h, outData.Add(size), size) == size;
+    }
+    fsWrapper::close(h);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+static int
+pack(int argc, const char** argv) {
+    String outPath;
+    String root;
+    uint32_t alignment = pakFormat::DefaultAlignment;
+    bool compress = false;
+    Array<String> files;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if ((0 == std::strcmp(arg, "-o")) && ((i + 1) < argc)) {
+            outPath = argv[++i];
+        }
+        else if ((0 == std::strcmp(arg, "-root")) && ((i + 1) < argc)) {
+            root = argv[++i];
+        }
+        else if ((0 == std::strcmp(arg, "-align")) && ((i + 1) < argc)) {
+            alignment = StringConverter::FromString<uint32_t>(argv[++i]);
+        }
+        else if (0 == std::strcmp(arg, "-compress")) {
+            compress = true;
+        }
+        else {
+            files.Add(arg);
+        }
+    }
+    if (outPath.Empty() || files.Empty() || (0 == alignment) || (0 != (alignment & (alignment - 1)))) {
+        Log::Info("usage: pakpacker -o out.pak [-root dir] [-align n] [-compress] files...\n");
+        return 10;
+    }
+
+    StringBuilder strBuilder;
+    pakWriter writer;
+    int numBytes = 0;
+    for (const String& file : files) {
+        // the entry name is the path relative to the root directory
+        strBuilder.Set(file);
+        strBuilder.SubstituteAll("\\", "/");
+        String name = strBuilder.GetString();
+        if (!root.Empty()) {
+            strBuilder.Set(root);
+            strBuilder.SubstituteAll("\\", "/");
+            if ((strBuilder.Length() > 0) && (strBuilder.Back() != '/')) {
+                strBuilder.Append('/');
+            }
+            strBuilder.Append(name);
+        }
+        Buffer data;
+        if (!readFile(strBuilder.GetString(), data)) {
+            Log::Error("pakpacker: failed to read '%s'\n", strBuilder.AsCStr());
+            return 10;
+        }
+        if (!writer.add(name, data.Data(), data.Size(), compress)) {
+            Log::Error("pakpacker: duplicate entry '%s'\n", name.AsCStr());
+            return 10;
+        }
+        numBytes += data.Size();
+    }
+
+    Buffer archive = writer.build(alignment);
+    fsWrapper::handle h = fsWrapper::openWrite(outPath.AsCStr());
+    if (fsWrapper::invalidHandle == h) {
+        Log::Error("pakpacker: failed to open '%s' for writing\n", outPath.AsCStr());
+        return 10;
+    }
+    const bool success = fsWrapper::write(h, archive.Data(), archive.Size()) == archive.Size();
+    fsWrapper::close(h);
+    if (!success) {
+        Log::Error("pakpacker: failed to write '%s'\n", outPath.AsCStr());
+        return 10;
+    }
+    Log::Info("pakpacker: packed %d files (%d bytes) into '%s' (%d bytes)\n",
+        writer.numEntries(), numBytes, outPath.AsCStr(), archive.Size());
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int
+main(int argc, const char** argv) {
+    Core::Setup();
+    const int result = pack(argc, argv);
+    Core::Discard();
+    return result;
+}
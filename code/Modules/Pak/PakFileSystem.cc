@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+//  PakFileSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "PakFileSystem.h"
+#include "Core/Core.h"
+#include "IO/IO.h"
+#include "IO/Core/LZ4Codec.h"
+
+namespace Oryol {
+
+using namespace _priv;
+
+//------------------------------------------------------------------------------
+std::function<Ptr<FileSystem>()>
+PakFileSystem::Creator(const URL& archiveUrl) {
+    o_assert_dbg(Core::IsMainThread());
+    URL url(IO::ResolveAssigns(archiveUrl.AsCStr()));
+    if (!url.HasPath()) {
+        o_warn("PakFileSystem::Creator(): no path in URL '%s'\n", url.AsCStr());
+        return nullptr;
+    }
+    Ptr<pakArchive> archive = pakArchive::Create();
+    if (!archive->open(url.Path().AsCStr())) {
+        return nullptr;
+    }
+    // the opened archive is read-only, so the filesystems of all
+    // IO workers can share it
+    return [archive]() -> Ptr<FileSystem> {
+        return PakFileSystem::Create(archive);
+    };
+}
+
+//------------------------------------------------------------------------------
+PakFileSystem::PakFileSystem(const Ptr<pakArchive>& archive_) :
+archive(archive_) {
+    o_assert_dbg(this->archive);
+}
+
+//------------------------------------------------------------------------------
+void
+PakFileSystem::onMsg(const Ptr<IORequest>& req) {
+    if (req->IsA<IORead>()) {
+        this->onRead(req->DynamicCast<IORead>());
+    }
+    else {
+        req->Status = IOStatus::BadRequest;
+        req->ErrorDesc = "Pak archives are read-only";
+    }
+    req->Handled = true;
+}
+
+//------------------------------------------------------------------------------
+void
+PakFileSystem::onRead(const Ptr<IORead>& msg) {
+    const Ptr<pakArchive>& archive = this->archive;
+    const String path = msg->Url.Path();
+    const pakFormat::entry* e = archive->find(path.AsCStr(), path.Length());
+    if (!e) {
+        msg->Status = IOStatus::NotFound;
+        msg->ErrorDesc = "File not found in pak archive";
+        return;
+    }
+
+    // the requested byte range in the uncompressed data
+    const int fileSize = int(e->uncompressedSize);
+    const int startOffset = msg->StartOffset;
+    const int endOffset = (msg->EndOffset == EndOfFile) ? fileSize : msg->EndOffset;
+    if ((startOffset < 0) || (endOffset > fileSize) || (startOffset > endOffset)) {
+        msg->Status = IOStatus::DownloadError;
+        msg->ErrorDesc = "Fewer bytes read then expected";
+        return;
+    }
+    const int size = endOffset - startOffset;
+
+    const uint8_t* src = archive->data(*e);
+    if (pakFormat::None == e->compression) {
+        if (msg->MapEnabled && (size > 0) && msg->Data.Empty()) {
+            // zero-copy: the buffer keeps the mapped archive alive
+            msg->Data.Wrap(src + startOffset, size, [archive](const uint8_t*, int) { });
+        }
+        else if (size > 0) {
+            msg->Data.Add(src + startOffset, size);
+        }
+    }
+    else if (size > 0) {
+        // decompress the whole entry, and drop the bytes outside the requested range
+        const int dataOffset = msg->Data.Size();
+        uint8_t* dst = msg->Data.Add(fileSize);
+        if (LZ4Codec::Decompress(src, int(e->size), dst, fileSize) != fileSize) {
+            msg->Data.Clear();
+            msg->Status = IOStatus::DownloadError;
+            msg->ErrorDesc = "Failed to decompress pak entry";
+            return;
+        }
+        if (endOffset < fileSize) {
+            msg->Data.Remove(dataOffset + endOffset, fileSize - endOffset);
+        }
+        if (startOffset > 0) {
+            msg->Data.Remove(dataOffset, startOffset);
+        }
+    }
+    msg->Status = IOStatus::OK;
+}
+
+} // namespace Oryol
@@ -0,0 +1,63 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @defgroup Pak Pak
+    @brief load files from indexed package archives
+
+    @class Oryol::PakFileSystem
+    @ingroup Pak
+    @brief FileSystem subclass to read files from memory-mapped pak archives
+
+    A pak archive packs many small files into a single file with a hashed
+    directory (see the pakpacker tool). The archive is opened and mapped
+    once by Creator(), after that a read is a hash table lookup and (for
+    uncompressed entries) a read-only view into the mapped file, no file
+    is opened per read. Compressed entries are decompressed on the IO
+    worker thread.
+
+    Each archive is registered as its own URL scheme, the path of a URL
+    is the name of the entry in the archive. The creator returned by
+    Creator() shares the opened archive between the filesystem objects
+    of all IO workers, and is empty if the archive can't be opened:
+
+    @code
+    auto creator = PakFileSystem::Creator("root:data.pak");
+    if (creator) {
+        IO::RegisterFileSystem("data", creator);
+    }
+    IO::Load("data:///textures/wood.dds", ...);
+    @endcode
+
+    Creator() must be called from the main thread, reads are handled on
+    the IO worker threads. An archive is closed when its scheme has been
+    unregistered with IO::UnregisterFileSystem(). The Data of a read from
+    an uncompressed entry wraps the mapped archive if IORead::MapEnabled
+    is set (otherwise it is copied), and keeps the mapping alive, even
+    after the archive has been closed.
+*/
+#include "IO/FS/FileSystem.h"
+#include "Pak/Core/pakArchive.h"
+#include <functional>
+
+namespace Oryol {
+
+class PakFileSystem : public FileSystem {
+    OryolClassDecl(PakFileSystem);
+public:
+    /// open a pak archive from a local file URL (e.g. 'root:data.pak'), return an empty creator on failure
+    static std::function<Ptr<FileSystem>()> Creator(const URL& archiveUrl);
+
+    /// constructor
+    PakFileSystem(const Ptr<_priv::pakArchive>& archive);
+
+    /// called when IO message should be handled
+    virtual void onMsg(const Ptr<IORequest>& ioReq) override;
+
+private:
+    /// handle IORead msg
+    void onRead(const Ptr<IORead>& ioRead);
+
+    Ptr<_priv::pakArchive> archive;
+};
+
+} // namespace Oryol
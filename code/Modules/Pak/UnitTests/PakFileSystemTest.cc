@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+//  PakFileSystemTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Time/Clock.h"
+#include "IO/IO.h"
+#include "IO/UnitTests/IOTestHelpers.h"
+#include "LocalFS/LocalFileSystem.h"
+#include "LocalFS/Core/fsWrapper.h"
+#include "Pak/PakFileSystem.h"
+#include "Pak/Core/pakWriter.h"
+#include <thread>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+static void
+setupPakIO() {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeFile(const URL& url, const Buffer& data) {
+    URL resolved(IO::ResolveAssigns(url.AsCStr()));
+    fsWrapper::handle h = fsWrapper::openWrite(resolved.Path().AsCStr());
+    CHECK(fsWrapper::invalidHandle != h);
+    fsWrapper::write(h, data.Data(), data.Size());
+    fsWrapper::close(h);
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IORead>
+readFile(const URL& url, int startOffset=0, int endOffset=EndOfFile) {
+    Ptr<IORead> req = IORead::Create();
+    req->Url = url;
+    req->MapEnabled = true;
+    req->StartOffset = startOffset;
+    req->EndOffset = endOffset;
+    IO::Put(req);
+    IOTest::waitHandled(req);
+    return req;
+}
+
+//------------------------------------------------------------------------------
+static void
+fillPattern(uint8_t* dst, int size, int seed) {
+    for (int i = 0; i < size; i++) {
+        dst[i] = uint8_t((i / 8) * 3 + seed);
+    }
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkPattern(const Buffer& data, int offset, int seed) {
+    for (int i = 0; i < data.Size(); i++) {
+        if (data.Data()[i] != uint8_t(((i + offset) / 8) * 3 + seed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if !ORYOL_UNITTESTS_HEADLESS
+//------------------------------------------------------------------------------
+TEST(PakFileSystemTest) {
+    setupPakIO();
+
+    // build an archive with a stored and a compressed entry
+    const int size = 10000;
+    Buffer data;
+    uint8_t* ptr = data.Add(size);
+    pakWriter writer;
+    fillPattern(ptr, size, 1);
+    CHECK(writer.add("textures/wood.dds", ptr, size));
+    fillPattern(ptr, size, 2);
+    CHECK(writer.add("meshes/box.omsh", ptr, size, true));
+    CHECK(writer.add("empty.txt", ptr, 0));
+    CHECK(!writer.add("empty.txt", ptr, 0));
+    CHECK(writer.numEntries() == 3);
+    Buffer archive = writer.build(64);
+    writeFile("root:test.pak", archive);
+
+    CHECK(!PakFileSystem::Creator("root:does_not_exist.pak"));
+    auto creator = PakFileSystem::Creator("root:test.pak");
+    CHECK(creator);
+    IO::RegisterFileSystem("data", creator);
+    creator = nullptr;
+
+    // uncompressed entries are mapped
+    Ptr<IORead> req = readFile("data:///textures/wood.dds");
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Size() == size);
+    CHECK(checkPattern(req->Data, 0, 1));
+    #if ORYOL_POSIX && !ORYOL_WINDOWS
+    CHECK(req->Data.IsWrapped());
+    CHECK(0 == (uintptr_t(req->Data.Data()) % 64));
+    #endif
+
+    // compressed entries are decompressed, also for partial reads
+    req = readFile("data:///meshes/box.omsh");
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Size() == size);
+    CHECK(checkPattern(req->Data, 0, 2));
+    req = readFile("data:///meshes/box.omsh", 100, 200);
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Size() == 100);
+    CHECK(checkPattern(req->Data, 100, 2));
+    req = readFile("data:///textures/wood.dds", 9990);
+    CHECK(req->Data.Size() == 10);
+    CHECK(checkPattern(req->Data, 9990, 1));
+
+    req = readFile("data:///empty.txt");
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Empty());
+    req = readFile("data:///textures/wood.dds", 0, size + 1);
+    CHECK(req->Status == IOStatus::DownloadError);
+    req = readFile("data:///textures/metal.dds");
+    CHECK(req->Status == IOStatus::NotFound);
+
+    // a second archive is independent from the first
+    pakWriter writer2;
+    fillPattern(data.Data(), size, 3);
+    CHECK(writer2.add("textures/wood.dds", data.Data(), 100));
+    writeFile("root:test2.pak", writer2.build());
+    IO::RegisterFileSystem("data2", PakFileSystem::Creator("root:test2.pak"));
+    req = readFile("data2:///textures/wood.dds");
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Size() == 100);
+    CHECK(checkPattern(req->Data, 0, 3));
+    req = readFile("data2:///meshes/box.omsh");
+    CHECK(req->Status == IOStatus::NotFound);
+    IO::UnregisterFileSystem("data2");
+
+    // mapped data stays valid after the archive has been closed
+    req = readFile("data:///textures/wood.dds");
+    IO::UnregisterFileSystem("data");
+    IOTest::runFrames(10);
+    CHECK(!IO::IsFileSystemRegistered("data"));
+    CHECK(checkPattern(req->Data, 0, 1));
+    req = nullptr;
+
+    // a damaged archive is rejected
+    Memory::Fill(archive.Data() + 8, 4, 0xFF);
+    writeFile("root:broken.pak", archive);
+    CHECK(!PakFileSystem::Creator("root:broken.pak"));
+
+    IO::Discard();
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(PakFileSystemBenchmark) {
+    setupPakIO();
+
+    // write many small files, and the same files as pak archive
+    const int numFiles = 2000;
+    StringBuilder strBuilder;
+    strBuilder.Format(4096, "%spakbench", fsWrapper::getExecutableDir().AsCStr());
+    const String dir = strBuilder.GetString();
+    #if ORYOL_POSIX && !ORYOL_WINDOWS
+    strBuilder.Format(4096, "mkdir -p '%s'", dir.AsCStr());
+    CHECK(0 == system(strBuilder.AsCStr()));
+    #endif
+    pakWriter writer;
+    Buffer data;
+    for (int i = 0; i < numFiles; i++) {
+        const int size = 256 + (i * 37) % 2048;
+        data.Clear();
+        fillPattern(data.Add(size), size, i);
+        strBuilder.Format(64, "file%d.bin", i);
+        writer.add(strBuilder.GetString(), data.Data(), data.Size());
+        strBuilder.Format(4096, "root:pakbench/file%d.bin", i);
+        writeFile(strBuilder.GetString(), data);
+    }
+    writeFile("root:bench.pak", writer.build());
+    auto creator = PakFileSystem::Creator("root:bench.pak");
+    CHECK(creator);
+    IO::RegisterFileSystem("bench", creator);
+
+    // load all files through IO::LoadFile(), once as loose files, once from the archive
+    const char* formats[2] = { "root:pakbench/file%d.bin", "bench:///file%d.bin" };
+    Duration times[2];
+    for (int pass = 0; pass < 2; pass++) {
+        const TimePoint start = Clock::Now();
+        Array<Ptr<IORead>> reqs;
+        reqs.Reserve(numFiles);
+        for (int i = 0; i < numFiles; i++) {
+            strBuilder.Format(64, formats[pass], i);
+            reqs.Add(IO::LoadFile(strBuilder.GetString()));
+        }
+        bool allOk = true;
+        for (const auto& req : reqs) {
+            IOTest::waitHandled(req);
+            allOk &= (req->Status == IOStatus::OK);
+        }
+        times[pass] = Clock::Since(start);
+        CHECK(allOk);
+        CHECK(checkPattern(reqs[123]->Data, 0, 123));
+    }
+    Log::Info("PakFileSystemBenchmark: %d small files: LocalFileSystem %.3f ms, PakFileSystem %.3f ms\n",
+        numFiles, times[0].AsMilliSeconds(), times[1].AsMilliSeconds());
+
+    IO::UnregisterFileSystem("bench");
+    IO::Discard();
+    Core::Discard();
+}
+#endif
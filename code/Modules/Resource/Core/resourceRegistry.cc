@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "resourceRegistry.h"
+#include "Core/Memory/FrameAllocator.h"
 
 namespace Oryol {
 namespace _priv {
@@ -112,6 +113,10 @@ Array<Id>
 resourceRegistry::Remove(ResourceLabel label) {
     o_assert_dbg(this->isValid);
     Array<Id> removed;
+    if (FrameAllocator::IsValid()) {
+        // the result is only consumed within the current frame
+        removed.UseFrameAllocator();
+    }
     removed.Reserve(this->entries.Size() < 256 ? this->entries.Size() : 256);
     
     // for each entry where id.label matches label (from behind
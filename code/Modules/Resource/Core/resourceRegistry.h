@@ -32,7 +32,7 @@ public:
     void Add(const Locator& loc, Id id, ResourceLabel label);
     /// lookup resource Id by locator
     Id Lookup(const Locator& loc) const;
-    /// remove all resource matching label from registry, returns removed Ids
+    /// remove all resource matching label from registry, returns removed Ids (frame-allocated)
     Array<Id> Remove(ResourceLabel label);
     
     /// check if resource is in registry
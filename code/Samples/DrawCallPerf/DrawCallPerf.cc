@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "Core/Main.h"
 #include "Core/Time/Clock.h"
+#include "Core/Time/TimingStats.h"
 #include "Gfx/Gfx.h"
 #include "Assets/Gfx/ShapeBuilder.h"
 #include "Dbg/Dbg.h"
@@ -35,7 +36,7 @@ private:
     bool updateEnabled = true;
     int frameCount = 0;
     int curNumParticles = 0;
-    TimePoint lastFrameTimePoint;
+    TimingStats timingStats;
     static const int NumParticlesEmittedPerFrame = 100;
     static const int MaxNumParticles = 1024 * 1024;
     struct {
@@ -49,31 +50,31 @@ OryolMain(DrawCallPerfApp);
 AppState::Code
 DrawCallPerfApp::OnRunning() {
     
-    Duration updTime, drawTime, applyRtTime;
     this->frameCount++;
     
     // update block
     this->updateCamera();
     if (this->updateEnabled) {
-        TimePoint updStart = Clock::Now();
+        TimingStats::Scope scope(this->timingStats, "upd");
         this->emitParticles();
         this->updateParticles();
-        updTime = Clock::Since(updStart);
     }
     
     // render block
-    TimePoint applyRtStart = Clock::Now();
-    Gfx::BeginPass();
-    applyRtTime = Clock::Since(applyRtStart);
-    TimePoint drawStart = Clock::Now();
-    Gfx::ApplyDrawState(this->drawState);
-    Gfx::ApplyUniformBlock(this->perFrameParams);
-    for (int i = 0; i < this->curNumParticles; i++) {
-        this->perParticleParams.Translate = this->particles[i].pos;
-        Gfx::ApplyUniformBlock(this->perParticleParams);
-        Gfx::Draw();
+    {
+        TimingStats::Scope scope(this->timingStats, "applyRt");
+        Gfx::BeginPass();
+    }
+    {
+        TimingStats::Scope scope(this->timingStats, "draw");
+        Gfx::ApplyDrawState(this->drawState);
+        Gfx::ApplyUniformBlock(this->perFrameParams);
+        for (int i = 0; i < this->curNumParticles; i++) {
+            this->perParticleParams.Translate = this->particles[i].pos;
+            Gfx::ApplyUniformBlock(this->perParticleParams);
+            Gfx::Draw();
+        }
     }
-    drawTime = Clock::Since(drawStart);
     
     Dbg::DrawTextBuffer();
     Gfx::EndPass();
@@ -84,15 +85,22 @@ DrawCallPerfApp::OnRunning() {
         this->updateEnabled = !this->updateEnabled;
     }
     
-    Duration frameTime = Clock::LapTime(this->lastFrameTimePoint);
+    this->timingStats.FrameTick();
     Dbg::TextColor(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
-    Dbg::PrintF("\n %d draws\n\r upd=%.3fms\n\r applyRt=%.3fms\n\r draw=%.3fms\n\r frame=%.3fms\n\r"
-                " LMB/tap: toggle particle update",
-                this->curNumParticles,
-                updTime.AsMilliSeconds(),
-                applyRtTime.AsMilliSeconds(),
-                drawTime.AsMilliSeconds(),
-                frameTime.AsMilliSeconds());
+    Dbg::PrintF("\n %d draws\n\r", this->curNumParticles);
+    for (int i = 0; i < this->timingStats.NumTimings(); i++) {
+        const TimingWindow& timings = this->timingStats.Timings(this->timingStats.TimingName(i));
+        Dbg::PrintF(" %s=%.3fms\n\r", this->timingStats.TimingName(i).AsCStr(), timings.Last().AsMilliSeconds());
+    }
+    if (this->timingStats.FrameTimes().NumSamples() > 0) {
+        const TimingWindow::Summary frame = this->timingStats.FrameTimes().Summarize();
+        Dbg::PrintF(" frame=%.3fms (p50=%.3fms p99=%.3fms max=%.3fms)\n\r",
+                    this->timingStats.FrameTimes().Last().AsMilliSeconds(),
+                    frame.P50.AsMilliSeconds(),
+                    frame.P99.AsMilliSeconds(),
+                    frame.Max.AsMilliSeconds());
+    }
+    Dbg::PrintF(" LMB/tap: toggle particle update");
     Dbg::TextColor(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
     Dbg::PrintF("\n\n\r NOTE: this demo will bring down GL fairly quickly!\n");
     
@@ -178,6 +186,7 @@ DrawCallPerfApp::OnInit() {
 //------------------------------------------------------------------------------
 AppState::Code
 DrawCallPerfApp::OnCleanup() {
+    this->timingStats.Dump();
     Dbg::Discard();
     Input::Discard();
     Gfx::Discard();
@@ -12,6 +12,9 @@ endif()
 option(ORYOL_SAMPLES "Build Oryol samples" ON)
 set(ORYOL_SAMPLE_URL "http://floooh.github.com/oryol/data/" CACHE STRING "Sample data URL")
 option(ORYOL_DEBUG_SHADERS "Enable/disable debug info for shaders" OFF)
+option(ORYOL_MEMORY_TRACKING "Enable per-tag memory allocation statistics" OFF)
+option(ORYOL_SMALL_OBJECT_ALLOCATOR "Use the size-class small-object allocator for Memory::Alloc" OFF)
+option(ORYOL_NATIVE_PROFILER "Use the built-in profiler instead of Remotery in profiling builds" OFF)
 if (FIPS_MACOS OR FIPS_LINUX OR FIPS_ANDROID)
     option(ORYOL_USE_LIBCURL "Use libcurl instead of native APIs" ON)
 else() 
@@ -45,8 +48,14 @@ else()
     set(ORYOL_OPENAL 0)
 endif()
 
+# use the headless Gfx backend (no window, no GPU)?
+option(ORYOL_USE_HEADLESS "Use headless Gfx backend without window and 3D API" OFF)
+if (ORYOL_USE_HEADLESS)
+    set(ORYOL_HEADLESS 1)
+endif()
+
 # use Metal on OSX/iOS?
-if (FIPS_OSX)
+if (FIPS_OSX AND NOT ORYOL_HEADLESS)
     option(ORYOL_USE_METAL "Use Metal 3D API on OSX/iOS" OFF)
     if (ORYOL_USE_METAL)
         set(ORYOL_METAL 1)
@@ -54,7 +63,7 @@ if (FIPS_OSX)
 endif()
 
 # use D3D11 on Windows?
-if (FIPS_WINDOWS)
+if (FIPS_WINDOWS AND NOT ORYOL_HEADLESS)
     set(d3d11_default OFF)
     option(ORYOL_USE_D3D11 "Use D3D11 3D API on Windows" ${d3d11_default})
     if (ORYOL_USE_D3D11)
@@ -63,7 +72,7 @@ if (FIPS_WINDOWS)
 endif()
 
 # use OpenGL?
-if (NOT ORYOL_METAL AND NOT ORYOL_D3D11)
+if (NOT ORYOL_METAL AND NOT ORYOL_D3D11 AND NOT ORYOL_HEADLESS)
     set(ORYOL_OPENGL 1)
     if (FIPS_RASPBERRYPI)
         set(ORYOL_OPENGLES2 1)
@@ -141,6 +150,11 @@ if (ORYOL_D3D11)
     add_definitions(-DORYOL_D3D11=1)
 endif()
 
+# headless defines
+if (ORYOL_HEADLESS)
+    add_definitions(-DORYOL_HEADLESS=1)
+endif()
+
 # OpenAL defines
 if (ORYOL_OPENAL)
     add_definitions(-DORYOL_OPENAL=1)
@@ -166,6 +180,15 @@ endif()
 if (FIPS_ALLOCATOR_DEBUG)
     add_definitions(-DORYOL_ALLOCATOR_DEBUG=1)
 endif()
+if (ORYOL_MEMORY_TRACKING)
+    add_definitions(-DORYOL_MEMORY_TRACKING=1)
+endif()
+if (ORYOL_SMALL_OBJECT_ALLOCATOR)
+    add_definitions(-DORYOL_SMALL_OBJECT_ALLOCATOR=1)
+endif()
+if (ORYOL_NATIVE_PROFILER)
+    add_definitions(-DORYOL_NATIVE_PROFILER=1)
+endif()
 if (FIPS_UNITTESTS)
     add_definitions(-DORYOL_UNITTESTS=1)
     if (FIPS_UNITTESTS_HEADLESS)